@@ -32,7 +32,6 @@ public class LabelMeasurer {
     private static final String ELLIPSIS = "\u2026";
     private static final byte LABEL_MODE = 0x0001;
     private static final byte RICH_TEXT_MODE = 0x0002;
-    private static StaticLayout sLayout;
 
     private final static String XIAO_MI = "xiaomi";
 
@@ -50,15 +49,24 @@ public class LabelMeasurer {
         return textPaint;
     }
 
+    // Labels are measured on layout worker threads as well, so each measured
+    // size carries its own layout.
+    private static class LabelSize extends Size {
+        private final StaticLayout mLayout;
+
+        LabelSize(StaticLayout layout) {
+            mLayout = layout;
+        }
+    }
+
     @CalledByNative
-    public static StaticLayout getTextLayout() {
-        return sLayout;
+    public static StaticLayout getTextLayout(Size size) {
+        return ((LabelSize) size).mLayout;
     }
 
     @CalledByNative
     public static Size measureLabelSize(String text, Style style, int width,
                                         int widthMode, int height, int heightMode) {
-        sLayout = null;
         if (text == null) {
             text = "";
         }
@@ -87,7 +95,7 @@ public class LabelMeasurer {
         }
 
         // When text or style is changed we use a new StaticLayout
-        sLayout = new StaticLayout(
+        StaticLayout layout = new StaticLayout(
                 span,
                 0,
                 span.length(),
@@ -126,15 +134,15 @@ public class LabelMeasurer {
                 && (
                         // Situation of single line.
                         (shouldBeSingleLine &&
-                                (sLayout.getLineCount() > 1 || sLayout.getWidth() > width))
+                                (layout.getLineCount() > 1 || layout.getWidth() > width))
 
                         ||
                         // Situation of final line not visible.
-                        (sLayout.getHeight() - height > sLayout.getHeight() / sLayout.getLineCount())
+                        (layout.getHeight() - height > layout.getHeight() / layout.getLineCount())
 
                         ||
                         // Situation of concrete line height.
-                        (lineCountWanted != Constants.UNDEFINED && lineCountWanted < sLayout.getLineCount())
+                        (lineCountWanted != Constants.UNDEFINED && lineCountWanted < layout.getLineCount())
                 );
 
 
@@ -142,18 +150,18 @@ public class LabelMeasurer {
         if (doEllipsis) {
             // Default target line is the first line
             int targetLine = 0;
-            if (sLayout.getHeight() > height) {
+            if (layout.getHeight() > height) {
                 if (lineCountWanted != Constants.UNDEFINED) {
                     targetLine = lineCountWanted - 1;
                 } else {
                     targetLine = (int) Math.ceil(height /
-                            (sLayout.getHeight() / sLayout.getLineCount())) - 1;
+                            (layout.getHeight() / layout.getLineCount())) - 1;
                 }
             }
             // TODO targetLine 为0 有问题
-            int surplus = sLayout.getWidth() - width;
+            int surplus = layout.getWidth() - width;
             // Keep the target line and above, remove other lines below
-            span.delete(sLayout.getLineEnd(targetLine), span.length());
+            span.delete(layout.getLineEnd(targetLine), span.length());
 
             // TODO 可能由于 wordbreak 问题，删除了可能已经够小了，无需往前删
             // Insert ellipsis
@@ -187,7 +195,7 @@ public class LabelMeasurer {
             }
             // After do ellipsis, refresh layout
             desiredWidth = width;
-            sLayout = new StaticLayout(
+            layout = new StaticLayout(
                     span,
                     0,
                     span.length(),
@@ -199,15 +207,15 @@ public class LabelMeasurer {
                     false);
         }
 
-        Size measuredSize = new Size();
+        Size measuredSize = new LabelSize(layout);
 
         // Set measured size
         if (shouldBeSingleLine) {
-            measuredSize.mHeight = sLayout.getHeight() / sLayout.getLineCount();
+            measuredSize.mHeight = layout.getHeight() / layout.getLineCount();
         } else {
-            measuredSize.mHeight = sLayout.getHeight();
+            measuredSize.mHeight = layout.getHeight();
         }
-        measuredSize.mWidth = sLayout.getWidth();
+        measuredSize.mWidth = layout.getWidth();
         return measuredSize;
     }
 
@@ -215,8 +223,6 @@ public class LabelMeasurer {
     public static Size measureSpanLabelSize(String[] inlineTextList, Object[] inlineStyleList,
                                             Style outStyle, int width, int widthMode, int height,
                                             int heightMode) {
-        sLayout = null;
-
         TextPaint textPaint = newTextPaint(outStyle.mFontColor, outStyle.mFontSize);
         SpannableStringBuilder span =new SpannableStringBuilder();
         for (int i = 0; i < inlineStyleList.length; i++) {
@@ -24,6 +24,8 @@ public class LynxRuntime {
                                                       int zoomRatioPx,
                                                       String deviceInfo);
 
+    private static native void nativeSetLayoutWorkerCount(int count);
+
     private native int nativeCreateNativeJSRuntime();
 
     private native void nativeDestroyNativeJSRuntime(long runtime);
@@ -70,6 +72,15 @@ public class LynxRuntime {
                 DeviceInfoUtil.getInfo());
     }
 
+    /**
+     * Lays out independent subtrees, such as list cells, on {@code count}
+     * threads besides the JS thread, for runtimes initialized from now on.
+     * 0, the default, turns it off.
+     */
+    public static void setLayoutWorkerCount(int count) {
+        nativeSetLayoutWorkerCount(count);
+    }
+
     public void runScript(String source) {
         nativeRunScript(mNativeRuntime, source, null);
     }
@@ -1,6 +1,8 @@
 // Copyright 2017 The Lynx Authors. All rights reserved.
 
 #include "string_utils.h"
+#include <limits.h>
+
 namespace base {
 
     bool SplitString(const std::string& target, char separator, std::vector<std::string>& result) {
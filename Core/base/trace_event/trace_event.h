@@ -15,7 +15,9 @@ struct TraceEvent {
     begin_timestamp_(0),
     end_timestamp_(0),
     pid_(0),
-    tid_(static_cast<uint32_t>(base::Thread::CurrentId())) {
+    tid_(static_cast<uint32_t>(base::Thread::CurrentId())),
+    is_counter_(false),
+    value_(0) {
 
     }
   const char* name_;
@@ -24,6 +26,10 @@ struct TraceEvent {
   uint64_t end_timestamp_;
   uint32_t pid_;
   uint32_t tid_;
+  // A counter samples |value_| at |begin_timestamp_| instead of spanning
+  // a duration.
+  bool is_counter_;
+  int64_t value_;
 };
 }
 
@@ -25,6 +25,17 @@ class ScopedTracer {
  private:
   base::ScopedPtr<TraceEvent> event_;
 };
+
+inline void TraceCounter(const char* category, const char* name,
+                         int64_t value) {
+#if ENABLE_TRACING
+  TraceEvent* event = new TraceEvent(category, name);
+  event->begin_timestamp_ = CurrentTimeMicroseconds();
+  event->is_counter_ = true;
+  event->value_ = value;
+  TraceLogger::Instance()->AddTraceEvent(event);
+#endif
+}
 }  // namespace base
 
 #define INTERNAL_TRACE_EVENT_UID2(a, b) trace_event_uid_##a##b
@@ -34,4 +45,7 @@ class ScopedTracer {
   base::ScopedTracer INTERNAL_TRACE_EVENT_UID(tracer); \
   INTERNAL_TRACE_EVENT_UID(tracer).Initialize(category, name);
 
+#define TRACE_COUNTER1(category, name, value) \
+  base::TraceCounter(category, name, value);
+
 #endif
\ No newline at end of file
@@ -45,6 +45,36 @@ void TraceWriter::Write(TraceEvent* event) {
 
 std::string TraceWriter::Format(TraceEvent* event) {
   std::ostringstream formater;
+  if (event->is_counter_) {
+    formater << "{";
+    formater << "\"name\""
+             << ":" << "\"" << event->name_ << "\"";
+    formater << ",";
+
+    formater << "\"cat\""
+             << ":" << "\"" << event->category_ << "\"";
+    formater << ",";
+
+    formater << "\"ph\""
+             << ":"
+             << "\"C\"";
+    formater << ",";
+
+    formater << "\"pid\""
+             << ":" << event->pid_;
+    formater << ",";
+
+    formater << "\"ts\""
+             << ":" << event->begin_timestamp_;
+    formater << ",";
+
+    formater << "\"args\""
+             << ":" << "{\"value\":" << event->value_ << "}";
+
+    formater << "}";
+    formater << ",";
+    return formater.str();
+  }
   formater << "{";
   formater << "\"name\""
            << ":" << "\"" << event->name_ << "\"";
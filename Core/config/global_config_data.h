@@ -15,6 +15,7 @@ class GlobalConfigData {
             : screen_density_(0),
               screen_width_(0),
               screen_height_(0),
+              layout_worker_count_(0),
               style_config_(),
               cache_manager_() {
 
@@ -56,6 +57,17 @@ class GlobalConfigData {
         device_info_ = device_info;
     }
 
+    // Threads besides the JS thread that lay out independent subtrees of
+    // runtimes set up from now on. 0, the default, lays out on the JS
+    // thread only.
+    inline int layout_worker_count() {
+        return layout_worker_count_;
+    }
+
+    void set_layout_worker_count(int layout_worker_count) {
+        layout_worker_count_ = layout_worker_count;
+    }
+
     lynx::CSSStyleConfig* style_config() {
         return &style_config_;
     }
@@ -70,6 +82,7 @@ class GlobalConfigData {
     int screen_height_;
     int zoom_ratio_;
     std::string device_info_;
+    int layout_worker_count_;
 
     lynx::CSSStyleConfig style_config_;
 
@@ -30,6 +30,7 @@ namespace {
         int count = 0;
         lynx::RenderObject* renderer = findRenderer(root, id);
         Json::Value propertys(Json::arrayValue);
+#if ENABLE_INSPECTOR
         if(renderer && !renderer->styles().empty()) {
             for(auto iter = renderer->styles().begin();
                 iter != renderer->styles().end(); ++iter) {
@@ -39,6 +40,7 @@ namespace {
                 propertys[count++] = property;
             }
         }
+#endif
         return propertys;
     }
     
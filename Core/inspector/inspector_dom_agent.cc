@@ -50,6 +50,7 @@ namespace {
         }
         
         
+#if ENABLE_INSPECTOR
         if(!renderer->styles().empty()) {
             std::string styles;
             for(auto iter = renderer->styles().begin();
@@ -62,6 +63,7 @@ namespace {
             attriubtes[attr_count++] = "style";
             attriubtes[attr_count++] = styles;
         }
+#endif
 
         
         node["attributes"] = attriubtes;
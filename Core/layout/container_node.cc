@@ -12,13 +12,42 @@ Node* ContainerNode::Find(int index) {
         return nullptr;
     }
 
-    Node* node = first_child_;
-
-    while (index-- && node != nullptr) node = node->next_;
+    if (index >= child_count_) {
+        return nullptr;
+    }
 
+    Node* node;
+    if (index < child_count_ / 2) {
+        node = first_child_;
+        while (index--) node = node->next_;
+    } else {
+        node = last_child_;
+        for (int position = child_count_ - 1; position > index; --position) {
+            node = node->previous_;
+        }
+    }
     return node;
 }
 
+Node* ContainerNode::ChildCursor::Find(int index) {
+    if (node_ == nullptr || index < 0 ||
+        (index < index_ && index < index_ - index)) {
+        node_ = parent_->Find(index);
+        index_ = index;
+        return node_;
+    }
+
+    while (index_ < index && node_ != nullptr) {
+        node_ = node_->next_;
+        ++index_;
+    }
+    while (index_ > index) {
+        node_ = node_->previous_;
+        --index_;
+    }
+    return node_;
+}
+
 int ContainerNode::Find(Node* node) {
     int index = 0;
 
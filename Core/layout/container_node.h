@@ -23,9 +23,26 @@ class ContainerNode : public Node {
     Node* RemoveChild(int index);
     Node* FirstChild() { return first_child_; }
     Node* LastChild() { return last_child_; }
+    // Walks from the nearer end, so finding the last child costs O(1).
     Node* Find(int index);
     int Find(Node* node);
 
+    // Finds the children of one container by index for a single caller.
+    // Each step walks from the child found last, so visiting them in order
+    // costs O(1) per child. The children must not change while in use.
+    class ChildCursor {
+     public:
+        explicit ChildCursor(ContainerNode* parent)
+            : parent_(parent), node_(NULL), index_(0) {}
+
+        Node* Find(int index);
+
+     private:
+        ContainerNode* parent_;
+        Node* node_;
+        int index_;
+    };
+
     int GetChildCount() {return child_count_;}
     
     ContainerNode* parent() {
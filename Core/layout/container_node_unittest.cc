@@ -0,0 +1,60 @@
+// Copyright 2017 The Lynx Authors. All rights reserved.
+
+#include "layout/container_node.h"
+
+#include "gtest/gtest.h"
+
+namespace lynx {
+
+class ContainerNodeTest : public testing::Test {
+ protected:
+  static const int kChildCount = 7;
+
+  ContainerNodeTest() {
+    for (int i = 0; i < kChildCount; ++i) {
+      parent_.InsertChild(&children_[i], i);
+    }
+  }
+
+  ContainerNode parent_;
+  ContainerNode children_[kChildCount];
+};
+
+TEST_F(ContainerNodeTest, FindTest) {
+  for (int i = 0; i < kChildCount; ++i) {
+    EXPECT_EQ(&children_[i], parent_.Find(i));
+    EXPECT_EQ(i, parent_.Find(&children_[i]));
+  }
+  EXPECT_EQ(NULL, parent_.Find(-1));
+  EXPECT_EQ(NULL, parent_.Find(kChildCount));
+
+  parent_.RemoveChild(&children_[0]);
+  EXPECT_EQ(&children_[1], parent_.Find(0));
+  EXPECT_EQ(&children_[kChildCount - 1], parent_.Find(kChildCount - 2));
+  EXPECT_EQ(NULL, parent_.Find(kChildCount - 1));
+}
+
+TEST_F(ContainerNodeTest, ChildCursorTest) {
+  ContainerNode::ChildCursor cursor(&parent_);
+  for (int i = 0; i < kChildCount; ++i) {
+    EXPECT_EQ(&children_[i], cursor.Find(i));
+  }
+  // Lines of a wrapping container are walked again from their start.
+  EXPECT_EQ(&children_[4], cursor.Find(4));
+  EXPECT_EQ(&children_[5], cursor.Find(5));
+  EXPECT_EQ(&children_[1], cursor.Find(1));
+  EXPECT_EQ(&children_[6], cursor.Find(6));
+  EXPECT_EQ(NULL, cursor.Find(kChildCount));
+  EXPECT_EQ(&children_[3], cursor.Find(3));
+  EXPECT_EQ(NULL, cursor.Find(-1));
+  EXPECT_EQ(&children_[0], cursor.Find(0));
+}
+
+TEST_F(ContainerNodeTest, EmptyTest) {
+  ContainerNode empty;
+  ContainerNode::ChildCursor cursor(&empty);
+  EXPECT_EQ(NULL, empty.Find(0));
+  EXPECT_EQ(NULL, cursor.Find(0));
+  EXPECT_EQ(NULL, cursor.Find(1));
+}
+}  // namespace lynx
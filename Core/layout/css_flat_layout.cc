@@ -0,0 +1,1535 @@
+// Copyright 2017 The Lynx Authors. All rights reserved.
+
+#include "layout/css_flat_layout.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "layout/css_style.h"
+#include "layout/css_type.h"
+#include "layout/layout_object.h"
+
+namespace lynx {
+
+namespace {
+// Orders flex items as CompareFlexOrder does, so std::sort permutes them
+// the same way.
+class CompareFlexOrder {
+ public:
+  explicit CompareFlexOrder(const std::vector<double>& flex_order)
+      : flex_order_(flex_order) {}
+
+  bool operator()(int node1, int node2) const {
+    return flex_order_[node1] < flex_order_[node2];
+  }
+
+ private:
+  const std::vector<double>& flex_order_;
+};
+}  // namespace
+
+const int CSSFlatLayout::kMaxCachedMeasures = LayoutObject::kMaxCachedMeasures;
+
+CSSFlatLayout::CSSFlatLayout()
+    : display_none_(false), viewport_width_(0), viewport_height_(0) {}
+
+CSSFlatLayout::~CSSFlatLayout() {}
+
+void CSSFlatLayout::Build(LayoutObject* root) {
+  objects_.clear();
+  parent_.clear();
+  first_child_.clear();
+  child_count_.clear();
+  children_.clear();
+  width_.clear();
+  height_.clear();
+  min_width_.clear();
+  max_width_.clear();
+  min_height_.clear();
+  max_height_.clear();
+  margin_left_.clear();
+  margin_right_.clear();
+  margin_top_.clear();
+  margin_bottom_.clear();
+  padding_left_.clear();
+  padding_right_.clear();
+  padding_top_.clear();
+  padding_bottom_.clear();
+  border_width_.clear();
+  flex_.clear();
+  flex_order_.clear();
+  flex_direction_.clear();
+  flex_wrap_.clear();
+  flex_justify_content_.clear();
+  flex_align_items_.clear();
+  flex_align_self_.clear();
+  css_position_type_.clear();
+  css_display_type_.clear();
+  left_.clear();
+  right_.clear();
+  top_.clear();
+  bottom_.clear();
+
+  // Breadth first, so the children of each node get consecutive indices
+  // and children_ is just 1, 2, ... n - 1.
+  AddNode(root, -1);
+  for (int node = 0; node < node_count(); ++node) {
+    first_child_[node] = static_cast<int>(children_.size());
+    for (Node* child = objects_[node]->FirstChild(); child != NULL;
+         child = child->Next()) {
+      children_.push_back(AddNode(static_cast<LayoutObject*>(child), node));
+    }
+    child_count_[node] = static_cast<int>(children_.size()) - first_child_[node];
+  }
+
+  int count = node_count();
+  measured_size_.assign(count, base::Size());
+  measured_position_.assign(count, base::Position());
+  laid_out_.assign(count, 0);
+  last_width_descriptor_.assign(count, 0);
+  last_height_descriptor_.assign(count, 0);
+  on_measure_width_descriptor_.assign(count, 0);
+  on_measure_height_descriptor_.assign(count, 0);
+  measure_cache_.resize(count * kMaxCachedMeasures);
+  measure_cache_size_.assign(count, 0);
+  measure_cache_next_.assign(count, 0);
+}
+
+int CSSFlatLayout::AddNode(LayoutObject* object, int parent) {
+  const CSSStyle& style = object->css_style();
+  objects_.push_back(object);
+  parent_.push_back(parent);
+  first_child_.push_back(0);
+  child_count_.push_back(0);
+  width_.push_back(style.width_);
+  height_.push_back(style.height_);
+  min_width_.push_back(style.min_width_);
+  max_width_.push_back(style.max_width_);
+  min_height_.push_back(style.min_height_);
+  max_height_.push_back(style.max_height_);
+  margin_left_.push_back(style.margin_left_);
+  margin_right_.push_back(style.margin_right_);
+  margin_top_.push_back(style.margin_top_);
+  margin_bottom_.push_back(style.margin_bottom_);
+  padding_left_.push_back(style.padding_left_);
+  padding_right_.push_back(style.padding_right_);
+  padding_top_.push_back(style.padding_top_);
+  padding_bottom_.push_back(style.padding_bottom_);
+  border_width_.push_back(style.border_width_);
+  flex_.push_back(style.flex_);
+  flex_order_.push_back(style.flex_order_);
+  flex_direction_.push_back(style.flex_direction_);
+  flex_wrap_.push_back(style.flex_wrap_);
+  flex_justify_content_.push_back(style.flex_justify_content_);
+  flex_align_items_.push_back(style.flex_align_items_);
+  flex_align_self_.push_back(style.flex_align_self_);
+  css_position_type_.push_back(style.css_position_type_);
+  css_display_type_.push_back(style.css_display_type_);
+  left_.push_back(style.left_);
+  right_.push_back(style.right_);
+  top_.push_back(style.top_);
+  bottom_.push_back(style.bottom_);
+  return static_cast<int>(objects_.size()) - 1;
+}
+
+void CSSFlatLayout::Layout(int left, int top, int right, int bottom) {
+  if (objects_.empty()) {
+    return;
+  }
+  // Everything is measured and laid out again, as on a dirty tree.
+  std::fill(measured_size_.begin(), measured_size_.end(), base::Size());
+  std::fill(laid_out_.begin(), laid_out_.end(), 0);
+  std::fill(measure_cache_size_.begin(), measure_cache_size_.end(), 0);
+  std::fill(measure_cache_next_.begin(), measure_cache_next_.end(), 0);
+  items_.clear();
+  display_none_ = false;
+
+  Measure(0, right - left, bottom - top);
+  LayoutNode(0, left, top, right, bottom);
+}
+
+void CSSFlatLayout::WriteBack() {
+  for (int node = 0; node < node_count(); ++node) {
+    LayoutObject* object = objects_[node];
+    int cache_size = measure_cache_size_[node];
+    if (cache_size != 0) {
+      object->measured_size_ = measured_size_[node];
+      const MeasureCacheEntry* cache =
+          &measure_cache_[node * kMaxCachedMeasures];
+      for (int i = 0; i < cache_size; ++i) {
+        LayoutObject::MeasureCacheEntry& entry = object->measure_cache_[i];
+        entry.width_descriptor_ = cache[i].width_descriptor_;
+        entry.height_descriptor_ = cache[i].height_descriptor_;
+        entry.size_ = cache[i].size_;
+      }
+      object->measure_cache_size_ = cache_size;
+      object->measure_cache_next_ = measure_cache_next_[node];
+      object->last_width_descriptor_ = last_width_descriptor_[node];
+      object->last_height_descriptor_ = last_height_descriptor_[node];
+      object->on_measure_width_descriptor_ = on_measure_width_descriptor_[node];
+      object->on_measure_height_descriptor_ =
+          on_measure_height_descriptor_[node];
+      object->relayout_root_ = false;
+    }
+    if (laid_out_[node]) {
+      const base::Position& position = measured_position_[node];
+      object->measured_position_.Reset(position);
+      LayoutObject* parent = static_cast<LayoutObject*>(object->parent());
+      object->offset_top_ =
+          position.top_ -
+          (parent == NULL ? 0 : parent->css_style_->border_width_);
+      object->offset_left_ =
+          position.left_ -
+          (parent == NULL ? 0 : parent->css_style_->border_width_);
+      object->offset_height_ = position.bottom_ - position.top_;
+      object->offset_width_ = position.right_ - position.left_;
+      object->UpToDate();
+    }
+  }
+}
+
+double CSSFlatLayout::ClampWidthInner(int node, double width) const {
+  if (width < min_width_[node])
+    width = min_width_[node];
+  if (width > max_width_[node])
+    width = max_width_[node];
+
+  double extra =
+      padding_left_[node] + padding_right_[node] + border_width_[node] * 2;
+  width = extra > width ? extra : width;
+
+  return width;
+}
+
+double CSSFlatLayout::ClampHeightInner(int node, double height) const {
+  if (height < min_height_[node])
+    height = min_height_[node];
+  if (height > max_height_[node])
+    height = max_height_[node];
+
+  double extra =
+      padding_top_[node] + padding_bottom_[node] + border_width_[node] * 2;
+  height = extra > height ? extra : height;
+
+  return height;
+}
+
+double CSSFlatLayout::ClampWidth(int node) const {
+  if (CSS_IS_UNDEFINED(width_[node]))
+    return width_[node];
+  return ClampWidthInner(node, width_[node]);
+}
+
+double CSSFlatLayout::ClampHeight(int node) const {
+  if (CSS_IS_UNDEFINED(height_[node]))
+    return height_[node];
+  return ClampHeightInner(node, height_[node]);
+}
+
+double CSSFlatLayout::ClampWidth(int node, double width) const {
+  if (!CSS_IS_UNDEFINED(width_[node])) {
+    width = width_[node];
+  }
+  if (CSS_IS_UNDEFINED(width)) {
+    width = 0;
+  }
+  return ClampWidthInner(node, width);
+}
+
+double CSSFlatLayout::ClampHeight(int node, double height) const {
+  if (!CSS_IS_UNDEFINED(height_[node])) {
+    height = height_[node];
+  }
+  if (CSS_IS_UNDEFINED(height)) {
+    height = 0;
+  }
+  return ClampHeightInner(node, height);
+}
+
+double CSSFlatLayout::ClampExactWidth(int node, double width) const {
+  if (CSS_IS_UNDEFINED(width)) {
+    width = 0;
+  }
+  return ClampWidthInner(node, width);
+}
+
+double CSSFlatLayout::ClampExactHeight(int node, double height) const {
+  if (CSS_IS_UNDEFINED(height)) {
+    height = 0;
+  }
+  return ClampHeightInner(node, height);
+}
+
+base::Size CSSFlatLayout::Measure(int node,
+                                  int width_descriptor,
+                                  int height_descriptor) {
+  last_width_descriptor_[node] = width_descriptor;
+  last_height_descriptor_[node] = height_descriptor;
+  MeasureCacheEntry* cache = &measure_cache_[node * kMaxCachedMeasures];
+  for (int i = 0; i < measure_cache_size_[node]; ++i) {
+    if (cache[i].width_descriptor_ == width_descriptor &&
+        cache[i].height_descriptor_ == height_descriptor) {
+      measured_size_[node] = cache[i].size_;
+      return cache[i].size_;
+    }
+  }
+
+  base::Size size = OnMeasure(node, width_descriptor, height_descriptor);
+  measured_size_[node] = size;
+  MeasureCacheEntry& entry = cache[measure_cache_next_[node]];
+  entry.width_descriptor_ = width_descriptor;
+  entry.height_descriptor_ = height_descriptor;
+  entry.size_ = size;
+  on_measure_width_descriptor_[node] = width_descriptor;
+  on_measure_height_descriptor_[node] = height_descriptor;
+  measure_cache_next_[node] =
+      (measure_cache_next_[node] + 1) % kMaxCachedMeasures;
+  if (measure_cache_size_[node] < kMaxCachedMeasures) {
+    ++measure_cache_size_[node];
+  }
+  return size;
+}
+
+bool CSSFlatLayout::MeasureForLayout(int node) {
+  if (measure_cache_size_[node] == 0) {
+    return false;
+  }
+  int width_descriptor = last_width_descriptor_[node];
+  int height_descriptor = last_height_descriptor_[node];
+  if (width_descriptor == on_measure_width_descriptor_[node] &&
+      height_descriptor == on_measure_height_descriptor_[node]) {
+    return false;
+  }
+  measured_size_[node] = OnMeasure(node, width_descriptor, height_descriptor);
+  on_measure_width_descriptor_[node] = width_descriptor;
+  on_measure_height_descriptor_[node] = height_descriptor;
+  return true;
+}
+
+void CSSFlatLayout::LayoutNode(int node,
+                               int left,
+                               int top,
+                               int right,
+                               int bottom) {
+  bool remeasured = MeasureForLayout(node);
+  if (measured_position_[node].Reset(left, top, right, bottom) ||
+      !laid_out_[node] || remeasured) {
+    laid_out_[node] = 1;
+    OnLayout(node, right - left, bottom - top);
+  }
+}
+
+base::Size CSSFlatLayout::OnMeasure(int node,
+                                    int width_descriptor,
+                                    int height_descriptor) {
+  int width_mode = base::Size::Descriptor::GetMode(width_descriptor);
+  int height_mode = base::Size::Descriptor::GetMode(height_descriptor);
+
+  int measured_width_mode = width_mode;
+  int measured_height_mode = height_mode;
+  if (!CSS_IS_UNDEFINED(width_[node]) || !CSS_IS_UNDEFINED(max_width_[node])) {
+    measured_width_mode = base::Size::Descriptor::EXACTLY;
+  }
+  if (!CSS_IS_UNDEFINED(height_[node]) ||
+      !CSS_IS_UNDEFINED(max_height_[node])) {
+    measured_height_mode = base::Size::Descriptor::EXACTLY;
+  }
+
+  int measured_width = base::Size::Descriptor::GetSize(width_descriptor);
+  int measured_height = base::Size::Descriptor::GetSize(height_descriptor);
+  if (measured_width_mode != base::Size::Descriptor::UNSPECIFIED) {
+    measured_width =
+        ClampWidth(node, base::Size::Descriptor::GetSize(width_descriptor));
+  }
+  if (measured_height_mode != base::Size::Descriptor::UNSPECIFIED) {
+    measured_height =
+        ClampHeight(node, base::Size::Descriptor::GetSize(height_descriptor));
+  }
+
+  base::Size size = MeasureInner(node, measured_width, measured_width_mode,
+                                 measured_height, measured_height_mode);
+
+  int w = !CSS_IS_UNDEFINED(width_descriptor) &&
+                  width_mode == base::Size::Descriptor::EXACTLY
+              ? ClampExactWidth(
+                    node, base::Size::Descriptor::GetSize(width_descriptor))
+              : ClampWidth(node, size.width_);
+  int h = !CSS_IS_UNDEFINED(height_descriptor) &&
+                  height_mode == base::Size::Descriptor::EXACTLY
+              ? ClampExactHeight(
+                    node, base::Size::Descriptor::GetSize(height_descriptor))
+              : ClampHeight(node, size.height_);
+
+  size.Update(w, h);
+  return size;
+}
+
+base::Size CSSFlatLayout::MeasureInner(int node,
+                                       int width,
+                                       int width_mode,
+                                       int height,
+                                       int height_mode) {
+  base::Size measured_size;
+
+  int available_width = width - padding_left_[node] - padding_right_[node] -
+                        border_width_[node] * 2;
+  int available_height = height - padding_top_[node] -
+                         padding_bottom_[node] - border_width_[node] * 2;
+
+  int count = child_count_[node];
+  if (flex_direction_[node] == CSSFLEX_DIRECTION_ROW ||
+      flex_direction_[node] == CSSFLEX_DIRECTION_ROW_REVERSE) {
+    measured_size =
+        flex_wrap_[node] != CSSFLEX_WRAP
+            ? MeasureRowOneLine(node, available_width, width_mode,
+                                available_height, height_mode, 0, count - 1)
+            : MeasureRowWrap(node, available_width, width_mode,
+                             available_height, height_mode);
+  } else {
+    measured_size =
+        flex_wrap_[node] != CSSFLEX_WRAP
+            ? MeasureColumnOneLine(node, available_width, width_mode,
+                                   available_height, height_mode, 0, count - 1)
+            : MeasureColumnWrap(node, available_width, width_mode,
+                                available_height, height_mode);
+  }
+
+  int w = measured_size.width_ + padding_left_[node] + padding_right_[node] +
+          border_width_[node] * 2;
+  int h = measured_size.height_ + padding_top_[node] + padding_bottom_[node] +
+          border_width_[node] * 2;
+
+  measured_size.Update(w, h);
+  return measured_size;
+}
+
+bool CSSFlatLayout::MeasureSpecially(int node,
+                                     int width,
+                                     int width_mode,
+                                     int height,
+                                     int height_mode) {
+  if (css_display_type_[node] != CSS_DISPLAY_FLEX) {
+    Measure(node, 0, 0);
+    return true;
+  }
+  if (css_position_type_[node] == CSS_POSITION_ABSOLUTE) {
+    MeasureAbsolute(node, width, height);
+    return true;
+  }
+  if (css_position_type_[node] == CSS_POSITION_FIXED) {
+    MeasureFixed(node);
+    return true;
+  }
+  return false;
+}
+
+base::Size CSSFlatLayout::MeasureRowItem(int node, int width, int height) {
+  int measure_width;
+  if (!CSS_IS_UNDEFINED(width_[node])) {
+    measure_width = base::Size::Descriptor::Make(
+        ClampWidth(node), base::Size::Descriptor::AT_MOST);
+  } else {
+    measure_width = base::Size::Descriptor::Make(
+        width - margin_left_[node] - margin_right_[node],
+        base::Size::Descriptor::UNSPECIFIED);
+  }
+  return Measure(node, measure_width,
+                 base::Size::Descriptor::Make(
+                     height - margin_top_[node] - margin_bottom_[node],
+                     base::Size::Descriptor::AT_MOST));
+}
+
+base::Size CSSFlatLayout::MeasureColumnItem(int node, int width, int height) {
+  int measure_height;
+  if (!CSS_IS_UNDEFINED(height_[node])) {
+    measure_height = base::Size::Descriptor::Make(
+        ClampHeight(node), base::Size::Descriptor::AT_MOST);
+  } else {
+    measure_height = base::Size::Descriptor::Make(
+        height - margin_top_[node] - margin_bottom_[node],
+        base::Size::Descriptor::UNSPECIFIED);
+  }
+  return Measure(node,
+                 base::Size::Descriptor::Make(
+                     width - margin_right_[node] - margin_left_[node],
+                     base::Size::Descriptor::AT_MOST),
+                 measure_height);
+}
+
+base::Size CSSFlatLayout::MeasureRowOneLine(int node,
+                                            int width,
+                                            int width_mode,
+                                            int height,
+                                            int height_mode,
+                                            int start,
+                                            int end) {
+  base::Size measured_size(0, 0);
+  int calc_width = 0;
+  int calc_height = 0;
+
+  float total_flex = 0;
+  float residual_width = width;
+
+  for (int i = start; i <= end; i++) {
+    int child = Child(node, i);
+
+    if (MeasureSpecially(child, width, width_mode, height, height_mode)) {
+      continue;
+    }
+
+    if (flex_[child] > 0) {
+      total_flex += flex_[child];
+      calc_width += margin_left_[child] + margin_right_[child];
+      continue;
+    }
+
+    base::Size child_size = MeasureRowItem(child, residual_width, height);
+
+    calc_width +=
+        child_size.width_ + margin_left_[child] + margin_right_[child];
+    calc_height = child_size.height_;
+
+    int child_item_height =
+        calc_height + margin_bottom_[child] + margin_top_[child];
+    measured_size.height_ = measured_size.height_ > child_item_height
+                                ? measured_size.height_
+                                : child_item_height;
+  }
+
+  if ((calc_width == 0 && total_flex > 0) ||
+      (CSS_IS_UNDEFINED(width_[node]) && CSS_IS_UNDEFINED(max_width_[node]) &&
+       min_width_[node] == 0)) {
+    residual_width = ClampWidth(node, width);
+    if (residual_width != width) {
+      residual_width = residual_width - padding_right_[node] -
+                       padding_left_[node] - 2 * border_width_[node];
+    }
+    residual_width -= calc_width;
+  } else {
+    residual_width = ClampWidth(node, calc_width) - padding_right_[node] -
+                     padding_left_[node] - 2 * border_width_[node] -
+                     calc_width;
+  }
+
+  if (residual_width < 0)
+    residual_width = 0;
+
+  for (int i = start; i <= end; i++) {
+    int child = Child(node, i);
+
+    if (css_display_type_[child] != CSS_DISPLAY_FLEX) {
+      continue;
+    }
+    if (css_position_type_[child] == CSS_POSITION_ABSOLUTE ||
+        css_position_type_[child] == CSS_POSITION_FIXED) {
+      continue;
+    }
+
+    if (flex_[child] <= 0)
+      continue;
+
+    int recalc_width = round(residual_width * flex_[child] / total_flex);
+
+    int measure_width =
+        recalc_width == 0
+            ? base::Size::Descriptor::Make(width,
+                                           base::Size::Descriptor::AT_MOST)
+            : width_mode == base::Size::Descriptor::UNSPECIFIED
+                  ? base::Size::Descriptor::Make(
+                        recalc_width, base::Size::Descriptor::AT_MOST)
+                  : base::Size::Descriptor::Make(
+                        recalc_width, base::Size::Descriptor::EXACTLY);
+
+    base::Size child_size = Measure(
+        child, measure_width,
+        base::Size::Descriptor::Make(height, base::Size::Descriptor::AT_MOST));
+
+    calc_width += child_size.width_;
+    calc_height = child_size.height_;
+
+    int child_item_height =
+        calc_height + margin_bottom_[child] + margin_top_[child];
+    measured_size.height_ = measured_size.height_ > child_item_height
+                                ? measured_size.height_
+                                : child_item_height;
+    residual_width -= child_size.width_;
+    total_flex -= flex_[child];
+  }
+  measured_size.width_ = calc_width;
+  return measured_size;
+}
+
+base::Size CSSFlatLayout::MeasureRowWrap(int node,
+                                         int width,
+                                         int width_mode,
+                                         int height,
+                                         int height_mode) {
+  int current_calc_width = 0;
+  int calc_width = 0;
+  int calc_height = 0;
+  int start = 0;
+
+  base::Size measured_size(width_[node], height_[node]);
+
+  for (int index = 0, child_view_count = child_count_[node];
+       index < child_view_count;) {
+    int child = Child(node, index);
+
+    if (MeasureSpecially(child, width, width_mode, height, height_mode)) {
+      index++;
+      continue;
+    }
+
+    base::Size child_size(0, 0);
+    if (flex_[child] == 0) {
+      child_size = MeasureRowItem(child, width, height);
+    }
+
+    current_calc_width = current_calc_width + child_size.width_ +
+                         margin_left_[child] + margin_right_[child];
+    if (current_calc_width <= width) {
+      calc_width = current_calc_width;
+      if (index == child_view_count - 1) {
+        base::Size row_size = MeasureRowOneLine(
+            node, width, width_mode, height, height_mode, start, index);
+        calc_width =
+            row_size.width_ > calc_width ? row_size.width_ : calc_width;
+        calc_height += row_size.height_;
+      }
+      index++;
+    } else {
+      int end = index;
+      if (start != index) {
+        end -= 1;
+      }
+
+      base::Size row_size = MeasureRowOneLine(node, width, width_mode, height,
+                                              height_mode, start, end);
+
+      calc_width = row_size.width_ > calc_width ? row_size.width_ : calc_width;
+      calc_height += row_size.height_;
+      if (start == index) {
+        index += 1;
+      }
+      start = index;
+      current_calc_width = 0;
+    }
+  }
+  measured_size.width_ = calc_width;
+  measured_size.height_ = calc_height;
+  return measured_size;
+}
+
+base::Size CSSFlatLayout::MeasureColumnOneLine(int node,
+                                               int width,
+                                               int width_mode,
+                                               int height,
+                                               int height_mode,
+                                               int start,
+                                               int end) {
+  base::Size measured_size(0, 0);
+  int calc_width = 0;
+  int calc_height = 0;
+
+  float total_flex = 0;
+  float residual_height = height;
+
+  for (int i = start; i <= end; i++) {
+    int child = Child(node, i);
+
+    if (MeasureSpecially(child, width, width_mode, height, height_mode)) {
+      continue;
+    }
+
+    if (flex_[child] > 0) {
+      total_flex += flex_[child];
+      calc_height += margin_top_[child] + margin_bottom_[child];
+      continue;
+    }
+
+    base::Size child_size = MeasureColumnItem(child, width, residual_height);
+
+    calc_width = child_size.width_;
+    calc_height +=
+        child_size.height_ + margin_top_[child] + margin_bottom_[child];
+
+    int child_item_width =
+        calc_width + margin_left_[child] + margin_right_[child];
+    measured_size.width_ = measured_size.width_ > child_item_width
+                               ? measured_size.width_
+                               : child_item_width;
+  }
+
+  if ((calc_height == 0 && total_flex > 0) ||
+      (CSS_IS_UNDEFINED(height_[node]) &&
+       CSS_IS_UNDEFINED(max_height_[node]) && min_height_[node] == 0)) {
+    residual_height = ClampHeight(node, height);
+    if (residual_height != height) {
+      residual_height = residual_height - padding_top_[node] -
+                        padding_bottom_[node] - 2 * border_width_[node];
+    }
+    residual_height -= calc_height;
+  } else {
+    residual_height = ClampHeight(node, calc_height) - padding_top_[node] -
+                      padding_bottom_[node] - 2 * border_width_[node] -
+                      calc_height;
+  }
+
+  if (residual_height < 0)
+    residual_height = 0;
+
+  for (int i = start; i <= end; i++) {
+    int child = Child(node, i);
+
+    if (css_display_type_[child] != CSS_DISPLAY_FLEX) {
+      continue;
+    }
+    if (css_position_type_[child] == CSS_POSITION_ABSOLUTE ||
+        css_position_type_[child] == CSS_POSITION_FIXED) {
+      continue;
+    }
+
+    if (flex_[child] <= 0)
+      continue;
+
+    int recalc_height = round(residual_height * flex_[child] / total_flex);
+
+    int measure_height =
+        recalc_height == 0
+            ? base::Size::Descriptor::Make(height,
+                                           base::Size::Descriptor::AT_MOST)
+            : height_mode == base::Size::Descriptor::UNSPECIFIED
+                  ? base::Size::Descriptor::Make(
+                        recalc_height, base::Size::Descriptor::AT_MOST)
+                  : base::Size::Descriptor::Make(
+                        recalc_height, base::Size::Descriptor::EXACTLY);
+
+    base::Size child_size = Measure(
+        child,
+        base::Size::Descriptor::Make(width, base::Size::Descriptor::AT_MOST),
+        measure_height);
+
+    calc_width = child_size.width_;
+    calc_height += child_size.height_;
+
+    int child_item_width =
+        calc_width + margin_left_[child] + margin_right_[child];
+    measured_size.width_ = measured_size.width_ > child_item_width
+                               ? measured_size.width_
+                               : child_item_width;
+    residual_height -= child_size.height_;
+    total_flex -= flex_[child];
+  }
+  measured_size.height_ = calc_height;
+  return measured_size;
+}
+
+base::Size CSSFlatLayout::MeasureColumnWrap(int node,
+                                            int width,
+                                            int width_mode,
+                                            int height,
+                                            int height_mode) {
+  int current_calc_height = 0;
+  int calc_width = 0;
+  int calc_height = 0;
+  int start = 0;
+
+  base::Size measured_size(width_[node], height_[node]);
+
+  for (int index = 0, child_view_count = child_count_[node];
+       index < child_view_count;) {
+    int child = Child(node, index);
+
+    if (MeasureSpecially(child, width, width_mode, height, height_mode)) {
+      index++;
+      continue;
+    }
+
+    base::Size child_size(0, 0);
+    if (flex_[child] == 0) {
+      child_size = MeasureColumnItem(child, width, height);
+    }
+
+    current_calc_height = current_calc_height + child_size.height_ +
+                          margin_top_[child] + margin_bottom_[child];
+    if (current_calc_height <= height) {
+      calc_height = current_calc_height;
+      if (index == child_view_count - 1) {
+        base::Size column_size = MeasureColumnOneLine(
+            node, width, width_mode, height, height_mode, start, index);
+
+        calc_width += column_size.width_;
+        calc_height = column_size.height_ > calc_height ? column_size.height_
+                                                        : calc_height;
+      }
+      index++;
+    } else {
+      int end = index;
+      if (start != index) {
+        end -= 1;
+      }
+
+      base::Size column_size = MeasureColumnOneLine(
+          node, width, width_mode, height, height_mode, start, end);
+
+      calc_width += column_size.width_;
+      calc_height =
+          column_size.height_ > calc_height ? column_size.height_ : calc_height;
+
+      if (start == index) {
+        index += 1;
+      }
+      start = index;
+    }
+  }
+  measured_size.width_ = calc_width;
+  measured_size.height_ = calc_height;
+  return measured_size;
+}
+
+void CSSFlatLayout::MeasureAbsolute(int node, int width, int height) {
+  int w = CSS_IS_UNDEFINED(width_[node]) ? width : width_[node];
+  int h = CSS_IS_UNDEFINED(height_[node]) ? height : height_[node];
+
+  w -= CSS_IS_UNDEFINED(right_[node]) ? 0 : right_[node];
+  w -= CSS_IS_UNDEFINED(left_[node]) ? 0 : left_[node];
+  h -= CSS_IS_UNDEFINED(top_[node]) ? 0 : top_[node];
+  h -= CSS_IS_UNDEFINED(bottom_[node]) ? 0 : bottom_[node];
+
+  w -= margin_left_[node] + margin_right_[node];
+  h -= margin_top_[node] + margin_bottom_[node];
+
+  Measure(node,
+          base::Size::Descriptor::Make(w, base::Size::Descriptor::AT_MOST),
+          base::Size::Descriptor::Make(h, base::Size::Descriptor::AT_MOST));
+}
+
+void CSSFlatLayout::MeasureFixed(int node) {
+  // Measured against the viewport, inside the padding of the root.
+  int available_width = viewport_width_ - border_width_[0] * 2 -
+                        padding_right_[0] - padding_left_[0];
+  int available_height = viewport_height_ - border_width_[0] * 2 -
+                         padding_top_[0] - padding_bottom_[0];
+  MeasureAbsolute(node, available_width, available_height);
+}
+
+void CSSFlatLayout::OnLayout(int node, int width, int height) {
+  if (display_none_) {
+    LayoutWhenDisplayNone(node);
+  } else if (css_display_type_[node] != CSS_DISPLAY_FLEX) {
+    display_none_ = true;
+    LayoutWhenDisplayNone(node);
+    display_none_ = false;
+  } else if (flex_direction_[node] == CSSFLEX_DIRECTION_ROW ||
+             flex_direction_[node] == CSSFLEX_DIRECTION_ROW_REVERSE) {
+    if (flex_wrap_[node] == CSSFLEX_NOWRAP) {
+      LayoutRowOneLine(node, width, height);
+    } else if (flex_wrap_[node] == CSSFLEX_WRAP ||
+               flex_wrap_[node] == CSSFLEX_WRAP_REVERSE) {
+      LayoutRowWrap(node, width, height);
+    }
+  } else if (flex_direction_[node] == CSSFLEX_DIRECTION_COLUMN ||
+             flex_direction_[node] == CSSFLEX_DIRECTION_COLUMN_REVERSE) {
+    if (flex_wrap_[node] == CSSFLEX_NOWRAP) {
+      LayoutColumnOneLine(node, width, height);
+    } else if (flex_wrap_[node] == CSSFLEX_WRAP ||
+               flex_wrap_[node] == CSSFLEX_WRAP_REVERSE) {
+      LayoutColumnWrap(node, width, height);
+    }
+  }
+}
+
+void CSSFlatLayout::LayoutWhenDisplayNone(int node) {
+  for (int i = 0; i < child_count_[node]; i++) {
+    LayoutNode(Child(node, i), 0, 0, 0, 0);
+  }
+}
+
+int CSSFlatLayout::CollectFlexItems(int node, int width, int height) {
+  int begin = static_cast<int>(items_.size());
+  for (int i = 0; i < child_count_[node]; i++) {
+    int child = Child(node, i);
+    if (css_display_type_[child] != CSS_DISPLAY_FLEX) {
+      LayoutNode(child, 0, 0, 0, 0);
+      continue;
+    }
+    if (css_position_type_[child] == CSS_POSITION_ABSOLUTE) {
+      LayoutFixedOrAbsolute(node, child, width, height);
+      continue;
+    }
+    if (css_position_type_[child] == CSS_POSITION_FIXED) {
+      LayoutFixedOrAbsolute(node, child, viewport_width_, viewport_height_);
+      continue;
+    }
+    items_.push_back(child);
+  }
+  std::sort(items_.begin() + begin, items_.end(), CompareFlexOrder(flex_order_));
+  return begin;
+}
+
+void CSSFlatLayout::LayoutRowWrap(int node, int width, int height) {
+  int available_width = width - padding_left_[node] - padding_right_[node] -
+                        border_width_[node] * 2;
+  int available_height = height - padding_top_[node] - padding_bottom_[node] -
+                         border_width_[node] * 2;
+
+  int current_row_without_absolute_count = 0;
+  int total_use_width_without_absolute = 0;
+
+  bool rflag = flex_direction_[node] == CSSFLEX_DIRECTION_ROW_REVERSE;
+  bool wrflag = flex_wrap_[node] == CSSFLEX_WRAP_REVERSE;
+  int justify_content = flex_justify_content_[node];
+
+  int total_used_height = 0;
+  int current_line_height = 0;
+  bool is_line_feed = false;
+
+  int begin = CollectFlexItems(node, width, height);
+  int start = begin;
+
+  for (int index = begin, child_view_count = items_.size();
+       index < child_view_count; index++) {
+    int child = items_[index];
+
+    int old_total_use_width_without_absolute = total_use_width_without_absolute;
+
+    current_row_without_absolute_count++;
+
+    total_use_width_without_absolute += measured_size_[child].width_ +
+                                        margin_left_[child] +
+                                        margin_right_[child];
+
+    if (total_use_width_without_absolute <= available_width) {
+      int child_height = measured_size_[child].height_ + margin_top_[child] +
+                         margin_bottom_[child];
+      current_line_height = current_line_height > child_height
+                                ? current_line_height
+                                : child_height;
+    }
+
+    bool is_last_view = (index == child_view_count - 1);
+
+    if (total_use_width_without_absolute > available_width || is_last_view) {
+      if (total_use_width_without_absolute > available_width &&
+          current_row_without_absolute_count > 1) {
+        is_line_feed = true;
+        index--;
+        current_row_without_absolute_count--;
+        total_use_width_without_absolute =
+            old_total_use_width_without_absolute;
+      } else if (is_last_view && !is_line_feed) {
+        current_line_height = available_height;
+      }
+
+      int adjust_width_start = 0;
+      int adjust_width_interval = 0;
+      if (current_row_without_absolute_count > 0) {
+        if (justify_content == CSSFLEX_JUSTIFY_FLEX_START && rflag) {
+          adjust_width_start =
+              available_width - total_use_width_without_absolute;
+        } else if (justify_content == CSSFLEX_JUSTIFY_FLEX_END && !rflag) {
+          adjust_width_start =
+              available_width - total_use_width_without_absolute;
+        } else if (justify_content == CSSFLEX_JUSTIFY_FLEX_CENTER) {
+          adjust_width_start = round(
+              (float)(available_width - total_use_width_without_absolute) /
+              2.0f);
+        } else if (total_use_width_without_absolute <= available_width &&
+                   justify_content == CSSFLEX_JUSTIFY_SPACE_BETWEEN) {
+          if (current_row_without_absolute_count > 1) {
+            adjust_width_interval = round(
+                ((float)(available_width - total_use_width_without_absolute)) /
+                (current_row_without_absolute_count - 1));
+          }
+        } else if (total_use_width_without_absolute <= available_width &&
+                   justify_content == CSSFLEX_JUSTIFY_SPACE_AROUND) {
+          float interval =
+              ((float)(available_width - total_use_width_without_absolute)) /
+              (current_row_without_absolute_count * 2);
+          adjust_width_start = round(interval);
+          adjust_width_interval = round(interval * 2);
+        }
+      }
+
+      int max_height = 0;
+      int child_origin_x =
+          padding_left_[node] + border_width_[node] + adjust_width_start;
+      int child_origin_y =
+          padding_top_[node] + border_width_[node] +
+          (!wrflag ? total_used_height : available_height - total_used_height);
+
+      if (rflag)
+        std::reverse(items_.begin() + start, items_.begin() + index + 1);
+      for (int i = start; i <= index; i++) {
+        int item = items_[i];
+
+        int align = flex_align_items_[node];
+        if (flex_align_self_[item] != CSSFLEX_ALIGN_AUTO) {
+          align = flex_align_self_[item];
+        }
+
+        int old_child_origin_y = child_origin_y;
+
+        child_origin_x += margin_left_[item];
+        child_origin_y += (!wrflag ? margin_top_[item] : -margin_bottom_[item]);
+        if (i > start)
+          child_origin_x += adjust_width_interval;
+
+        int adjust_y = 0;
+        int adjust_height = CSS_UNDEFINED;
+        if (align == CSSFLEX_ALIGN_FLEX_START) {
+          // do nothing
+        } else if (align == CSSFLEX_ALIGN_FLEX_END) {
+          adjust_y = current_line_height - margin_bottom_[item] -
+                     measured_size_[item].height_;
+        } else if (align == CSSFLEX_ALIGN_STRETCH) {
+          adjust_height =
+              current_line_height - margin_top_[item] - margin_bottom_[item];
+          adjust_height = ClampHeight(item, adjust_height);
+        } else if (align == CSSFLEX_ALIGN_CENTER) {
+          adjust_y = round(
+              (float)(current_line_height - measured_size_[item].height_) /
+              2.0f);
+        }
+
+        int l = child_origin_x;
+        int r = l + measured_size_[item].width_;
+        int t = 0, b = 0;
+        if (!wrflag) {
+          t = child_origin_y + adjust_y;
+          b = CSS_IS_UNDEFINED(adjust_height)
+                  ? t + measured_size_[item].height_
+                  : t + adjust_height;
+        } else {
+          b = child_origin_y - adjust_y;
+          t = CSS_IS_UNDEFINED(adjust_height)
+                  ? b - measured_size_[item].height_
+                  : b - adjust_height;
+        }
+
+        LayoutNode(item, l, t, r, b);
+
+        child_origin_x += measured_size_[item].width_ + margin_right_[item];
+        child_origin_y = old_child_origin_y;
+        int child_item_height =
+            (b - t) + margin_bottom_[item] + margin_top_[item];
+        max_height =
+            max_height < child_item_height ? child_item_height : max_height;
+      }
+      start = index + 1;
+      total_use_width_without_absolute =
+          padding_left_[node] + padding_right_[node];
+      current_row_without_absolute_count = 0;
+      total_used_height += max_height;
+      current_line_height = 0;
+    }
+  }
+  items_.resize(begin);
+}
+
+void CSSFlatLayout::LayoutRowOneLine(int node, int width, int height) {
+  int available_width = width - padding_left_[node] - padding_right_[node] -
+                        border_width_[node] * 2;
+  int available_height = height - padding_top_[node] - padding_bottom_[node] -
+                         border_width_[node] * 2;
+
+  int begin = CollectFlexItems(node, width, height);
+  int end = items_.size();
+  int current_row_without_absolute_count = end - begin;
+  // Summed in child order, each step truncated to int, as CSSStaticLayout
+  // does before sorting.
+  int total_use_width_without_absolute = 0;
+  for (int i = 0; i < child_count_[node]; i++) {
+    int child = Child(node, i);
+    if (css_display_type_[child] == CSS_DISPLAY_FLEX &&
+        css_position_type_[child] != CSS_POSITION_ABSOLUTE &&
+        css_position_type_[child] != CSS_POSITION_FIXED) {
+      total_use_width_without_absolute += measured_size_[child].width_ +
+                                          margin_left_[child] +
+                                          margin_right_[child];
+    }
+  }
+
+  bool rflag = flex_direction_[node] == CSSFLEX_DIRECTION_ROW_REVERSE;
+  if (rflag)
+    std::reverse(items_.begin() + begin, items_.end());
+
+  int justify_content = flex_justify_content_[node];
+  int adjust_width_start = 0;
+  int adjust_width_interval = 0;
+  if (current_row_without_absolute_count > 0) {
+    if (justify_content == CSSFLEX_JUSTIFY_FLEX_START && rflag) {
+      adjust_width_start = available_width - total_use_width_without_absolute;
+    } else if (justify_content == CSSFLEX_JUSTIFY_FLEX_END && !rflag) {
+      adjust_width_start = available_width - total_use_width_without_absolute;
+    } else if (justify_content == CSSFLEX_JUSTIFY_FLEX_CENTER) {
+      adjust_width_start = round(
+          (float)(available_width - total_use_width_without_absolute) / 2.0f);
+    } else if (total_use_width_without_absolute <= available_width &&
+               justify_content == CSSFLEX_JUSTIFY_SPACE_BETWEEN) {
+      if (current_row_without_absolute_count > 1) {
+        adjust_width_interval = round(
+            ((float)(available_width - total_use_width_without_absolute)) /
+            (current_row_without_absolute_count - 1));
+      }
+    } else if (total_use_width_without_absolute <= available_width &&
+               justify_content == CSSFLEX_JUSTIFY_SPACE_AROUND) {
+      float interval =
+          ((float)(available_width - total_use_width_without_absolute)) /
+          (current_row_without_absolute_count * 2);
+      adjust_width_start = round(interval);
+      adjust_width_interval = round(interval * 2);
+    }
+  }
+
+  int child_origin_x =
+      adjust_width_start + padding_left_[node] + border_width_[node];
+  int child_origin_y = padding_top_[node] + border_width_[node];
+
+  for (int i = begin; i < end; i++) {
+    int child = items_[i];
+
+    int align = flex_align_items_[node];
+    if (flex_align_self_[child] != CSSFLEX_ALIGN_AUTO) {
+      align = flex_align_self_[child];
+    }
+
+    int old_child_origin_y = child_origin_y;
+
+    child_origin_x += margin_left_[child];
+    if (child != items_[begin])
+      child_origin_x += adjust_width_interval;
+    child_origin_y += margin_top_[child];
+
+    int adjust_y = 0;
+    int adjust_height = CSS_UNDEFINED;
+    if (align == CSSFLEX_ALIGN_FLEX_START) {
+      // do nothing
+    } else if (align == CSSFLEX_ALIGN_FLEX_END) {
+      adjust_y = available_height - margin_bottom_[child] -
+                 measured_size_[child].height_;
+    } else if (align == CSSFLEX_ALIGN_STRETCH) {
+      if (CSS_IS_UNDEFINED(height_[child])) {
+        adjust_height =
+            available_height - margin_top_[child] - margin_bottom_[child];
+        adjust_height = ClampHeight(child, adjust_height);
+      }
+    } else if (align == CSSFLEX_ALIGN_CENTER) {
+      adjust_y = round(
+          (float)(available_height - measured_size_[child].height_) / 2.0f);
+    }
+
+    int l = child_origin_x;
+    int t = adjust_y + child_origin_y;
+    int r = child_origin_x + measured_size_[child].width_;
+    int b = CSS_IS_UNDEFINED(adjust_height)
+                ? child_origin_y + measured_size_[child].height_ + adjust_y
+                : child_origin_y + adjust_height;
+    LayoutNode(child, l, t, r, b);
+
+    child_origin_x += measured_size_[child].width_ + margin_right_[child];
+    child_origin_y = old_child_origin_y;
+  }
+  items_.resize(begin);
+}
+
+void CSSFlatLayout::LayoutColumnWrap(int node, int width, int height) {
+  int available_width = width - padding_left_[node] - padding_right_[node] -
+                        border_width_[node] * 2;
+  int available_height = height - padding_top_[node] - padding_bottom_[node] -
+                         border_width_[node] * 2;
+
+  int current_column_without_absolute_count = 0;
+  int total_use_height_without_absolute = 0;
+
+  bool rflag = flex_direction_[node] == CSSFLEX_DIRECTION_COLUMN_REVERSE;
+  bool wrflag = flex_wrap_[node] == CSSFLEX_WRAP_REVERSE;
+  int justify_content = flex_justify_content_[node];
+
+  int total_used_width = 0;
+  int current_line_width = 0;
+  bool is_line_feed = false;
+
+  int begin = CollectFlexItems(node, width, height);
+  int start = begin;
+
+  for (int index = begin, child_view_count = items_.size();
+       index < child_view_count; index++) {
+    int child = items_[index];
+
+    int old_total_use_height_without_absolute =
+        total_use_height_without_absolute;
+    current_column_without_absolute_count++;
+
+    if (!CSS_IS_UNDEFINED(height_[child])) {
+      total_use_height_without_absolute +=
+          height_[child] + margin_top_[child] + margin_bottom_[child];
+    } else {
+      total_use_height_without_absolute += measured_size_[child].height_ +
+                                           margin_top_[child] +
+                                           margin_bottom_[child];
+    }
+
+    if (total_use_height_without_absolute <= available_height) {
+      int child_width = measured_size_[child].width_ + margin_left_[child] +
+                        margin_right_[child];
+      current_line_width =
+          current_line_width > child_width ? current_line_width : child_width;
+    }
+
+    bool is_last_view = (index == child_view_count - 1);
+
+    if (total_use_height_without_absolute > available_height || is_last_view) {
+      if (total_use_height_without_absolute > available_height &&
+          current_column_without_absolute_count > 1) {
+        is_line_feed = true;
+        index--;
+        current_column_without_absolute_count--;
+        total_use_height_without_absolute =
+            old_total_use_height_without_absolute;
+      } else if (is_last_view && !is_line_feed) {
+        current_line_width = available_width;
+      }
+
+      int adjust_height_start = 0;
+      int adjust_height_interval = 0;
+      if (current_column_without_absolute_count > 0) {
+        if (justify_content == CSSFLEX_JUSTIFY_FLEX_START && rflag) {
+          adjust_height_start =
+              available_height - total_use_height_without_absolute;
+        } else if (justify_content == CSSFLEX_JUSTIFY_FLEX_END && !rflag) {
+          adjust_height_start =
+              available_height - total_use_height_without_absolute;
+        } else if (justify_content == CSSFLEX_JUSTIFY_FLEX_CENTER) {
+          adjust_height_start = round(
+              (float)(available_height - total_use_height_without_absolute) /
+              2.0f);
+        } else if (total_use_height_without_absolute <= available_height &&
+                   justify_content == CSSFLEX_JUSTIFY_SPACE_BETWEEN) {
+          if (current_column_without_absolute_count > 1) {
+            adjust_height_interval =
+                round(((float)(available_height -
+                               total_use_height_without_absolute)) /
+                      (current_column_without_absolute_count - 1));
+          }
+        } else if (total_use_height_without_absolute <= available_height &&
+                   justify_content == CSSFLEX_JUSTIFY_SPACE_AROUND) {
+          float interval =
+              ((float)(available_height - total_use_height_without_absolute)) /
+              (current_column_without_absolute_count * 2);
+          adjust_height_start = round(interval);
+          adjust_height_interval = round(interval * 2);
+        }
+      }
+
+      int max_width = 0;
+      int child_origin_x =
+          padding_left_[node] + border_width_[node] +
+          (!wrflag ? total_used_width : available_width - total_used_width);
+      int child_origin_y =
+          padding_top_[node] + border_width_[node] + adjust_height_start;
+
+      if (rflag)
+        std::reverse(items_.begin() + start, items_.begin() + index + 1);
+      for (int i = start; i <= index; i++) {
+        int item = items_[i];
+
+        int align = flex_align_items_[node];
+        if (flex_align_self_[item] != CSSFLEX_ALIGN_AUTO) {
+          align = flex_align_self_[item];
+        }
+
+        int old_child_origin_x = child_origin_x;
+        child_origin_x += (!wrflag ? margin_left_[item] : -margin_right_[item]);
+        child_origin_y += margin_top_[item];
+        if (i > start)
+          child_origin_y += adjust_height_interval;
+
+        int adjust_x = 0;
+        int adjust_width = CSS_UNDEFINED;
+        if (align == CSSFLEX_ALIGN_FLEX_START) {
+          // do nothing
+        } else if (align == CSSFLEX_ALIGN_FLEX_END) {
+          adjust_x = current_line_width - margin_right_[item] -
+                     measured_size_[item].width_;
+        } else if (align == CSSFLEX_ALIGN_STRETCH) {
+          adjust_width =
+              current_line_width - margin_right_[item] - margin_left_[item];
+          adjust_width = ClampWidth(item, adjust_width);
+        } else if (align == CSSFLEX_ALIGN_CENTER) {
+          adjust_x = round((float)(current_line_width - margin_right_[item] -
+                                   margin_left_[item] -
+                                   measured_size_[item].width_) /
+                           2.0f);
+        }
+
+        int l = 0, r = 0;
+        int t = child_origin_y;
+        int b = t + measured_size_[item].height_;
+        if (!wrflag) {
+          l = child_origin_x + adjust_x;
+          r = CSS_IS_UNDEFINED(adjust_width) ? l + measured_size_[item].width_
+                                             : l + adjust_width;
+        } else {
+          r = child_origin_x - adjust_x;
+          l = CSS_IS_UNDEFINED(adjust_width) ? r - measured_size_[item].width_
+                                             : r - adjust_width;
+        }
+
+        LayoutNode(item, l, t, r, b);
+
+        child_origin_x = old_child_origin_x;
+        child_origin_y += measured_size_[item].height_ + margin_bottom_[item];
+        int child_item_width =
+            (r - l) + margin_left_[item] + margin_right_[item];
+        max_width = max_width < child_item_width ? child_item_width : max_width;
+      }
+      start = index + 1;
+      total_use_height_without_absolute =
+          padding_top_[node] + padding_bottom_[node];
+      current_column_without_absolute_count = 0;
+      total_used_width += max_width;
+      current_line_width = 0;
+    }
+  }
+  items_.resize(begin);
+}
+
+void CSSFlatLayout::LayoutColumnOneLine(int node, int width, int height) {
+  int available_width = width - padding_left_[node] - padding_right_[node] -
+                        border_width_[node] * 2;
+  int available_height = height - padding_top_[node] - padding_bottom_[node] -
+                         border_width_[node] * 2;
+
+  int begin = CollectFlexItems(node, width, height);
+  int end = items_.size();
+  int current_column_without_absolute_count = end - begin;
+  int total_use_height_without_absolute = 0;
+  for (int i = 0; i < child_count_[node]; i++) {
+    int child = Child(node, i);
+    if (css_display_type_[child] == CSS_DISPLAY_FLEX &&
+        css_position_type_[child] != CSS_POSITION_ABSOLUTE &&
+        css_position_type_[child] != CSS_POSITION_FIXED) {
+      total_use_height_without_absolute += measured_size_[child].height_ +
+                                           margin_top_[child] +
+                                           margin_bottom_[child];
+    }
+  }
+
+  bool rflag = flex_direction_[node] == CSSFLEX_DIRECTION_COLUMN_REVERSE;
+  if (rflag)
+    std::reverse(items_.begin() + begin, items_.end());
+
+  int justify_content = flex_justify_content_[node];
+  int adjust_height_start = 0;
+  int adjust_height_interval = 0;
+  if (current_column_without_absolute_count > 0) {
+    if (justify_content == CSSFLEX_JUSTIFY_FLEX_START && rflag) {
+      adjust_height_start =
+          available_height - total_use_height_without_absolute;
+    } else if (justify_content == CSSFLEX_JUSTIFY_FLEX_END && !rflag) {
+      adjust_height_start =
+          available_height - total_use_height_without_absolute;
+    } else if (justify_content == CSSFLEX_JUSTIFY_FLEX_CENTER) {
+      adjust_height_start = round(
+          (float)(available_height - total_use_height_without_absolute) / 2.0f);
+    } else if (total_use_height_without_absolute <= available_height &&
+               justify_content == CSSFLEX_JUSTIFY_SPACE_BETWEEN) {
+      if (current_column_without_absolute_count > 1) {
+        adjust_height_interval = round(
+            ((float)(available_height - total_use_height_without_absolute)) /
+            (current_column_without_absolute_count - 1));
+      }
+    } else if (total_use_height_without_absolute <= available_height &&
+               justify_content == CSSFLEX_JUSTIFY_SPACE_AROUND) {
+      float interval =
+          ((float)(available_height - total_use_height_without_absolute)) /
+          (current_column_without_absolute_count * 2);
+      adjust_height_start = round(interval);
+      adjust_height_interval = round(interval * 2);
+    }
+  }
+
+  int child_origin_x = padding_left_[node] + border_width_[node];
+  int child_origin_y =
+      padding_top_[node] + border_width_[node] + adjust_height_start;
+  for (int i = begin; i < end; i++) {
+    int child = items_[i];
+
+    int align = flex_align_items_[node];
+    if (flex_align_self_[child] != CSSFLEX_ALIGN_AUTO) {
+      align = flex_align_self_[child];
+    }
+    int old_child_origin_x = child_origin_x;
+
+    child_origin_x += margin_left_[child];
+    child_origin_y += margin_top_[child];
+    if (child != items_[begin])
+      child_origin_y += adjust_height_interval;
+
+    int adjust_x = 0;
+    int adjust_width = CSS_UNDEFINED;
+    if (align == CSSFLEX_ALIGN_FLEX_START) {
+      // do nothing
+    } else if (align == CSSFLEX_ALIGN_FLEX_END) {
+      adjust_x = available_width - margin_right_[child] -
+                 measured_size_[child].width_;
+    } else if (align == CSSFLEX_ALIGN_STRETCH) {
+      if (CSS_IS_UNDEFINED(width_[child])) {
+        adjust_width =
+            available_width - margin_right_[child] - margin_left_[child];
+        adjust_width = ClampWidth(child, adjust_width);
+      }
+    } else if (align == CSSFLEX_ALIGN_CENTER) {
+      adjust_x = (available_width - margin_right_[child] -
+                  margin_left_[child] - measured_size_[child].width_) /
+                 2;
+    }
+
+    int l = adjust_x + child_origin_x;
+    int t = child_origin_y;
+    int r = CSS_IS_UNDEFINED(adjust_width)
+                ? child_origin_x + measured_size_[child].width_ + adjust_x
+                : adjust_width + child_origin_x;
+    int b = child_origin_y + measured_size_[child].height_;
+
+    LayoutNode(child, l, t, r, b);
+
+    child_origin_x = old_child_origin_x;
+    child_origin_y += measured_size_[child].height_ + margin_bottom_[child];
+  }
+  items_.resize(begin);
+}
+
+void CSSFlatLayout::LayoutFixedOrAbsolute(int parent,
+                                          int child,
+                                          int width,
+                                          int height) {
+  int l = 0, r = 0, t = 0, b = 0;
+
+  int offset_left = margin_left_[child] + border_width_[parent];
+  int offset_right = margin_right_[child] + border_width_[parent];
+  int offset_top = margin_top_[child] + border_width_[parent];
+  int offset_bottom = margin_bottom_[child] + border_width_[parent];
+
+  if (CSS_IS_UNDEFINED(left_[child]) && CSS_IS_UNDEFINED(right_[child])) {
+    int adjust =
+        CalculateOffsetWithFlexContainerStyle(parent, child, width,
+                                              CSS_UNDEFINED);
+    l = adjust + offset_left + padding_left_[parent];
+    r = l + measured_size_[child].width_;
+  } else if (!CSS_IS_UNDEFINED(left_[child]) &&
+             !CSS_IS_UNDEFINED(right_[child])) {
+    if (CSS_IS_UNDEFINED(width_[child])) {
+      l = left_[child] + offset_left;
+      r = width - right_[child] - offset_right;
+      if (l > r) {
+        r = l;
+      }
+    } else {
+      l = left_[child] + offset_left;
+      r = l + measured_size_[child].width_;
+    }
+  } else if (!CSS_IS_UNDEFINED(left_[child])) {
+    l = left_[child] + offset_left;
+    r = l + measured_size_[child].width_;
+  } else {
+    r = width - right_[child] - offset_right;
+    l = r - measured_size_[child].width_;
+  }
+
+  if (CSS_IS_UNDEFINED(top_[child]) && CSS_IS_UNDEFINED(bottom_[child])) {
+    int adjust =
+        CalculateOffsetWithFlexContainerStyle(parent, child, CSS_UNDEFINED,
+                                              height);
+    t = adjust + offset_top + padding_top_[parent];
+    b = t + measured_size_[child].height_;
+  } else if (!CSS_IS_UNDEFINED(top_[child]) &&
+             !CSS_IS_UNDEFINED(bottom_[child])) {
+    if (CSS_IS_UNDEFINED(height_[child])) {
+      t = top_[child] + offset_top;
+      b = height - bottom_[child] - offset_bottom;
+      if (t > b) {
+        b = t;
+      }
+    } else {
+      t = top_[child] + offset_top;
+      b = t + measured_size_[child].height_;
+    }
+  } else if (!CSS_IS_UNDEFINED(top_[child])) {
+    t = top_[child] + offset_top;
+    b = t + measured_size_[child].height_;
+  } else {
+    b = height - bottom_[child] - offset_bottom;
+    t = b - measured_size_[child].height_;
+  }
+
+  LayoutNode(child, l, t, r, b);
+}
+
+int CSSFlatLayout::CalculateOffsetWithFlexContainerStyle(int parent,
+                                                         int child,
+                                                         int width,
+                                                         int height) {
+  int offset = 0;
+  bool is_width_available = !CSS_IS_UNDEFINED(width);
+
+  int available_width = CSS_UNDEFINED;
+  int available_height = CSS_UNDEFINED;
+
+  if (is_width_available) {
+    available_width = width - padding_left_[parent] - padding_right_[parent] -
+                      border_width_[parent] * 2;
+  } else {
+    available_height = height - padding_top_[parent] -
+                       padding_bottom_[parent] - border_width_[parent] * 2;
+  }
+
+  bool is_main_axis =
+      (is_width_available &&
+       flex_direction_[parent] == CSSFLEX_DIRECTION_ROW) ||
+      (!is_width_available &&
+       flex_direction_[parent] == CSSFLEX_DIRECTION_COLUMN);
+
+  int available_target_axis, child_size_on_target_axis;
+  if (is_width_available) {
+    available_target_axis = available_width;
+    child_size_on_target_axis = measured_size_[child].width_;
+  } else {
+    available_target_axis = available_height;
+    child_size_on_target_axis = measured_size_[child].height_;
+  }
+
+  if (is_main_axis) {
+    int justify_content = flex_justify_content_[parent];
+    if (justify_content == CSSFLEX_JUSTIFY_FLEX_START ||
+        justify_content == CSSFLEX_JUSTIFY_SPACE_BETWEEN) {
+      // no action
+    } else if (justify_content == CSSFLEX_JUSTIFY_FLEX_END) {
+      offset = available_target_axis - child_size_on_target_axis;
+    } else if (justify_content == CSSFLEX_JUSTIFY_FLEX_CENTER ||
+               justify_content == CSSFLEX_JUSTIFY_SPACE_AROUND) {
+      offset = round(
+          (float)(available_target_axis - child_size_on_target_axis) / 2.0f);
+    }
+  } else {
+    int align = flex_align_items_[parent];
+    if (flex_align_self_[child] != CSSFLEX_ALIGN_AUTO) {
+      align = flex_align_self_[child];
+    }
+
+    if (flex_align_items_[parent] == CSSFLEX_ALIGN_FLEX_START) {
+      // do nothing
+    } else if (align == CSSFLEX_ALIGN_FLEX_END) {
+      offset = available_target_axis - child_size_on_target_axis;
+    } else if (align == CSSFLEX_ALIGN_STRETCH) {
+      // Nothing to do when position: absolute/fixed
+    } else if (align == CSSFLEX_ALIGN_CENTER) {
+      offset = round(
+          (float)(available_target_axis - child_size_on_target_axis) / 2.0f);
+    }
+  }
+
+  return offset;
+}
+}  // namespace lynx
@@ -0,0 +1,193 @@
+// Copyright 2017 The Lynx Authors. All rights reserved.
+
+#ifndef LYNX_LAYOUT_CSS_FLAT_LAYOUT_H_
+#define LYNX_LAYOUT_CSS_FLAT_LAYOUT_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/position.h"
+#include "base/size.h"
+
+namespace lynx {
+
+class LayoutObject;
+
+// The flexbox layout of CSSStaticLayout, run on a flattened copy of a
+// LayoutObject tree. Build() copies the nodes into arrays indexed by node,
+// the children of a node next to each other, and the style fields the
+// layout reads into one array per field, so a measure pass walks
+// contiguous memory instead of following ContainerNode links into whole
+// CSSStyle blocks. Layout() then lays the tree out as ReLayout does on a
+// dirty tree, and WriteBack() stores sizes, positions and measure caches in
+// the LayoutObjects, leaving them up to date for incremental relayout.
+//
+// Every node is measured and laid out the way LayoutObject does it, so the
+// tree must not hold objects overriding OnMeasure or OnLayout, as labels,
+// images and the other platform views do.
+class CSSFlatLayout {
+ public:
+  CSSFlatLayout();
+  ~CSSFlatLayout();
+
+  void Build(LayoutObject* root);
+
+  void Layout(int left, int top, int right, int bottom);
+
+  void WriteBack();
+
+  // The viewport of position: fixed nodes, empty by default as in tests.
+  void set_viewport(int width, int height) {
+    viewport_width_ = width;
+    viewport_height_ = height;
+  }
+
+  int node_count() const { return static_cast<int>(objects_.size()); }
+
+ private:
+  static const int kMaxCachedMeasures;
+
+  struct MeasureCacheEntry {
+    int width_descriptor_;
+    int height_descriptor_;
+    base::Size size_;
+  };
+
+  int AddNode(LayoutObject* object, int parent);
+
+  int Child(int node, int index) const {
+    return children_[first_child_[node] + index];
+  }
+
+  double ClampWidthInner(int node, double width) const;
+  double ClampHeightInner(int node, double height) const;
+  double ClampWidth(int node) const;
+  double ClampHeight(int node) const;
+  double ClampWidth(int node, double width) const;
+  double ClampHeight(int node, double height) const;
+  double ClampExactWidth(int node, double width) const;
+  double ClampExactHeight(int node, double height) const;
+
+  // LayoutObject::Measure and Layout.
+  base::Size Measure(int node, int width_descriptor, int height_descriptor);
+  bool MeasureForLayout(int node);
+  void LayoutNode(int node, int left, int top, int right, int bottom);
+
+  // CSSStaticLayout, on node indices.
+  base::Size OnMeasure(int node, int width_descriptor, int height_descriptor);
+  base::Size MeasureInner(int node,
+                          int width,
+                          int width_mode,
+                          int height,
+                          int height_mode);
+  bool MeasureSpecially(int node,
+                        int width,
+                        int width_mode,
+                        int height,
+                        int height_mode);
+  // CSSStaticLayout::MeasureRowItem and MeasureColumnItem.
+  base::Size MeasureRowItem(int node, int width, int height);
+  base::Size MeasureColumnItem(int node, int width, int height);
+  base::Size MeasureRowOneLine(int node,
+                               int width,
+                               int width_mode,
+                               int height,
+                               int height_mode,
+                               int start,
+                               int end);
+  base::Size MeasureRowWrap(int node,
+                            int width,
+                            int width_mode,
+                            int height,
+                            int height_mode);
+  base::Size MeasureColumnOneLine(int node,
+                                  int width,
+                                  int width_mode,
+                                  int height,
+                                  int height_mode,
+                                  int start,
+                                  int end);
+  base::Size MeasureColumnWrap(int node,
+                               int width,
+                               int width_mode,
+                               int height,
+                               int height_mode);
+  void MeasureAbsolute(int node, int width, int height);
+  void MeasureFixed(int node);
+
+  void OnLayout(int node, int width, int height);
+  void LayoutWhenDisplayNone(int node);
+  // Lays out the hidden, absolute and fixed children and pushes the flex
+  // items, sorted by order, onto items_. Returns where they start.
+  int CollectFlexItems(int node, int width, int height);
+  void LayoutRowOneLine(int node, int width, int height);
+  void LayoutRowWrap(int node, int width, int height);
+  void LayoutColumnOneLine(int node, int width, int height);
+  void LayoutColumnWrap(int node, int width, int height);
+  void LayoutFixedOrAbsolute(int parent, int child, int width, int height);
+  int CalculateOffsetWithFlexContainerStyle(int parent,
+                                            int child,
+                                            int width,
+                                            int height);
+
+  // Tree. The children of a node are children_[first_child_[node]] on.
+  std::vector<LayoutObject*> objects_;
+  std::vector<int> parent_;
+  std::vector<int> first_child_;
+  std::vector<int> child_count_;
+  std::vector<int> children_;
+
+  // Style, one array per field.
+  std::vector<double> width_;
+  std::vector<double> height_;
+  std::vector<double> min_width_;
+  std::vector<double> max_width_;
+  std::vector<double> min_height_;
+  std::vector<double> max_height_;
+  std::vector<double> margin_left_;
+  std::vector<double> margin_right_;
+  std::vector<double> margin_top_;
+  std::vector<double> margin_bottom_;
+  std::vector<double> padding_left_;
+  std::vector<double> padding_right_;
+  std::vector<double> padding_top_;
+  std::vector<double> padding_bottom_;
+  std::vector<double> border_width_;
+  std::vector<double> flex_;
+  std::vector<double> flex_order_;
+  std::vector<uint8_t> flex_direction_;
+  std::vector<uint8_t> flex_wrap_;
+  std::vector<uint8_t> flex_justify_content_;
+  std::vector<uint8_t> flex_align_items_;
+  std::vector<uint8_t> flex_align_self_;
+  std::vector<uint8_t> css_position_type_;
+  std::vector<uint8_t> css_display_type_;
+  // Only read for absolute and fixed nodes.
+  std::vector<double> left_;
+  std::vector<double> right_;
+  std::vector<double> top_;
+  std::vector<double> bottom_;
+
+  // Results, and the measure cache of LayoutObject.
+  std::vector<base::Size> measured_size_;
+  std::vector<base::Position> measured_position_;
+  std::vector<uint8_t> laid_out_;
+  std::vector<int> last_width_descriptor_;
+  std::vector<int> last_height_descriptor_;
+  std::vector<int> on_measure_width_descriptor_;
+  std::vector<int> on_measure_height_descriptor_;
+  std::vector<MeasureCacheEntry> measure_cache_;
+  std::vector<uint8_t> measure_cache_size_;
+  std::vector<uint8_t> measure_cache_next_;
+
+  // Flex items of the containers being laid out, innermost last.
+  std::vector<int> items_;
+
+  bool display_none_;
+  int viewport_width_;
+  int viewport_height_;
+};
+}  // namespace lynx
+
+#endif  // LYNX_LAYOUT_CSS_FLAT_LAYOUT_H_
@@ -3,9 +3,11 @@
 #include "layout/css_layout.h"
 #include <algorithm>
 #include <vector>
+#include "base/threading/thread_local.h"
 #include "layout/css_style.h"
 #include "layout/css_type.h"
 #include "layout/layout_object.h"
+#include "layout/layout_worker_pool.h"
 #ifndef TESTING
 #include "render/render_object.h"
 #include "render/render_tree_host.h"
@@ -14,6 +16,15 @@ using namespace std;
 
 namespace lynx {
 
+namespace {
+// The hidden node whose subtree is being laid out on this thread. Kept
+// per thread, as workers lay out subtrees side by side.
+base::ThreadLocalPointer<LayoutObject> display_none_root;
+// The independent children queued by the container being laid out on
+// this thread, see LayoutChild.
+base::ThreadLocalPointer<vector<LayoutWorkerPool::Task> > pending_layouts;
+}  // namespace
+
 //实现order排序的比较函数
 bool CompareFlexOrder(LayoutObject* obj1, LayoutObject* obj2) {
   const CSSStyle* item1_style = &(obj1->css_style());
@@ -85,6 +96,12 @@ base::Size CSSStaticLayout::MeasureInner(LayoutObject* renderer,
   int available_height = h - style->padding_top_ - style->padding_bottom_ -
                          style->border_width_ * 2;
 
+  LayoutWorkerPool* pool = LayoutWorkerPool::Current();
+  if (pool != NULL && pool->worker_count() > 0) {
+    MeasureIndependentChildren(renderer, available_width, available_height,
+                               pool);
+  }
+
   if (style->flex_direction_ == CSSFLEX_DIRECTION_ROW ||
       style->flex_direction_ == CSSFLEX_DIRECTION_ROW_REVERSE) {
     measured_size = MeasureRow(renderer, available_width, width_mode,
@@ -125,13 +142,71 @@ bool CSSStaticLayout::MeasureSpecially(LayoutObject* renderer,
   return false;
 }
 
-base::Size CSSStaticLayout::MeasureRowOneLine(LayoutObject* renderer,
+void CSSStaticLayout::RowItemDescriptors(LayoutObject* child,
+                                         int width,
+                                         int height,
+                                         int* width_descriptor,
+                                         int* height_descriptor) {
+  const CSSStyle* child_style = &(child->css_style());
+  if (!CSS_IS_UNDEFINED(child_style->width_)) {
+    *width_descriptor = base::Size::Descriptor::Make(
+        child_style->ClampWidth(), base::Size::Descriptor::AT_MOST);
+  } else {
+    *width_descriptor = base::Size::Descriptor::Make(
+        width - child_style->margin_left_ - child_style->margin_right_,
+        base::Size::Descriptor::UNSPECIFIED);
+  }
+  *height_descriptor = base::Size::Descriptor::Make(
+      height - child_style->margin_top_ - child_style->margin_bottom_,
+      base::Size::Descriptor::AT_MOST);
+}
+
+void CSSStaticLayout::ColumnItemDescriptors(LayoutObject* child,
+                                            int width,
+                                            int height,
+                                            int* width_descriptor,
+                                            int* height_descriptor) {
+  const CSSStyle* child_style = &(child->css_style());
+  *width_descriptor = base::Size::Descriptor::Make(
+      width - child_style->margin_right_ - child_style->margin_left_,
+      base::Size::Descriptor::AT_MOST);
+  if (!CSS_IS_UNDEFINED(child_style->height_)) {
+    *height_descriptor = base::Size::Descriptor::Make(
+        child_style->ClampHeight(), base::Size::Descriptor::AT_MOST);
+  } else {
+    *height_descriptor = base::Size::Descriptor::Make(
+        height - child_style->margin_top_ - child_style->margin_bottom_,
+        base::Size::Descriptor::UNSPECIFIED);
+  }
+}
+
+base::Size CSSStaticLayout::MeasureRowItem(LayoutObject* child,
+                                           int width,
+                                           int height) {
+  int width_descriptor, height_descriptor;
+  RowItemDescriptors(child, width, height, &width_descriptor,
+                     &height_descriptor);
+  return child->Measure(width_descriptor, height_descriptor);
+}
+
+base::Size CSSStaticLayout::MeasureColumnItem(LayoutObject* child,
                                               int width,
-                                              int width_mode,
-                                              int height,
-                                              int height_mode,
-                                              int start,
-                                              int end) {
+                                              int height) {
+  int width_descriptor, height_descriptor;
+  ColumnItemDescriptors(child, width, height, &width_descriptor,
+                        &height_descriptor);
+  return child->Measure(width_descriptor, height_descriptor);
+}
+
+base::Size CSSStaticLayout::MeasureRowOneLine(
+    LayoutObject* renderer,
+    int width,
+    int width_mode,
+    int height,
+    int height_mode,
+    int start,
+    int end,
+    ContainerNode::ChildCursor* children) {
   base::Size measured_size(0, 0);
   int calc_width = 0;
   int calc_height = 0;
@@ -143,9 +218,7 @@ base::Size CSSStaticLayout::MeasureRowOneLine(LayoutObject* renderer,
   //计算子view中无flex属性的view
   // size，并且计算出剩下含有flex属性的子view可使用的宽度
   for (int i = start; i <= end; i++) {
-    int measure_width;
-
-    LayoutObject* child = (LayoutObject*)renderer->Find(i);
+    LayoutObject* child = (LayoutObject*)children->Find(i);
     const CSSStyle* child_style = &(child->css_style());
 
     if (MeasureSpecially(child, width, width_mode, height, height_mode)) {
@@ -158,21 +231,7 @@ base::Size CSSStaticLayout::MeasureRowOneLine(LayoutObject* renderer,
       continue;
     }
 
-    if (!CSS_IS_UNDEFINED(child_style->width_)) {
-      measure_width = base::Size::Descriptor::Make(
-          child_style->ClampWidth(), base::Size::Descriptor::AT_MOST);
-    } else {
-      measure_width = base::Size::Descriptor::Make(
-          residual_width - child_style->margin_left_ -
-              child_style->margin_right_,
-          base::Size::Descriptor::UNSPECIFIED);
-    }
-
-    base::Size child_size = child->Measure(
-        measure_width,
-        base::Size::Descriptor::Make(
-            height - child_style->margin_top_ - child_style->margin_bottom_,
-            base::Size::Descriptor::AT_MOST));
+    base::Size child_size = MeasureRowItem(child, residual_width, height);
 
     calc_width += child_size.width_ + child_style->margin_left_ +
                   child_style->margin_right_;
@@ -207,7 +266,7 @@ base::Size CSSStaticLayout::MeasureRowOneLine(LayoutObject* renderer,
     residual_width = 0;
 
   for (int i = start; i <= end; i++) {
-    LayoutObject* child = (LayoutObject*)renderer->Find(i);
+    LayoutObject* child = (LayoutObject*)children->Find(i);
     const CSSStyle* child_style = &(child->css_style());
 
     if (child_style->css_display_type_ != CSS_DISPLAY_FLEX) {
@@ -268,9 +327,10 @@ base::Size CSSStaticLayout::MeasureRowWrap(LayoutObject* renderer,
   base::Size measured_size(renderer->css_style().width_,
                            renderer->css_style().height_);
 
+  ContainerNode::ChildCursor children(renderer);
   for (int index = 0, child_view_count = renderer->GetChildCount();
        index < child_view_count;) {
-    LayoutObject* child = (LayoutObject*)renderer->Find(index);
+    LayoutObject* child = (LayoutObject*)children.Find(index);
     const CSSStyle* child_style = &(child->css_style());
 
     if (MeasureSpecially(child, width, width_mode, height, height_mode)) {
@@ -278,16 +338,11 @@ base::Size CSSStaticLayout::MeasureRowWrap(LayoutObject* renderer,
       continue;
     }
 
-    int measure_width =
-        width - child_style->margin_left_ - child_style->margin_right_;
+    // Measured as MeasureRowOneLine does, so that the line measures below
+    // find the size in the cache of the child.
     base::Size child_size(0, 0);
-
     if (child_style->flex_ == 0) {
-      child_size =
-          child->Measure(base::Size::Descriptor::Make(
-                             measure_width, base::Size::Descriptor::AT_MOST),
-                         base::Size::Descriptor::Make(
-                             height, base::Size::Descriptor::AT_MOST));
+      child_size = MeasureRowItem(child, width, height);
     }
 
     current_calc_width = current_calc_width + child_size.width_ +
@@ -295,8 +350,9 @@ base::Size CSSStaticLayout::MeasureRowWrap(LayoutObject* renderer,
     if (current_calc_width <= width) {
       calc_width = current_calc_width;
       if (index == child_view_count - 1) {
-        base::Size row_size = MeasureRowOneLine(
-            renderer, width, width_mode, height, height_mode, start, index);
+        base::Size row_size =
+            MeasureRowOneLine(renderer, width, width_mode, height,
+                              height_mode, start, index, &children);
         calc_width =
             row_size.width_ > calc_width ? row_size.width_ : calc_width;
         calc_height += row_size.height_;
@@ -311,8 +367,9 @@ base::Size CSSStaticLayout::MeasureRowWrap(LayoutObject* renderer,
         end -= 1;
       }
 
-      base::Size row_size = MeasureRowOneLine(renderer, width, width_mode,
-                                              height, height_mode, start, end);
+      base::Size row_size =
+          MeasureRowOneLine(renderer, width, width_mode, height, height_mode,
+                            start, end, &children);
 
       calc_width = row_size.width_ > calc_width ? row_size.width_ : calc_width;
       calc_height += row_size.height_;
@@ -335,21 +392,24 @@ base::Size CSSStaticLayout::MeasureRow(LayoutObject* renderer,
                                        int height_mode) {
   const CSSStyle* item_style = &(renderer->css_style());
   if (item_style->flex_wrap_ != CSSFLEX_WRAP) {
+    ContainerNode::ChildCursor children(renderer);
     return MeasureRowOneLine(renderer, width, width_mode, height, height_mode,
-                             0, renderer->GetChildCount() - 1);
+                             0, renderer->GetChildCount() - 1, &children);
   } else {
     // measure flex-wrap
     return MeasureRowWrap(renderer, width, width_mode, height, height_mode);
   }
 }
 
-base::Size CSSStaticLayout::MeasureColumnOneLine(LayoutObject* renderer,
-                                                 int width,
-                                                 int width_mode,
-                                                 int height,
-                                                 int height_mode,
-                                                 int start,
-                                                 int end) {
+base::Size CSSStaticLayout::MeasureColumnOneLine(
+    LayoutObject* renderer,
+    int width,
+    int width_mode,
+    int height,
+    int height_mode,
+    int start,
+    int end,
+    ContainerNode::ChildCursor* children) {
   base::Size measured_size(0, 0);
   int calc_width = 0;
   int calc_height = 0;
@@ -361,9 +421,7 @@ base::Size CSSStaticLayout::MeasureColumnOneLine(LayoutObject* renderer,
   //计算子view中无flex属性的view
   // size，并且计算出剩下含有flex属性的子view可使用的宽度
   for (int i = start; i <= end; i++) {
-    int measure_height;
-
-    LayoutObject* child = (LayoutObject*)renderer->Find(i);
+    LayoutObject* child = (LayoutObject*)children->Find(i);
     const CSSStyle* child_style = &(child->css_style());
 
     if (MeasureSpecially(child, width, width_mode, height, height_mode)) {
@@ -376,21 +434,7 @@ base::Size CSSStaticLayout::MeasureColumnOneLine(LayoutObject* renderer,
       continue;
     }
 
-    if (!CSS_IS_UNDEFINED(child_style->height_)) {
-      measure_height = base::Size::Descriptor::Make(
-          child_style->ClampHeight(), base::Size::Descriptor::AT_MOST);
-    } else {
-      measure_height = base::Size::Descriptor::Make(
-          residual_height - calc_height - child_style->margin_top_ -
-              child_style->margin_bottom_,
-          base::Size::Descriptor::UNSPECIFIED);
-    }
-
-    base::Size child_size = child->Measure(
-        base::Size::Descriptor::Make(
-            width - child_style->margin_right_ - child_style->margin_left_,
-            base::Size::Descriptor::AT_MOST),
-        measure_height);
+    base::Size child_size = MeasureColumnItem(child, width, residual_height);
 
     calc_width = child_size.width_;
     calc_height += child_size.height_ + child_style->margin_top_ +
@@ -425,7 +469,7 @@ base::Size CSSStaticLayout::MeasureColumnOneLine(LayoutObject* renderer,
     residual_height = 0;
 
   for (int i = start; i <= end; i++) {
-    LayoutObject* child = (LayoutObject*)renderer->Find(i);
+    LayoutObject* child = (LayoutObject*)children->Find(i);
     const CSSStyle* child_style = &(child->css_style());
 
     if (child_style->css_display_type_ != CSS_DISPLAY_FLEX) {
@@ -487,9 +531,10 @@ base::Size CSSStaticLayout::MeasureColumnWrap(LayoutObject* renderer,
   base::Size measured_size(renderer->css_style().width_,
                            renderer->css_style().height_);
 
+  ContainerNode::ChildCursor children(renderer);
   for (int index = 0, child_view_count = renderer->GetChildCount();
        index < child_view_count;) {
-    LayoutObject* child = (LayoutObject*)renderer->Find(index);
+    LayoutObject* child = (LayoutObject*)children.Find(index);
     const CSSStyle* child_style = &(child->css_style());
 
     if (MeasureSpecially(child, width, width_mode, height, height_mode)) {
@@ -497,15 +542,11 @@ base::Size CSSStaticLayout::MeasureColumnWrap(LayoutObject* renderer,
       continue;
     }
 
-    int measure_height =
-        height - child_style->margin_top_ - child_style->margin_bottom_;
+    // Measured as MeasureColumnOneLine does, so that the line measures
+    // below find the size in the cache of the child.
     base::Size child_size(0, 0);
-
     if (child_style->flex_ == 0) {
-      child_size = child->Measure(
-          base::Size::Descriptor::Make(width, base::Size::Descriptor::AT_MOST),
-          base::Size::Descriptor::Make(measure_height,
-                                       base::Size::Descriptor::AT_MOST));
+      child_size = MeasureColumnItem(child, width, height);
     }
 
     current_calc_height = current_calc_height + child_size.height_ +
@@ -514,8 +555,9 @@ base::Size CSSStaticLayout::MeasureColumnWrap(LayoutObject* renderer,
     if (current_calc_height <= height) {
       calc_height = current_calc_height;
       if (index == child_view_count - 1) {
-        base::Size column_size = MeasureColumnOneLine(
-            renderer, width, width_mode, height, height_mode, start, index);
+        base::Size column_size =
+            MeasureColumnOneLine(renderer, width, width_mode, height,
+                                 height_mode, start, index, &children);
 
         calc_width += column_size.width_;
         calc_height = column_size.height_ > calc_height ? column_size.height_
@@ -531,8 +573,9 @@ base::Size CSSStaticLayout::MeasureColumnWrap(LayoutObject* renderer,
         end -= 1;
       }
 
-      base::Size column_size = MeasureColumnOneLine(
-          renderer, width, width_mode, height, height_mode, start, end);
+      base::Size column_size =
+          MeasureColumnOneLine(renderer, width, width_mode, height,
+                               height_mode, start, end, &children);
 
       calc_width += column_size.width_;
       calc_height =
@@ -557,37 +600,112 @@ base::Size CSSStaticLayout::MeasureColumn(LayoutObject* renderer,
                                           int height_mode) {
   const CSSStyle* item_style = &(renderer->css_style());
   if (item_style->flex_wrap_ != CSSFLEX_WRAP) {
+    ContainerNode::ChildCursor children(renderer);
     return MeasureColumnOneLine(renderer, width, width_mode, height,
-                                height_mode, 0, renderer->GetChildCount() - 1);
+                                height_mode, 0, renderer->GetChildCount() - 1,
+                                &children);
   } else {
     // measure flex-wrap
     return MeasureColumnWrap(renderer, width, width_mode, height, height_mode);
   }
 }
 
-static bool sDisplayNoneFlag = false;
-
 void CSSStaticLayout::Layout(LayoutObject* renderer, int width, int height) {
   const CSSStyle* item_style = &(renderer->css_style());
   // 如果是隐藏的view，之后的view都不进行排版，需要重新measure
-  if (sDisplayNoneFlag) {
+  if (display_none_root.Get() != NULL) {
     LayoutWhenDisplayNone(renderer);
-  } else if (item_style->css_display_type_ != CSS_DISPLAY_FLEX) {
-    sDisplayNoneFlag = true;
+    return;
+  }
+  if (item_style->css_display_type_ != CSS_DISPLAY_FLEX) {
+    display_none_root.Set(renderer);
     LayoutWhenDisplayNone(renderer);
-    sDisplayNoneFlag = false;
-  } else if (item_style->flex_direction_ == CSSFLEX_DIRECTION_ROW ||
-             item_style->flex_direction_ == CSSFLEX_DIRECTION_ROW_REVERSE) {
+    display_none_root.Set(NULL);
+    return;
+  }
+
+  // With a worker pool, independent children are queued while the others
+  // are laid out, and run on the pool once all positions are known.
+  LayoutWorkerPool* pool = LayoutWorkerPool::Current();
+  vector<LayoutWorkerPool::Task> tasks;
+  vector<LayoutWorkerPool::Task>* outer = pending_layouts.Get();
+  pending_layouts.Set(pool != NULL && pool->worker_count() > 0 ? &tasks
+                                                                : NULL);
+  if (item_style->flex_direction_ == CSSFLEX_DIRECTION_ROW ||
+      item_style->flex_direction_ == CSSFLEX_DIRECTION_ROW_REVERSE) {
     LayoutRow(renderer, width, height);
   } else if (item_style->flex_direction_ == CSSFLEX_DIRECTION_COLUMN ||
              item_style->flex_direction_ == CSSFLEX_DIRECTION_COLUMN_REVERSE) {
     LayoutColumn(renderer, width, height);
   }
+  pending_layouts.Set(outer);
+  if (!tasks.empty()) {
+    pool->Run(tasks);
+  }
+}
+
+bool CSSStaticLayout::IsIndependent(LayoutObject* child) {
+  const CSSStyle* child_style = &(child->css_style());
+  // A leaf costs less to lay out than to hand to another thread.
+  if (child->FirstChild() == NULL ||
+      child_style->css_display_type_ != CSS_DISPLAY_FLEX ||
+      child_style->css_position_type_ == CSS_POSITION_FIXED) {
+    return false;
+  }
+  return child_style->css_position_type_ == CSS_POSITION_ABSOLUTE ||
+         child->IsRelayoutBoundary();
+}
+
+void CSSStaticLayout::MeasureIndependentChildren(LayoutObject* renderer,
+                                                 int width,
+                                                 int height,
+                                                 LayoutWorkerPool* pool) {
+  const CSSStyle* style = &(renderer->css_style());
+  bool row = style->flex_direction_ == CSSFLEX_DIRECTION_ROW ||
+             style->flex_direction_ == CSSFLEX_DIRECTION_ROW_REVERSE;
+  vector<LayoutWorkerPool::Task> tasks;
+  for (Node* node = renderer->FirstChild(); node != NULL;
+       node = node->Next()) {
+    LayoutObject* child = static_cast<LayoutObject*>(node);
+    // Flexible children are measured once the space left for them is known.
+    if (child->measure_cache_size_ != 0 ||
+        child->css_style().css_position_type_ == CSS_POSITION_ABSOLUTE ||
+        child->css_style().flex_ > 0 || !IsIndependent(child)) {
+      continue;
+    }
+    int width_descriptor, height_descriptor;
+    if (row) {
+      RowItemDescriptors(child, width, height, &width_descriptor,
+                         &height_descriptor);
+    } else {
+      ColumnItemDescriptors(child, width, height, &width_descriptor,
+                            &height_descriptor);
+    }
+    tasks.push_back(
+        LayoutWorkerPool::Task(child, width_descriptor, height_descriptor));
+  }
+  if (tasks.size() > 1) {
+    pool->Run(tasks);
+  }
+}
+
+void CSSStaticLayout::LayoutChild(LayoutObject* child,
+                                  int left,
+                                  int top,
+                                  int right,
+                                  int bottom) {
+  vector<LayoutWorkerPool::Task>* tasks = pending_layouts.Get();
+  if (tasks != NULL && IsIndependent(child)) {
+    tasks->push_back(LayoutWorkerPool::Task(child, left, top, right, bottom));
+  } else {
+    child->Layout(left, top, right, bottom);
+  }
 }
 
 void CSSStaticLayout::LayoutWhenDisplayNone(LayoutObject* renderer) {
+  ContainerNode::ChildCursor children(renderer);
   for (int i = 0; i < renderer->GetChildCount(); i++) {
-    LayoutObject* child = (LayoutObject*)renderer->Find(i);
+    LayoutObject* child = (LayoutObject*)children.Find(i);
     child->Layout(0, 0, 0, 0);
   }
 }
@@ -635,9 +753,10 @@ void CSSStaticLayout::LayoutRowWrap(LayoutObject* renderer,
   // child_list中所有flex-item
   vector<LayoutObject*> child_list;
   child_list.reserve(renderer->GetChildCount());
+  ContainerNode::ChildCursor children(renderer);
   for (int index = 0, child_view_count = renderer->GetChildCount();
        index < child_view_count; index++) {
-    LayoutObject* child = (LayoutObject*)renderer->Find(index);
+    LayoutObject* child = (LayoutObject*)children.Find(index);
     const CSSStyle* child_style = &(child->css_style());
 
     if (child_style->css_display_type_ != CSS_DISPLAY_FLEX) {
@@ -803,7 +922,7 @@ void CSSStaticLayout::LayoutRowWrap(LayoutObject* renderer,
                   : b - adjust_height;
         }
 
-        recalc_child->Layout(l, t, r, b);
+        LayoutChild(recalc_child, l, t, r, b);
 
         child_origin_x += recalc_child->measured_size_.width_ +
                           recalc_child_style->margin_right_;
@@ -843,9 +962,10 @@ void CSSStaticLayout::LayoutRowOneLine(LayoutObject* renderer,
   child_list.reserve(renderer->GetChildCount());
 
   // 计算所有flex-item的总width
+  ContainerNode::ChildCursor children(renderer);
   for (int index = 0, child_view_count = renderer->GetChildCount();
        index < child_view_count; index++) {
-    LayoutObject* child = (LayoutObject*)renderer->Find(index);
+    LayoutObject* child = (LayoutObject*)children.Find(index);
     const CSSStyle* child_style = &(child->css_style());
 
     if (child_style->css_display_type_ != CSS_DISPLAY_FLEX) {
@@ -953,7 +1073,7 @@ void CSSStaticLayout::LayoutRowOneLine(LayoutObject* renderer,
     int b = CSS_IS_UNDEFINED(adjust_height)
                 ? child_origin_y + child->measured_size_.height_ + adjust_y
                 : child_origin_y + adjust_height;
-    child->Layout(l, t, r, b);
+    LayoutChild(child, l, t, r, b);
 
     child_origin_x += child->measured_size_.width_ + child_style->margin_right_;
     child_origin_y = old_child_origin_y;
@@ -1004,9 +1124,10 @@ void CSSStaticLayout::LayoutColumnWrap(LayoutObject* renderer,
   // child_list中所有flex-item
   vector<LayoutObject*> child_list;
   child_list.reserve(renderer->GetChildCount());
+  ContainerNode::ChildCursor children(renderer);
   for (int index = 0, child_view_count = renderer->GetChildCount();
        index < child_view_count; index++) {
-    LayoutObject* child = (LayoutObject*)renderer->Find(index);
+    LayoutObject* child = (LayoutObject*)children.Find(index);
     const CSSStyle* child_style = &(child->css_style());
 
     if (child_style->css_display_type_ != CSS_DISPLAY_FLEX) {
@@ -1173,7 +1294,7 @@ void CSSStaticLayout::LayoutColumnWrap(LayoutObject* renderer,
                   : r - adjust_width;
         }
 
-        recalc_child->Layout(l, t, r, b);
+        LayoutChild(recalc_child, l, t, r, b);
 
         child_origin_x = old_child_origin_x;
         child_origin_y += recalc_child->measured_size_.height_ +
@@ -1212,9 +1333,10 @@ void CSSStaticLayout::LayoutColumnOneLine(LayoutObject* renderer,
   child_list.reserve(renderer->GetChildCount());
 
   // 计算所有flex-item的总width
+  ContainerNode::ChildCursor children(renderer);
   for (int index = 0, child_view_count = renderer->GetChildCount();
        index < child_view_count; index++) {
-    LayoutObject* child = (LayoutObject*)renderer->Find(index);
+    LayoutObject* child = (LayoutObject*)children.Find(index);
     const CSSStyle* child_style = &(child->css_style());
     if (child_style->css_display_type_ != CSS_DISPLAY_FLEX) {
       child->Layout(0, 0, 0, 0);
@@ -1323,7 +1445,7 @@ void CSSStaticLayout::LayoutColumnOneLine(LayoutObject* renderer,
                 : adjust_width + child_origin_x;
     int b = child_origin_y + child->measured_size_.height_;
 
-    child->Layout(l, t, r, b);
+    LayoutChild(child, l, t, r, b);
 
     child_origin_x = old_child_origin_x;
     child_origin_y +=
@@ -1492,7 +1614,7 @@ void CSSStaticLayout::LayoutFixedOrAbsolute(LayoutObject* parent,
     b = t + child->measured_size_.height_;
   }
 
-  child->Layout(l, t, r, b);
+  LayoutChild(child, l, t, r, b);
 }
 
 int CSSStaticLayout::CalculateOffsetWithFlexContainerStyle(LayoutObject* parent,
@@ -6,10 +6,12 @@
 #include <vector>
 
 #include "base/size.h"
+#include "layout/container_node.h"
 
 namespace lynx {
 
 class LayoutObject;
+class LayoutWorkerPool;
 class CSSStaticLayout {
  public:
   static base::Size Measure(LayoutObject* renderer,
@@ -29,13 +31,33 @@ class CSSStaticLayout {
                                int width_mode,
                                int height,
                                int height_mode);
+  // Measures a child without flex in a line of |width| by |height|, the
+  // same way for the line breaking of wrapped containers and for the line
+  // itself, so that each child is measured once per pass. The size offered
+  // does not depend on where in the line the child ends up.
+  static base::Size MeasureRowItem(LayoutObject* child, int width, int height);
+  static base::Size MeasureColumnItem(LayoutObject* child,
+                                      int width,
+                                      int height);
+  // The descriptors MeasureRowItem and MeasureColumnItem measure with.
+  static void RowItemDescriptors(LayoutObject* child,
+                                 int width,
+                                 int height,
+                                 int* width_descriptor,
+                                 int* height_descriptor);
+  static void ColumnItemDescriptors(LayoutObject* child,
+                                    int width,
+                                    int height,
+                                    int* width_descriptor,
+                                    int* height_descriptor);
   static base::Size MeasureRowOneLine(LayoutObject* renderer,
                                       int width,
                                       int width_mode,
                                       int height,
                                       int height_mode,
                                       int start,
-                                      int end);
+                                      int end,
+                                      ContainerNode::ChildCursor* children);
   static base::Size MeasureRowWrap(LayoutObject* renderer,
                                    int width,
                                    int width_mode,
@@ -52,7 +74,8 @@ class CSSStaticLayout {
                                          int height,
                                          int height_mode,
                                          int start,
-                                         int end);
+                                         int end,
+                                         ContainerNode::ChildCursor* children);
   static base::Size MeasureColumnWrap(LayoutObject* renderer,
                                       int width,
                                       int width_mode,
@@ -100,6 +123,24 @@ class CSSStaticLayout {
                                     int width,
                                     int height);
 
+  // Relayout boundaries and absolute children with children of their own
+  // do not depend on their siblings, so they can be measured and laid out
+  // on the current LayoutWorkerPool.
+  static bool IsIndependent(LayoutObject* child);
+  // Measures the dirty independent children on the pool up front, with the
+  // descriptors the measure pass of the parent offers them for |width| and
+  // |height|, so that pass finds their sizes in the measure cache.
+  static void MeasureIndependentChildren(LayoutObject* renderer,
+                                         int width,
+                                         int height,
+                                         LayoutWorkerPool* pool);
+  // Lays the child out, or queues it while its parent fans out.
+  static void LayoutChild(LayoutObject* child,
+                          int left,
+                          int top,
+                          int right,
+                          int bottom);
+
   static int CalculateOffsetWithFlexContainerStyle(LayoutObject* parent,
                                                    LayoutObject* child,
                                                    int width,
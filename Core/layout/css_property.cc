@@ -0,0 +1,56 @@
+// Copyright 2017 The Lynx Authors. All rights reserved.
+
+#include "layout/css_property.h"
+
+#include <string.h>
+
+namespace lynx {
+
+namespace {
+const char* const kPropertyNames[] = {
+#define CSS_PROPERTY_NAME(id, setter, name, parser) name,
+    CSS_PROPERTY_LIST(CSS_PROPERTY_NAME)
+#undef CSS_PROPERTY_NAME
+};
+
+bool NameEquals(const char* name, size_t length, const char* expected) {
+  return strlen(expected) == length && memcmp(name, expected, length) == 0;
+}
+}  // namespace
+
+CSSPropertyID CSSPropertyIDForName(const char* name, size_t length) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; ++i) {
+    hash = (hash ^ static_cast<unsigned char>(name[i])) * 16777619u;
+  }
+  // A matching hash only names a candidate, the name itself decides.
+  switch (hash) {
+#define CSS_PROPERTY_CASE(id, setter, property_name, parser)           \
+  case CSSPropertyHash(property_name):                                 \
+    return NameEquals(name, length, property_name) ? CSS_PROPERTY_##id \
+                                                   : CSS_PROPERTY_INVALID;
+    CSS_PROPERTY_LIST(CSS_PROPERTY_CASE)
+#undef CSS_PROPERTY_CASE
+#define CSS_PROPERTY_ALIAS_CASE(id, alias)                     \
+  case CSSPropertyHash(alias):                                 \
+    return NameEquals(name, length, alias) ? CSS_PROPERTY_##id \
+                                           : CSS_PROPERTY_INVALID;
+    CSS_PROPERTY_ALIAS_LIST(CSS_PROPERTY_ALIAS_CASE)
+#undef CSS_PROPERTY_ALIAS_CASE
+    default:
+      return CSS_PROPERTY_INVALID;
+  }
+}
+
+CSSPropertyID CSSPropertyIDForName(const std::string& name) {
+  return CSSPropertyIDForName(name.data(), name.length());
+}
+
+const char* CSSPropertyName(CSSPropertyID id) {
+  if (id < 0 || id >= CSS_PROPERTY_COUNT) {
+    return "";
+  }
+  return kPropertyNames[id];
+}
+
+}  // namespace lynx
@@ -0,0 +1,138 @@
+// Copyright 2017 The Lynx Authors. All rights reserved.
+
+#ifndef LYNX_LAYOUT_CSS_PROPERTY_H_
+#define LYNX_LAYOUT_CSS_PROPERTY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+namespace lynx {
+
+// Every style property CSSStyle understands: its id, the CSSStyle setter,
+// its css name and the kind of value it takes, see CSSValue::Parse.
+#define CSS_PROPERTY_LIST(V)                                                          \
+  V(WIDTH, SetWidth, "width", Length)                                                 \
+  V(HEIGHT, SetHeight, "height", Length)                                              \
+  V(LEFT, SetLeft, "left", Length)                                                    \
+  V(RIGHT, SetRight, "right", Length)                                                 \
+  V(TOP, SetTop, "top", Length)                                                       \
+  V(BOTTOM, SetBottom, "bottom", Length)                                              \
+  V(MIN_WIDTH, SetMinWidth, "min-width", Length)                                      \
+  V(MAX_WIDTH, SetMaxWidth, "max-width", Length)                                      \
+  V(MIN_HEIGHT, SetMinHeight, "min-height", Length)                                   \
+  V(MAX_HEIGHT, SetMaxHeight, "max-height", Length)                                   \
+  V(MARGIN_LEFT, SetMarginLeft, "margin-left", Length)                                \
+  V(MARGIN_RIGHT, SetMarginRight, "margin-right", Length)                             \
+  V(MARGIN_TOP, SetMarginTop, "margin-top", Length)                                   \
+  V(MARGIN_BOTTOM, SetMarginBottom, "margin-bottom", Length)                          \
+  V(PADDING_LEFT, SetPaddingLeft, "padding-left", Length)                             \
+  V(PADDING_RIGHT, SetPaddingRight, "padding-right", Length)                          \
+  V(PADDING_TOP, SetPaddingTop, "padding-top", Length)                                \
+  V(PADDING_BOTTOM, SetPaddingBottom, "padding-bottom", Length)                       \
+  V(VISIBLE, SetVisible, "visible", Visible)                                          \
+  V(BACKGROUND_COLOR, SetBackgroundColor, "background-color", Color)                  \
+  V(COLOR, SetFontColor, "color", Color)                                              \
+  V(BORDER_WIDTH, SetBorderWidth, "border-width", Length)                             \
+  V(BORDER_COLOR, SetBorderColor, "border-color", Color)                              \
+  V(BORDER_RADIUS, SetBorderRadius, "border-radius", Length)                          \
+  V(OPACITY, SetOpacity, "opacity", Number)                                           \
+  V(FLEX, SetFlex, "flex", Number)                                                    \
+  V(FLEX_DIRECTION, SetFlexDirection, "flex-direction", FlexDirection)                \
+  V(FLEX_WRAP, SetFlexWrap, "flex-wrap", FlexWrap)                                    \
+  V(ORDER, SetFlexOrder, "order", Number)                                             \
+  V(JUSTIFY_CONTENT, SetFlexJustify, "justify-content", FlexJustify)                  \
+  V(ALIGN_ITEMS, SetFlexAlignItem, "align-items", FlexAlign)                          \
+  V(ALIGN_SELF, SetFlexAlignSelf, "align-self", FlexAlign)                            \
+  V(POSITION, SetPositionType, "position", Position)                                  \
+  V(FONT_WEIGHT, SetFontWeight, "font-weight", FontWeight)                            \
+  V(FONT_SIZE, SetFontSize, "font-size", Length)                                      \
+  V(TEXT_OVERFLOW, SetTextOverflow, "text-overflow", TextOverflow)                    \
+  V(WHITE_SPACE, SetTextWhiteSpace, "white-space", WhiteSpace)                        \
+  V(TEXT_ALIGN, setTextAlign, "text-align", TextAlign)                                \
+  V(TEXT_DECORATION, SetTextDecoration, "text-decoration", TextDecoration)            \
+  V(DISPLAY, SetDisplayType, "display", Display)                                      \
+  V(OBJECT_FIT, SetObjectFit, "object-fit", ObjectFit)                                \
+  V(Z_INDEX, SetZIndex, "z-index", Number)                                            \
+  V(LINE_HEIGHT, SetLineHeight, "line-height", Length)                                \
+  V(POINTER_EVENTS, SetPointerEvents, "pointer-events", PointerEvents)                \
+  V(BACKGROUND_IMAGE, SetBackgroundImage, "background-image", Url)                    \
+  V(BACKGROUND_REPEAT, SetBackgroundRepeat, "background-repeat", BackgroundRepeat)    \
+  V(BACKGROUND_SIZE, SetBackgroundSize, "background-size", String)                    \
+  V(BACKGROUND_POSITION, SetBackgroundPosition, "background-position", String)        \
+  V(BACKGROUND_POSITION_X, SetBackgroundPositionX, "background-position-x", Length)   \
+  V(BACKGROUND_POSITION_Y, SetBackgroundPositionY, "background-position-y", Length)
+
+// The camelCase names the scripts use, and the id each stands for.
+#define CSS_PROPERTY_ALIAS_LIST(V)                                           \
+  V(MIN_WIDTH, "minWidth")                                                   \
+  V(MAX_WIDTH, "maxWidth")                                                   \
+  V(MIN_HEIGHT, "minHeight")                                                 \
+  V(MAX_HEIGHT, "maxHeight")                                                 \
+  V(MARGIN_LEFT, "marginLeft")                                               \
+  V(MARGIN_RIGHT, "marginRight")                                             \
+  V(MARGIN_TOP, "marginTop")                                                 \
+  V(MARGIN_BOTTOM, "marginBottom")                                           \
+  V(PADDING_LEFT, "paddingLeft")                                             \
+  V(PADDING_RIGHT, "paddingRight")                                           \
+  V(PADDING_TOP, "paddingTop")                                               \
+  V(PADDING_BOTTOM, "paddingBottom")                                         \
+  V(BACKGROUND_COLOR, "backgroundColor")                                     \
+  V(BORDER_WIDTH, "borderWidth")                                             \
+  V(BORDER_COLOR, "borderColor")                                             \
+  V(BORDER_RADIUS, "borderRadius")                                           \
+  V(FLEX_DIRECTION, "flexDirection")                                         \
+  V(FLEX_WRAP, "flexWrap")                                                   \
+  V(JUSTIFY_CONTENT, "justifyContent")                                       \
+  V(ALIGN_ITEMS, "alignItems")                                               \
+  V(ALIGN_SELF, "alignSelf")                                                 \
+  V(FONT_WEIGHT, "fontWeight")                                               \
+  V(FONT_SIZE, "fontSize")                                                   \
+  V(TEXT_OVERFLOW, "textOverflow")                                           \
+  V(WHITE_SPACE, "whiteSpace")                                               \
+  V(TEXT_ALIGN, "textAlign")                                                 \
+  V(TEXT_DECORATION, "textDecoration")                                       \
+  V(OBJECT_FIT, "objectFit")                                                 \
+  V(Z_INDEX, "zIndex")                                                       \
+  V(LINE_HEIGHT, "lineHeight")                                               \
+  V(POINTER_EVENTS, "pointerEvents")                                         \
+  V(BACKGROUND_IMAGE, "backgroundImage")                                     \
+  V(BACKGROUND_REPEAT, "backgroundRepeat")                                   \
+  V(BACKGROUND_SIZE, "backgroundSize")                                       \
+  V(BACKGROUND_POSITION, "backgroundPosition")                               \
+  V(BACKGROUND_POSITION_X, "backgroundPositionX")                            \
+  V(BACKGROUND_POSITION_Y, "backgroundPositionY")
+
+// Dense ids of the style properties, so that a parsed style can be kept
+// as (id, value) pairs and applied again without looking names up.
+enum CSSPropertyID {
+  CSS_PROPERTY_INVALID = -1,
+#define DECLARE_CSS_PROPERTY_ID(id, setter, name, parser) CSS_PROPERTY_##id,
+  CSS_PROPERTY_LIST(DECLARE_CSS_PROPERTY_ID)
+#undef DECLARE_CSS_PROPERTY_ID
+  CSS_PROPERTY_COUNT,
+};
+
+// FNV-1a of a property name. Evaluated by the compiler for the names in
+// the lists above, so that two names of the same hash do not compile.
+constexpr uint32_t CSSPropertyHash(const char* name,
+                                   uint32_t hash = 2166136261u) {
+  return *name == '\0'
+             ? hash
+             : CSSPropertyHash(
+                   name + 1,
+                   (hash ^ static_cast<unsigned char>(*name)) * 16777619u);
+}
+
+// The id of the property called |name|, in css or camelCase, or
+// CSS_PROPERTY_INVALID.
+CSSPropertyID CSSPropertyIDForName(const char* name, size_t length);
+CSSPropertyID CSSPropertyIDForName(const std::string& name);
+
+// The css name of |id|.
+const char* CSSPropertyName(CSSPropertyID id);
+
+}  // namespace lynx
+
+#endif  // LYNX_LAYOUT_CSS_PROPERTY_H_
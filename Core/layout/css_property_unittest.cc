@@ -0,0 +1,38 @@
+#include "layout/css_property.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace lynx {
+TEST(CSSPropertyTest, IDForNameTest) {
+  EXPECT_EQ(CSS_PROPERTY_WIDTH, CSSPropertyIDForName("width"));
+  EXPECT_EQ(CSS_PROPERTY_MARGIN_LEFT, CSSPropertyIDForName("margin-left"));
+  EXPECT_EQ(CSS_PROPERTY_MARGIN_LEFT, CSSPropertyIDForName("marginLeft"));
+  EXPECT_EQ(CSS_PROPERTY_COLOR, CSSPropertyIDForName("color"));
+  EXPECT_EQ(CSS_PROPERTY_BACKGROUND_POSITION_Y,
+            CSSPropertyIDForName("backgroundPositionY"));
+  EXPECT_EQ(CSS_PROPERTY_INVALID, CSSPropertyIDForName("test"));
+  EXPECT_EQ(CSS_PROPERTY_INVALID, CSSPropertyIDForName(""));
+  EXPECT_EQ(CSS_PROPERTY_INVALID, CSSPropertyIDForName("Width"));
+  EXPECT_EQ(CSS_PROPERTY_INVALID, CSSPropertyIDForName("width "));
+  EXPECT_EQ(CSS_PROPERTY_INVALID, CSSPropertyIDForName("font-color"));
+}
+
+TEST(CSSPropertyTest, NameTest) {
+  for (int id = 0; id < CSS_PROPERTY_COUNT; ++id) {
+    const char* name = CSSPropertyName(static_cast<CSSPropertyID>(id));
+    EXPECT_EQ(id, CSSPropertyIDForName(name));
+  }
+  EXPECT_STREQ("line-height", CSSPropertyName(CSS_PROPERTY_LINE_HEIGHT));
+  EXPECT_STREQ("", CSSPropertyName(CSS_PROPERTY_INVALID));
+  EXPECT_STREQ("", CSSPropertyName(CSS_PROPERTY_COUNT));
+}
+
+TEST(CSSPropertyTest, AliasTest) {
+#define EXPECT_ALIAS(id, alias) \
+  EXPECT_EQ(CSS_PROPERTY_##id, CSSPropertyIDForName(std::string(alias)));
+  CSS_PROPERTY_ALIAS_LIST(EXPECT_ALIAS)
+#undef EXPECT_ALIAS
+}
+}  // namespace lynx
@@ -9,94 +9,11 @@
 namespace lynx {
 
 void CSSStyle::Initialize(CSSStyleConfig* config) {
-  CSSStyleConfig::StyleFuncMap* func_map = config->func_map();
-  (*func_map)["width"] = &CSSStyle::SetWidth;
-  (*func_map)["height"] = &CSSStyle::SetHeight;
-  (*func_map)["left"] = &CSSStyle::SetLeft;
-  (*func_map)["right"] = &CSSStyle::SetRight;
-  (*func_map)["top"] = &CSSStyle::SetTop;
-  (*func_map)["bottom"] = &CSSStyle::SetBottom;
-  (*func_map)["minWidth"] = &CSSStyle::SetMinWidth;
-  (*func_map)["min-width"] = &CSSStyle::SetMinWidth;
-  (*func_map)["maxWidth"] = &CSSStyle::SetMaxWidth;
-  (*func_map)["max-width"] = &CSSStyle::SetMaxWidth;
-  (*func_map)["minHeight"] = &CSSStyle::SetMinHeight;
-  (*func_map)["min-height"] = &CSSStyle::SetMinHeight;
-  (*func_map)["maxHeight"] = &CSSStyle::SetMaxHeight;
-  (*func_map)["max-height"] = &CSSStyle::SetMaxHeight;
-  (*func_map)["marginLeft"] = &CSSStyle::SetMarginLeft;
-  (*func_map)["margin-left"] = &CSSStyle::SetMarginLeft;
-  (*func_map)["marginRight"] = &CSSStyle::SetMarginRight;
-  (*func_map)["margin-right"] = &CSSStyle::SetMarginRight;
-  (*func_map)["marginTop"] = &CSSStyle::SetMarginTop;
-  (*func_map)["margin-top"] = &CSSStyle::SetMarginTop;
-  (*func_map)["marginBottom"] = &CSSStyle::SetMarginBottom;
-  (*func_map)["margin-bottom"] = &CSSStyle::SetMarginBottom;
-  (*func_map)["paddingLeft"] = &CSSStyle::SetPaddingLeft;
-  (*func_map)["padding-left"] = &CSSStyle::SetPaddingLeft;
-  (*func_map)["paddingRight"] = &CSSStyle::SetPaddingRight;
-  (*func_map)["padding-right"] = &CSSStyle::SetPaddingRight;
-  (*func_map)["paddingTop"] = &CSSStyle::SetPaddingTop;
-  (*func_map)["padding-top"] = &CSSStyle::SetPaddingTop;
-  (*func_map)["paddingBottom"] = &CSSStyle::SetPaddingBottom;
-  (*func_map)["padding-bottom"] = &CSSStyle::SetPaddingBottom;
-  (*func_map)["visible"] = &CSSStyle::SetVisible;
-  (*func_map)["backgroundColor"] = &CSSStyle::SetBackgroundColor;
-  (*func_map)["background-color"] = &CSSStyle::SetBackgroundColor;
-  (*func_map)["color"] = &CSSStyle::SetFontColor;
-  (*func_map)["borderWidth"] = &CSSStyle::SetBorderWidth;
-  (*func_map)["border-width"] = &CSSStyle::SetBorderWidth;
-  (*func_map)["borderColor"] = &CSSStyle::SetBorderColor;
-  (*func_map)["border-color"] = &CSSStyle::SetBorderColor;
-  (*func_map)["borderRadius"] = &CSSStyle::SetBorderRadius;
-  (*func_map)["border-radius"] = &CSSStyle::SetBorderRadius;
-  (*func_map)["opacity"] = &CSSStyle::SetOpacity;
-  (*func_map)["flex"] = &CSSStyle::SetFlex;
-  (*func_map)["flexDirection"] = &CSSStyle::SetFlexDirection;
-  (*func_map)["flex-direction"] = &CSSStyle::SetFlexDirection;
-  (*func_map)["flexWrap"] = &CSSStyle::SetFlexWrap;
-  (*func_map)["flex-wrap"] = &CSSStyle::SetFlexWrap;
-  (*func_map)["order"] = &CSSStyle::SetFlexOrder;
-  (*func_map)["justifyContent"] = &CSSStyle::SetFlexJustify;
-  (*func_map)["justify-content"] = &CSSStyle::SetFlexJustify;
-  (*func_map)["alignItems"] = &CSSStyle::SetFlexAlignItem;
-  (*func_map)["align-items"] = &CSSStyle::SetFlexAlignItem;
-  (*func_map)["alignSelf"] = &CSSStyle::SetFlexAlignSelf;
-  (*func_map)["align-self"] = &CSSStyle::SetFlexAlignSelf;
-  (*func_map)["position"] = &CSSStyle::SetPositionType;
-  (*func_map)["fontWeight"] = &CSSStyle::SetFontWeight;
-  (*func_map)["font-weight"] = &CSSStyle::SetFontWeight;
-  (*func_map)["fontSize"] = &CSSStyle::SetFontSize;
-  (*func_map)["font-size"] = &CSSStyle::SetFontSize;
-  (*func_map)["textOverflow"] = &CSSStyle::SetTextOverflow;
-  (*func_map)["text-overflow"] = &CSSStyle::SetTextOverflow;
-  (*func_map)["whiteSpace"] = &CSSStyle::SetTextWhiteSpace;
-  (*func_map)["white-space"] = &CSSStyle::SetTextWhiteSpace;
-  (*func_map)["textAlign"] = &CSSStyle::setTextAlign;
-  (*func_map)["text-align"] = &CSSStyle::setTextAlign;
-  (*func_map)["textDecoration"] = &CSSStyle::SetTextDecoration;
-  (*func_map)["text-decoration"] = &CSSStyle::SetTextDecoration;
-  (*func_map)["display"] = &CSSStyle::SetDisplayType;
-  (*func_map)["objectFit"] = &CSSStyle::SetObjectFit;
-  (*func_map)["object-fit"] = &CSSStyle::SetObjectFit;
-  (*func_map)["zIndex"] = &CSSStyle::SetZIndex;
-  (*func_map)["z-index"] = &CSSStyle::SetZIndex;
-  (*func_map)["line-height"] = &CSSStyle::SetLineHeight;
-  (*func_map)["lineHeight"] = &CSSStyle::SetLineHeight;
-  (*func_map)["pointer-events"] = &CSSStyle::SetPointerEvents;
-  (*func_map)["pointerEvents"] = &CSSStyle::SetPointerEvents;
-  (*func_map)["backgroundImage"] = &CSSStyle::SetBackgroundImage;
-  (*func_map)["background-image"] = &CSSStyle::SetBackgroundImage;
-  (*func_map)["backgroundRepeat"] = &CSSStyle::SetBackgroundRepeat;
-  (*func_map)["background-repeat"] = &CSSStyle::SetBackgroundRepeat;
-  (*func_map)["backgroundSize"] = &CSSStyle::SetBackgroundSize;
-  (*func_map)["background-size"] = &CSSStyle::SetBackgroundSize;
-  (*func_map)["backgroundPosition"] = &CSSStyle::SetBackgroundPosition;
-  (*func_map)["background-position"] = &CSSStyle::SetBackgroundPosition;
-  (*func_map)["backgroundPositionX"] = &CSSStyle::SetBackgroundPositionX;
-  (*func_map)["background-position-x"] = &CSSStyle::SetBackgroundPositionX;
-  (*func_map)["backgroundPositionY"] = &CSSStyle::SetBackgroundPositionY;
-  (*func_map)["background-position-y"] = &CSSStyle::SetBackgroundPositionY;
+  CSSStyleConfig::StyleFunc* func_table = config->func_table();
+#define CSS_PROPERTY_SETTER(id, setter, name, parser) \
+  func_table[CSS_PROPERTY_##id] = &CSSStyle::setter;
+  CSS_PROPERTY_LIST(CSS_PROPERTY_SETTER)
+#undef CSS_PROPERTY_SETTER
 }
 
 CSSStyle::CSSStyle() {
@@ -183,39 +100,106 @@ void CSSStyle::Reset() {
 }
 
 bool CSSStyle::ToPx(const std::string& value, double& px) {
-  if (value.empty()) return false;
-
-  bool is_px = false;
-  std::string px_str = value;
-  size_t start = value.length() - kPX.length();
-  if (start > 0 && value.find(kPX, start - 1) != std::string::npos) {
-    is_px = true;
-    px_str = value.substr(0, start);
-  }
+  CSSValue length;
+  return CSSValue::ParseLength(value, length) && ToPx(length, px);
+}
 
-  double d;
-  if (UNLIKELY(!base::StringToDouble(px_str, d))) {
-    return false;
-  }
-  if (is_px) {
-    px = round(d * density_);
-  } else {
-    px = round(d * density_ * screen_width_ / zoom_ratio_);
+bool CSSStyle::ToPx(const CSSValue& value, double& px) {
+  switch (value.type()) {
+    case CSSValue::CSS_VALUE_PX:
+      px = round(value.number() * density_);
+      return true;
+    case CSSValue::CSS_VALUE_NUMBER:
+      px = round(value.number() * density_ * screen_width_ / zoom_ratio_);
+      return true;
+    default:
+      return false;
   }
-  return true;
 }
 
 bool CSSStyle::SetValue(const std::string& name, const std::string& value) {
-  CSSStyleConfig::StyleFuncMap* func_map = config_->func_map();
-  CSSStyleConfig::StyleFuncMap::iterator iter = func_map->find(name);
+  return SetValue(CSSPropertyIDForName(name), value);
+}
 
-  if (iter == func_map->end())
+bool CSSStyle::SetValue(CSSPropertyID id, const std::string& value) {
+  return SetValue(id, CSSValue::Parse(id, value));
+}
+
+bool CSSStyle::SetValue(CSSPropertyID id, const CSSValue& value) {
+  if (id < 0 || id >= CSS_PROPERTY_COUNT)
     return false;
-  CSSStyleConfig::StyleFunc func = iter->second;
+  CSSStyleConfig::StyleFunc func = config_->func_table()[id];
   (this->*func)(value);
   return true;
 }
 
+bool CSSStyle::Equals(const CSSStyle& other) const {
+  return width_ == other.width_ && height_ == other.height_ &&
+         left_ == other.left_ && right_ == other.right_ &&
+         top_ == other.top_ && bottom_ == other.bottom_ &&
+         min_width_ == other.min_width_ && max_width_ == other.max_width_ &&
+         min_height_ == other.min_height_ &&
+         max_height_ == other.max_height_ &&
+         margin_left_ == other.margin_left_ &&
+         margin_right_ == other.margin_right_ &&
+         margin_top_ == other.margin_top_ &&
+         margin_bottom_ == other.margin_bottom_ &&
+         padding_left_ == other.padding_left_ &&
+         padding_right_ == other.padding_right_ &&
+         padding_top_ == other.padding_top_ &&
+         padding_bottom_ == other.padding_bottom_ &&
+         visible_ == other.visible_ &&
+         background_color_ == other.background_color_ &&
+         border_width_ == other.border_width_ &&
+         border_color_ == other.border_color_ &&
+         border_radius_ == other.border_radius_ &&
+         opacity_ == other.opacity_ &&
+         background_image_ == other.background_image_ &&
+         background_repeat_ == other.background_repeat_ &&
+         background_width_ == other.background_width_ &&
+         background_height_ == other.background_height_ &&
+         background_position_x_ == other.background_position_x_ &&
+         background_position_y_ == other.background_position_y_ &&
+         font_color_ == other.font_color_ && font_size_ == other.font_size_ &&
+         font_weight_ == other.font_weight_ &&
+         text_overflow_ == other.text_overflow_ &&
+         text_white_space_ == other.text_white_space_ &&
+         text_align_ == other.text_align_ &&
+         text_decoration_ == other.text_decoration_ &&
+         line_height_ == other.line_height_ && flex_ == other.flex_ &&
+         flex_direction_ == other.flex_direction_ &&
+         flex_wrap_ == other.flex_wrap_ &&
+         flex_justify_content_ == other.flex_justify_content_ &&
+         flex_align_items_ == other.flex_align_items_ &&
+         flex_order_ == other.flex_order_ &&
+         flex_align_self_ == other.flex_align_self_ &&
+         css_position_type_ == other.css_position_type_ &&
+         css_display_type_ == other.css_display_type_ &&
+         css_object_fit_ == other.css_object_fit_ &&
+         pointer_events_ == other.pointer_events_ &&
+         zindex_ == other.zindex_ && config_ == other.config_ &&
+         density_ == other.density_ && screen_width_ == other.screen_width_ &&
+         zoom_ratio_ == other.zoom_ratio_;
+}
+
+size_t CSSStyle::Hash() const {
+  // Box sizes, direction and colors tell the styles of a page apart, the
+  // remaining fields are left to Equals.
+  const double sizes[] = {width_,         height_,        margin_left_,
+                          margin_right_,  margin_top_,    margin_bottom_,
+                          padding_left_,  padding_right_, padding_top_,
+                          padding_bottom_, flex_,         font_size_};
+  size_t hash = 0;
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    hash = hash * 31 + static_cast<size_t>(static_cast<long long>(sizes[i]));
+  }
+  hash = hash * 31 + flex_direction_;
+  hash = hash * 31 + css_position_type_;
+  hash = hash * 31 + background_color_.Cast();
+  hash = hash * 31 + font_color_.Cast();
+  return hash;
+}
+
 double CSSStyle::ClampWidthInner(double width) const {
   if (width < min_width_)
     width = min_width_;
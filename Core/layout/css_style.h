@@ -16,7 +16,9 @@
 
 #include "layout/css_color.h"
 #include "layout/css_layout.h"
+#include "layout/css_property.h"
 #include "layout/css_type.h"
+#include "layout/css_value.h"
 
 
 namespace lynx {
@@ -33,6 +35,19 @@ class CSSStyle {
 
   bool SetValue(const std::string& name, const std::string& value);
 
+  // Sets a property already looked up, see CSSPropertyIDForName.
+  bool SetValue(CSSPropertyID id, const std::string& value);
+
+  // Sets a value parsed beforehand, see CSSValue::Parse.
+  bool SetValue(CSSPropertyID id, const CSSValue& value);
+
+  // Whether every field of |other|, config included, equals this one.
+  bool Equals(const CSSStyle& other) const;
+
+  // A hash over the fields that tell styles apart most often, consistent
+  // with Equals.
+  size_t Hash() const;
+
   double ClampWidth() const;
 
   double ClampHeight() const;
@@ -57,9 +72,9 @@ class CSSStyle {
 
   int margin_bottom() const { return margin_bottom_; }
 
-  CSSStyleType css_position_type() { return css_position_type_; }
+  CSSStyleType css_position_type() const { return css_position_type_; }
 
-  CSSStyleType flex_direction() { return flex_direction_; }
+  CSSStyleType flex_direction() const { return flex_direction_; }
 
   void set_flex_direction(CSSStyleType flex_direction) {
     flex_direction_ = flex_direction;
@@ -67,15 +82,16 @@ class CSSStyle {
 
   CSSColor& background_color() { return background_color_; }
 
-  int opacity() { return opacity_; }
+  int opacity() const { return opacity_; }
 
-  int border_radius() { return border_radius_; }
+  int border_radius() const { return border_radius_; }
 
-  int border_width() { return border_width_; }
+  int border_width() const { return border_width_; }
 
   static void Initialize(CSSStyleConfig* config);
 
   friend class CSSStaticLayout;
+  friend class CSSFlatLayout;
   friend class InspectorCSSAgent;
 
  private:
@@ -85,280 +101,298 @@ class CSSStyle {
 
   bool ToPx(const std::string& value, double& px);
 
+  bool ToPx(const CSSValue& value, double& px);
+
+  static bool ToNumber(const CSSValue& value, double& number) {
+    if (value.type() != CSSValue::CSS_VALUE_NUMBER)
+      return false;
+    number = value.number();
+    return true;
+  }
+
+  static bool ToColor(const CSSValue& value, CSSColor& color) {
+    if (value.type() != CSSValue::CSS_VALUE_COLOR)
+      return false;
+    color = value.color();
+    return true;
+  }
+
+  template <typename T>
+  static bool ToKeyword(const CSSValue& value, T& type) {
+    if (value.type() != CSSValue::CSS_VALUE_KEYWORD)
+      return false;
+    type = static_cast<T>(value.keyword());
+    return true;
+  }
+
   void Reset();
 
-  void SetWidth(const std::string& value) {
+  void SetWidth(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, width_))) {
       width_ = CSS_UNDEFINED;
     }
   }
 
-  void SetHeight(const std::string& value) {
+  void SetHeight(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, height_))) {
       height_ = CSS_UNDEFINED;
     }
   }
 
-  void SetLeft(const std::string& value) {
+  void SetLeft(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, left_))) {
       left_ = CSS_UNDEFINED;
     }
   }
 
-  void SetRight(const std::string& value) {
+  void SetRight(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, right_))) {
       right_ = CSS_UNDEFINED;
     }
   }
 
-  void SetTop(const std::string& value) {
+  void SetTop(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, top_))) {
       top_ = CSS_UNDEFINED;
     }
   }
 
-  void SetBottom(const std::string& value) {
+  void SetBottom(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, bottom_))) {
       bottom_ = CSS_UNDEFINED;
     }
   }
 
-  void SetMaxWidth(const std::string& value) {
+  void SetMaxWidth(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, max_width_))) {
       max_width_ = CSS_UNDEFINED;
     }
   }
 
-  void SetMaxHeight(const std::string& value) {
+  void SetMaxHeight(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, max_height_))) {
       max_height_ = CSS_UNDEFINED;
     }
   }
 
-  void SetMarginLeft(const std::string& value) {
+  void SetMarginLeft(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, margin_left_))) {
       margin_left_ = 0;
     }
   }
 
-  void SetMarginRight(const std::string& value) {
+  void SetMarginRight(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, margin_right_))) {
       margin_right_ = 0;
     }
   }
 
-  void SetMarginTop(const std::string& value) {
+  void SetMarginTop(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, margin_top_))) {
       margin_top_ = 0;
     }
   }
 
-  void SetMarginBottom(const std::string& value) {
+  void SetMarginBottom(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, margin_bottom_))) {
       margin_bottom_ = 0;
     }
   }
 
-  void SetPaddingLeft(const std::string& value) {
+  void SetPaddingLeft(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, padding_left_))) {
       padding_left_ = 0;
     }
   }
 
-  void SetPaddingRight(const std::string& value) {
+  void SetPaddingRight(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, padding_right_))) {
       padding_right_ = 0;
     }
   }
 
-  void SetPaddingTop(const std::string& value) {
+  void SetPaddingTop(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, padding_top_))) {
       padding_top_ = 0;
     }
   }
 
-  void SetPaddingBottom(const std::string& value) {
+  void SetPaddingBottom(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, padding_bottom_))) {
       padding_bottom_ = 0;
     }
   }
 
-  void SetMinWidth(const std::string& value) {
+  void SetMinWidth(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, min_width_))) {
       min_width_ = 0;
     }
   }
 
-  void SetMinHeight(const std::string& value) {
+  void SetMinHeight(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, min_height_))) {
       min_height_ = 0;
     }
   }
 
-  void SetVisible(const std::string& value) {
-    if (UNLIKELY(!ToVisibleType(value, visible_))) {
+  void SetVisible(const CSSValue& value) {
+    if (UNLIKELY(!ToKeyword(value, visible_))) {
     }
   }
 
-  void SetBackgroundColor(const std::string& value) {
-    if (UNLIKELY(!CSSColor::Parse(value, background_color_))) {
+  void SetBackgroundColor(const CSSValue& value) {
+    if (UNLIKELY(!ToColor(value, background_color_))) {
       background_color_ = {0, 0, 0, 0};
     }
   }
 
-  void SetFontColor(const std::string& value) {
-    if (UNLIKELY(!CSSColor::Parse(value, font_color_))) {
+  void SetFontColor(const CSSValue& value) {
+    if (UNLIKELY(!ToColor(value, font_color_))) {
       font_color_ = {0, 0, 0, 1.0f};
     }
   }
 
-  void SetBorderWidth(const std::string& value) {
+  void SetBorderWidth(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, border_width_))) {
       border_width_ = 0;
     }
   }
 
-  void SetBorderColor(const std::string& value) {
-    if (UNLIKELY(!CSSColor::Parse(value, border_color_))) {
+  void SetBorderColor(const CSSValue& value) {
+    if (UNLIKELY(!ToColor(value, border_color_))) {
       border_color_ = {0, 0, 0, 1.0f};
     }
   }
 
-  void SetBorderRadius(const std::string& value) {
+  void SetBorderRadius(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, border_radius_))) {
       border_radius_ = 0;
     }
   }
 
-  void SetOpacity(const std::string& value) {
-    if (UNLIKELY(!base::StringToDouble(value, opacity_))) {
+  void SetOpacity(const CSSValue& value) {
+    if (UNLIKELY(!ToNumber(value, opacity_))) {
       opacity_ = 1;
     }
     opacity_ *= 255;
   }
 
-  void SetFlex(const std::string& value) {
-    if (UNLIKELY(!base::StringToDouble(value, flex_))) {
+  void SetFlex(const CSSValue& value) {
+    if (UNLIKELY(!ToNumber(value, flex_))) {
       flex_ = 1;
     }
   }
 
-  void SetFlexDirection(const std::string& value) {
-    if (UNLIKELY(!ToFlexDirectionType(value, flex_direction_))) {
+  void SetFlexDirection(const CSSValue& value) {
+    if (UNLIKELY(!ToKeyword(value, flex_direction_))) {
     }
   }
 
-  void SetFlexWrap(const std::string& value) {
-    if (UNLIKELY(!ToFlexWrapType(value, flex_wrap_))) {
+  void SetFlexWrap(const CSSValue& value) {
+    if (UNLIKELY(!ToKeyword(value, flex_wrap_))) {
     }
   }
 
-  void SetFlexJustify(const std::string& value) {
-    if (UNLIKELY(!ToFlexJustifyType(value, flex_justify_content_))) {
+  void SetFlexJustify(const CSSValue& value) {
+    if (UNLIKELY(!ToKeyword(value, flex_justify_content_))) {
     }
   }
 
-  void SetFlexAlignItem(const std::string& value) {
-    if (UNLIKELY(!ToFlexAlignType(value, flex_align_items_))) {
+  void SetFlexAlignItem(const CSSValue& value) {
+    if (UNLIKELY(!ToKeyword(value, flex_align_items_))) {
     }
   }
 
-  void SetFlexAlignSelf(const std::string& value) {
-    if (UNLIKELY(!ToFlexAlignType(value, flex_align_self_))) {
+  void SetFlexAlignSelf(const CSSValue& value) {
+    if (UNLIKELY(!ToKeyword(value, flex_align_self_))) {
     }
   }
 
-  void SetFlexOrder(const std::string& value){
+  void SetFlexOrder(const CSSValue& value){
     double flex_order = 0;
-    if(UNLIKELY(!base::StringToDouble(value, flex_order))){
+    if(UNLIKELY(!ToNumber(value, flex_order))){
       flex_order = 0;
     }
     flex_order_ = round(flex_order);
   }
 
-  void SetPositionType(const std::string& value) {
-    if (UNLIKELY(!ToPositionType(value, css_position_type_))) {
+  void SetPositionType(const CSSValue& value) {
+    if (UNLIKELY(!ToKeyword(value, css_position_type_))) {
     }
   }
 
-  void SetDisplayType(const std::string& value) {
-    if (UNLIKELY(!ToDisplayType(value, css_display_type_))) {
+  void SetDisplayType(const CSSValue& value) {
+    if (UNLIKELY(!ToKeyword(value, css_display_type_))) {
     }
   }
 
-  void SetObjectFit(const std::string& value) {
-    if (UNLIKELY(!ToObjectFitType(value, css_object_fit_))) {
+  void SetObjectFit(const CSSValue& value) {
+    if (UNLIKELY(!ToKeyword(value, css_object_fit_))) {
     }
   }
 
-  void SetZIndex(const std::string& value) {
+  void SetZIndex(const CSSValue& value) {
     double zindex = 0;
-    if (UNLIKELY(!base::StringToDouble(value, zindex))) {
+    if (UNLIKELY(!ToNumber(value, zindex))) {
       zindex = 0;
     }
     zindex_ = round(zindex);
   }
 
-  void SetLineHeight(const std::string& value) {
+  void SetLineHeight(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, line_height_))) {
       line_height_ = 0;
     }
   }
 
-  void SetFontSize(const std::string& value) {
+  void SetFontSize(const CSSValue& value) {
     if (UNLIKELY(!ToPx(value, font_size_))) {
       font_size_ = 14 * density_;
     }
   }
 
-  void SetFontWeight(const std::string& value) {
-    if (UNLIKELY(!ToTextFontWeightType(value, font_weight_))) {
+  void SetFontWeight(const CSSValue& value) {
+    if (UNLIKELY(!ToKeyword(value, font_weight_))) {
     }
   }
 
-  void setTextAlign(const std::string& value) {
-    if (UNLIKELY(!ToTextAlignType(value, text_align_))) {
+  void setTextAlign(const CSSValue& value) {
+    if (UNLIKELY(!ToKeyword(value, text_align_))) {
     }
   }
 
-  void SetTextWhiteSpace(const std::string& value) {
-    if (UNLIKELY(!ToTextWhiteSpaceType(value, text_white_space_))) {
+  void SetTextWhiteSpace(const CSSValue& value) {
+    if (UNLIKELY(!ToKeyword(value, text_white_space_))) {
     }
   }
 
-  void SetTextOverflow(const std::string& value) {
-    if (UNLIKELY(!ToTextOverflowType(value, text_overflow_))) {
+  void SetTextOverflow(const CSSValue& value) {
+    if (UNLIKELY(!ToKeyword(value, text_overflow_))) {
     }
   }
 
-  void SetTextDecoration(const std::string& value) {
-    if (UNLIKELY(!ToTextDecorationType(value, text_decoration_))) {
+  void SetTextDecoration(const CSSValue& value) {
+    if (UNLIKELY(!ToKeyword(value, text_decoration_))) {
     }
   }
 
-  void SetPointerEvents(const std::string& value) {
-    if (UNLIKELY(!ToPointerEventsType(value, pointer_events_))) {
+  void SetPointerEvents(const CSSValue& value) {
+    if (UNLIKELY(!ToKeyword(value, pointer_events_))) {
     }
   }
 
-  void SetBackgroundImage(const std::string& value) {
-    auto start = value.find('(');
-    auto end = value.find(')');
-    if (start != std::string::npos && end != std::string::npos) {
-      background_image_ = value.substr(start + 1, end - start - 1);
-    } else {
-      background_image_ = "";
-    }
+  void SetBackgroundImage(const CSSValue& value) {
+    background_image_ = value.string();
   }
 
-  void SetBackgroundRepeat(const std::string& value) {
-    if (UNLIKELY(!ToBackgroundImageRepeatType(value, background_repeat_))) {
+  void SetBackgroundRepeat(const CSSValue& value) {
+    if (UNLIKELY(!ToKeyword(value, background_repeat_))) {
     }
   }
 
-  void SetBackgroundSize(const std::string& value) {
+  void SetBackgroundSize(const CSSValue& value) {
     std::vector<std::string> split_result;
-    base::SplitString(value, ' ', split_result);
+    base::SplitString(value.string(), ' ', split_result);
     if (UNLIKELY(split_result.size() > 0 && !ToPx(split_result[0], background_width_))) {
         background_width_ = CSS_UNDEFINED;
     }
@@ -367,9 +401,9 @@ class CSSStyle {
     }
   }
 
-  void SetBackgroundPosition(const std::string& value) {
+  void SetBackgroundPosition(const CSSValue& value) {
     std::vector<std::string> split_result;
-    base::SplitString(value, ' ', split_result);
+    base::SplitString(value.string(), ' ', split_result);
     if (UNLIKELY(split_result.size() > 0 && !ToPx(split_result[0], background_position_x_))) {
         background_position_x_ = 0;
     }
@@ -378,18 +412,26 @@ class CSSStyle {
     }
   }
 
-  void SetBackgroundPositionX(const std::string& value) {
+  void SetBackgroundPositionX(const CSSValue& value) {
       if (UNLIKELY(!ToPx(value, background_position_x_))) {
           background_position_x_ = 0;
       }
   }
 
-  void SetBackgroundPositionY(const std::string& value) {
+  void SetBackgroundPositionY(const CSSValue& value) {
       if (UNLIKELY(!ToPx(value, background_position_y_))) {
           background_position_y_ = 0;
       }
   }
 
+  // The setters by text, which parse it as CSSValue::Parse does.
+#define CSS_PROPERTY_TEXT_SETTER(id, setter, name, parser) \
+  void setter(const std::string& value) {                  \
+    setter(CSSValue::Parse(CSS_PROPERTY_##id, value));     \
+  }
+  CSS_PROPERTY_LIST(CSS_PROPERTY_TEXT_SETTER)
+#undef CSS_PROPERTY_TEXT_SETTER
+
  public:
   // base css style
   double width_;
@@ -3,24 +3,31 @@
 #ifndef LYNX_LAYOUT_CSS_STYLE_CONFIG_H_
 #define LYNX_LAYOUT_CSS_STYLE_CONFIG_H_
 
-#include <map>
 #include <string>
 
+#include "layout/css_property.h"
+#include "layout/shared_css_style.h"
+
 namespace lynx {
 class CSSStyle;
+class CSSValue;
 class CSSStyleConfig {
  public:
-    typedef void (CSSStyle::*StyleFunc)(const std::string&);
-    typedef std::map<std::string, StyleFunc> StyleFuncMap;
+    typedef void (CSSStyle::*StyleFunc)(const CSSValue&);
+
+    // The setter of each CSSPropertyID.
+    StyleFunc* func_table() {
+        return func_table_;
+    }
 
-    StyleFuncMap* func_map() {
-        return &func_map_;
+    // The styles shared by the nodes of pages using this config.
+    CSSStylePool* style_pool() {
+        return &style_pool_;
     }
 
  private:
-    StyleFuncMap func_map_;
-    
-    
+    StyleFunc func_table_[CSS_PROPERTY_COUNT];
+    CSSStylePool style_pool_;
 };
 }  // namespace lynx
 
@@ -104,6 +104,36 @@ TEST_F(CSSStyleTest, SetBorderColorTest) {
   EXPECT_EQ(CSSColor(0, 0, 0, 1), style()->border_color_);
 }
 
+TEST_F(CSSStyleTest, SetValueTest) {
+  EXPECT_TRUE(style()->SetValue("flexDirection", "column"));
+  EXPECT_EQ(CSSFLEX_DIRECTION_COLUMN, style()->flex_direction_);
+  EXPECT_TRUE(style()->SetValue("flex-direction", "row"));
+  EXPECT_EQ(CSSFLEX_DIRECTION_ROW, style()->flex_direction_);
+  EXPECT_TRUE(style()->SetValue(CSS_PROPERTY_WIDTH, "750"));
+  EXPECT_EQ(525, style()->width_);
+  EXPECT_FALSE(style()->SetValue("test", "750"));
+  EXPECT_FALSE(style()->SetValue(CSS_PROPERTY_INVALID, "750"));
+  EXPECT_FALSE(style()->SetValue(CSS_PROPERTY_COUNT, "750"));
+}
+
+TEST_F(CSSStyleTest, SetParsedValueTest) {
+  EXPECT_TRUE(style()->SetValue(CSS_PROPERTY_WIDTH, CSSValue::MakePx(750)));
+  EXPECT_EQ(1125, style()->width_);
+  EXPECT_TRUE(style()->SetValue(CSS_PROPERTY_HEIGHT, CSSValue::MakeNumber(750)));
+  EXPECT_EQ(525, style()->height_);
+  EXPECT_TRUE(style()->SetValue(CSS_PROPERTY_HEIGHT, CSSValue()));
+  EXPECT_EQ(CSS_UNDEFINED, style()->height_);
+  EXPECT_TRUE(style()->SetValue(CSS_PROPERTY_OPACITY, CSSValue::MakePx(1)));
+  EXPECT_EQ(255, style()->opacity_);
+  EXPECT_TRUE(style()->SetValue(
+      CSS_PROPERTY_BORDER_COLOR, CSSValue::MakeColor(CSSColor(255, 0, 0, 1))));
+  EXPECT_EQ(CSSColor(255, 0, 0, 1), style()->border_color_);
+  EXPECT_TRUE(style()->SetValue(CSS_PROPERTY_FLEX_DIRECTION,
+                                CSSValue::MakeKeyword(CSSFLEX_DIRECTION_COLUMN)));
+  EXPECT_EQ(CSSFLEX_DIRECTION_COLUMN, style()->flex_direction_);
+  EXPECT_FALSE(style()->SetValue(CSS_PROPERTY_INVALID, CSSValue::MakePx(1)));
+}
+
 }  // namespace lynx
 
 #undef private
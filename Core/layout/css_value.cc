@@ -0,0 +1,154 @@
+// Copyright 2017 The Lynx Authors. All rights reserved.
+
+#include "layout/css_value.h"
+
+#include "base/string/string_number_convert.h"
+#include "layout/css_type.h"
+
+namespace lynx {
+
+namespace {
+const std::string kPxUnit = "px";
+
+typedef bool (*ParseFunc)(const std::string& text, CSSValue& value);
+
+bool ParseLength(const std::string& text, CSSValue& value) {
+  return CSSValue::ParseLength(text, value);
+}
+
+bool ParseNumber(const std::string& text, CSSValue& value) {
+  double number;
+  if (!base::StringToDouble(text, number)) {
+    return false;
+  }
+  value = CSSValue::MakeNumber(number);
+  return true;
+}
+
+bool ParseColor(const std::string& text, CSSValue& value) {
+  CSSColor color;
+  if (!CSSColor::Parse(text, color)) {
+    return false;
+  }
+  value = CSSValue::MakeColor(color);
+  return true;
+}
+
+// The url of url(...), or no image.
+bool ParseUrl(const std::string& text, CSSValue& value) {
+  auto start = text.find('(');
+  auto end = text.find(')');
+  if (start != std::string::npos && end != std::string::npos) {
+    value = CSSValue::MakeString(text.substr(start + 1, end - start - 1));
+  } else {
+    value = CSSValue::MakeString("");
+  }
+  return true;
+}
+
+bool ParseString(const std::string& text, CSSValue& value) {
+  value = CSSValue::MakeString(text);
+  return true;
+}
+
+#define CSS_KEYWORD_PARSER(Name, Type, Convert)                  \
+  bool Parse##Name(const std::string& text, CSSValue& value) {   \
+    Type type;                                                   \
+    if (!Convert(text, type)) {                                  \
+      return false;                                              \
+    }                                                            \
+    value = CSSValue::MakeKeyword(type);                         \
+    return true;                                                 \
+  }
+
+CSS_KEYWORD_PARSER(Visible, CSSStyleType, ToVisibleType)
+CSS_KEYWORD_PARSER(Display, CSSStyleType, ToDisplayType)
+CSS_KEYWORD_PARSER(FlexAlign, CSSStyleType, ToFlexAlignType)
+CSS_KEYWORD_PARSER(FlexDirection, CSSStyleType, ToFlexDirectionType)
+CSS_KEYWORD_PARSER(FlexJustify, CSSStyleType, ToFlexJustifyType)
+CSS_KEYWORD_PARSER(FlexWrap, CSSStyleType, ToFlexWrapType)
+CSS_KEYWORD_PARSER(Position, CSSStyleType, ToPositionType)
+CSS_KEYWORD_PARSER(PointerEvents, CSSStyleType, ToPointerEventsType)
+CSS_KEYWORD_PARSER(BackgroundRepeat, CSSStyleType, ToBackgroundImageRepeatType)
+CSS_KEYWORD_PARSER(TextAlign, TextStyleType, ToTextAlignType)
+CSS_KEYWORD_PARSER(TextDecoration, TextStyleType, ToTextDecorationType)
+CSS_KEYWORD_PARSER(FontWeight, TextStyleType, ToTextFontWeightType)
+CSS_KEYWORD_PARSER(TextOverflow, TextStyleType, ToTextOverflowType)
+CSS_KEYWORD_PARSER(WhiteSpace, TextStyleType, ToTextWhiteSpaceType)
+CSS_KEYWORD_PARSER(ObjectFit, ImageStyleType, ToObjectFitType)
+
+#undef CSS_KEYWORD_PARSER
+
+const ParseFunc kParsers[] = {
+#define CSS_PROPERTY_PARSER(id, setter, name, parser) &Parse##parser,
+    CSS_PROPERTY_LIST(CSS_PROPERTY_PARSER)
+#undef CSS_PROPERTY_PARSER
+};
+}  // namespace
+
+CSSValue CSSValue::Parse(CSSPropertyID id, const std::string& text) {
+  CSSValue value;
+  if (id < 0 || id >= CSS_PROPERTY_COUNT || !kParsers[id](text, value)) {
+    value = CSSValue();
+  }
+#if ENABLE_INSPECTOR
+  value.text_ = text;
+#endif
+  return value;
+}
+
+bool CSSValue::ParseLength(const std::string& text, CSSValue& value) {
+  if (text.empty()) return false;
+
+  bool is_px = false;
+  std::string number_text = text;
+  size_t start = text.length() - kPxUnit.length();
+  if (start > 0 && text.find(kPxUnit, start - 1) != std::string::npos) {
+    is_px = true;
+    number_text = text.substr(0, start);
+  }
+
+  double number;
+  if (!base::StringToDouble(number_text, number)) {
+    return false;
+  }
+  value = is_px ? MakePx(number) : MakeNumber(number);
+  return true;
+}
+
+CSSValue CSSValue::MakeNumber(double number) {
+  CSSValue value;
+  value.type_ = CSS_VALUE_NUMBER;
+  value.number_ = number;
+  return value;
+}
+
+CSSValue CSSValue::MakePx(double px) {
+  CSSValue value;
+  value.type_ = CSS_VALUE_PX;
+  value.number_ = px;
+  return value;
+}
+
+CSSValue CSSValue::MakeColor(const CSSColor& color) {
+  CSSValue value;
+  value.type_ = CSS_VALUE_COLOR;
+  value.color_ = color;
+  return value;
+}
+
+CSSValue CSSValue::MakeKeyword(int keyword) {
+  CSSValue value;
+  value.type_ = CSS_VALUE_KEYWORD;
+  value.keyword_ = keyword;
+  return value;
+}
+
+CSSValue CSSValue::MakeString(const std::string& string) {
+  CSSValue value;
+  value.type_ = CSS_VALUE_STRING;
+  value.string_ = string;
+  return value;
+}
+
+}  // namespace lynx
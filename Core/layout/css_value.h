@@ -0,0 +1,77 @@
+// Copyright 2017 The Lynx Authors. All rights reserved.
+
+#ifndef LYNX_LAYOUT_CSS_VALUE_H_
+#define LYNX_LAYOUT_CSS_VALUE_H_
+
+#include <string>
+
+#include "layout/css_color.h"
+#include "layout/css_property.h"
+
+namespace lynx {
+
+// A style value parsed once, for the property it is set on, so that
+// CSSStyle applies it without parsing text again. Lengths are kept in the
+// unit they were written in; CSSStyle scales them by its density.
+class CSSValue {
+ public:
+  enum Type {
+    // Text that is not a value of the property. Setters fall back to their
+    // defaults, as they do for text that does not parse.
+    CSS_VALUE_INVALID,
+    // A bare number: a plain number, or a length scaled to the screen
+    // width.
+    CSS_VALUE_NUMBER,
+    // A length in px.
+    CSS_VALUE_PX,
+    CSS_VALUE_COLOR,
+    // One of the enums of css_type.h.
+    CSS_VALUE_KEYWORD,
+    // Text kept for the setter: image urls and values of several parts.
+    CSS_VALUE_STRING,
+  };
+
+  CSSValue() : type_(CSS_VALUE_INVALID), number_(0), keyword_(0) {}
+
+  // Parses |text| as a value of |id|.
+  static CSSValue Parse(CSSPropertyID id, const std::string& text);
+
+  // Parses |text| as a length, in px or bare.
+  static bool ParseLength(const std::string& text, CSSValue& value);
+
+  static CSSValue MakeNumber(double number);
+  static CSSValue MakePx(double px);
+  static CSSValue MakeColor(const CSSColor& color);
+  static CSSValue MakeKeyword(int keyword);
+  static CSSValue MakeString(const std::string& string);
+
+  Type type() const { return type_; }
+
+  double number() const { return number_; }
+
+  const CSSColor& color() const { return color_; }
+
+  int keyword() const { return keyword_; }
+
+  const std::string& string() const { return string_; }
+
+#if ENABLE_INSPECTOR
+  // The text the value was parsed from, shown by the inspector.
+  const std::string& text() const { return text_; }
+#endif
+
+ private:
+  Type type_;
+  double number_;
+  CSSColor color_;
+  int keyword_;
+  std::string string_;
+
+#if ENABLE_INSPECTOR
+  std::string text_;
+#endif
+};
+
+}  // namespace lynx
+
+#endif  // LYNX_LAYOUT_CSS_VALUE_H_
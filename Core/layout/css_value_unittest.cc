@@ -0,0 +1,66 @@
+#include "layout/css_value.h"
+
+#include "gtest/gtest.h"
+#include "layout/css_type.h"
+
+namespace lynx {
+TEST(CSSValueTest, ParseLengthTest) {
+  CSSValue value = CSSValue::Parse(CSS_PROPERTY_WIDTH, "750px");
+  EXPECT_EQ(CSSValue::CSS_VALUE_PX, value.type());
+  EXPECT_EQ(750, value.number());
+
+  value = CSSValue::Parse(CSS_PROPERTY_MARGIN_LEFT, "12.5");
+  EXPECT_EQ(CSSValue::CSS_VALUE_NUMBER, value.type());
+  EXPECT_EQ(12.5, value.number());
+
+  EXPECT_EQ(CSSValue::CSS_VALUE_INVALID,
+            CSSValue::Parse(CSS_PROPERTY_WIDTH, "750rpx").type());
+  EXPECT_EQ(CSSValue::CSS_VALUE_INVALID,
+            CSSValue::Parse(CSS_PROPERTY_WIDTH, "").type());
+}
+
+TEST(CSSValueTest, ParseNumberTest) {
+  CSSValue value = CSSValue::Parse(CSS_PROPERTY_OPACITY, "0.5");
+  EXPECT_EQ(CSSValue::CSS_VALUE_NUMBER, value.type());
+  EXPECT_EQ(0.5, value.number());
+  EXPECT_EQ(CSSValue::CSS_VALUE_INVALID,
+            CSSValue::Parse(CSS_PROPERTY_Z_INDEX, "3px").type());
+}
+
+TEST(CSSValueTest, ParseColorTest) {
+  CSSValue value = CSSValue::Parse(CSS_PROPERTY_COLOR, "#00ff00");
+  EXPECT_EQ(CSSValue::CSS_VALUE_COLOR, value.type());
+  EXPECT_EQ(CSSColor(0, 255, 0, 1), value.color());
+  EXPECT_EQ(CSSValue::CSS_VALUE_INVALID,
+            CSSValue::Parse(CSS_PROPERTY_BORDER_COLOR, "test").type());
+}
+
+TEST(CSSValueTest, ParseKeywordTest) {
+  CSSValue value = CSSValue::Parse(CSS_PROPERTY_FLEX_DIRECTION, "column");
+  EXPECT_EQ(CSSValue::CSS_VALUE_KEYWORD, value.type());
+  EXPECT_EQ(CSSFLEX_DIRECTION_COLUMN, value.keyword());
+
+  value = CSSValue::Parse(CSS_PROPERTY_TEXT_ALIGN, "center");
+  EXPECT_EQ(CSSValue::CSS_VALUE_KEYWORD, value.type());
+  EXPECT_EQ(CSSTEXT_ALIGN_CENTER, value.keyword());
+
+  EXPECT_EQ(CSSValue::CSS_VALUE_INVALID,
+            CSSValue::Parse(CSS_PROPERTY_POSITION, "sticky").type());
+}
+
+TEST(CSSValueTest, ParseStringTest) {
+  CSSValue value = CSSValue::Parse(CSS_PROPERTY_BACKGROUND_IMAGE, "url(a.png)");
+  EXPECT_EQ(CSSValue::CSS_VALUE_STRING, value.type());
+  EXPECT_EQ("a.png", value.string());
+  EXPECT_EQ("", CSSValue::Parse(CSS_PROPERTY_BACKGROUND_IMAGE, "a.png").string());
+  EXPECT_EQ("10px 20px",
+            CSSValue::Parse(CSS_PROPERTY_BACKGROUND_SIZE, "10px 20px").string());
+}
+
+TEST(CSSValueTest, ParseInvalidPropertyTest) {
+  EXPECT_EQ(CSSValue::CSS_VALUE_INVALID,
+            CSSValue::Parse(CSS_PROPERTY_INVALID, "750px").type());
+  EXPECT_EQ(CSSValue::CSS_VALUE_INVALID,
+            CSSValue::Parse(CSS_PROPERTY_COUNT, "750px").type());
+}
+}  // namespace lynx
@@ -2,6 +2,8 @@
 
 #include "layout/layout_object.h"
 
+#include "layout/css_style_config.h"
+
 #ifndef TESTING
 #include "base/trace_event/trace_event_common.h"
 #endif
@@ -11,12 +13,18 @@ LayoutObject::LayoutObject()
     : measured_size_(),
       measured_position_(),
       layout_state_(LAYOUT_STATE_DIRTY),
-      css_style_(),
+      css_style_(lynx_new SharedCSSStyle()),
       offset_top_(0),
       offset_left_(0),
       offset_width_(0),
       offset_height_(0),
-      last_measured_size_from_parent_() {}
+      last_width_descriptor_(0),
+      last_height_descriptor_(0),
+      on_measure_width_descriptor_(0),
+      on_measure_height_descriptor_(0),
+      relayout_root_(false),
+      measure_cache_size_(0),
+      measure_cache_next_(0) {}
 
 LayoutObject::~LayoutObject() {}
 
@@ -33,6 +41,7 @@ void LayoutObject::RemoveChild(ContainerNode* child) {
 base::Size LayoutObject::Measure(int width_descriptor, int height_descriptor) {
   if (NeedRemeasure(width_descriptor, height_descriptor)) {
     measured_size_ = OnMeasure(width_descriptor, height_descriptor);
+    CacheMeasuredSize(width_descriptor, height_descriptor);
   }
   return measured_size_;
 }
@@ -43,17 +52,60 @@ base::Size LayoutObject::OnMeasure(int width_descriptor,
 }
 
 void LayoutObject::Layout(int left, int top, int right, int bottom) {
-  if (measured_position_.Reset(left, top, right, bottom) || IsDirty()) {
+  bool remeasured = MeasureForLayout();
+  if (measured_position_.Reset(left, top, right, bottom) || IsDirty() ||
+      remeasured) {
     offset_top_ =
         top -
-        (parent_ == NULL ? 0 : ((LayoutObject*)parent_)->css_style_.border_width_);
+        (parent_ == NULL ? 0 : ((LayoutObject*)parent_)->css_style_->border_width_);
     offset_left_ =
         left -
-        (parent_ == NULL ? 0 : ((LayoutObject*)parent_)->css_style_.border_width_);
+        (parent_ == NULL ? 0 : ((LayoutObject*)parent_)->css_style_->border_width_);
     offset_height_ = bottom - top;
     offset_width_ = right - left;
     UpToDate();
     OnLayout(left, top, right, bottom);
+  } else if (layout_state_ == LAYOUT_STATE_DESCENDANT_DIRTY) {
+    LayoutDirtyDescendants();
+  }
+}
+
+bool LayoutObject::MeasureForLayout() {
+  if (relayout_root_) {
+    Measure(last_width_descriptor_, last_height_descriptor_);
+    return true;
+  }
+  if (measure_cache_size_ == 0) {
+    return false;
+  }
+  if (last_width_descriptor_ == on_measure_width_descriptor_ &&
+      last_height_descriptor_ == on_measure_height_descriptor_) {
+    return false;
+  }
+  // The last size came from the cache, but the children, and whatever
+  // OnMeasure leaves behind, follow a later OnMeasure under other
+  // descriptors.
+  measured_size_ = OnMeasure(last_width_descriptor_, last_height_descriptor_);
+  on_measure_width_descriptor_ = last_width_descriptor_;
+  on_measure_height_descriptor_ = last_height_descriptor_;
+  return true;
+}
+
+void LayoutObject::LayoutDirtyDescendants() {
+  UpToDate();
+  // Everything below a hidden node is laid out empty, at once.
+  if (css_style_->css_display_type_ != CSS_DISPLAY_FLEX) {
+    OnLayout(measured_position_.left_, measured_position_.top_,
+             measured_position_.right_, measured_position_.bottom_);
+    return;
+  }
+  for (Node* node = FirstChild(); node != NULL; node = node->Next()) {
+    LayoutObject* child = static_cast<LayoutObject*>(node);
+    if (child->layout_state_ != LAYOUT_STATE_UP_TO_DATE) {
+      const base::Position& position = child->measured_position_;
+      child->Layout(position.left_, position.top_, position.right_,
+                    position.bottom_);
+    }
   }
 }
 
@@ -73,15 +125,65 @@ void LayoutObject::ReLayout(int left, int top, int right, int bottom) {
     int height = bottom - top;
     Measure(width, height);
     Layout(left, top, right, bottom);
+  } else if (layout_state_ == LAYOUT_STATE_DESCENDANT_DIRTY) {
+#ifndef TESTING
+    TRACE_EVENT0("Layout", "LayoutObject::LayoutDirtyDescendants");
+#endif
+    LayoutDirtyDescendants();
   }
 }
 
 void LayoutObject::Dirty() {
+  bool measured = measure_cache_size_ != 0;
+  layout_state_ = LAYOUT_STATE_DIRTY;
+  measure_cache_size_ = 0;
+  measure_cache_next_ = 0;
+  LayoutObject* parent = static_cast<LayoutObject*>(parent_);
+  if (parent == NULL || parent->layout_state_ == LAYOUT_STATE_DIRTY) {
+    return;
+  }
+  if (measured && IsRelayoutBoundary()) {
+    relayout_root_ = true;
+    parent->MarkDescendantDirty();
+  } else {
+    parent->Dirty();
+  }
+}
+
+void LayoutObject::DirtyStyle() {
+  Dirty();
   LayoutObject* parent = static_cast<LayoutObject*>(parent_);
   if (parent != NULL && parent->layout_state_ != LAYOUT_STATE_DIRTY) {
     parent->Dirty();
   }
-  layout_state_ = LAYOUT_STATE_DIRTY;
+}
+
+void LayoutObject::MarkDescendantDirty() {
+  LayoutObject* node = this;
+  while (node != NULL && node->layout_state_ == LAYOUT_STATE_UP_TO_DATE) {
+    node->layout_state_ = LAYOUT_STATE_DESCENDANT_DIRTY;
+    node = static_cast<LayoutObject*>(node->parent_);
+  }
+}
+
+bool LayoutObject::IsRelayoutBoundary() {
+  return !CSS_IS_UNDEFINED(css_style_->width_) &&
+         !CSS_IS_UNDEFINED(css_style_->height_) &&
+         css_style_->css_display_type_ == CSS_DISPLAY_FLEX;
+}
+
+void LayoutObject::InternStyle() {
+  if (css_style_->interned() || css_style_->config_ == NULL) {
+    return;
+  }
+  css_style_ = css_style_->config_->style_pool()->Intern(*css_style_);
+}
+
+CSSStyle* LayoutObject::MutableStyle() {
+  if (css_style_->interned() || !css_style_->HasOneRef()) {
+    css_style_ = lynx_new SharedCSSStyle(css_style());
+  }
+  return const_cast<SharedCSSStyle*>(css_style_.Get());
 }
 
 void LayoutObject::UpToDate() {
@@ -93,8 +195,31 @@ bool LayoutObject::IsDirty() {
 }
 
 bool LayoutObject::NeedRemeasure(int width_descriptor, int height_descriptor) {
-  return last_measured_size_from_parent_.Update(width_descriptor,
-                                                height_descriptor) ||
-         IsDirty();
+  relayout_root_ = false;
+  last_width_descriptor_ = width_descriptor;
+  last_height_descriptor_ = height_descriptor;
+  for (int i = 0; i < measure_cache_size_; ++i) {
+    const MeasureCacheEntry& entry = measure_cache_[i];
+    if (entry.width_descriptor_ == width_descriptor &&
+        entry.height_descriptor_ == height_descriptor) {
+      measured_size_ = entry.size_;
+      return false;
+    }
+  }
+  return true;
+}
+
+void LayoutObject::CacheMeasuredSize(int width_descriptor,
+                                     int height_descriptor) {
+  MeasureCacheEntry& entry = measure_cache_[measure_cache_next_];
+  entry.width_descriptor_ = width_descriptor;
+  entry.height_descriptor_ = height_descriptor;
+  entry.size_ = measured_size_;
+  on_measure_width_descriptor_ = width_descriptor;
+  on_measure_height_descriptor_ = height_descriptor;
+  measure_cache_next_ = (measure_cache_next_ + 1) % kMaxCachedMeasures;
+  if (measure_cache_size_ < kMaxCachedMeasures) {
+    ++measure_cache_size_;
+  }
 }
 }  // namespace lynx
@@ -5,10 +5,12 @@
 
 #include <string>
 
+#include "base/debug/memory_debug.h"
 #include "base/position.h"
 #include "base/size.h"
 #include "layout/container_node.h"
 #include "layout/css_style.h"
+#include "layout/shared_css_style.h"
 
 namespace lynx {
 class LayoutObject : public ContainerNode {
@@ -22,21 +24,47 @@ class LayoutObject : public ContainerNode {
   virtual void RemoveChild(ContainerNode* child);
 
   virtual void SetStyle(const std::string& key, const std::string& value) {
-    css_style_.SetValue(key, value);
+    MutableStyle()->SetValue(key, value);
   }
 
-  void set_css_style(const CSSStyle& css_style) { css_style_ = css_style; }
+  virtual void SetStyle(CSSPropertyID id, const std::string& value) {
+    MutableStyle()->SetValue(id, value);
+  }
+
+  virtual void SetStyle(CSSPropertyID id, const CSSValue& value) {
+    MutableStyle()->SetValue(id, value);
+  }
+
+  void set_css_style(const CSSStyle& css_style) {
+    css_style_ = lynx_new SharedCSSStyle(css_style);
+  }
+
+  const CSSStyle& css_style() { return *css_style_; }
 
-  const CSSStyle& css_style() { return css_style_; }
+  // Swaps the style for the equal one of the style pool, so that nodes of
+  // the same style keep one copy of it. A later change copies it again.
+  void InternStyle();
 
   const base::Size& measured_size() { return measured_size_; }
 
   const base::Position& measured_position() { return measured_position_; }
 
+  // Marks this node for measure and layout after its content changed,
+  // its children or its text. The parent is marked as well, unless this
+  // node is a relayout boundary.
   void Dirty();
 
+  // Marks this node after its own style changed. The style can move or
+  // resize it, so the parent is always marked.
+  void DirtyStyle();
+
   bool IsDirty();
 
+  // A node whose size does not depend on its content: a flex container
+  // with a fixed width and height. Changes below it are measured and laid
+  // out from it instead of from the root.
+  virtual bool IsRelayoutBoundary();
+
   inline void set_offset_top(int offset_top) { offset_top_ = offset_top; }
 
   inline void set_offset_left(int offset_left) { offset_left_ = offset_left; }
@@ -50,6 +78,7 @@ class LayoutObject : public ContainerNode {
   inline int offset_height() { return offset_height_; }
 
   friend class CSSStaticLayout;
+  friend class CSSFlatLayout;
   virtual base::Size Measure(int width_descriptor, int height_descriptor);
 
   // Subclasses should override onMeasure(int, int) to provide
@@ -67,26 +96,74 @@ class LayoutObject : public ContainerNode {
   enum LAYOUT_STATE {
     LAYOUT_STATE_DIRTY,
     LAYOUT_STATE_UP_TO_DATE,
+    // Measured size and position are valid, but a relayout boundary below
+    // is dirty.
+    LAYOUT_STATE_DESCENDANT_DIRTY,
   };
 
   void UpToDate();
 
-  bool NeedRemeasure(int width, int height);
+  // The style to change, copied first when it is shared.
+  CSSStyle* MutableStyle();
+
+  // Looks the descriptors up in the measure cache. On a hit measured_size_
+  // is set from it and false returned, otherwise OnMeasure has to run and
+  // its result be stored with CacheMeasuredSize.
+  bool NeedRemeasure(int width_descriptor, int height_descriptor);
+
+  void CacheMeasuredSize(int width_descriptor, int height_descriptor);
+
+  // Lays out the dirty boundaries below this node at their last positions.
+  void LayoutDirtyDescendants();
+
+  // Runs OnMeasure again before layout when the measured size does not
+  // match what the last OnMeasure left in the children. Returns true when
+  // it did.
+  bool MeasureForLayout();
 
   base::Size measured_size_;
   base::Position measured_position_;
 
   LAYOUT_STATE layout_state_;
 
-  CSSStyle css_style_;
+  SharedCSSStylePtr css_style_;
 
   int offset_top_;
   int offset_left_;
   int offset_width_;
   int offset_height_;
 
+  // Descriptors of the last Measure.
+  int last_width_descriptor_;
+  int last_height_descriptor_;
+
  private:
-  base::Size last_measured_size_from_parent_;
+  void MarkDescendantDirty();
+
+  // Descriptors of the last OnMeasure. The measured sizes of the children
+  // are the ones it asked for.
+  int on_measure_width_descriptor_;
+  int on_measure_height_descriptor_;
+
+  // Dirtied as a relayout boundary, so its parent stays clean and will not
+  // measure it. It is measured again with the last descriptors instead,
+  // once it is laid out.
+  bool relayout_root_;
+
+  // A parent measures a child under several constraints in one pass, as
+  // flex and wrap lines are resolved, so a few results are kept, keyed
+  // on the width and height descriptors. Cleared when dirtied.
+  struct MeasureCacheEntry {
+    int width_descriptor_;
+    int height_descriptor_;
+    base::Size size_;
+  };
+
+  static const int kMaxCachedMeasures = 8;
+
+  MeasureCacheEntry measure_cache_[kMaxCachedMeasures];
+  int measure_cache_size_;
+  int measure_cache_next_;
 };
 }  // namespace lynx
 
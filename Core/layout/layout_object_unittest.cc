@@ -0,0 +1,240 @@
+// Copyright 2017 The Lynx Authors. All rights reserved.
+
+#include "layout/layout_object.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "layout/css_style_config.h"
+#include "layout/layout_worker_pool.h"
+
+namespace lynx {
+
+namespace {
+class CountingObject : public LayoutObject {
+ public:
+  CountingObject() : measures_(0), layouts_(0) {}
+
+  virtual base::Size OnMeasure(int width_descriptor, int height_descriptor) {
+    ++measures_;
+    return LayoutObject::OnMeasure(width_descriptor, height_descriptor);
+  }
+
+  virtual void OnLayout(int left, int top, int right, int bottom) {
+    ++layouts_;
+    LayoutObject::OnLayout(left, top, right, bottom);
+  }
+
+  bool descendant_dirty() {
+    return layout_state_ == LAYOUT_STATE_DESCENDANT_DIRTY;
+  }
+
+  bool up_to_date() { return layout_state_ == LAYOUT_STATE_UP_TO_DATE; }
+
+  void ResetCounts() {
+    measures_ = 0;
+    layouts_ = 0;
+  }
+
+  int measures_;
+  int layouts_;
+};
+
+int Exactly(int size) {
+  return base::Size::Descriptor::Make(size, base::Size::Descriptor::EXACTLY);
+}
+
+int AtMost(int size) {
+  return base::Size::Descriptor::Make(size, base::Size::Descriptor::AT_MOST);
+}
+}  // namespace
+
+class LayoutObjectTest : public testing::Test {
+ protected:
+  LayoutObjectTest() { CSSStyle::Initialize(&config_); }
+
+  ~LayoutObjectTest() {
+    for (size_t i = 0; i < objects_.size(); ++i) {
+      delete objects_[i];
+    }
+  }
+
+  // A node appended to |parent|, fixed to |width| and |height| unless
+  // they are NULL.
+  CountingObject* NewObject(LayoutObject* parent,
+                            const char* width,
+                            const char* height) {
+    CountingObject* object = new CountingObject;
+    object->set_css_style(CSSStyle(&config_, 1, 750, 750));
+    if (width != NULL) {
+      object->SetStyle("width", width);
+    }
+    if (height != NULL) {
+      object->SetStyle("height", height);
+    }
+    if (parent != NULL) {
+      parent->InsertChild(object, -1);
+    }
+    objects_.push_back(object);
+    return object;
+  }
+
+  void ReLayout(LayoutObject* root) { root->ReLayout(0, 0, 750, 1334); }
+
+  CSSStyleConfig config_;
+  std::vector<CountingObject*> objects_;
+};
+
+TEST_F(LayoutObjectTest, MeasureCacheTest) {
+  CountingObject* object = NewObject(NULL, "100px", "50px");
+  base::Size size = object->Measure(Exactly(300), AtMost(200));
+  EXPECT_EQ(1, object->measures_);
+
+  base::Size cached = object->Measure(Exactly(300), AtMost(200));
+  EXPECT_TRUE(size.IsEqual(cached));
+  EXPECT_EQ(1, object->measures_);
+
+  object->Measure(AtMost(300), AtMost(200));
+  EXPECT_EQ(2, object->measures_);
+  object->Measure(Exactly(300), AtMost(200));
+  object->Measure(AtMost(300), AtMost(200));
+  EXPECT_EQ(2, object->measures_);
+
+  // The oldest entry goes once the cache is full.
+  for (int i = 1; i <= 7; ++i) {
+    object->Measure(Exactly(300 + i), AtMost(200));
+  }
+  EXPECT_EQ(9, object->measures_);
+  object->Measure(Exactly(300), AtMost(200));
+  EXPECT_EQ(10, object->measures_);
+}
+
+TEST_F(LayoutObjectTest, DirtyClearsMeasureCacheTest) {
+  CountingObject* object = NewObject(NULL, "100px", "50px");
+  object->Measure(Exactly(300), AtMost(200));
+  object->Dirty();
+  EXPECT_TRUE(object->IsDirty());
+  object->Measure(Exactly(300), AtMost(200));
+  EXPECT_EQ(2, object->measures_);
+
+  object->DirtyStyle();
+  object->Measure(Exactly(300), AtMost(200));
+  EXPECT_EQ(3, object->measures_);
+}
+
+TEST_F(LayoutObjectTest, DirtyTest) {
+  CountingObject* root = NewObject(NULL, NULL, NULL);
+  CountingObject* middle = NewObject(root, NULL, NULL);
+  CountingObject* leaf = NewObject(middle, NULL, NULL);
+  ReLayout(root);
+  EXPECT_TRUE(root->up_to_date());
+
+  // Without a boundary on the way, the root is dirtied.
+  leaf->Dirty();
+  EXPECT_TRUE(leaf->IsDirty());
+  EXPECT_TRUE(middle->IsDirty());
+  EXPECT_TRUE(root->IsDirty());
+}
+
+TEST_F(LayoutObjectTest, BoundaryDirtyTest) {
+  CountingObject* root = NewObject(NULL, NULL, NULL);
+  CountingObject* middle = NewObject(root, NULL, NULL);
+  CountingObject* boundary = NewObject(middle, "100px", "100px");
+  CountingObject* leaf = NewObject(boundary, NULL, NULL);
+  ReLayout(root);
+
+  // Dirtying stops at the boundary, the ancestors above it only learn that
+  // something below is dirty.
+  leaf->Dirty();
+  EXPECT_TRUE(boundary->IsDirty());
+  EXPECT_TRUE(middle->descendant_dirty());
+  EXPECT_TRUE(root->descendant_dirty());
+  EXPECT_FALSE(root->IsDirty());
+
+  // A dirty ancestor is not downgraded.
+  ReLayout(root);
+  middle->Dirty();
+  leaf->Dirty();
+  EXPECT_TRUE(middle->IsDirty());
+  EXPECT_TRUE(root->IsDirty());
+}
+
+TEST_F(LayoutObjectTest, BoundaryDirtyStyleTest) {
+  CountingObject* root = NewObject(NULL, NULL, NULL);
+  CountingObject* boundary = NewObject(root, "100px", "100px");
+  ReLayout(root);
+
+  // The style of the boundary itself can move or resize it.
+  boundary->DirtyStyle();
+  EXPECT_TRUE(boundary->IsDirty());
+  EXPECT_TRUE(root->IsDirty());
+}
+
+TEST_F(LayoutObjectTest, IsRelayoutBoundaryTest) {
+  EXPECT_TRUE(NewObject(NULL, "100px", "100px")->IsRelayoutBoundary());
+  EXPECT_FALSE(NewObject(NULL, "100px", NULL)->IsRelayoutBoundary());
+  EXPECT_FALSE(NewObject(NULL, NULL, "100px")->IsRelayoutBoundary());
+  EXPECT_FALSE(NewObject(NULL, NULL, NULL)->IsRelayoutBoundary());
+
+  CountingObject* hidden = NewObject(NULL, "100px", "100px");
+  hidden->SetStyle("display", "none");
+  EXPECT_FALSE(hidden->IsRelayoutBoundary());
+}
+
+TEST_F(LayoutObjectTest, LayoutDirtyDescendantsTest) {
+  CountingObject* root = NewObject(NULL, NULL, NULL);
+  CountingObject* dirty = NewObject(root, "100px", "100px");
+  CountingObject* dirty_leaf = NewObject(dirty, NULL, NULL);
+  CountingObject* clean = NewObject(root, "100px", "100px");
+  CountingObject* clean_leaf = NewObject(clean, NULL, NULL);
+  ReLayout(root);
+  base::Position position = dirty->measured_position();
+  EXPECT_FALSE(position.IsEmpty());
+  for (size_t i = 0; i < objects_.size(); ++i) {
+    objects_[i]->ResetCounts();
+  }
+
+  dirty_leaf->Dirty();
+  ReLayout(root);
+
+  // Only the dirty boundary is measured and laid out again, at the
+  // position it had.
+  EXPECT_EQ(0, root->measures_);
+  EXPECT_EQ(0, root->layouts_);
+  EXPECT_EQ(1, dirty->measures_);
+  EXPECT_EQ(1, dirty->layouts_);
+  EXPECT_EQ(1, dirty_leaf->measures_);
+  EXPECT_EQ(0, clean->measures_);
+  EXPECT_EQ(0, clean->layouts_);
+  EXPECT_EQ(0, clean_leaf->measures_);
+  EXPECT_EQ(0, clean_leaf->layouts_);
+  const base::Position& after = dirty->measured_position();
+  EXPECT_TRUE(position.Equal(after.left_, after.top_, after.right_,
+                             after.bottom_));
+  for (size_t i = 0; i < objects_.size(); ++i) {
+    EXPECT_TRUE(objects_[i]->up_to_date());
+  }
+}
+
+TEST_F(LayoutObjectTest, PoolMeasuresBoundariesOnceTest) {
+  CountingObject* root = NewObject(NULL, NULL, NULL);
+  std::vector<CountingObject*> boundaries;
+  for (int i = 0; i < 4; ++i) {
+    CountingObject* boundary = NewObject(root, "100px", "100px");
+    NewObject(boundary, NULL, NULL);
+    boundaries.push_back(boundary);
+  }
+  root->SetStyle("flex-direction", "row");
+  boundaries[0]->SetStyle("margin-top", "10px");
+
+  // The boundaries are measured on the pool with the descriptors the row
+  // offers them, so the row finds their sizes in the measure cache.
+  LayoutWorkerPool pool(2);
+  LayoutWorkerPool::Scope scope(&pool);
+  ReLayout(root);
+  for (size_t i = 0; i < boundaries.size(); ++i) {
+    EXPECT_EQ(1, boundaries[i]->measures_);
+    EXPECT_EQ(1, boundaries[i]->layouts_);
+  }
+}
+}  // namespace lynx
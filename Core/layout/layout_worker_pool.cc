@@ -0,0 +1,190 @@
+// Copyright 2017 The Lynx Authors. All rights reserved.
+
+#include "layout/layout_worker_pool.h"
+
+#if OS_ANDROID
+#include "base/android/android_jni.h"
+#endif
+
+#include "base/debug/memory_debug.h"
+#include "base/threading/thread_local.h"
+#include "layout/layout_object.h"
+
+namespace lynx {
+
+namespace {
+base::ThreadLocalPointer<LayoutWorkerPool> current_pool;
+// The worker of the current pool running on this thread, if any.
+base::ThreadLocalPointer<void> current_worker;
+// Closures deferred by the task running on this thread.
+base::ThreadLocalPointer<std::vector<base::Closure*> > current_deferred;
+
+void RunTask(const LayoutWorkerPool::Task& task) {
+  if (task.type_ == LayoutWorkerPool::Task::MEASURE) {
+    task.object_->Measure(task.left_, task.top_);
+  } else {
+    task.object_->Layout(task.left_, task.top_, task.right_, task.bottom_);
+  }
+}
+}  // namespace
+
+struct LayoutWorkerPool::Batch {
+  explicit Batch(const std::vector<Task>& tasks)
+      : tasks_(tasks), remaining_(static_cast<int>(tasks.size())),
+        deferred_(tasks.size()) {}
+
+  const std::vector<Task>& tasks_;
+  std::atomic<int> remaining_;
+  std::vector<std::vector<base::Closure*> > deferred_;
+};
+
+LayoutWorkerPool::LayoutWorkerPool(int worker_count)
+    : workers_(), queued_(0), quit_(false), next_worker_(0) {
+  for (int i = 0; i < worker_count; ++i) {
+    workers_.push_back(lynx_new Worker);
+  }
+  // Started once all deques exist, as workers steal from each other.
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i]->thread_ =
+        std::thread(&LayoutWorkerPool::WorkerMain, this, workers_[i]);
+  }
+}
+
+LayoutWorkerPool::~LayoutWorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_lock_);
+    quit_ = true;
+  }
+  wake_.notify_all();
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i]->thread_.join();
+    lynx_delete(workers_[i]);
+  }
+}
+
+LayoutWorkerPool* LayoutWorkerPool::Current() {
+  return current_pool.Get();
+}
+
+bool LayoutWorkerPool::InTask() {
+  return current_deferred.Get() != NULL;
+}
+
+void LayoutWorkerPool::Defer(base::Closure* closure) {
+  current_deferred.Get()->push_back(closure);
+}
+
+LayoutWorkerPool::Scope::Scope(LayoutWorkerPool* pool)
+    : outer_(current_pool.Get()) {
+  current_pool.Set(pool);
+}
+
+LayoutWorkerPool::Scope::~Scope() {
+  current_pool.Set(outer_);
+}
+
+void LayoutWorkerPool::Run(const std::vector<Task>& tasks) {
+  if (workers_.empty() || tasks.size() < 2) {
+    for (size_t i = 0; i < tasks.size(); ++i) {
+      RunTask(tasks[i]);
+    }
+    return;
+  }
+
+  Batch batch(tasks);
+  // A worker fanning out keeps the tasks on its own deque for the others
+  // to steal, any other thread spreads them over all workers.
+  Worker* self = current_pool.Get() == this
+                     ? static_cast<Worker*>(current_worker.Get())
+                     : NULL;
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    Worker* worker =
+        self != NULL ? self : workers_[next_worker_++ % workers_.size()];
+    Work work = {&batch, static_cast<int>(i)};
+    std::lock_guard<std::mutex> lock(worker->lock_);
+    worker->deque_.push_back(work);
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_lock_);
+    queued_ += static_cast<int>(tasks.size());
+  }
+  wake_.notify_all();
+
+  while (batch.remaining_ > 0) {
+    Work work;
+    if (Take(self, &work)) {
+      Execute(work);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  for (size_t i = 0; i < batch.deferred_.size(); ++i) {
+    std::vector<base::Closure*>& deferred = batch.deferred_[i];
+    for (size_t j = 0; j < deferred.size(); ++j) {
+      deferred[j]->Run();
+      lynx_delete(deferred[j]);
+    }
+  }
+}
+
+void LayoutWorkerPool::WorkerMain(Worker* self) {
+  current_pool.Set(this);
+  current_worker.Set(self);
+  while (true) {
+    Work work;
+    if (Take(self, &work)) {
+      Execute(work);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_lock_);
+    while (!quit_ && queued_ == 0) {
+      wake_.wait(lock);
+    }
+    if (quit_) {
+      break;
+    }
+  }
+#if OS_ANDROID
+  // Measuring a label attaches the worker to the VM.
+  base::android::DetachFromVM();
+#endif
+}
+
+bool LayoutWorkerPool::Take(Worker* self, Work* work) {
+  if (queued_ == 0) {
+    return false;
+  }
+  if (self != NULL) {
+    std::lock_guard<std::mutex> lock(self->lock_);
+    if (!self->deque_.empty()) {
+      *work = self->deque_.back();
+      self->deque_.pop_back();
+      --queued_;
+      return true;
+    }
+  }
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    Worker* victim = workers_[i];
+    if (victim == self) {
+      continue;
+    }
+    std::lock_guard<std::mutex> lock(victim->lock_);
+    if (!victim->deque_.empty()) {
+      *work = victim->deque_.front();
+      victim->deque_.pop_front();
+      --queued_;
+      return true;
+    }
+  }
+  return false;
+}
+
+void LayoutWorkerPool::Execute(const Work& work) {
+  std::vector<base::Closure*>* outer = current_deferred.Get();
+  current_deferred.Set(&work.batch_->deferred_[work.index_]);
+  RunTask(work.batch_->tasks_[work.index_]);
+  current_deferred.Set(outer);
+  --work.batch_->remaining_;
+}
+}  // namespace lynx
@@ -0,0 +1,126 @@
+// Copyright 2017 The Lynx Authors. All rights reserved.
+
+#ifndef LYNX_LAYOUT_LAYOUT_WORKER_POOL_H_
+#define LYNX_LAYOUT_LAYOUT_WORKER_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base/task/callback.h"
+
+namespace lynx {
+
+class LayoutObject;
+
+// Measures and lays out independent sibling subtrees on worker threads.
+// Each worker keeps a deque of tasks, runs its newest first and steals the
+// oldest from the others when it runs dry. The thread waiting in Run()
+// takes tasks as well, so a subtree laid out on a worker can fan out again
+// without blocking it.
+//
+// Closures deferred while a task runs are run by the thread that called
+// Run(), in task order, after all tasks finished. The render tree uses
+// this to emit its commands from one thread.
+//
+// A pool without workers is the single thread fallback: CSSStaticLayout
+// does not fan out at all and lays children out in tree order.
+class LayoutWorkerPool {
+ public:
+  struct Task {
+    enum Type {
+      MEASURE,
+      LAYOUT,
+    };
+
+    // Measure(width_descriptor, height_descriptor).
+    Task(LayoutObject* object, int width_descriptor, int height_descriptor)
+        : object_(object),
+          type_(MEASURE),
+          left_(width_descriptor),
+          top_(height_descriptor),
+          right_(0),
+          bottom_(0) {}
+
+    // Layout(left, top, right, bottom).
+    Task(LayoutObject* object, int left, int top, int right, int bottom)
+        : object_(object),
+          type_(LAYOUT),
+          left_(left),
+          top_(top),
+          right_(right),
+          bottom_(bottom) {}
+
+    LayoutObject* object_;
+    Type type_;
+    int left_;
+    int top_;
+    int right_;
+    int bottom_;
+  };
+
+  explicit LayoutWorkerPool(int worker_count);
+  ~LayoutWorkerPool();
+
+  // Runs all tasks and returns once they are done.
+  void Run(const std::vector<Task>& tasks);
+
+  int worker_count() const { return static_cast<int>(workers_.size()); }
+
+  // The pool layout on this thread fans out to, if any.
+  static LayoutWorkerPool* Current();
+
+  // True while this thread runs a task of a parallel Run().
+  static bool InTask();
+
+  // Keeps |closure| for the thread that joins the running task. Only
+  // valid when InTask().
+  static void Defer(base::Closure* closure);
+
+  // Makes |pool| the current pool of this thread for its lifetime.
+  class Scope {
+   public:
+    explicit Scope(LayoutWorkerPool* pool);
+    ~Scope();
+
+   private:
+    LayoutWorkerPool* outer_;
+  };
+
+ private:
+  struct Batch;
+
+  struct Work {
+    Batch* batch_;
+    int index_;
+  };
+
+  struct Worker {
+    std::mutex lock_;
+    std::deque<Work> deque_;
+    std::thread thread_;
+  };
+
+  void WorkerMain(Worker* self);
+
+  // Pops the newest work of |self|, or steals the oldest of another
+  // worker.
+  bool Take(Worker* self, Work* work);
+
+  void Execute(const Work& work);
+
+  std::vector<Worker*> workers_;
+
+  std::mutex sleep_lock_;
+  std::condition_variable wake_;
+  std::atomic<int> queued_;
+  bool quit_;
+
+  std::atomic<unsigned> next_worker_;
+};
+}  // namespace lynx
+
+#endif  // LYNX_LAYOUT_LAYOUT_WORKER_POOL_H_
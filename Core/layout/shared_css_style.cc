@@ -0,0 +1,80 @@
+// Copyright 2017 The Lynx Authors. All rights reserved.
+
+#include "layout/shared_css_style.h"
+
+#include "base/debug/memory_debug.h"
+
+namespace lynx {
+
+SharedCSSStyle::SharedCSSStyle() : ref_count_(0), table_(), hash_(0) {}
+
+SharedCSSStyle::SharedCSSStyle(const CSSStyle& style)
+    : CSSStyle(style), ref_count_(0), table_(), hash_(0) {}
+
+void SharedCSSStyle::AddRef() const {
+  base::AtomicRefCountInc(&ref_count_);
+}
+
+void SharedCSSStyle::Release() const {
+  // The pool may hand an interned style out again until it is erased, so
+  // its count only drops under the lock of the table.
+  CSSStyleTable* table = table_.Get();
+  if (table == NULL) {
+    if (!base::AtomicRefCountDec(&ref_count_)) {
+      lynx_delete(this);
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(table->lock_);
+    if (base::AtomicRefCountDec(&ref_count_)) {
+      return;
+    }
+    auto range = table->styles_.equal_range(hash_);
+    for (auto iter = range.first; iter != range.second; ++iter) {
+      if (iter->second == this) {
+        table->styles_.erase(iter);
+        break;
+      }
+    }
+  }
+  // May release the last reference to the table.
+  lynx_delete(this);
+}
+
+bool SharedCSSStyle::HasOneRef() const {
+  return base::AtomicRefCountIsOne(&ref_count_);
+}
+
+CSSStylePool::CSSStylePool() : table_(lynx_new CSSStyleTable) {}
+
+CSSStylePool::~CSSStylePool() {
+  // Styles still referenced outlive the pool and keep the table until
+  // they are released.
+  std::lock_guard<std::mutex> guard(table_->lock_);
+  table_->pooled_.store(false);
+  table_->styles_.clear();
+}
+
+SharedCSSStylePtr CSSStylePool::Intern(const CSSStyle& style) {
+  size_t hash = style.Hash();
+  std::lock_guard<std::mutex> guard(table_->lock_);
+  auto range = table_->styles_.equal_range(hash);
+  for (auto iter = range.first; iter != range.second; ++iter) {
+    if (iter->second->Equals(style)) {
+      return SharedCSSStylePtr(iter->second);
+    }
+  }
+  SharedCSSStyle* shared = lynx_new SharedCSSStyle(style);
+  shared->table_ = table_;
+  shared->hash_ = hash;
+  table_->styles_.insert(std::make_pair(hash, shared));
+  return SharedCSSStylePtr(shared);
+}
+
+size_t CSSStylePool::size() {
+  std::lock_guard<std::mutex> guard(table_->lock_);
+  return table_->styles_.size();
+}
+
+}  // namespace lynx
@@ -0,0 +1,93 @@
+// Copyright 2017 The Lynx Authors. All rights reserved.
+
+#ifndef LYNX_LAYOUT_SHARED_CSS_STYLE_H_
+#define LYNX_LAYOUT_SHARED_CSS_STYLE_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include "base/atomic_ref_count.h"
+#include "base/macros.h"
+#include "base/ref_counted_ptr.h"
+#include "layout/css_style.h"
+
+namespace lynx {
+
+class SharedCSSStyle;
+
+// The lock and styles of a CSSStylePool. Interned styles hold it as well,
+// so one released after its pool is gone still takes the lock.
+class CSSStyleTable : public base::RefCountPtr<CSSStyleTable> {
+ public:
+  CSSStyleTable() : pooled_(true) {}
+
+ private:
+  friend class CSSStylePool;
+  friend class SharedCSSStyle;
+
+  std::mutex lock_;
+  std::unordered_multimap<size_t, SharedCSSStyle*> styles_;
+  // Cleared when the pool goes, its styles are never handed out again.
+  std::atomic<bool> pooled_;
+};
+
+// A refcounted CSSStyle. Nodes hold it as a pointer to const and copy it
+// before a change unless they are its only holder, so a style handed to
+// a render command never changes under it.
+//
+// An interned style is owned by a CSSStylePool, which hands the same
+// object to every node of an equal style.
+class SharedCSSStyle : public CSSStyle {
+ public:
+  SharedCSSStyle();
+  explicit SharedCSSStyle(const CSSStyle& style);
+
+  void AddRef() const;
+  void Release() const;
+
+  bool HasOneRef() const;
+
+  bool interned() const {
+    return table_.Get() != NULL && table_->pooled_.load();
+  }
+
+ private:
+  friend class CSSStylePool;
+
+  mutable base::AtomicRefCount ref_count_;
+  // Set by the pool before the style is handed out, never changed after.
+  base::ScopedRefPtr<CSSStyleTable> table_;
+  size_t hash_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedCSSStyle);
+};
+
+typedef base::ScopedRefPtr<const SharedCSSStyle> SharedCSSStylePtr;
+
+// The interned styles of a CSSStyleConfig. Styles are released on
+// whichever thread drops the last reference, the UI thread for those
+// carried by render commands, so the table is locked and may outlive the
+// pool.
+class CSSStylePool {
+ public:
+  CSSStylePool();
+  ~CSSStylePool();
+
+  // The interned style equal to |style|, created if there is none.
+  SharedCSSStylePtr Intern(const CSSStyle& style);
+
+  // The number of distinct interned styles.
+  size_t size();
+
+ private:
+  base::ScopedRefPtr<CSSStyleTable> table_;
+
+  DISALLOW_COPY_AND_ASSIGN(CSSStylePool);
+};
+
+}  // namespace lynx
+
+#endif  // LYNX_LAYOUT_SHARED_CSS_STYLE_H_
@@ -0,0 +1,76 @@
+#include "layout/shared_css_style.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "layout/css_style_config.h"
+
+namespace lynx {
+class SharedCSSStyleTest : public testing::Test {
+ protected:
+  SharedCSSStyleTest() { CSSStyle::Initialize(&config_); }
+
+  CSSStyle NewStyle() { return CSSStyle(&config_, 2, 750, 750); }
+
+  CSSStyleConfig config_;
+};
+
+TEST_F(SharedCSSStyleTest, EqualsTest) {
+  CSSStyle style = NewStyle();
+  CSSStyle other = NewStyle();
+  EXPECT_TRUE(style.Equals(other));
+  EXPECT_EQ(style.Hash(), other.Hash());
+
+  other.SetValue(CSS_PROPERTY_BACKGROUND_IMAGE, "url(a.png)");
+  EXPECT_FALSE(style.Equals(other));
+  style.SetValue(CSS_PROPERTY_BACKGROUND_IMAGE, "url(a.png)");
+  EXPECT_TRUE(style.Equals(other));
+
+  other.SetValue(CSS_PROPERTY_WIDTH, "100px");
+  EXPECT_FALSE(style.Equals(other));
+}
+
+TEST_F(SharedCSSStyleTest, InternTest) {
+  CSSStyle style = NewStyle();
+  style.SetValue(CSS_PROPERTY_FLEX_DIRECTION, "column");
+  SharedCSSStylePtr first = config_.style_pool()->Intern(style);
+  SharedCSSStylePtr second = config_.style_pool()->Intern(NewStyle());
+  SharedCSSStylePtr third = config_.style_pool()->Intern(style);
+  EXPECT_TRUE(first->interned());
+  EXPECT_EQ(first, third);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(2u, config_.style_pool()->size());
+
+  first = SharedCSSStylePtr();
+  EXPECT_EQ(2u, config_.style_pool()->size());
+  third = SharedCSSStylePtr();
+  EXPECT_EQ(1u, config_.style_pool()->size());
+  second = SharedCSSStylePtr();
+  EXPECT_EQ(0u, config_.style_pool()->size());
+}
+
+TEST_F(SharedCSSStyleTest, OutlivePoolTest) {
+  SharedCSSStylePtr style;
+  {
+    CSSStylePool pool;
+    style = pool.Intern(NewStyle());
+    EXPECT_TRUE(style->interned());
+  }
+  EXPECT_FALSE(style->interned());
+  EXPECT_TRUE(style->HasOneRef());
+}
+
+TEST_F(SharedCSSStyleTest, ReleaseWithPoolTest) {
+  for (int round = 0; round < 100; ++round) {
+    std::vector<SharedCSSStylePtr> styles;
+    CSSStylePool* pool = lynx_new CSSStylePool;
+    for (int i = 0; i < 16; ++i) {
+      styles.push_back(pool->Intern(NewStyle()));
+    }
+    std::thread release([&styles]() { styles.clear(); });
+    lynx_delete(pool);
+    release.join();
+  }
+}
+}  // namespace lynx
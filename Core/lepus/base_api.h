@@ -11,18 +11,18 @@ namespace lepus {
         long params_count = context->GetParamsSize();
         for(long i = 0; i < params_count; i++) {
             Value* v = context->GetParam(i);
-            switch (v->type_) {
+            switch (v->type()) {
                 case Value_Nil:
                     printf("null\n");
                     break;
                 case Value_Number:
-                    printf("%lf\n", v->number_);
+                    printf("%lf\n", v->number());
                     break;
                 case Value_Boolean:
-                    printf("%s\n", v->boolean_ ? "true" : "false");
+                    printf("%s\n", v->boolean() ? "true" : "false");
                     break;
                 case Value_String:
-                    printf("%s\n", v->str_->c_str());
+                    printf("%s\n", v->str()->c_str());
                     break;
                 default:
                     break;
@@ -34,7 +34,7 @@ namespace lepus {
         Value* condition = context->GetParam(1);
         Value* msg = context->GetParam(2);
         if(condition->IsFalse()){
-           throw RuntimeException("Assertion failed:", msg->str_->c_str());
+           throw RuntimeException("Assertion failed:", msg->str()->c_str());
         }
         return Value();
     }
@@ -8,23 +8,22 @@ namespace lepus {
     
     void RegisterCFunction(Context* context, const char* name, CFunction function) {
         Value value;
-        value.native_function_ = reinterpret_cast<void*>(function);
-        value.type_ = Value_CFunction;
+        value.SetCFunction(reinterpret_cast<void*>(function));
         context->SetGlobalData(context->string_pool()->NewString(name), value);
     }
     
-    void RegisterFunctionTable(Context* context, const char* name, void* table) {
+    void RegisterFunctionTable(Context* context, const char* name, Dictonary* table) {
+        context->gc()->Track(table);
         Value value;
-        value.table_ = table;
-        value.type_ = Value_Table;
+        value.SetTable(table);
         context->SetGlobalData(context->string_pool()->NewString(name), value);
     }
     
     void RegisterTableFunction(Context* context, Dictonary* table, const char* name, CFunction function) {
         Value value;
-        value.native_function_ = reinterpret_cast<void*>(function);
-        value.type_ = Value_CFunction;
+        value.SetCFunction(reinterpret_cast<void*>(function));
         table->SetValue(context->string_pool()->NewString(name), value);
+        context->gc()->Barrier(table, value);
     }
     
     void RegisterBuiltin(Context* ctx) {
@@ -8,7 +8,7 @@
 namespace lepus {
     void RegisterBuiltin(Context* context);
     void RegisterCFunction(Context* context, const char* name, CFunction function);
-    void RegisterFunctionTable(Context* context, const char* name, void* function);
+    void RegisterFunctionTable(Context* context, const char* name, Dictonary* table);
     void RegisterTableFunction(Context* context, Dictonary* table, const char* name, CFunction function);
 }
 
@@ -0,0 +1,448 @@
+
+#include "lepus/bytecode.h"
+
+#include <cstring>
+
+#include "lepus/value.h"
+#include "lepus/switch.h"
+#include "lepus/exception.h"
+
+namespace lepus {
+
+    static const int kMaxFunctionDepth = 200;
+
+    bool IsBytecode(const char* data, std::size_t size) {
+        return size >= kBytecodeMagicSize
+            && memcmp(data, kBytecodeMagic, kBytecodeMagicSize) == 0;
+    }
+
+    BytecodeWriter::BytecodeWriter(Context* context)
+        : context_(context),
+          strings_(),
+          string_index_(),
+          buffer_() {
+    }
+
+    void BytecodeWriter::Write(Function* root,
+                               const std::unordered_map<String*, long>& top_level_variables,
+                               std::string& output) {
+        std::vector<String*> globals;
+        context_->global()->GetNames(globals);
+
+        for(std::size_t i = 0; i < globals.size(); ++i) {
+            AddString(globals[i]);
+        }
+        for(auto iter = top_level_variables.begin(); iter != top_level_variables.end(); ++iter) {
+            AddString(iter->first);
+        }
+        CollectStrings(root);
+
+        buffer_.append(kBytecodeMagic, kBytecodeMagicSize);
+        WriteU32(kBytecodeVersion);
+
+        WriteU32(strings_.size());
+        for(std::size_t i = 0; i < strings_.size(); ++i) {
+            WriteU32(strings_[i]->length());
+            buffer_.append(strings_[i]->c_str(), strings_[i]->length());
+        }
+
+        WriteU32(globals.size());
+        for(std::size_t i = 0; i < globals.size(); ++i) {
+            WriteString(globals[i]);
+        }
+
+        WriteU32(top_level_variables.size());
+        for(auto iter = top_level_variables.begin(); iter != top_level_variables.end(); ++iter) {
+            WriteString(iter->first);
+            WriteU32(static_cast<unsigned int>(iter->second));
+        }
+
+        WriteFunction(root);
+        output.swap(buffer_);
+        buffer_.clear();
+    }
+
+    void BytecodeWriter::CollectStrings(Function* function) {
+        for(std::size_t i = 0; i < function->const_values_.size(); ++i) {
+            if(function->const_values_[i].IsString()) {
+                AddString(function->const_values_[i].str());
+            }
+        }
+        for(std::size_t i = 0; i < function->upvalues_.size(); ++i) {
+            AddString(function->upvalues_[i].name_);
+        }
+        for(std::size_t i = 0; i < function->switches_.size(); ++i) {
+            SwitchInfo* info = function->switches_[i];
+            for(std::size_t j = 0; j < info->CaseSize(); ++j) {
+                if(info->GetCaseKey(j).IsString()) {
+                    AddString(info->GetCaseKey(j).str());
+                }
+            }
+        }
+        for(std::size_t i = 0; i < function->child_functions_.size(); ++i) {
+            CollectStrings(function->child_functions_[i]);
+        }
+    }
+
+    void BytecodeWriter::AddString(String* string) {
+        if(string_index_.find(string) != string_index_.end()) {
+            return;
+        }
+        string_index_[string] = strings_.size();
+        strings_.push_back(string);
+    }
+
+    // Function:
+    //   u32 count, { u32 instruction }
+    //   u32 count, { value }                    constants, u8 type and payload
+    //   u32 count, { u32 string, u32 register, u8 in_parent_vars }
+    //   u32 count, { i64 default_offset, u32 count, { value key, i64 offset } }
+    //                                           switches, rebuilt on load
+    //   u32 count, { function }                 child functions
+    void BytecodeWriter::WriteFunction(Function* function) {
+        WriteU32(function->op_codes_.size());
+        for(std::size_t i = 0; i < function->op_codes_.size(); ++i) {
+            WriteU32(static_cast<unsigned int>(function->op_codes_[i].op_code_));
+        }
+
+        WriteU32(function->const_values_.size());
+        for(std::size_t i = 0; i < function->const_values_.size(); ++i) {
+            WriteValue(function->const_values_[i]);
+        }
+
+        WriteU32(function->upvalues_.size());
+        for(std::size_t i = 0; i < function->upvalues_.size(); ++i) {
+            const UpvalueInfo& info = function->upvalues_[i];
+            WriteString(info.name_);
+            WriteU32(static_cast<unsigned int>(info.register_));
+            WriteU8(info.in_parent_vars_ ? 1 : 0);
+        }
+
+        WriteU32(function->switches_.size());
+        for(std::size_t i = 0; i < function->switches_.size(); ++i) {
+            SwitchInfo* info = function->switches_[i];
+            WriteI64(info->default_offset());
+            WriteU32(info->CaseSize());
+            for(std::size_t j = 0; j < info->CaseSize(); ++j) {
+                WriteValue(info->GetCaseKey(j));
+                WriteI64(info->GetCaseOffset(j));
+            }
+        }
+
+        WriteU32(function->child_functions_.size());
+        for(std::size_t i = 0; i < function->child_functions_.size(); ++i) {
+            WriteFunction(function->child_functions_[i]);
+        }
+    }
+
+    void BytecodeWriter::WriteU8(unsigned char value) {
+        buffer_.push_back(static_cast<char>(value));
+    }
+
+    void BytecodeWriter::WriteU32(unsigned int value) {
+        for(int i = 0; i < 4; ++i) {
+            buffer_.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+        }
+    }
+
+    void BytecodeWriter::WriteI64(long long value) {
+        unsigned long long bits = static_cast<unsigned long long>(value);
+        for(int i = 0; i < 8; ++i) {
+            buffer_.push_back(static_cast<char>((bits >> (i * 8)) & 0xFF));
+        }
+    }
+
+    void BytecodeWriter::WriteDouble(double value) {
+        long long bits = 0;
+        memcpy(&bits, &value, sizeof(bits));
+        WriteI64(bits);
+    }
+
+    void BytecodeWriter::WriteString(String* string) {
+        WriteU32(string_index_[string]);
+    }
+
+    void BytecodeWriter::WriteValue(const Value& value) {
+        WriteU8(value.type());
+        switch (value.type()) {
+            case Value_Number:
+                WriteDouble(value.number());
+                break;
+            case Value_Boolean:
+                WriteU8(value.boolean() ? 1 : 0);
+                break;
+            case Value_String:
+                WriteString(value.str());
+                break;
+            default:
+                break;
+        }
+    }
+
+    BytecodeReader::BytecodeReader(Context* context, const char* data, std::size_t size)
+        : context_(context),
+          data_(data),
+          end_(data + size),
+          strings_(),
+          global_remap_() {
+    }
+
+    Function* BytecodeReader::Read(std::unordered_map<String*, long>& top_level_variables) {
+        if(!IsBytecode(data_, end_ - data_)) {
+            throw RuntimeException("invalid lepus bytecode");
+        }
+        data_ += kBytecodeMagicSize;
+        if(ReadU32() != kBytecodeVersion) {
+            throw RuntimeException("unsupported lepus bytecode version");
+        }
+
+        unsigned int string_count = ReadU32();
+        for(unsigned int i = 0; i < string_count; ++i) {
+            unsigned int length = ReadU32();
+            Need(length);
+            strings_.push_back(context_->string_pool()->NewString(data_, length));
+            data_ += length;
+        }
+
+        // Globals are addressed by index, the executing context may have
+        // registered them in a different order than the compiling one.
+        unsigned int global_count = ReadU32();
+        for(unsigned int i = 0; i < global_count; ++i) {
+            global_remap_.push_back(context_->global()->Search(ReadString()));
+        }
+
+        unsigned int variable_count = ReadU32();
+        std::vector<std::pair<String*, long> > variables;
+        for(unsigned int i = 0; i < variable_count; ++i) {
+            String* name = ReadString();
+            long register_id = ReadU32();
+            variables.push_back(std::make_pair(name, register_id));
+        }
+
+        base::ScopedPtr<Function> root(ReadFunction(nullptr, 0));
+        if(data_ != end_) {
+            throw RuntimeException("invalid lepus bytecode");
+        }
+        // Top level variables live in the registers of the root function.
+        for(std::size_t i = 0; i < variables.size(); ++i) {
+            if(static_cast<std::size_t>(variables[i].second) >= root->frame_size()) {
+                throw RuntimeException("invalid lepus bytecode variable register");
+            }
+        }
+        for(std::size_t i = 0; i < variables.size(); ++i) {
+            if(top_level_variables.insert(variables[i]).second) {
+                variables[i].first->AddRef();
+            }
+        }
+        return root.Release();
+    }
+
+    Function* BytecodeReader::ReadFunction(Function* parent, int depth) {
+        if(depth > kMaxFunctionDepth) {
+            throw RuntimeException("invalid lepus bytecode");
+        }
+        base::ScopedPtr<Function> function(lynx_new Function);
+
+        unsigned int op_count = ReadU32();
+        // Counts are checked against the data left before they size
+        // anything.
+        Need(static_cast<std::size_t>(op_count) * 4);
+        function->op_codes_.reserve(op_count);
+        for(unsigned int i = 0; i < op_count; ++i) {
+            Instruction instruction;
+            instruction.op_code_ = ReadU32();
+            long op = Instruction::GetOpCode(instruction);
+            if(op < TypeOp_LoadNil || op > kLastOpCode) {
+                throw RuntimeException("invalid lepus bytecode op code");
+            }
+            if(Instruction::GetOpCode(instruction) == TypeOp_GetGlobal) {
+                std::size_t index = Instruction::GetParamBx(instruction);
+                if(index >= global_remap_.size() || global_remap_[index] < 0) {
+                    throw RuntimeException("lepus bytecode references unknown global");
+                }
+                instruction = Instruction::ABxCode(TypeOp_GetGlobal,
+                                                   Instruction::GetParamA(instruction),
+                                                   global_remap_[index]);
+            }
+            function->op_codes_.push_back(instruction);
+        }
+        // Fused compares borrow the offset of the Jmp that follows them.
+        for(std::size_t i = 0; i < function->op_codes_.size(); ++i) {
+            long op = Instruction::GetOpCode(function->op_codes_[i]);
+            if((op == TypeOp_LessJmpFalse || op == TypeOp_LessEqualJmpFalse)
+               && (i + 1 == function->op_codes_.size()
+                   || Instruction::GetOpCode(function->op_codes_[i + 1]) != TypeOp_Jmp)) {
+                throw RuntimeException("invalid lepus bytecode op code");
+            }
+            if(op == TypeOp_Jmp || op == TypeOp_JmpFalse) {
+                CheckJump(function.Get(), i, Instruction::GetParamsBx(function->op_codes_[i]));
+            }
+        }
+        // Sizes the frame, which the upvalues of the children index into.
+        function->GetDecodedOpCodes();
+
+        unsigned int const_count = ReadU32();
+        // At least a type byte each.
+        Need(const_count);
+        function->const_values_.reserve(const_count);
+        for(unsigned int i = 0; i < const_count; ++i) {
+            Value value = ReadValue();
+            if(value.IsString()) {
+                value.str()->AddRef();
+            }
+            function->const_values_.push_back(value);
+        }
+
+        unsigned int upvalue_count = ReadU32();
+        for(unsigned int i = 0; i < upvalue_count; ++i) {
+            String* name = ReadString();
+            long register_id = ReadU32();
+            bool in_parent_vars = ReadU8() != 0;
+            // A closure takes its upvalues from a register of the frame
+            // that creates it or from the upvalues of that frame's closure.
+            // The root closure has none.
+            std::size_t limit = 0;
+            if(parent != nullptr) {
+                limit = in_parent_vars ? parent->frame_size() : parent->UpvaluesSize();
+            }
+            if(static_cast<std::size_t>(register_id) >= limit) {
+                throw RuntimeException("invalid lepus bytecode upvalue");
+            }
+            function->AddUpvalue(name, register_id, in_parent_vars);
+        }
+
+        unsigned int switch_count = ReadU32();
+        for(unsigned int i = 0; i < switch_count; ++i) {
+            SwitchInfo* info = lynx_new SwitchInfo;
+            function->switches_.push_back(info);
+            info->set_default_offset(ReadI64());
+            unsigned int case_count = ReadU32();
+            // At least a type byte and an offset each.
+            Need(static_cast<std::size_t>(case_count) * 9);
+            for(unsigned int j = 0; j < case_count; ++j) {
+                Value key = ReadValue();
+                info->AddCase(key, ReadI64());
+            }
+            info->Build();
+        }
+
+        unsigned int child_count = ReadU32();
+        for(unsigned int i = 0; i < child_count; ++i) {
+            Function* child = ReadFunction(function.Get(), depth + 1);
+            child->set_index(function->AddChildFunction(child));
+        }
+        CheckOperands(function.Get());
+        return function.Release();
+    }
+
+    void BytecodeReader::CheckOperands(Function* function) {
+        for(std::size_t i = 0; i < function->op_codes_.size(); ++i) {
+            Instruction instruction = function->op_codes_[i];
+            std::size_t index = Instruction::GetParamBx(instruction);
+            switch (Instruction::GetOpCode(instruction)) {
+                case TypeOp_LoadConst:
+                    if(index >= function->const_values_.size()) {
+                        throw RuntimeException("invalid lepus bytecode constant index");
+                    }
+                    break;
+                case TypeOp_Closure:
+                    if(index >= function->child_functions_.size()) {
+                        throw RuntimeException("invalid lepus bytecode function index");
+                    }
+                    break;
+                case TypeOp_GetUpvalue:
+                case TypeOp_SetUpvalue:
+                    if(static_cast<std::size_t>(Instruction::GetParamB(instruction))
+                       >= function->upvalues_.size()) {
+                        throw RuntimeException("invalid lepus bytecode upvalue index");
+                    }
+                    break;
+                case TypeOp_Switch: {
+                    if(index >= function->switches_.size()) {
+                        throw RuntimeException("invalid lepus bytecode switch index");
+                    }
+                    SwitchInfo* info = function->switches_[index];
+                    CheckJump(function, i, info->default_offset());
+                    for(std::size_t j = 0; j < info->CaseSize(); ++j) {
+                        CheckJump(function, i, info->GetCaseOffset(j));
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+
+    // The target may be one past the last instruction, which returns.
+    void BytecodeReader::CheckJump(Function* function, std::size_t pc, long offset) {
+        long size = static_cast<long>(function->op_codes_.size());
+        if(offset < -static_cast<long>(pc) || offset > size - static_cast<long>(pc)) {
+            throw RuntimeException("invalid lepus bytecode jump target");
+        }
+    }
+
+    void BytecodeReader::Need(std::size_t size) {
+        if(static_cast<std::size_t>(end_ - data_) < size) {
+            throw RuntimeException("truncated lepus bytecode");
+        }
+    }
+
+    unsigned char BytecodeReader::ReadU8() {
+        Need(1);
+        return static_cast<unsigned char>(*data_++);
+    }
+
+    unsigned int BytecodeReader::ReadU32() {
+        Need(4);
+        unsigned int value = 0;
+        for(int i = 0; i < 4; ++i) {
+            value |= static_cast<unsigned int>(static_cast<unsigned char>(*data_++)) << (i * 8);
+        }
+        return value;
+    }
+
+    long long BytecodeReader::ReadI64() {
+        Need(8);
+        unsigned long long bits = 0;
+        for(int i = 0; i < 8; ++i) {
+            bits |= static_cast<unsigned long long>(static_cast<unsigned char>(*data_++)) << (i * 8);
+        }
+        return static_cast<long long>(bits);
+    }
+
+    double BytecodeReader::ReadDouble() {
+        long long bits = ReadI64();
+        double value = 0;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    String* BytecodeReader::ReadString() {
+        unsigned int index = ReadU32();
+        if(index >= strings_.size()) {
+            throw RuntimeException("invalid lepus bytecode string index");
+        }
+        return strings_[index];
+    }
+
+    Value BytecodeReader::ReadValue() {
+        Value value;
+        switch (ReadU8()) {
+            case Value_Nil:
+                break;
+            case Value_Number:
+                value.SetNumber(ReadDouble());
+                break;
+            case Value_Boolean:
+                value.SetBoolean(ReadU8() != 0);
+                break;
+            case Value_String:
+                value.SetString(ReadString());
+                break;
+            default:
+                throw RuntimeException("invalid lepus bytecode constant");
+        }
+        return value;
+    }
+}
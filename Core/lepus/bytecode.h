@@ -0,0 +1,81 @@
+
+#ifndef LYNX_LEPUS_BYTECODE_H_
+#define LYNX_LEPUS_BYTECODE_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "lepus/context.h"
+#include "lepus/function.h"
+#include "lepus/lepus_string.h"
+
+namespace lepus {
+
+    // Layout of a serialized program, all integers little-endian:
+    //   magic "\x1bLPS", u32 version
+    //   string table   : u32 count, { u32 length, bytes }
+    //   global table   : u32 count, { u32 string } (global name by index)
+    //   top level vars : u32 count, { u32 string, i32 register }
+    //   root function  : see BytecodeWriter::WriteFunction
+    static const char kBytecodeMagic[] = "\x1bLPS";
+    static const std::size_t kBytecodeMagicSize = 4;
+    static const unsigned int kBytecodeVersion = 3;
+
+    bool IsBytecode(const char* data, std::size_t size);
+
+    class BytecodeWriter {
+    public:
+        explicit BytecodeWriter(Context* context);
+        void Write(Function* root,
+                   const std::unordered_map<String*, long>& top_level_variables,
+                   std::string& output);
+    private:
+        void CollectStrings(Function* function);
+        void AddString(String* string);
+        void WriteFunction(Function* function);
+        void WriteU8(unsigned char value);
+        void WriteU32(unsigned int value);
+        void WriteI64(long long value);
+        void WriteDouble(double value);
+        void WriteString(String* string);
+        void WriteValue(const Value& value);
+
+        Context* context_;
+        std::vector<String*> strings_;
+        std::unordered_map<String*, unsigned int> string_index_;
+        std::string buffer_;
+    };
+
+    class BytecodeReader {
+    public:
+        BytecodeReader(Context* context, const char* data, std::size_t size);
+        // Returns the root function, ownership is passed to the caller.
+        // Throws RuntimeException if the data is truncated or malformed.
+        Function* Read(std::unordered_map<String*, long>& top_level_variables);
+    private:
+        // |parent| is null for the root function.
+        Function* ReadFunction(Function* parent, int depth);
+        // Every index an instruction carries must stay inside |function|:
+        // constants, child functions, upvalues, switches and jump targets.
+        // Registers are not checked, the frame is sized to fit them.
+        void CheckOperands(Function* function);
+        void CheckJump(Function* function, std::size_t pc, long offset);
+        void Need(std::size_t size);
+        unsigned char ReadU8();
+        unsigned int ReadU32();
+        long long ReadI64();
+        double ReadDouble();
+        String* ReadString();
+        // Strings come back unpinned.
+        Value ReadValue();
+
+        Context* context_;
+        const char* data_;
+        const char* end_;
+        std::vector<String*> strings_;
+        std::vector<long> global_remap_;
+    };
+}
+
+#endif  // LYNX_LEPUS_BYTECODE_H_
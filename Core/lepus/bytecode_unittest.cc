@@ -0,0 +1,187 @@
+// Copyright 2017 The Lynx Authors. All rights reserved.
+
+#include "lepus/bytecode.h"
+
+#include "gtest/gtest.h"
+#include "lepus/exception.h"
+#include "lepus/value.h"
+#include "lepus/vm_context.h"
+
+namespace lepus {
+
+class BytecodeTest : public testing::Test {
+ protected:
+  typedef std::unordered_map<String*, long> Variables;
+
+  BytecodeTest() { context_.Initialize(); }
+
+  // Writes |root| out and reads it back, throws if the reader rejects it.
+  void RoundTrip(Function* root, const Variables& variables) {
+    std::string bytecode;
+    BytecodeWriter writer(&context_);
+    writer.Write(root, variables, bytecode);
+    Variables read_variables;
+    BytecodeReader reader(&context_, bytecode.data(), bytecode.size());
+    base::ScopedPtr<Function> read(reader.Read(read_variables));
+    for (Variables::iterator iter = read_variables.begin();
+         iter != read_variables.end(); ++iter) {
+      iter->first->Release();
+    }
+  }
+
+  void RoundTrip(Function* root) { RoundTrip(root, Variables()); }
+
+  String* NewString(const char* string) {
+    return context_.string_pool()->NewString(string);
+  }
+
+  VMContext context_;
+};
+
+TEST_F(BytecodeTest, CompiledScriptTest) {
+  const std::string source =
+      "var count = 0;\n"
+      "function counter(step) {\n"
+      "  function add() { count = count + step; return count; }\n"
+      "  return add;\n"
+      "}\n"
+      "function name(n) {\n"
+      "  switch (n) {\n"
+      "    case 1: return \"one\";\n"
+      "    case 2: return \"two\";\n"
+      "    case \"three\": return 3;\n"
+      "    default: return \"many\";\n"
+      "  }\n"
+      "}\n"
+      "for (var i = 0; i < 10; i++) { counter(i)(); }\n"
+      "name(count);\n";
+  std::string bytecode;
+  ASSERT_TRUE(context_.Compile(source, bytecode));
+
+  VMContext context;
+  context.Initialize();
+  Variables variables;
+  BytecodeReader reader(&context, bytecode.data(), bytecode.size());
+  base::ScopedPtr<Function> root;
+  EXPECT_NO_THROW(root.Reset(reader.Read(variables)));
+  EXPECT_EQ(2u, root->ChildFunctionsSize());
+}
+
+TEST_F(BytecodeTest, ValidFunctionTest) {
+  Function root;
+  root.AddConstNumber(1);
+  root.AddInstruction(Instruction::ABxCode(TypeOp_LoadConst, 0, 0));
+  root.AddInstruction(Instruction::ABxCode(TypeOp_JmpFalse, 0, 2));
+  root.AddInstruction(Instruction::ABxCode(TypeOp_Jmp, 0, -2));
+  EXPECT_NO_THROW(RoundTrip(&root));
+}
+
+TEST_F(BytecodeTest, TruncatedTest) {
+  Function root;
+  root.AddInstruction(Instruction::ACode(TypeOp_LoadNil, 0));
+  std::string bytecode;
+  BytecodeWriter writer(&context_);
+  writer.Write(&root, Variables(), bytecode);
+
+  Variables variables;
+  BytecodeReader reader(&context_, bytecode.data(), bytecode.size() - 1);
+  EXPECT_THROW(reader.Read(variables), RuntimeException);
+}
+
+TEST_F(BytecodeTest, ConstantIndexTest) {
+  Function root;
+  root.AddConstNumber(1);
+  root.AddInstruction(Instruction::ABxCode(TypeOp_LoadConst, 0, 1));
+  EXPECT_THROW(RoundTrip(&root), RuntimeException);
+}
+
+TEST_F(BytecodeTest, JumpTargetTest) {
+  // One past the last instruction is the end of the function.
+  Function end;
+  end.AddInstruction(Instruction::ABxCode(TypeOp_Jmp, 0, 1));
+  EXPECT_NO_THROW(RoundTrip(&end));
+
+  Function forward;
+  forward.AddInstruction(Instruction::ABxCode(TypeOp_Jmp, 0, 2));
+  EXPECT_THROW(RoundTrip(&forward), RuntimeException);
+
+  Function backward;
+  backward.AddInstruction(Instruction::ACode(TypeOp_LoadNil, 0));
+  backward.AddInstruction(Instruction::ABxCode(TypeOp_JmpFalse, 0, -2));
+  EXPECT_THROW(RoundTrip(&backward), RuntimeException);
+
+  Function fused;
+  fused.AddInstruction(Instruction::ABCCode(TypeOp_LessJmpFalse, 0, 0, 1));
+  fused.AddInstruction(Instruction::ABxCode(TypeOp_Jmp, 0, 3));
+  EXPECT_THROW(RoundTrip(&fused), RuntimeException);
+}
+
+TEST_F(BytecodeTest, SwitchTest) {
+  Function index;
+  index.AddInstruction(Instruction::ABxCode(TypeOp_Switch, 0, 0));
+  EXPECT_THROW(RoundTrip(&index), RuntimeException);
+
+  Function offset;
+  SwitchInfo* info = lynx_new SwitchInfo;
+  info->AddCase(Value(1), 5);
+  info->set_default_offset(1);
+  offset.AddSwitch(info);
+  offset.AddInstruction(Instruction::ABxCode(TypeOp_Switch, 0, 0));
+  EXPECT_THROW(RoundTrip(&offset), RuntimeException);
+
+  Function default_offset;
+  info = lynx_new SwitchInfo;
+  info->AddCase(Value(1), 1);
+  info->set_default_offset(-1);
+  default_offset.AddSwitch(info);
+  default_offset.AddInstruction(Instruction::ABxCode(TypeOp_Switch, 0, 0));
+  EXPECT_THROW(RoundTrip(&default_offset), RuntimeException);
+}
+
+TEST_F(BytecodeTest, ClosureIndexTest) {
+  Function root;
+  root.AddInstruction(Instruction::ABxCode(TypeOp_Closure, 0, 0));
+  EXPECT_THROW(RoundTrip(&root), RuntimeException);
+}
+
+TEST_F(BytecodeTest, UpvalueTest) {
+  Function index;
+  Function* child = lynx_new Function;
+  child->AddInstruction(Instruction::ABCode(TypeOp_GetUpvalue, 0, 0));
+  index.AddChildFunction(child);
+  index.AddInstruction(Instruction::ABxCode(TypeOp_Closure, 0, 0));
+  EXPECT_THROW(RoundTrip(&index), RuntimeException);
+
+  // The parent frame has registers 0 and 1.
+  Function parent_register;
+  child = lynx_new Function;
+  child->AddUpvalue(NewString("x"), 2, true);
+  parent_register.AddChildFunction(child);
+  parent_register.AddInstruction(Instruction::ABxCode(TypeOp_Closure, 1, 0));
+  EXPECT_THROW(RoundTrip(&parent_register), RuntimeException);
+
+  Function parent_upvalue;
+  child = lynx_new Function;
+  child->AddUpvalue(NewString("x"), 0, false);
+  parent_upvalue.AddChildFunction(child);
+  parent_upvalue.AddInstruction(Instruction::ABxCode(TypeOp_Closure, 0, 0));
+  EXPECT_THROW(RoundTrip(&parent_upvalue), RuntimeException);
+
+  Function root;
+  root.AddUpvalue(NewString("x"), 0, true);
+  root.AddInstruction(Instruction::ACode(TypeOp_LoadNil, 0));
+  EXPECT_THROW(RoundTrip(&root), RuntimeException);
+}
+
+TEST_F(BytecodeTest, VariableRegisterTest) {
+  Function root;
+  root.AddInstruction(Instruction::ACode(TypeOp_LoadNil, 1));
+
+  Variables variables;
+  variables[NewString("x")] = 1;
+  EXPECT_NO_THROW(RoundTrip(&root, variables));
+
+  variables[NewString("y")] = 2;
+  EXPECT_THROW(RoundTrip(&root, variables), RuntimeException);
+}
+}  // namespace lepus
@@ -211,8 +211,9 @@ namespace lepus {
             Guard<CodeGenerator> g(this, &CodeGenerator::EnterBlock, &CodeGenerator::LeaveBlock);
             ast->block()->Accept(this, nullptr);
             Value* top = context_->heap().top_++;
-            top->closure_ = lynx_new Closure(static_cast<Function*>(current_function_->function_));
-            top->type_ = Value_Closure;
+            Closure* closure = lynx_new Closure(static_cast<Function*>(current_function_->function_));
+            context_->gc()->Track(closure);
+            top->SetClosure(closure);
         }
         context_->root_function_.Reset(static_cast<Function*>(current_function_->function_));
     }
@@ -297,6 +298,37 @@ namespace lepus {
         UpvalueOperator(TypeOp_SetUpvalue, src, dst);
     }
     
+    void CodeGenerator::WriteTableValue(LexicalOp op, long table, long key, long src) {
+        Guard<CodeGenerator> g(this, &CodeGenerator::EnterRegister, &CodeGenerator::LeaveRegister);
+        Function* function = current_function_->function_;
+        long register_id = GenerateRegisiterId();
+        switch (op) {
+            case LexicalOp_ASSIGN_ADD:
+                BinaryOperator(TypeOp_GetTable, register_id, table, key);
+                BinaryOperator(TypeOp_Add, src, register_id, src);
+                break;
+            case LexicalOp_ASSIGN_SUB:
+                BinaryOperator(TypeOp_GetTable, register_id, table, key);
+                BinaryOperator(TypeOp_Sub, src, register_id, src);
+                break;
+            case LexicalOp_ASSIGN_MUL:
+                BinaryOperator(TypeOp_GetTable, register_id, table, key);
+                BinaryOperator(TypeOp_Mul, src, register_id, src);
+                break;
+            case LexicalOp_ASSIGN_DIV:
+                BinaryOperator(TypeOp_GetTable, register_id, table, key);
+                BinaryOperator(TypeOp_Div, src, register_id, src);
+                break;
+            case LexicalOp_ASSIGN_MOD:
+                BinaryOperator(TypeOp_GetTable, register_id, table, key);
+                BinaryOperator(TypeOp_Mod, src, register_id, src);
+                break;
+            default:
+                break;
+        }
+        BinaryOperator(TypeOp_SetTable, table, key, src);
+    }
+    
     void CodeGenerator::AutomaticLocalValue(AutomaticType type, long dst, long src) {
         Function* function = current_function_->function_;
         switch (type) {
@@ -530,6 +562,8 @@ namespace lepus {
     void CodeGenerator::Visit(FunctionStatementAST* ast, void* data){
         long child_index = 0;
         long register_id = GenerateRegisiterId();
+        // Visible inside its own body so the function can recurse.
+        InsertVariable(ast->function_name().str_, register_id);
         {
             Guard<CodeGenerator> g(this, &CodeGenerator::EnterFunction, &CodeGenerator::LeaveFunction);
             {
@@ -545,7 +579,6 @@ namespace lepus {
         }
         ResetRegisiterId(register_id + 1);
         
-        InsertVariable(ast->function_name().str_, register_id);
         Instruction i = Instruction::ABxCode(TypeOp_Closure,
                                              register_id,
                                              child_index);
@@ -688,22 +721,48 @@ namespace lepus {
             Guard<CodeGenerator> g(this, &CodeGenerator::EnterLoop, &CodeGenerator::LeaveLoop);
             long register_id = GenerateRegisiterId();
             ast->expression()->Accept(this, &register_id);
-            SwitchInfo* info = SwitchInfo::Create(ast->cases());
+            SwitchInfo* info = lynx_new SwitchInfo;
             long index = function->AddSwitch(info);
             Switch(jmp_index, register_id, index);
             for(base::ScopedVector<ASTree>::iterator iter = ast->cases().begin();
                 iter != ast->cases().end(); ++iter) {
                 Guard<CodeGenerator> g(this, &CodeGenerator::EnterBlock, &CodeGenerator::LeaveBlock);
+                CaseStatementAST* case_ast = static_cast<CaseStatementAST*>(*iter);
                 long case_jmp_index = function->OpCodeSize();
-                (*iter)->Accept(this, &case_jmp_index);
-                info->Modify(static_cast<CaseStatementAST*>(*iter)->key(), case_jmp_index-jmp_index);
+                case_ast->Accept(this, &case_jmp_index);
+                if(case_ast->is_default()) {
+                    info->set_default_offset(case_jmp_index - jmp_index);
+                }else{
+                    info->AddCase(CaseKey(case_ast->key()), case_jmp_index - jmp_index);
+                }
             }
             if(info->default_offset() == -1) {
                 info->set_default_offset(function->OpCodeSize() - jmp_index);
             }
+            info->Build();
         }
     }
     
+    Value CodeGenerator::CaseKey(const Token& key) {
+        Value value;
+        switch (key.token_) {
+            case Token_Number:
+                value.SetNumber(key.number_);
+                break;
+            case Token_String:
+                value.SetString(key.str_);
+                break;
+            case Token_True: case Token_False:
+                value.SetBoolean(key.token_ == Token_True);
+                break;
+            case Token_Nil:
+                break;
+            default:
+                throw CompileException("case label must be a constant", key);
+        }
+        return value;
+    }
+    
     void CodeGenerator::Visit(CaseStatementAST* ast, void* data) {
         ast->block()->Accept(this, nullptr);
     }
@@ -727,7 +786,11 @@ namespace lepus {
 
         function->AddInstruction(Instruction::ABxCode(TypeOp_LoadConst, member_reg_id, index));
         
-        function->AddInstruction(Instruction::ABCCode(TypeOp_GetTable, *static_cast<int*>(data), reg, member_reg_id));
+        if(ast->lex_op() >= LexicalOp_Write) {
+            WriteTableValue(ast->lex_op(), reg, member_reg_id, *static_cast<long*>(data));
+        }else{
+            function->AddInstruction(Instruction::ABCCode(TypeOp_GetTable, *static_cast<long*>(data), reg, member_reg_id));
+        }
     }
     
     void CodeGenerator::Visit(FunctionCallAST* ast, void* data){
@@ -118,6 +118,10 @@ namespace lepus {
         
         void WriteLocalValue(LexicalOp op, long dst, long src);
         void WriteUpValue(LexicalOp op, long dst, long src);
+        void WriteTableValue(LexicalOp op, long table, long key, long src);
+        
+        // Constant value of a case label.
+        Value CaseKey(const Token& key);
         
         void AutomaticLocalValue(AutomaticType type, long dst, long src);
         void AutomaticUpValue(AutomaticType type, long dst, long src);
@@ -9,6 +9,7 @@
 #include "lepus/value.h"
 #include "lepus/lepus_string.h"
 #include "lepus/table.h"
+#include "lepus/gc.h"
 
 namespace lepus {
     
@@ -17,13 +18,11 @@ namespace lepus {
         Global() : global_(), global_content_(){
         }
         
+        // Tables are owned by the GC, only the name pins are dropped here.
         ~Global() {
             std::unordered_map<String*, int>::iterator iter = global_.begin();
             for(;iter != global_.end(); ++iter) {
                 iter->first->Release();
-                if(global_content_[iter->second].type_ == Value_Table){
-                    lynx_delete(static_cast<Dictonary*>(global_content_[iter->second].table_));
-                }
             }
         }
         
@@ -60,13 +59,28 @@ namespace lepus {
             global_.insert(std::make_pair(name, global_content_.size() - 1));
             return global_content_.size() - 1;
         }
+        
+        void MarkRoots(GC* gc) {
+            for(std::size_t i = 0; i < global_content_.size(); ++i) {
+                gc->Mark(global_content_[i]);
+            }
+        }
+        
+        void GetNames(std::vector<String*>& names) {
+            names.resize(global_content_.size(), nullptr);
+            std::unordered_map<String*, int>::iterator iter = global_.begin();
+            for(;iter != global_.end(); ++iter) {
+                names[iter->second] = iter->first;
+            }
+        }
     private:
         std::unordered_map<String*, int> global_;
         std::vector<Value> global_content_;
     };
     
-    class Context {
+    class Context : public GCRoots {
     public:
+        Context() : string_pool_(&gc_), gc_(this), global_(), user_data_(nullptr) {}
         virtual ~Context(){}
         virtual void Initialize() = 0;
         virtual void Execute(const std::string& source) = 0;
@@ -82,10 +96,28 @@ namespace lepus {
         StringPool* string_pool(){
             return &string_pool_;
         }
+        GC* gc() {
+            return &gc_;
+        }
+        // Opaque pointer of the embedder, handed back to CFunctions through
+        // the context they are called with.
+        void set_user_data(void* user_data) {
+            user_data_ = user_data;
+        }
+        void* user_data() {
+            return user_data_;
+        }
+        virtual void MarkRoots(GC* gc) {
+            global_.MarkRoots(gc);
+        }
     protected:
 
+        // Destroyed bottom up: globals drop their pins, then the GC frees
+        // every object, which unregisters the strings from the pool.
         StringPool string_pool_;
+        GC gc_;
         Global global_;
+        void* user_data_;
     };
     
     typedef Value (*CFunction)(Context *);
@@ -0,0 +1,113 @@
+#include "lepus/disassembler.h"
+
+#include <iomanip>
+#include <sstream>
+
+#include "lepus/value.h"
+
+namespace lepus {
+    namespace {
+        const char* kOpCodeNames[] = {
+            "End", "LoadNil", "LoadConst", "Move", "GetUpvalue", "SetUpvalue",
+            "GetGlobal", "SetGlobal", "Closure", "Call", "Ret", "JmpFalse",
+            "Jmp", "Neg", "Not", "Len", "Add", "Sub", "Mul", "Div", "Pow",
+            "Mod", "And", "Or", "Less", "Greater", "Equal", "UnEqual",
+            "LessEqual", "GreaterEqual", "NewTable", "SetTable", "GetTable",
+            "Switch", "Inc", "Dec", "Noop", "LessJmpFalse",
+            "LessEqualJmpFalse",
+        };
+        static_assert(sizeof(kOpCodeNames) / sizeof(kOpCodeNames[0]) == kLastOpCode + 1,
+                      "every op code needs a name");
+        
+        void PrintConst(Function* function, std::size_t index, std::ostream& out) {
+            Value* value = function->GetConstValue(index);
+            if(value == nullptr) {
+                out << "<bad const>";
+                return;
+            }
+            switch (value->type()) {
+                case Value_Number:
+                    out << value->number();
+                    break;
+                case Value_String:
+                    out << '"' << value->str()->c_str() << '"';
+                    break;
+                case Value_Boolean:
+                    out << (value->boolean() ? "true" : "false");
+                    break;
+                default:
+                    out << "nil";
+                    break;
+            }
+        }
+        
+        void DisassembleFunction(Function* function, const std::string& name, std::ostream& out) {
+            out << "function " << name << ": " << function->OpCodeSize() << " instructions, "
+                << function->ConstValuesSize() << " constants, "
+                << function->UpvaluesSize() << " upvalues" << std::endl;
+            for(std::size_t pc = 0; pc < function->OpCodeSize(); ++pc) {
+                Instruction i = *function->GetInstruction(pc);
+                long op = Instruction::GetOpCode(i);
+                long a = Instruction::GetParamA(i);
+                long b = Instruction::GetParamB(i);
+                long c = Instruction::GetParamC(i);
+                out << std::setw(6) << pc << "  " << std::left << std::setw(18)
+                    << OpCodeName(op) << std::right;
+                switch (op) {
+                    case TypeOp_LoadNil: case TypeOp_Neg: case TypeOp_Not:
+                    case TypeOp_Len: case TypeOp_NewTable: case TypeOp_Inc:
+                    case TypeOp_Dec: case TypeOp_Ret:
+                        out << a;
+                        break;
+                    case TypeOp_Move: case TypeOp_GetUpvalue: case TypeOp_SetUpvalue:
+                        out << a << ' ' << b;
+                        break;
+                    case TypeOp_LoadConst:
+                        out << a << ' ' << Instruction::GetParamBx(i) << "    ; ";
+                        PrintConst(function, Instruction::GetParamBx(i), out);
+                        break;
+                    case TypeOp_GetGlobal: case TypeOp_SetGlobal: case TypeOp_Closure:
+                    case TypeOp_Switch:
+                        out << a << ' ' << Instruction::GetParamBx(i);
+                        break;
+                    case TypeOp_JmpFalse:
+                        out << a << " -> " << pc + Instruction::GetParamsBx(i);
+                        break;
+                    case TypeOp_Jmp:
+                        out << "-> " << pc + Instruction::GetParamsBx(i);
+                        break;
+                    case TypeOp_LessJmpFalse: case TypeOp_LessEqualJmpFalse:
+                        out << b << ' ' << c;
+                        break;
+                    case TypeOp_Noop:
+                        break;
+                    default:
+                        out << a << ' ' << b << ' ' << c;
+                        break;
+                }
+                out << std::endl;
+            }
+            for(std::size_t i = 0; i < function->ChildFunctionsSize(); ++i) {
+                std::ostringstream child;
+                child << name << '.' << i;
+                DisassembleFunction(function->GetChildFunction(i), child.str(), out);
+            }
+        }
+    }
+    
+    const char* OpCodeName(long op) {
+        return op >= 0 && op <= kLastOpCode ? kOpCodeNames[op] : "?";
+    }
+    
+    void Disassemble(Function* function, std::ostream& out) {
+        DisassembleFunction(function, "0", out);
+    }
+    
+    std::size_t CountInstructions(Function* function) {
+        std::size_t count = function->OpCodeSize();
+        for(std::size_t i = 0; i < function->ChildFunctionsSize(); ++i) {
+            count += CountInstructions(function->GetChildFunction(i));
+        }
+        return count;
+    }
+}
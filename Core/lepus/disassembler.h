@@ -0,0 +1,19 @@
+#ifndef LYNX_LEPUS_DISASSEMBLER_H_
+#define LYNX_LEPUS_DISASSEMBLER_H_
+
+#include <ostream>
+
+#include "lepus/function.h"
+
+namespace lepus {
+    const char* OpCodeName(long op);
+    
+    // Prints |function| and its child functions, one instruction per line
+    // with jump targets resolved to instruction indexes.
+    void Disassemble(Function* function, std::ostream& out);
+    
+    // Instructions of |function| and its child functions.
+    std::size_t CountInstructions(Function* function);
+}
+
+#endif  // LYNX_LEPUS_DISASSEMBLER_H_
@@ -7,16 +7,22 @@
 namespace lepus {
     class Exception {
     public:
+        Exception() : stream_() {}
+        
+        Exception(const Exception& other) : stream_() {
+            stream_<<other.message();
+        }
+        
         const std::string message() const {
-            return stream_->str();
+            return stream_.str();
         }
         
     protected:
         std::ostringstream& stream() {
-            return *stream_;
+            return stream_;
         }
     private:
-        std::ostringstream* stream_;
+        std::ostringstream stream_;
     };
     
     class CompileException : public Exception {
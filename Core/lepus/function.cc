@@ -1,35 +1,102 @@
 #include "lepus/function.h"
 #include "lepus/value.h"
 
+#include <algorithm>
+
 namespace lepus {
+    Function::~Function() {
+        for(std::size_t i = 0; i < const_values_.size(); ++i) {
+            if(const_values_[i].IsString()) {
+                const_values_[i].str()->Release();
+            }
+        }
+        for(std::size_t i = 0; i < upvalues_.size(); ++i) {
+            upvalues_[i].name_->Release();
+        }
+#if LEPUS_JIT
+        lynx_delete(jit_code_.load());
+#endif
+    }
+    
     std::size_t Function::AddConstNumber(double number) {
         Value v;
-        v.number_ = number;
-        v.type_ = Value_Number;
+        v.SetNumber(number);
         return AddConstValue(v);
     }
     
     std::size_t Function::AddConstString(String* string) {
         Value v;
-        v.str_ = string;
-        v.str_->AddRef();
-        v.type_ = Value_String;
+        v.SetString(string);
         return AddConstValue(v);
     }
     
     std::size_t Function::AddConstBoolean(bool boolean) {
         Value v;
-        v.boolean_ = boolean;
-        v.type_ = Value_Boolean;
+        v.SetBoolean(boolean);
         return AddConstValue(v);
     }
     
+    void Function::Decode() {
+        long max_register = -1;
+        decoded_op_codes_.reserve(op_codes_.size() + 1);
+        for(std::size_t i = 0; i < op_codes_.size(); ++i) {
+            DecodedInstruction decoded(op_codes_[i]);
+            long reg = decoded.a_;
+            switch (decoded.op_) {
+                case TypeOp_Move:
+                    reg = std::max<long>(reg, decoded.b_);
+                    break;
+                case TypeOp_Call:
+                    reg = std::max<long>(reg + decoded.b_, decoded.c_);
+                    break;
+                case TypeOp_Add: case TypeOp_Sub: case TypeOp_Mul:
+                case TypeOp_Div: case TypeOp_Pow: case TypeOp_Mod:
+                case TypeOp_And: case TypeOp_Or: case TypeOp_Less:
+                case TypeOp_Greater: case TypeOp_Equal: case TypeOp_UnEqual:
+                case TypeOp_LessEqual: case TypeOp_GreaterEqual:
+                    reg = std::max<long>(reg, std::max(decoded.b_, decoded.c_));
+                    break;
+                case TypeOp_SetTable: case TypeOp_GetTable:
+                    reg = std::max<long>(reg, std::max(decoded.b_, decoded.c_));
+                    // ABC op codes leave bx_ free, it indexes the inline cache.
+                    decoded.bx_ = table_caches_++;
+                    break;
+                case TypeOp_LessJmpFalse: case TypeOp_LessEqualJmpFalse:
+                    reg = std::max(decoded.b_, decoded.c_);
+                    // Folds in the offset of the Jmp that follows, relative
+                    // to this instruction, so both outcomes take one dispatch.
+                    decoded.bx_ = 1 + Instruction::GetParamsBx(op_codes_[i + 1]);
+                    break;
+                default:
+                    break;
+            }
+            max_register = std::max(max_register, reg);
+            decoded_op_codes_.push_back(decoded);
+        }
+        decoded_op_codes_.push_back(DecodedInstruction());
+        frame_size_ = max_register + 1;
+    }
+    
+    std::size_t Function::Prepare(std::size_t table_cache_base) {
+        GetDecodedOpCodes();
+        table_cache_base_ = table_cache_base;
+        std::size_t end = table_cache_base + table_caches_;
+        for(std::size_t i = 0; i < child_functions_.size(); ++i) {
+            end = child_functions_[i]->Prepare(end);
+        }
+        return end;
+    }
+    
     std::size_t Function::AddConstValue(const Value& v) {
         for(size_t i = 0; i < const_values_.size(); i++) {
             if(const_values_[i] == v) {
                 return i;
             }
         }
+        // Constant strings stay pinned for the lifetime of the function.
+        if(v.IsString()) {
+            v.str()->AddRef();
+        }
         const_values_.push_back(v);
         return const_values_.size() - 1;
     }
@@ -1,29 +1,39 @@
 #ifndef LYNX_LEPUS_FUNCTION_H_
 #define LYNX_LEPUS_FUNCTION_H_
 
+#include <atomic>
 #include <vector>
 
 #include "lepus/op_code.h"
 #include "lepus/syntax_tree.h"
 #include "lepus/upvalue.h"
 #include "lepus/switch.h"
-
-#include "base/ref_counted_ptr.h"
+#include "lepus/gc.h"
+#include "lepus/jit.h"
+#include "base/scoped_ptr.h"
 
 namespace lepus {
     class Value;
     class Function {
     public:
         Function() :op_codes_(),
+                     decoded_op_codes_(),
                      const_values_(),
                      upvalues_(),
                      switches_(),
                      child_functions_(),
-                     index_(0){
+                     index_(0),
+                     frame_size_(0),
+                     table_caches_(0),
+                     table_cache_base_(0)
+#if LEPUS_JIT
+                     ,jit_code_(nullptr),
+                     jit_hotness_(0)
+#endif
+                     {
                          
                      }
-        ~Function(){
-        }
+        ~Function();
         
         std::size_t OpCodeSize() {
             return op_codes_.size();
@@ -33,6 +43,34 @@ namespace lepus {
             return op_codes_.empty() ? nullptr : &op_codes_[0];
         }
         
+        // Decoded on first execution, op_codes_ must not change afterwards.
+        const DecodedInstruction* GetDecodedOpCodes() {
+            if(decoded_op_codes_.empty()) {
+                Decode();
+            }
+            return &decoded_op_codes_[0];
+        }
+        
+        // Decodes this function and its children up front, so a tree shared
+        // by several contexts is only read while they run, and lays out
+        // their inline caches from |table_cache_base| on. Returns the end of
+        // the layout, the number of caches a context needs for the tree.
+        std::size_t Prepare(std::size_t table_cache_base);
+        
+        // Number of registers a call of this function may touch, valid once
+        // the op codes have been decoded.
+        std::size_t frame_size() {
+            return frame_size_;
+        }
+        
+        // Inline caches live in the context, not in the function, so the
+        // function stays immutable. A GetTable or SetTable instruction uses
+        // the context's cache at table_cache_base() plus its decoded bx_,
+        // which holds the table slot the key was last found in.
+        std::size_t table_cache_base() {
+            return table_cache_base_;
+        }
+        
         std::size_t AddInstruction(Instruction i) {
             op_codes_.push_back(i);
             return op_codes_.size() - 1;
@@ -60,6 +98,10 @@ namespace lepus {
             return child_functions_[index];
         }
         
+        std::size_t ChildFunctionsSize() {
+            return child_functions_.size();
+        }
+        
         
         
         Value* GetConstValue(std::size_t index) {
@@ -77,6 +119,7 @@ namespace lepus {
         }
         
         long AddUpvalue(String* name, long register_index, bool in_parent_vars) {
+            name->AddRef();
             upvalues_.push_back(UpvalueInfo(name, register_index, in_parent_vars));
             return upvalues_.size() - 1;
         }
@@ -94,6 +137,10 @@ namespace lepus {
             return switches_[index];
         }
         
+        std::size_t ConstValuesSize() {
+            return const_values_.size();
+        }
+        
         std::size_t UpvaluesSize() {
             return upvalues_.size();
         }
@@ -105,9 +152,34 @@ namespace lepus {
         std::size_t index() {
             return index_;
         }
+        
+#if LEPUS_JIT
+        // Contexts sharing the function may run on several threads, the
+        // one that makes it hot compiles and publishes the code.
+        JitCode* jit_code() {
+            return jit_code_.load(std::memory_order_acquire);
+        }
+        
+        void set_jit_code(JitCode* code) {
+            jit_code_.store(code, std::memory_order_release);
+        }
+        
+        // Counts one execution and returns true exactly once, when the
+        // function has become hot enough to compile.
+        bool CountHotness() {
+            return jit_hotness_.load(std::memory_order_relaxed) < JitCode::kHotness
+                && jit_hotness_.fetch_add(1, std::memory_order_relaxed) + 1 == JitCode::kHotness;
+        }
+#endif
     private:
+        friend class BytecodeWriter;
+        friend class BytecodeReader;
+        friend class Optimizer;
+        
         std::vector<Instruction> op_codes_;
         
+        std::vector<DecodedInstruction> decoded_op_codes_;
+        
         std::vector<Value> const_values_;
         
         std::vector<UpvalueInfo> upvalues_;
@@ -118,13 +190,28 @@ namespace lepus {
         
         std::size_t index_;
         
+        std::size_t frame_size_;
+        
+        // GetTable and SetTable instructions, counted by Decode.
+        std::size_t table_caches_;
+        
+        std::size_t table_cache_base_;
+        
+#if LEPUS_JIT
+        std::atomic<JitCode*> jit_code_;
+        
+        std::atomic<int> jit_hotness_;
+#endif
+        
+        void Decode();
     };
     
-    class Closure : public base::RefCountPtr<Closure>{
+    // Closures reference no other GC object: the function tree is owned by
+    // the context and upvalues are register stack slots, which are roots.
+    class Closure : public GCObject{
     public:
         Closure(Function* function)
         :function_(function){
-            AddRef();
         }
         
         void set_function(Function* function) {
@@ -135,16 +222,23 @@ namespace lepus {
             return function_;
         }
         
-        void AddUpvalue(Value* value) {
-            upvalues_.push_back(value);
+        // Upvalues are register stack slots, not pointers, so they stay valid
+        // when the stack is reallocated.
+        void AddUpvalue(long slot) {
+            upvalues_.push_back(slot);
         }
         
-        Value* GetUpvalue(long index) {
+        long GetUpvalue(long index) {
             return upvalues_[index];
         }
         
+    protected:
+        virtual std::size_t GCSize() {
+            return sizeof(Closure) + upvalues_.capacity() * sizeof(long);
+        }
+        
     private:
-        std::vector<Value*> upvalues_;
+        std::vector<long> upvalues_;
         Function* function_;
     };
 }
@@ -0,0 +1,197 @@
+
+#include "lepus/gc.h"
+
+#include <chrono>
+
+#include "lepus/value.h"
+#include "lepus/table.h"
+
+namespace lepus {
+
+    GC::GC(GCRoots* roots)
+        : roots_(roots),
+          objects_(nullptr),
+          sweep_(nullptr),
+          gray_(),
+          phase_(Phase_Idle),
+          current_mark_(false),
+          incremental_(true),
+          step_budget_(kDefaultStepBudget),
+          debt_(0),
+          threshold_(kMinThreshold),
+          sweep_live_objects_(0),
+          sweep_live_bytes_(0),
+          stats_() {
+    }
+
+    GC::~GC() {
+        while(objects_) {
+            GCObject* object = objects_;
+            objects_ = object->gc_next_;
+            lynx_delete(object);
+        }
+    }
+
+    void GC::Track(GCObject* object) {
+        std::size_t size = object->GCSize();
+        // New objects carry the current mark: live for a cycle in progress,
+        // white once the next cycle flips the mark.
+        object->mark_ = current_mark_;
+        object->gc_next_ = objects_;
+        objects_ = object;
+        debt_ += size;
+        ++stats_.allocated_objects;
+        stats_.allocated_bytes += size;
+        ++stats_.live_objects;
+        stats_.live_bytes += size;
+        if(phase_ == Phase_Sweep) {
+            ++sweep_live_objects_;
+            sweep_live_bytes_ += size;
+        }
+    }
+
+    void GC::Mark(GCObject* object) {
+        // Shared objects belong to a frozen GC and reference only shared
+        // objects, so there is nothing to trace.
+        if(object == nullptr || object->shared_ || IsLive(object)) {
+            return;
+        }
+        object->mark_ = current_mark_;
+        gray_.push_back(object);
+    }
+
+    void GC::Mark(const Value& value) {
+        switch (value.type()) {
+            case Value_String:
+                Mark(value.str());
+                break;
+            case Value_Closure:
+                Mark(value.closure());
+                break;
+            case Value_Table:
+                Mark(static_cast<Dictonary*>(value.table()));
+                break;
+            default:
+                break;
+        }
+    }
+
+    void GC::Barrier(GCObject* object, const Value& value) {
+        if(phase_ == Phase_Mark && IsLive(object)) {
+            Mark(value);
+        }
+    }
+
+    void GC::Step() {
+        auto begin = std::chrono::steady_clock::now();
+        if(phase_ == Phase_Idle) {
+            StartCycle();
+        }
+        std::size_t budget = incremental_ ? step_budget_ : static_cast<std::size_t>(-1);
+        if(phase_ == Phase_Mark && Propagate(budget)) {
+            FinishMark();
+        }
+        if(phase_ == Phase_Sweep && Sweep(budget)) {
+            FinishCycle();
+        }
+        auto end = std::chrono::steady_clock::now();
+        RecordPause(std::chrono::duration<double, std::milli>(end - begin).count());
+    }
+
+    void GC::Collect() {
+        auto begin = std::chrono::steady_clock::now();
+        std::size_t unbounded = static_cast<std::size_t>(-1);
+        // A cycle in progress may have missed garbage created since it
+        // started, so finish it and run one more from scratch.
+        for(int cycles = phase_ == Phase_Idle ? 1 : 2; cycles > 0; --cycles) {
+            if(phase_ == Phase_Idle) {
+                StartCycle();
+            }
+            if(phase_ == Phase_Mark) {
+                Propagate(unbounded);
+                FinishMark();
+            }
+            Sweep(unbounded);
+            FinishCycle();
+        }
+        auto end = std::chrono::steady_clock::now();
+        RecordPause(std::chrono::duration<double, std::milli>(end - begin).count());
+    }
+
+    void GC::Freeze() {
+        Collect();
+        for(GCObject* object = objects_; object != nullptr; object = object->gc_next_) {
+            object->shared_ = true;
+        }
+    }
+
+    void GC::StartCycle() {
+        // Flipping the mark turns every existing object white at once.
+        current_mark_ = !current_mark_;
+        phase_ = Phase_Mark;
+        roots_->MarkRoots(this);
+    }
+
+    bool GC::Propagate(std::size_t budget) {
+        while(!gray_.empty() && budget > 0) {
+            GCObject* object = gray_.back();
+            gray_.pop_back();
+            object->Trace(this);
+            --budget;
+        }
+        return gray_.empty();
+    }
+
+    void GC::FinishMark() {
+        // Registers and globals are written without barriers, rescan them
+        // atomically before anything is freed.
+        roots_->MarkRoots(this);
+        Propagate(static_cast<std::size_t>(-1));
+        phase_ = Phase_Sweep;
+        sweep_ = &objects_;
+        sweep_live_objects_ = 0;
+        sweep_live_bytes_ = 0;
+    }
+
+    bool GC::Sweep(std::size_t budget) {
+        while(*sweep_ && budget > 0) {
+            GCObject* object = *sweep_;
+            if(IsLive(object) || object->pinned()) {
+                ++sweep_live_objects_;
+                sweep_live_bytes_ += object->GCSize();
+                sweep_ = &object->gc_next_;
+            }else{
+                *sweep_ = object->gc_next_;
+                Free(object);
+            }
+            --budget;
+        }
+        return *sweep_ == nullptr;
+    }
+
+    void GC::FinishCycle() {
+        phase_ = Phase_Idle;
+        sweep_ = nullptr;
+        stats_.live_objects = sweep_live_objects_;
+        stats_.live_bytes = sweep_live_bytes_;
+        ++stats_.collections;
+        // Let the heap grow to about twice its live size before the next
+        // cycle starts.
+        threshold_ = stats_.live_bytes > kMinThreshold ? stats_.live_bytes : kMinThreshold;
+        debt_ = 0;
+    }
+
+    void GC::Free(GCObject* object) {
+        ++stats_.freed_objects;
+        lynx_delete(object);
+    }
+
+    void GC::RecordPause(double ms) {
+        ++stats_.steps;
+        stats_.last_pause_ms = ms;
+        stats_.total_pause_ms += ms;
+        if(ms > stats_.max_pause_ms) {
+            stats_.max_pause_ms = ms;
+        }
+    }
+}
@@ -0,0 +1,180 @@
+
+#ifndef LYNX_LEPUS_GC_H_
+#define LYNX_LEPUS_GC_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "base/debug/memory_debug.h"
+
+namespace lepus {
+    class GC;
+    class Value;
+
+    // Base of every heap object of a context: strings, closures and tables.
+    // Objects are owned by the context's GC and freed by its sweep, never
+    // by whoever holds them. Values copy the raw pointer without touching
+    // any counter.
+    class GCObject {
+    public:
+        GCObject() : gc_next_(nullptr), pin_count_(0), mark_(false), shared_(false) {}
+        virtual ~GCObject() {}
+
+        // Pins keep an object alive while it is referenced from native
+        // code the collector can not see (tokens, constants, table keys,
+        // host handles). Release never frees, the object is collected by
+        // a later sweep once it is unpinned and unreachable. A pin does not
+        // keep alive what the object itself references.
+        void AddRef() {
+            if(!shared_) {
+                ++pin_count_;
+            }
+        }
+
+        void Release() {
+            if(!shared_) {
+                --pin_count_;
+            }
+        }
+
+        bool pinned() const {
+            return pin_count_ > 0;
+        }
+
+        // Frozen into a Program and read by several contexts, possibly on
+        // several threads. Shared objects are never written, pinned, marked
+        // or freed again until the program goes away. See GC::Freeze.
+        bool shared() const {
+            return shared_;
+        }
+
+    protected:
+        friend class GC;
+        // Marks every object this one references.
+        virtual void Trace(GC* gc) {}
+        // Approximate footprint in bytes, used to pace the collector.
+        virtual std::size_t GCSize() = 0;
+
+    private:
+        GCObject* gc_next_;
+        long pin_count_;
+        bool mark_;
+        bool shared_;
+    };
+
+    // Implemented by the owner of a GC to report its roots.
+    class GCRoots {
+    public:
+        virtual ~GCRoots() {}
+        virtual void MarkRoots(GC* gc) = 0;
+    };
+
+    // Incremental mark and sweep collector, one per context. Collection only
+    // advances from Step(), which the VM calls at safe points where every
+    // live Value is reachable from the roots. Values held by native code
+    // between calls into the context are not roots: pin the object or keep
+    // the value in a lepus variable.
+    class GC {
+    public:
+        struct Stats {
+            std::size_t allocated_objects;
+            std::size_t allocated_bytes;
+            std::size_t freed_objects;
+            std::size_t live_objects;
+            std::size_t live_bytes;
+            std::size_t collections;
+            std::size_t steps;
+            double last_pause_ms;
+            double max_pause_ms;
+            double total_pause_ms;
+        };
+
+        explicit GC(GCRoots* roots);
+        ~GC();
+
+        // Takes ownership of |object|.
+        void Track(GCObject* object);
+
+        void Mark(GCObject* object);
+        void Mark(const Value& value);
+
+        // Revives a leaf object reached through a weak reference, such as
+        // the string pool, that the current cycle may have condemned.
+        void KeepAlive(GCObject* object) {
+            if(phase_ != Phase_Idle && !object->shared_) {
+                object->mark_ = current_mark_;
+            }
+        }
+
+        // Must be called after storing |value| into |object| so an object
+        // already scanned in this cycle does not hide a new reference.
+        void Barrier(GCObject* object, const Value& value);
+
+        bool ShouldStep() const {
+            return phase_ != Phase_Idle || debt_ >= threshold_;
+        }
+
+        // Does a bounded amount of work, starting a cycle if needed. With
+        // incremental collection off a whole cycle runs at once.
+        void Step();
+
+        // Finishes the current cycle, if any, and runs a complete one.
+        void Collect();
+
+        // Collects, then marks every object left as shared. The GC keeps
+        // ownership but must not run again, other contexts reference the
+        // objects without marking them.
+        void Freeze();
+
+        // Objects marked or swept per Step(), the pause bound.
+        void set_step_budget(std::size_t budget) {
+            step_budget_ = budget > 0 ? budget : 1;
+        }
+
+        void set_incremental(bool incremental) {
+            incremental_ = incremental;
+        }
+
+        const Stats& stats() const {
+            return stats_;
+        }
+
+        static const std::size_t kMinThreshold = 256 * 1024;
+        static const std::size_t kDefaultStepBudget = 512;
+
+    private:
+        enum Phase {
+            Phase_Idle,
+            Phase_Mark,
+            Phase_Sweep,
+        };
+
+        bool IsLive(GCObject* object) const {
+            return object->mark_ == current_mark_;
+        }
+
+        void StartCycle();
+        bool Propagate(std::size_t budget);
+        void FinishMark();
+        bool Sweep(std::size_t budget);
+        void FinishCycle();
+        void Free(GCObject* object);
+        void RecordPause(double ms);
+
+        GCRoots* roots_;
+        GCObject* objects_;
+        GCObject** sweep_;
+        std::vector<GCObject*> gray_;
+        Phase phase_;
+        bool current_mark_;
+        bool incremental_;
+        std::size_t step_budget_;
+        std::size_t debt_;
+        std::size_t threshold_;
+        std::size_t sweep_live_objects_;
+        std::size_t sweep_live_bytes_;
+        Stats stats_;
+    };
+}
+
+#endif  // LYNX_LEPUS_GC_H_
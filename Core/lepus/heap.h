@@ -5,19 +5,56 @@
 #include "lepus/op_code.h"
 
 namespace lepus {
+    // Register stack shared by all frames of a context. It starts small and
+    // grows on demand up to max_size(), so the storage may move: hold offsets
+    // from base() across anything that can grow it, not Value pointers.
     class Heap {
     public:
-        Heap():heap_(kBaseHeapSize) {
+        Heap():heap_(kBaseHeapSize), max_size_(kDefaultMaxHeapSize) {
             top_ = &heap_[0];
         }
         Value* top_;
         Value* base() {
             return &heap_[0];
         }
+        
+        Value* limit() {
+            return &heap_[0] + heap_.size();
+        }
+        
+        std::size_t size() const {
+            return heap_.size();
+        }
+        
+        std::size_t max_size() const {
+            return max_size_;
+        }
+        
+        void set_max_size(std::size_t max_size) {
+            max_size_ = max_size < kBaseHeapSize ? kBaseHeapSize : max_size;
+        }
+        
+        // Resizes to |size| values, clamped to [kBaseHeapSize, max_size()].
+        // top_ is kept at the same offset; other pointers must be relocated
+        // by the caller.
+        void Resize(std::size_t size) {
+            std::size_t top = top_ - base();
+            if(size < kBaseHeapSize) size = kBaseHeapSize;
+            if(size > max_size_) size = max_size_;
+            std::vector<Value> heap(size);
+            std::size_t count = size < heap_.size() ? size : heap_.size();
+            for(std::size_t i = 0; i < count; ++i) {
+                heap[i] = heap_[i];
+            }
+            heap_.swap(heap);
+            top_ = base() + (top < size ? top : size);
+        }
+        
+        static const std::size_t kBaseHeapSize = 32;
+        static const std::size_t kDefaultMaxHeapSize = 64 * 1024;
     private:
-        static const int kBaseHeapSize = 1000;
         std::vector<Value> heap_;
-        
+        std::size_t max_size_;
     };
     
     struct Frame {
@@ -27,9 +64,7 @@ namespace lepus {
         
         Value* return_;
         
-        const Instruction* instruction_;
-        
-        const Instruction* end_;
+        const DecodedInstruction* instruction_;
         
         Frame() : register_(nullptr), function_(nullptr), return_(nullptr), instruction_(nullptr){}
     };
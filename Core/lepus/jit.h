@@ -0,0 +1,75 @@
+#ifndef LYNX_LEPUS_JIT_H_
+#define LYNX_LEPUS_JIT_H_
+
+#include <cstddef>
+
+// Baseline JIT, off unless enabled with VMContext::set_jit_enabled. Only the
+// x86-64 Linux backend exists so far, other targets always interpret.
+#if defined(__x86_64__) && defined(__linux__)
+#define LEPUS_JIT 1
+#else
+#define LEPUS_JIT 0
+#endif
+
+namespace lepus {
+    class Function;
+    class JitCompiler;
+    class Value;
+    class VMContext;
+    struct DecodedInstruction;
+
+    // Runtime entry of the native code for an instruction it does not
+    // inline. Executes |i| on the current frame of |context|, whose
+    // registers start at |registers|, and must not throw.
+    typedef void (*JitHelper)(VMContext* context, Value* registers, const DecodedInstruction* i);
+
+    struct JitHelpers {
+        JitHelper get_global_;
+        JitHelper get_upvalue_;
+        JitHelper set_upvalue_;
+        JitHelper get_table_;
+        JitHelper set_table_;
+        JitHelper logic_;
+    };
+
+    // Native code of one function, translated instruction by instruction
+    // from its decoded op codes. It works on the interpreter's register
+    // file in place, so control can move between the two at any
+    // instruction boundary. Numbers are handled inline behind type guards;
+    // a failed guard, a call, a return, a closure or a switch leaves to the
+    // interpreter at that instruction.
+    class JitCode {
+    public:
+        typedef long (*Entry)(Value* registers, long index, VMContext* context);
+
+        ~JitCode();
+
+        // Translates |function|, whose op codes must be decoded already.
+        // Returns nullptr when it can not be compiled.
+        static JitCode* Compile(Function* function, const JitHelpers& helpers);
+
+        // Runs from instruction |index| and returns the index of the first
+        // instruction the interpreter has to execute.
+        long Run(Value* registers, long index, VMContext* context) {
+            return entry_(registers, index, context);
+        }
+
+        std::size_t size() const {
+            return size_;
+        }
+
+        // Executions of a function, counted on entry and on backward
+        // jumps, before it gets compiled.
+        static const int kHotness = 16;
+
+    private:
+        friend class JitCompiler;
+        JitCode(void* memory, std::size_t size);
+
+        void* memory_;
+        std::size_t size_;
+        Entry entry_;
+    };
+}
+
+#endif  // LYNX_LEPUS_JIT_H_
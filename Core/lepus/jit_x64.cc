@@ -0,0 +1,718 @@
+
+#include "lepus/jit.h"
+
+#if LEPUS_JIT
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include <vector>
+
+#include "base/debug/memory_debug.h"
+#include "lepus/function.h"
+#include "lepus/op_code.h"
+#include "lepus/value.h"
+
+namespace lepus {
+    namespace {
+        // Position of a label not bound yet, also marks an exit stub not
+        // created yet.
+        const std::size_t kUnbound = static_cast<std::size_t>(-1);
+
+        enum Gp {
+            RAX = 0, RCX = 1, RDX = 2, RBX = 3,
+            RSP = 4, RBP = 5, RSI = 6, RDI = 7,
+            R12 = 12,
+        };
+
+        enum Xmm {
+            XMM0 = 0, XMM1 = 1, XMM2 = 2,
+        };
+
+        enum Condition {
+            Below = 0x2, AboveEqual = 0x3, Equal = 0x4, NotEqual = 0x5,
+            BelowEqual = 0x6, Above = 0x7, Parity = 0xA, NoParity = 0xB,
+        };
+
+        // Just the x86-64 encodings the translator needs. Registers of
+        // the frame are addressed as [rbx + index * 8].
+        class Assembler {
+        public:
+            typedef std::size_t Label;
+
+            Label NewLabel() {
+                labels_.push_back(kUnbound);
+                return labels_.size() - 1;
+            }
+
+            void Bind(Label label) {
+                labels_[label] = code_.size();
+            }
+
+            std::size_t offset(Label label) const {
+                return labels_[label];
+            }
+
+            std::size_t size() const {
+                return code_.size();
+            }
+
+            const unsigned char* code() const {
+                return &code_[0];
+            }
+
+            void Byte(int byte) {
+                code_.push_back(static_cast<unsigned char>(byte));
+            }
+
+            void Int32(int32_t value) {
+                for(int i = 0; i < 4; ++i) {
+                    Byte((value >> (i * 8)) & 0xFF);
+                }
+            }
+
+            void Int64(uint64_t value) {
+                for(int i = 0; i < 8; ++i) {
+                    Byte((value >> (i * 8)) & 0xFF);
+                }
+            }
+
+            void Align(std::size_t alignment) {
+                while(code_.size() % alignment != 0) {
+                    Byte(0xCC);
+                }
+            }
+
+            // mov gp, [rbx + slot * 8]
+            void Load(Gp gp, long slot) {
+                Byte(0x48);
+                Byte(0x8B);
+                SlotOperand(gp, slot);
+            }
+
+            // mov [rbx + slot * 8], gp
+            void Store(long slot, Gp gp) {
+                Byte(0x48);
+                Byte(0x89);
+                SlotOperand(gp, slot);
+            }
+
+            // movsd xmm, [rbx + slot * 8]
+            void LoadDouble(Xmm xmm, long slot) {
+                Byte(0xF2);
+                Byte(0x0F);
+                Byte(0x10);
+                SlotOperand(xmm, slot);
+            }
+
+            // movsd [rbx + slot * 8], xmm
+            void StoreDouble(long slot, Xmm xmm) {
+                Byte(0xF2);
+                Byte(0x0F);
+                Byte(0x11);
+                SlotOperand(xmm, slot);
+            }
+
+            // mov gp, imm64
+            void MoveImmediate(Gp gp, uint64_t value) {
+                Byte(gp >= 8 ? 0x49 : 0x48);
+                Byte(0xB8 + (gp & 7));
+                Int64(value);
+            }
+
+            // mov dst, src
+            void Move(Gp dst, Gp src) {
+                Byte(0x48 | (src >= 8 ? 0x4 : 0) | (dst >= 8 ? 0x1 : 0));
+                Byte(0x89);
+                Byte(0xC0 | ((src & 7) << 3) | (dst & 7));
+            }
+
+            // cmp left, right
+            void Compare(Gp left, Gp right) {
+                Byte(0x48);
+                Byte(0x39);
+                Byte(0xC0 | (right << 3) | left);
+            }
+
+            // movq xmm, gp
+            void MoveToDouble(Xmm xmm, Gp gp) {
+                Byte(0x66);
+                Byte(0x48);
+                Byte(0x0F);
+                Byte(0x6E);
+                Byte(0xC0 | (xmm << 3) | gp);
+            }
+
+            // Scalar double ops of the form "prefix 0F op /r" on two xmm
+            // registers: addsd, subsd, mulsd, divsd, ucomisd, andpd, xorpd,
+            // movapd.
+            void Sse(int prefix, int op, Xmm dst, Xmm src) {
+                Byte(prefix);
+                Byte(0x0F);
+                Byte(op);
+                Byte(0xC0 | (dst << 3) | src);
+            }
+
+            void AddDouble(Xmm dst, Xmm src) { Sse(0xF2, 0x58, dst, src); }
+            void SubDouble(Xmm dst, Xmm src) { Sse(0xF2, 0x5C, dst, src); }
+            void MulDouble(Xmm dst, Xmm src) { Sse(0xF2, 0x59, dst, src); }
+            void DivDouble(Xmm dst, Xmm src) { Sse(0xF2, 0x5E, dst, src); }
+            void CompareDouble(Xmm left, Xmm right) { Sse(0x66, 0x2E, left, right); }
+            void AndDouble(Xmm dst, Xmm src) { Sse(0x66, 0x54, dst, src); }
+            void XorDouble(Xmm dst, Xmm src) { Sse(0x66, 0x57, dst, src); }
+            void CopyDouble(Xmm dst, Xmm src) { Sse(0x66, 0x28, dst, src); }
+
+            // cvttsd2si eax, xmm
+            void TruncateToInt32(Xmm xmm) {
+                Byte(0xF2);
+                Byte(0x0F);
+                Byte(0x2C);
+                Byte(0xC0 | (RAX << 3) | xmm);
+            }
+
+            // cvtsi2sd xmm, eax
+            void Int32ToDouble(Xmm xmm) {
+                Byte(0xF2);
+                Byte(0x0F);
+                Byte(0x2A);
+                Byte(0xC0 | (xmm << 3) | RAX);
+            }
+
+            // setcc al
+            void SetAl(Condition condition) {
+                Byte(0x0F);
+                Byte(0x90 | condition);
+                Byte(0xC0);
+            }
+
+            // movzx eax, al
+            void ZeroExtendAl() {
+                Byte(0x0F);
+                Byte(0xB6);
+                Byte(0xC0);
+            }
+
+            void Jump(Label label) {
+                Byte(0xE9);
+                Rel32(label);
+            }
+
+            void JumpIf(Condition condition, Label label) {
+                Byte(0x0F);
+                Byte(0x80 | condition);
+                Rel32(label);
+            }
+
+            // lea rax, [rip + label]
+            void LoadAddress(Label label) {
+                Byte(0x48);
+                Byte(0x8D);
+                Byte(0x05);
+                Rel32(label);
+            }
+
+            // Resolves the rel32 operands, false if a label was never bound.
+            bool Finish() {
+                for(std::size_t i = 0; i < patches_.size(); ++i) {
+                    std::size_t target = labels_[patches_[i].label_];
+                    if(target == kUnbound) {
+                        return false;
+                    }
+                    int32_t rel = static_cast<int32_t>(target - (patches_[i].offset_ + 4));
+                    memcpy(&code_[patches_[i].offset_], &rel, sizeof(rel));
+                }
+                return true;
+            }
+
+        private:
+            struct Patch {
+                std::size_t offset_;
+                Label label_;
+            };
+
+            void SlotOperand(int reg, long slot) {
+                Byte(0x80 | ((reg & 7) << 3) | RBX);
+                Int32(static_cast<int32_t>(slot * sizeof(Value)));
+            }
+
+            void Rel32(Label label) {
+                Patch patch = {code_.size(), label};
+                patches_.push_back(patch);
+                Int32(0);
+            }
+
+            std::vector<unsigned char> code_;
+            std::vector<std::size_t> labels_;
+            std::vector<Patch> patches_;
+        };
+    }
+
+    // Translates one function. Native code keeps the register file in rbx
+    // and the context in r12; rax, rcx, rdx and xmm0-2 are scratch.
+    class JitCompiler {
+    public:
+        JitCompiler(Function* function, const JitHelpers& helpers)
+            : function_(function),
+              helpers_(helpers),
+              instructions_(function->GetDecodedOpCodes()),
+              count_(function->OpCodeSize()),
+              masm_(),
+              labels_(),
+              exits_(),
+              epilogue_(0) {
+        }
+
+        JitCode* Compile();
+
+    private:
+        static const uint64_t kNilBits = Value::kNilBits;
+        // Every word below it is a number, see Value::IsNumber.
+        static const uint64_t kBoxedBits = Value::kBoxedBits;
+        static const uint64_t kCanonicalNaN = Value::kCanonicalNaN;
+        static const uint64_t kSignBit = 0x8000000000000000ULL;
+        static const uint64_t kAbsMask = 0x7FFFFFFFFFFFFFFFULL;
+
+        static uint64_t FalseBits() {
+            return Value::Tag(Value_Boolean);
+        }
+
+        static int TagOf(ValueType type) {
+            return static_cast<int>(Value::Tag(type) >> Value::kTagShift);
+        }
+
+        static uint64_t DoubleBits(double number) {
+            return Value(number).bits();
+        }
+
+        bool Translate(long index);
+        void EmitExit(long index);
+        Assembler::Label ExitLabel(long index);
+        void EmitCallHelper(JitHelper helper, long index);
+        void EmitNumberGuard(long slot, Assembler::Label fail);
+        void EmitStoreNumber(long slot);
+        void EmitCompare(const DecodedInstruction* i);
+        void EmitEqual(const DecodedInstruction* i);
+        void EmitIsFalse(long slot, Assembler::Label bailout);
+        void EmitBoolean(long slot);
+
+        Function* function_;
+        const JitHelpers& helpers_;
+        const DecodedInstruction* instructions_;
+        long count_;
+        Assembler masm_;
+        // Native start of every instruction, count_ is the terminating End.
+        std::vector<Assembler::Label> labels_;
+        // Stubs leaving to the interpreter, created on demand.
+        std::vector<Assembler::Label> exits_;
+        Assembler::Label epilogue_;
+    };
+
+    JitCode* JitCompiler::Compile() {
+        labels_.resize(count_ + 1);
+        exits_.resize(count_ + 1, kUnbound);
+        for(long i = 0; i <= count_; ++i) {
+            labels_[i] = masm_.NewLabel();
+        }
+        epilogue_ = masm_.NewLabel();
+        Assembler::Label table = masm_.NewLabel();
+
+        // long entry(Value* registers, long index, VMContext* context)
+        masm_.Byte(0x53);                                   // push rbx
+        masm_.Byte(0x41); masm_.Byte(0x54);                 // push r12
+        masm_.Byte(0x48); masm_.Byte(0x83);                 // sub rsp, 8
+        masm_.Byte(0xEC); masm_.Byte(0x08);
+        masm_.Move(RBX, RDI);
+        masm_.Move(R12, RDX);
+        masm_.LoadAddress(table);
+        masm_.Byte(0x48); masm_.Byte(0x63);                 // movsxd rcx, [rax + rsi * 4]
+        masm_.Byte(0x0C); masm_.Byte(0xB0);
+        masm_.Byte(0x48); masm_.Byte(0x01); masm_.Byte(0xC1); // add rcx, rax
+        masm_.Byte(0xFF); masm_.Byte(0xE1);                 // jmp rcx
+
+        for(long i = 0; i < count_; ++i) {
+            masm_.Bind(labels_[i]);
+            if(!Translate(i)) {
+                return nullptr;
+            }
+        }
+        masm_.Bind(labels_[count_]);
+        EmitExit(count_);
+
+        for(long i = 0; i <= count_; ++i) {
+            if(exits_[i] != kUnbound) {
+                masm_.Bind(exits_[i]);
+                EmitExit(i);
+            }
+        }
+
+        masm_.Bind(epilogue_);
+        masm_.Byte(0x48); masm_.Byte(0x83);                 // add rsp, 8
+        masm_.Byte(0xC4); masm_.Byte(0x08);
+        masm_.Byte(0x41); masm_.Byte(0x5C);                 // pop r12
+        masm_.Byte(0x5B);                                   // pop rbx
+        masm_.Byte(0xC3);                                   // ret
+
+        // Entry table, offsets of the instructions from the table itself.
+        masm_.Align(4);
+        masm_.Bind(table);
+        std::size_t table_offset = masm_.size();
+        for(long i = 0; i <= count_; ++i) {
+            masm_.Int32(0);
+        }
+        if(!masm_.Finish()) {
+            return nullptr;
+        }
+
+        std::vector<unsigned char> code(masm_.code(), masm_.code() + masm_.size());
+        for(long i = 0; i <= count_; ++i) {
+            int32_t rel = static_cast<int32_t>(masm_.offset(labels_[i]) - table_offset);
+            memcpy(&code[table_offset + i * 4], &rel, sizeof(rel));
+        }
+
+        void* memory = mmap(nullptr, code.size(), PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(memory == MAP_FAILED) {
+            return nullptr;
+        }
+        memcpy(memory, &code[0], code.size());
+        if(mprotect(memory, code.size(), PROT_READ | PROT_EXEC) != 0) {
+            munmap(memory, code.size());
+            return nullptr;
+        }
+        return lynx_new JitCode(memory, code.size());
+    }
+
+    bool JitCompiler::Translate(long index) {
+        const DecodedInstruction* i = instructions_ + index;
+        switch(i->op_) {
+            case TypeOp_LoadNil:
+                masm_.MoveImmediate(RAX, kNilBits);
+                masm_.Store(i->a_, RAX);
+                return true;
+            case TypeOp_LoadConst: {
+                Value* value = function_->GetConstValue(i->bx_);
+                if(value == nullptr) {
+                    EmitExit(index);
+                    return true;
+                }
+                // The same word the interpreter copies from the table.
+                masm_.MoveImmediate(RAX, value->bits());
+                masm_.Store(i->a_, RAX);
+                return true;
+            }
+            case TypeOp_Move:
+                masm_.Load(RAX, i->b_);
+                masm_.Store(i->a_, RAX);
+                return true;
+            case TypeOp_GetGlobal:
+                EmitCallHelper(helpers_.get_global_, index);
+                return true;
+            case TypeOp_GetUpvalue:
+                EmitCallHelper(helpers_.get_upvalue_, index);
+                return true;
+            case TypeOp_SetUpvalue:
+                EmitCallHelper(helpers_.set_upvalue_, index);
+                return true;
+            case TypeOp_GetTable:
+                EmitCallHelper(helpers_.get_table_, index);
+                return true;
+            case TypeOp_SetTable:
+                EmitCallHelper(helpers_.set_table_, index);
+                return true;
+            case TypeOp_And:
+            case TypeOp_Or:
+                EmitCallHelper(helpers_.logic_, index);
+                return true;
+            case TypeOp_Jmp: {
+                long target = index + i->bx_;
+                if(target < 0 || target > count_) {
+                    return false;
+                }
+                masm_.Jump(labels_[target]);
+                return true;
+            }
+            case TypeOp_JmpFalse: {
+                long target = index + i->bx_;
+                if(target < 0 || target > count_) {
+                    return false;
+                }
+                EmitIsFalse(i->a_, ExitLabel(index));
+                masm_.Byte(0x84); masm_.Byte(0xC0);         // test al, al
+                masm_.JumpIf(NotEqual, labels_[target]);
+                return true;
+            }
+            case TypeOp_LessJmpFalse:
+            case TypeOp_LessEqualJmpFalse: {
+                long target = index + i->bx_;
+                if(target < 0 || target > count_ || index + 2 > count_) {
+                    return false;
+                }
+                EmitNumberGuard(i->b_, labels_[target]);
+                masm_.LoadDouble(XMM0, i->b_);
+                masm_.LoadDouble(XMM1, i->c_);
+                masm_.CompareDouble(XMM1, XMM0);
+                // Unordered sets CF and ZF, so NaN takes the false branch.
+                masm_.JumpIf(i->op_ == TypeOp_LessJmpFalse ? BelowEqual : Below,
+                             labels_[target]);
+                masm_.Jump(labels_[index + 2]);
+                return true;
+            }
+            case TypeOp_Neg: {
+                Assembler::Label skip = masm_.NewLabel();
+                EmitNumberGuard(i->a_, skip);
+                masm_.LoadDouble(XMM0, i->a_);
+                masm_.MoveImmediate(RCX, kSignBit);
+                masm_.MoveToDouble(XMM1, RCX);
+                masm_.XorDouble(XMM0, XMM1);
+                EmitStoreNumber(i->a_);
+                masm_.Bind(skip);
+                return true;
+            }
+            case TypeOp_Inc:
+            case TypeOp_Dec: {
+                Assembler::Label skip = masm_.NewLabel();
+                EmitNumberGuard(i->a_, skip);
+                masm_.LoadDouble(XMM0, i->a_);
+                masm_.MoveImmediate(RCX, DoubleBits(1));
+                masm_.MoveToDouble(XMM1, RCX);
+                if(i->op_ == TypeOp_Inc) {
+                    masm_.AddDouble(XMM0, XMM1);
+                } else {
+                    masm_.SubDouble(XMM0, XMM1);
+                }
+                EmitStoreNumber(i->a_);
+                masm_.Bind(skip);
+                return true;
+            }
+            case TypeOp_Not:
+                EmitIsFalse(i->a_, ExitLabel(index));
+                EmitBoolean(i->a_);
+                return true;
+            case TypeOp_Add:
+                // Anything but two numbers may concatenate strings, which
+                // allocates: leave that to the interpreter.
+                EmitNumberGuard(i->b_, ExitLabel(index));
+                EmitNumberGuard(i->c_, ExitLabel(index));
+                masm_.LoadDouble(XMM0, i->b_);
+                masm_.LoadDouble(XMM1, i->c_);
+                masm_.AddDouble(XMM0, XMM1);
+                EmitStoreNumber(i->a_);
+                return true;
+            case TypeOp_Sub:
+            case TypeOp_Mul:
+            case TypeOp_Div:
+                // The interpreter reads any operand as a double, a boxed
+                // value is a NaN and so is the result.
+                masm_.LoadDouble(XMM0, i->b_);
+                masm_.LoadDouble(XMM1, i->c_);
+                if(i->op_ == TypeOp_Sub) {
+                    masm_.SubDouble(XMM0, XMM1);
+                } else if(i->op_ == TypeOp_Mul) {
+                    masm_.MulDouble(XMM0, XMM1);
+                } else {
+                    masm_.DivDouble(XMM0, XMM1);
+                }
+                EmitStoreNumber(i->a_);
+                return true;
+            case TypeOp_Mod:
+                // b - int(b / c) * c, the int conversion as C++ does it.
+                masm_.LoadDouble(XMM0, i->b_);
+                masm_.LoadDouble(XMM1, i->c_);
+                masm_.CopyDouble(XMM2, XMM0);
+                masm_.DivDouble(XMM2, XMM1);
+                masm_.TruncateToInt32(XMM2);
+                masm_.Int32ToDouble(XMM2);
+                masm_.MulDouble(XMM2, XMM1);
+                masm_.SubDouble(XMM0, XMM2);
+                EmitStoreNumber(i->a_);
+                return true;
+            case TypeOp_Less:
+            case TypeOp_Greater:
+            case TypeOp_LessEqual:
+            case TypeOp_GreaterEqual:
+                EmitCompare(i);
+                return true;
+            case TypeOp_Equal:
+            case TypeOp_UnEqual:
+                EmitEqual(i);
+                return true;
+            case TypeOp_SetGlobal:
+            case TypeOp_Len:
+            case TypeOp_Pow:
+            case TypeOp_NewTable:
+            case TypeOp_Noop:
+                // No-ops in the interpreter as well.
+                return true;
+            default:
+                // Call, Ret, Closure, Switch and anything new change frames
+                // or jump through tables, the interpreter runs them.
+                EmitExit(index);
+                return true;
+        }
+    }
+
+    void JitCompiler::EmitExit(long index) {
+        masm_.Byte(0xB8);                                   // mov eax, index
+        masm_.Int32(static_cast<int32_t>(index));
+        masm_.Jump(epilogue_);
+    }
+
+    Assembler::Label JitCompiler::ExitLabel(long index) {
+        if(exits_[index] == kUnbound) {
+            exits_[index] = masm_.NewLabel();
+        }
+        return exits_[index];
+    }
+
+    void JitCompiler::EmitCallHelper(JitHelper helper, long index) {
+        masm_.Move(RDI, R12);
+        masm_.Move(RSI, RBX);
+        masm_.MoveImmediate(RDX, reinterpret_cast<uint64_t>(instructions_ + index));
+        masm_.MoveImmediate(RAX, reinterpret_cast<uint64_t>(helper));
+        masm_.Byte(0xFF); masm_.Byte(0xD0);                 // call rax
+    }
+
+    void JitCompiler::EmitNumberGuard(long slot, Assembler::Label fail) {
+        masm_.Load(RAX, slot);
+        masm_.MoveImmediate(RCX, kBoxedBits);
+        masm_.Compare(RAX, RCX);
+        masm_.JumpIf(AboveEqual, fail);
+    }
+
+    // Stores xmm0, canonicalizing NaN like Value::SetNumber.
+    void JitCompiler::EmitStoreNumber(long slot) {
+        Assembler::Label nan = masm_.NewLabel();
+        Assembler::Label done = masm_.NewLabel();
+        masm_.CompareDouble(XMM0, XMM0);
+        masm_.JumpIf(Parity, nan);
+        masm_.StoreDouble(slot, XMM0);
+        masm_.Jump(done);
+        masm_.Bind(nan);
+        masm_.MoveImmediate(RAX, kCanonicalNaN);
+        masm_.Store(slot, RAX);
+        masm_.Bind(done);
+    }
+
+    // a = b is a number && b op c
+    void JitCompiler::EmitCompare(const DecodedInstruction* i) {
+        Assembler::Label not_number = masm_.NewLabel();
+        Assembler::Label done = masm_.NewLabel();
+        EmitNumberGuard(i->b_, not_number);
+        masm_.LoadDouble(XMM0, i->b_);
+        masm_.LoadDouble(XMM1, i->c_);
+        // Compare so that the result is "above" or "above or equal",
+        // both false when unordered.
+        if(i->op_ == TypeOp_Less || i->op_ == TypeOp_LessEqual) {
+            masm_.CompareDouble(XMM1, XMM0);
+        } else {
+            masm_.CompareDouble(XMM0, XMM1);
+        }
+        masm_.SetAl(i->op_ == TypeOp_Less || i->op_ == TypeOp_Greater ? Above : AboveEqual);
+        masm_.Jump(done);
+        masm_.Bind(not_number);
+        masm_.Byte(0x31); masm_.Byte(0xC0);                 // xor eax, eax
+        masm_.Bind(done);
+        EmitBoolean(i->a_);
+    }
+
+    // Numbers are equal within 0.000001, everything else by identity, see
+    // lepus::operator==.
+    void JitCompiler::EmitEqual(const DecodedInstruction* i) {
+        Assembler::Label identity = masm_.NewLabel();
+        Assembler::Label done = masm_.NewLabel();
+        masm_.Load(RAX, i->b_);
+        masm_.Load(RDX, i->c_);
+        masm_.MoveImmediate(RCX, kBoxedBits);
+        masm_.Compare(RAX, RCX);
+        masm_.JumpIf(AboveEqual, identity);
+        masm_.Compare(RDX, RCX);
+        masm_.JumpIf(AboveEqual, identity);
+        masm_.MoveToDouble(XMM0, RAX);
+        masm_.MoveToDouble(XMM1, RDX);
+        masm_.SubDouble(XMM0, XMM1);
+        masm_.MoveImmediate(RCX, kAbsMask);
+        masm_.MoveToDouble(XMM1, RCX);
+        masm_.AndDouble(XMM0, XMM1);
+        masm_.MoveImmediate(RCX, DoubleBits(0.000001));
+        masm_.MoveToDouble(XMM1, RCX);
+        masm_.CompareDouble(XMM1, XMM0);
+        masm_.SetAl(Above);
+        masm_.Jump(done);
+        masm_.Bind(identity);
+        masm_.Compare(RAX, RDX);
+        masm_.SetAl(Equal);
+        masm_.Bind(done);
+        if(i->op_ == TypeOp_UnEqual) {
+            masm_.Byte(0x34); masm_.Byte(0x01);             // xor al, 1
+        }
+        EmitBoolean(i->a_);
+    }
+
+    // al = Value::IsFalse() of the slot. Strings, which need their
+    // characters read, leave through |bailout|.
+    void JitCompiler::EmitIsFalse(long slot, Assembler::Label bailout) {
+        Assembler::Label is_false = masm_.NewLabel();
+        Assembler::Label boxed = masm_.NewLabel();
+        Assembler::Label not_boolean = masm_.NewLabel();
+        Assembler::Label done = masm_.NewLabel();
+        masm_.Load(RAX, slot);
+        // Nil is the lowest boxed word.
+        masm_.MoveImmediate(RCX, kNilBits);
+        masm_.Compare(RAX, RCX);
+        masm_.JumpIf(Equal, is_false);
+        masm_.JumpIf(AboveEqual, boxed);
+        // A number is false when it equals zero, NaN is unordered.
+        masm_.MoveToDouble(XMM0, RAX);
+        masm_.XorDouble(XMM1, XMM1);
+        masm_.CompareDouble(XMM0, XMM1);
+        masm_.SetAl(Equal);
+        masm_.Byte(0x0F); masm_.Byte(0x9B); masm_.Byte(0xC1); // setnp cl
+        masm_.Byte(0x20); masm_.Byte(0xC8);                 // and al, cl
+        masm_.Jump(done);
+        masm_.Bind(boxed);
+        masm_.Move(RDX, RAX);
+        masm_.Byte(0x48); masm_.Byte(0xC1);                 // shr rdx, 48
+        masm_.Byte(0xEA); masm_.Byte(Value::kTagShift);
+        masm_.Byte(0x81); masm_.Byte(0xFA);                 // cmp edx, boolean tag
+        masm_.Int32(TagOf(Value_Boolean));
+        masm_.JumpIf(NotEqual, not_boolean);
+        masm_.Byte(0xA8); masm_.Byte(0x01);                 // test al, 1
+        masm_.SetAl(Equal);
+        masm_.Jump(done);
+        masm_.Bind(not_boolean);
+        masm_.Byte(0x81); masm_.Byte(0xFA);                 // cmp edx, string tag
+        masm_.Int32(TagOf(Value_String));
+        masm_.JumpIf(Equal, bailout);
+        masm_.Byte(0x31); masm_.Byte(0xC0);                 // xor eax, eax
+        masm_.Jump(done);
+        masm_.Bind(is_false);
+        masm_.Byte(0xB8); masm_.Int32(1);                   // mov eax, 1
+        masm_.Bind(done);
+    }
+
+    // Stores the boolean in al to the slot.
+    void JitCompiler::EmitBoolean(long slot) {
+        masm_.ZeroExtendAl();
+        masm_.MoveImmediate(RCX, FalseBits());
+        masm_.Byte(0x48); masm_.Byte(0x09); masm_.Byte(0xC8); // or rax, rcx
+        masm_.Store(slot, RAX);
+    }
+
+    JitCode::JitCode(void* memory, std::size_t size)
+        : memory_(memory),
+          size_(size),
+          entry_(reinterpret_cast<Entry>(memory)) {
+    }
+
+    JitCode::~JitCode() {
+        munmap(memory_, size_);
+    }
+
+    JitCode* JitCode::Compile(Function* function, const JitHelpers& helpers) {
+        JitCompiler compiler(function, helpers);
+        return compiler.Compile();
+    }
+}
+
+#endif  // LEPUS_JIT
@@ -1,47 +1,154 @@
 
 #include "lepus/lepus_string.h"
-#include <iostream>
+
+#include <new>
+
 namespace lepus{
-    
-    String::String(const char* str, std::size_t len, StringPool* string_pool) {
-        string_pool_ = string_pool;
-        length_ = len;
-        str_ = lynx_new char[len + 1];
-        memcpy(str_, str, len);
-        str_[len] = 0;
-        Hash(str_);
-    }
-    
+    namespace {
+        const std::size_t kMinSlots = 64;
+    }
+
+    String* String::New(const char* str, std::size_t length, std::size_t hash,
+                        StringPool* string_pool) {
+        void* memory = ::operator new(sizeof(String) + length + 1);
+#if DEBUG_MEMORY
+        base::MemoryTracker::Instance()->AddMemInfo(reinterpret_cast<intptr_t>(memory),
+                                                    __FILE__, __LINE__);
+#endif
+        String* string = new(memory) String(length, hash, string_pool);
+        char* chars = reinterpret_cast<char*>(string + 1);
+        memcpy(chars, str, length);
+        chars[length] = 0;
+        return string;
+    }
+
     String::~String(){
         string_pool_->Earse(this);
-        lynx_deleteA(str_);
-    }
-    
-    void String::Hash(const char *s)
-    {
-        hash_ = 5381;
-        int c = 0;
-        
-        while ((c = *s++))
-            hash_ = ((hash_ << 5) + hash_) + c;
-    }
-    
-    
+    }
+
+    // djb2. Switch tables, also in serialized bytecode, are keyed by it.
+    std::size_t String::Hash(const char* str, std::size_t length) {
+        std::size_t hash = 5381;
+        for(std::size_t i = 0; i < length; ++i) {
+            int c = str[i];
+            hash = ((hash << 5) + hash) + c;
+        }
+        return hash;
+    }
+
     String* StringPool::NewString(const char* str) {
-        return NewString(std::string(str));
+        return NewString(str, strlen(str));
     }
-    
+
     String* StringPool::NewString(const std::string& str) {
-        auto iter = string_map_.find(str);
-        if(iter != string_map_.end()) {
-            return iter->second;
+        return NewString(str.data(), str.size());
+    }
+
+    String* StringPool::NewString(const char* str, std::size_t length) {
+        std::size_t hash = String::Hash(str, length);
+        String* shared = FindShared(str, length, hash);
+        if(shared != nullptr) {
+            return shared;
+        }
+        std::size_t slot = FindSlot(str, length, hash);
+        if(slot != kNoSlot) {
+            // The pool does not keep strings alive, one found here may
+            // already be condemned by a sweep in progress.
+            gc_->KeepAlive(slots_[slot].string_);
+            return slots_[slot].string_;
+        }
+        if((used_slots_ + 1) * 4 > slots_.size() * 3) {
+            Rehash();
+        }
+        String* string = String::New(str, length, hash, this);
+        std::size_t mask = slots_.size() - 1;
+        slot = hash & mask;
+        while(slots_[slot].string_ != nullptr) {
+            slot = (slot + 1) & mask;
         }
-        String* string = lynx_new String(str.c_str(), str.size(), this);
-        string_map_.insert(std::make_pair(str, string));
+        if(!slots_[slot].deleted_) {
+            ++used_slots_;
+        }
+        slots_[slot].hash_ = hash;
+        slots_[slot].string_ = string;
+        slots_[slot].deleted_ = false;
+        ++size_;
+        gc_->Track(string);
         return string;
     }
-    
+
+    String* StringPool::Find(const char* str, std::size_t length) {
+        std::size_t hash = String::Hash(str, length);
+        String* shared = FindShared(str, length, hash);
+        if(shared != nullptr) {
+            return shared;
+        }
+        std::size_t slot = FindSlot(str, length, hash);
+        if(slot == kNoSlot) {
+            return nullptr;
+        }
+        gc_->KeepAlive(slots_[slot].string_);
+        return slots_[slot].string_;
+    }
+
+    String* StringPool::FindShared(const char* str, std::size_t length, std::size_t hash) const {
+        if(shared_ == nullptr) {
+            return nullptr;
+        }
+        std::size_t slot = shared_->FindSlot(str, length, hash);
+        return slot == kNoSlot ? nullptr : shared_->slots_[slot].string_;
+    }
+
+    std::size_t StringPool::FindSlot(const char* str, std::size_t length, std::size_t hash) const {
+        if(slots_.empty()) {
+            return kNoSlot;
+        }
+        std::size_t mask = slots_.size() - 1;
+        for(std::size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            const Slot& entry = slots_[slot];
+            if(entry.string_ == nullptr) {
+                if(!entry.deleted_) {
+                    return kNoSlot;
+                }
+            } else if(entry.hash_ == hash && entry.string_->length() == length
+                      && memcmp(entry.string_->c_str(), str, length) == 0) {
+                return slot;
+            }
+        }
+    }
+
+    void StringPool::Rehash() {
+        std::vector<Slot> old;
+        old.swap(slots_);
+        std::size_t size = kMinSlots;
+        while((size_ + 1) * 2 > size) {
+            size *= 2;
+        }
+        Slot empty = {0, nullptr, false};
+        slots_.assign(size, empty);
+        std::size_t mask = size - 1;
+        for(std::size_t i = 0; i < old.size(); ++i) {
+            if(old[i].string_ == nullptr) {
+                continue;
+            }
+            std::size_t slot = old[i].hash_ & mask;
+            while(slots_[slot].string_ != nullptr) {
+                slot = (slot + 1) & mask;
+            }
+            slots_[slot] = old[i];
+        }
+        used_slots_ = size_;
+    }
+
     void StringPool::Earse(String* string) {
-        string_map_.erase(string->c_str());
+        std::size_t mask = slots_.size() - 1;
+        for(std::size_t slot = string->hash() & mask;; slot = (slot + 1) & mask) {
+            if(slots_[slot].string_ == string) {
+                slots_[slot].string_ = nullptr;
+                slots_[slot].deleted_ = true;
+                --size_;
+                return;
+            }
+        }
     }
 }
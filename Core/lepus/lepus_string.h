@@ -1,75 +1,124 @@
-
 #ifndef LYNX_LEPUS_STRING_H_
 #define LYNX_LEPUS_STRING_H_
 
-#include "base/ref_counted_ptr.h"
-#include <unordered_set>
-#include <unordered_map>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "lepus/gc.h"
 
 namespace lepus {
     class StringPool;
-    class String : public base::RefCountPtr<String>{
+    // Immutable interned string. The characters are stored inline right
+    // after the object and the hash is computed once by the pool, so two
+    // strings of one context are equal exactly when their pointers are.
+    class String : public GCObject{
     public:
-        explicit String(const char* str, std::size_t len, StringPool* string_pool) ;
         virtual ~String();
-        
+
         std::size_t hash() const{
             return hash_;
         }
-        
-        const char* c_str() {
-            return str_;
+
+        const char* c_str() const {
+            return reinterpret_cast<const char*>(this + 1);
         }
 
         std::size_t length() const{
             return length_;
         }
-        
+
         long find(const String& other, long index) {
-            char *str = strstr(str_+index, other.str_);
+            const char *str = strstr(c_str() + index, other.c_str());
             if(str == nullptr)
                 return -1;
-            return str - str_;
+            return str - c_str();
         }
-        
+
         friend bool operator == (const String& left, const String& right) {
-            return memcmp(left.str_, right.str_, left.length_) == 0;
+            return left.length_ == right.length_
+                && memcmp(left.c_str(), right.c_str(), left.length_) == 0;
         }
-    
+
+        // Memory comes from New(), the matching release is here so deleting
+        // through a GCObject pointer frees the whole block.
+        static void operator delete(void* pointer) {
+            ::operator delete(pointer);
+        }
+
+        static std::size_t Hash(const char* str, std::size_t length);
+
+    protected:
+        virtual std::size_t GCSize() {
+            return sizeof(String) + length_ + 1;
+        }
+
     private:
-        void Hash(const char *s);
-        
-        char* str_;
+        friend class StringPool;
+        String(std::size_t length, std::size_t hash, StringPool* string_pool)
+            : length_(length), hash_(hash), string_pool_(string_pool) {}
+        static String* New(const char* str, std::size_t length, std::size_t hash,
+                           StringPool* string_pool);
+
         std::size_t length_;
         std::size_t hash_;
         StringPool* string_pool_;
     };
-    
+
+    // Open addressing intern table of a context. Slots keep the hash next
+    // to the pointer, so a probe only touches a string's characters when
+    // the hashes match. The pool does not keep strings alive, a string
+    // unregisters itself when the GC frees it.
     class StringPool {
     public:
-        StringPool() : string_set_(), string_map_(){}
+        explicit StringPool(GC* gc)
+            : gc_(gc), shared_(nullptr), slots_(), used_slots_(0), size_(0) {}
         ~StringPool() {
-            
+
         }
         String* NewString(const char* str);
+        String* NewString(const char* str, std::size_t length);
         String* NewString(const std::string& str);
+
+        // Returns the interned string with these characters, or nullptr
+        // when there is none. Never allocates.
+        String* Find(const char* str, std::size_t length);
+
+        std::size_t size() const {
+            return size_;
+        }
+
+        // Strings of |shared|, the frozen pool of a Program, are returned
+        // instead of interning a copy here, which keeps pointer equality
+        // with the program's constants and table keys. Must be set before
+        // anything is interned.
+        void set_shared(const StringPool* shared) {
+            shared_ = shared;
+        }
     protected:
         friend class String;
         void Earse(String* string);
     private:
-        struct Hash {
-            std::size_t operator ()(const String* str) const {
-                return str->hash();
-            }
-        };
-        
-        struct Equal {
-            bool operator () (const String* left, const String* right) const {
-                return left == right || *left == *right;
-            }
+        // An empty slot has no string and is not deleted. Deleted slots
+        // keep probe chains intact until the next rehash.
+        struct Slot {
+            std::size_t hash_;
+            String* string_;
+            bool deleted_;
         };
-        std::unordered_set<String*, Hash, Equal> string_set_;
-        std::unordered_map<std::string, String*> string_map_;
+
+        static const std::size_t kNoSlot = static_cast<std::size_t>(-1);
+
+        std::size_t FindSlot(const char* str, std::size_t length, std::size_t hash) const;
+        String* FindShared(const char* str, std::size_t length, std::size_t hash) const;
+        void Rehash();
+
+        GC* gc_;
+        const StringPool* shared_;
+        std::vector<Slot> slots_;
+        // Live and deleted slots.
+        std::size_t used_slots_;
+        std::size_t size_;
     };
 }
 
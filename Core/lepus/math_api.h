@@ -6,100 +6,100 @@ namespace lepus {
     
     Value Sin(Context* context) {
         Value* arg = context->GetParam(1);
-        if(arg->type_ != Value_Number){
+        if(arg->type() != Value_Number){
             return Value();
         }
-        return Value(sin(arg->number_));
+        return Value(sin(arg->number()));
     }
     Value Acos(Context* context) {
         Value* arg = context->GetParam(1);
-        if(arg->type_ != Value_Number){
+        if(arg->type() != Value_Number){
             return Value();
         }
-        return Value(acos(arg->number_));
+        return Value(acos(arg->number()));
     }
     
     Value Asin(Context* context) {
         Value* arg = context->GetParam(1);
-        if(arg->type_ != Value_Number){
+        if(arg->type() != Value_Number){
             return Value();
         }
-        return Value(asin(arg->number_));
+        return Value(asin(arg->number()));
     }
     
     Value Abs(Context* context) {
         Value* arg = context->GetParam(1);
-        if(arg->type_ != Value_Number){
+        if(arg->type() != Value_Number){
             return Value();
         }
-        return Value(fabs(arg->number_));
+        return Value(fabs(arg->number()));
     }
     
     Value Atan(Context* context) {
         Value* arg = context->GetParam(1);
-        if(arg->type_ != Value_Number){
+        if(arg->type() != Value_Number){
             return Value();
         }
-        return Value(atan(arg->number_));
+        return Value(atan(arg->number()));
     }
     Value Ceil(Context* context) {
         Value* arg = context->GetParam(1);
-        if(arg->type_ != Value_Number){
+        if(arg->type() != Value_Number){
             return Value();
         }
-        return Value(ceil(arg->number_));
+        return Value(ceil(arg->number()));
     }
     Value Cos(Context* context) {
         Value* arg = context->GetParam(1);
-        if(arg->type_ != Value_Number){
+        if(arg->type() != Value_Number){
             return Value();
         }
-        return Value(cos(arg->number_));
+        return Value(cos(arg->number()));
     }
     Value Exp(Context* context) {
         Value* arg = context->GetParam(1);
-        if(arg->type_ != Value_Number){
+        if(arg->type() != Value_Number){
             return Value();
         }
-        return Value(exp(arg->number_));
+        return Value(exp(arg->number()));
     }
     Value Floor(Context* context) {
         Value* arg = context->GetParam(1);
-        if(arg->type_ != Value_Number){
+        if(arg->type() != Value_Number){
             return Value();
         }
-        return Value(floor(arg->number_));
+        return Value(floor(arg->number()));
     }
     Value Log(Context* context) {
         Value* arg = context->GetParam(1);
-        if(arg->type_ != Value_Number){
+        if(arg->type() != Value_Number){
             return Value();
         }
-        return Value(log(arg->number_));
+        return Value(log(arg->number()));
     }
     Value Max(Context* context) {
         Value* arg1 = context->GetParam(1);
         Value* arg2 = context->GetParam(2);
-        if(arg1->type_ != Value_Number||arg2->type_ != Value_Number){
+        if(arg1->type() != Value_Number||arg2->type() != Value_Number){
             return Value();
         }
-        return Value(fmax(arg1->number_, arg2->number_));
+        return Value(fmax(arg1->number(), arg2->number()));
     }
     Value Min(Context* context) {
         Value* arg1 = context->GetParam(1);
         Value* arg2 = context->GetParam(2);
-        if(arg1->type_ != Value_Number||arg2->type_ != Value_Number){
+        if(arg1->type() != Value_Number||arg2->type() != Value_Number){
             return Value();
         }
-        return Value(fmin(arg1->number_, arg2->number_));
+        return Value(fmin(arg1->number(), arg2->number()));
     }
     Value Pow(Context* context) {
         Value* arg1 = context->GetParam(1);
         Value* arg2 = context->GetParam(2);
-        if(arg1->type_ != Value_Number||arg2->type_ != Value_Number){
+        if(arg1->type() != Value_Number||arg2->type() != Value_Number){
             return Value();
         }
-        return Value(pow(arg1->number_, arg2->number_));
+        return Value(pow(arg1->number(), arg2->number()));
     }
     Value Random(Context* context) {
         static bool seeded = false;
@@ -111,24 +111,24 @@ namespace lepus {
     }
     Value Round(Context* context) {
         Value* arg = context->GetParam(1);
-        if(arg->type_ != Value_Number){
+        if(arg->type() != Value_Number){
             return Value();
         }
-        return Value(round(arg->number_));
+        return Value(round(arg->number()));
     }
     Value Sqrt(Context* context) {
         Value* arg = context->GetParam(1);
-        if(arg->type_ != Value_Number){
+        if(arg->type() != Value_Number){
             return Value();
         }
-        return Value(sqrt(arg->number_));
+        return Value(sqrt(arg->number()));
     }
     Value Tan(Context* context) {
         Value* arg = context->GetParam(1);
-        if(arg->type_ != Value_Number){
+        if(arg->type() != Value_Number){
             return Value();
         }
-        return Value(tan(arg->number_));
+        return Value(tan(arg->number()));
     }
     
     
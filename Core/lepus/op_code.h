@@ -33,13 +33,19 @@ namespace lepus {
         TypeOp_GreaterEqual,            // ABC  A: dst register B: operand1 register C: operand2 register
         TypeOp_NewTable,                // A    A: register of table
         TypeOp_SetTable,                // ABC  A: register of table B: key register C: value register
-        TypeOp_GetTable,                // ABC  A: register of table B: key register C: value register
+        TypeOp_GetTable,                // ABC  A: value register B: register of table C: key register
         TypeOp_Switch,
         TypeOp_Inc,
         TypeOp_Dec,
         TypeOp_Noop,
+        // Superinstructions emitted by the optimizer, always followed by a Jmp
+        // that is taken when the comparison is false and skipped otherwise.
+        TypeOp_LessJmpFalse,            // ABC  B: operand1 register C: operand2 register
+        TypeOp_LessEqualJmpFalse,       // ABC  B: operand1 register C: operand2 register
     };
     
+    static const long kLastOpCode = TypeOp_LessEqualJmpFalse;
+    
     struct Instruction {
         unsigned long op_code_;
         
@@ -114,6 +120,32 @@ namespace lepus {
         }
         
     };
+    
+    // Instruction with its operands unpacked once, so the interpreter does not
+    // shift and mask on every dispatch. bx_ holds sBx for jumps, Bx for the
+    // other ABx op codes and the inline cache index for GetTable and SetTable.
+    // A decoded stream is terminated by an op_ of 0.
+    struct DecodedInstruction {
+        unsigned char op_;
+        unsigned char a_;
+        unsigned char b_;
+        unsigned char c_;
+        int bx_;
+        
+        DecodedInstruction() : op_(0), a_(0), b_(0), c_(0), bx_(0) {
+            
+        }
+        
+        explicit DecodedInstruction(Instruction i)
+            : op_(Instruction::GetOpCode(i)),
+              a_(Instruction::GetParamA(i)),
+              b_(Instruction::GetParamB(i)),
+              c_(Instruction::GetParamC(i)),
+              bx_(op_ == TypeOp_Jmp || op_ == TypeOp_JmpFalse ?
+                  Instruction::GetParamsBx(i) : Instruction::GetParamBx(i)) {
+            
+        }
+    };
 }
 
 #endif
@@ -0,0 +1,644 @@
+#include "lepus/optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "lepus/value.h"
+
+namespace lepus {
+    namespace {
+        const int kMaxRounds = 8;
+        const long kMaxConstIndex = 0xFFFF;
+        const long kRegisterCount = 256;
+
+        bool IsBinary(long op) {
+            switch (op) {
+                case TypeOp_Add: case TypeOp_Sub: case TypeOp_Mul:
+                case TypeOp_Div: case TypeOp_Mod: case TypeOp_And:
+                case TypeOp_Or: case TypeOp_Less: case TypeOp_Greater:
+                case TypeOp_Equal: case TypeOp_UnEqual:
+                case TypeOp_LessEqual: case TypeOp_GreaterEqual:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // Op codes that write register A from their other operands and have
+        // no other effect.
+        bool DefinesA(long op) {
+            switch (op) {
+                case TypeOp_LoadNil: case TypeOp_LoadConst: case TypeOp_Move:
+                case TypeOp_GetUpvalue: case TypeOp_GetGlobal: case TypeOp_Closure:
+                case TypeOp_GetTable:
+                    return true;
+                default:
+                    return IsBinary(op);
+            }
+        }
+
+        // Op codes that can be dropped once the registers they write are dead.
+        bool IsPure(long op) {
+            switch (op) {
+                case TypeOp_Neg: case TypeOp_Not: case TypeOp_Inc:
+                case TypeOp_Dec: case TypeOp_Noop:
+                    return true;
+                default:
+                    return DefinesA(op);
+            }
+        }
+
+        bool IsJump(long op) {
+            return op == TypeOp_Jmp || op == TypeOp_JmpFalse;
+        }
+    }
+
+    Optimizer::Optimizer()
+        : function_(nullptr),
+          ops_(),
+          exit_live_(),
+          captured_(),
+          live_out_(),
+          jump_target_() {
+    }
+
+    void Optimizer::Optimize(Function* function, const RegisterSet& exit_live) {
+        function_ = function;
+        exit_live_ = exit_live;
+        captured_.reset();
+        for(std::size_t i = 0; i < function->ChildFunctionsSize(); ++i) {
+            Function* child = function->GetChildFunction(i);
+            for(std::size_t j = 0; j < child->UpvaluesSize(); ++j) {
+                UpvalueInfo* info = child->GetUpvalue(j);
+                if(info->in_parent_vars_ && info->register_ < kRegisterCount) {
+                    captured_.set(info->register_);
+                }
+            }
+            Optimizer child_optimizer;
+            child_optimizer.Optimize(child, RegisterSet());
+        }
+
+        Load();
+        for(std::size_t i = 0; i < ops_.size(); ++i) {
+            if(ops_[i].op_ == TypeOp_Switch) {
+                return;
+            }
+            if(IsJump(ops_[i].op_)
+               && (ops_[i].target_ < 0 || ops_[i].target_ > static_cast<long>(ops_.size()))) {
+                return;
+            }
+        }
+
+        for(int round = 0; round < kMaxRounds; ++round) {
+            bool changed = ThreadJumps();
+            Compact();
+            changed |= FoldConstants();
+            Compact();
+            changed |= PropagateCopies();
+            Compact();
+            changed |= RemoveDeadCode();
+            Compact();
+            changed |= RemoveUnreachableCode();
+            Compact();
+            if(!changed) {
+                break;
+            }
+        }
+        FuseCompares();
+        Store();
+    }
+
+    void Optimizer::Load() {
+        ops_.clear();
+        ops_.reserve(function_->op_codes_.size());
+        for(std::size_t i = 0; i < function_->op_codes_.size(); ++i) {
+            Instruction instruction = function_->op_codes_[i];
+            Op op;
+            op.op_ = Instruction::GetOpCode(instruction);
+            op.a_ = Instruction::GetParamA(instruction);
+            op.b_ = Instruction::GetParamB(instruction);
+            op.c_ = Instruction::GetParamC(instruction);
+            op.bx_ = Instruction::GetParamBx(instruction);
+            op.target_ = IsJump(op.op_) ? i + Instruction::GetParamsBx(instruction) : -1;
+            op.dead_ = false;
+            ops_.push_back(op);
+        }
+    }
+
+    void Optimizer::Store() {
+        std::vector<Instruction> op_codes;
+        op_codes.reserve(ops_.size());
+        for(std::size_t i = 0; i < ops_.size(); ++i) {
+            const Op& op = ops_[i];
+            TypeOpCode type = static_cast<TypeOpCode>(op.op_);
+            switch (op.op_) {
+                case TypeOp_Jmp: case TypeOp_JmpFalse:
+                    op_codes.push_back(Instruction::ABxCode(type, op.a_, op.target_ - static_cast<long>(i)));
+                    break;
+                case TypeOp_LoadConst: case TypeOp_GetGlobal: case TypeOp_SetGlobal:
+                case TypeOp_Closure: case TypeOp_Switch:
+                    op_codes.push_back(Instruction::ABxCode(type, op.a_, op.bx_));
+                    break;
+                default:
+                    op_codes.push_back(Instruction::ABCCode(type, op.a_, op.b_, op.c_));
+                    break;
+            }
+        }
+        function_->op_codes_.swap(op_codes);
+    }
+
+    void Optimizer::Compact() {
+        // Jumps to a removed op code land on the next remaining one.
+        std::vector<long> new_index(ops_.size() + 1);
+        long count = 0;
+        for(std::size_t i = 0; i < ops_.size(); ++i) {
+            new_index[i] = count;
+            if(!ops_[i].dead_) {
+                ++count;
+            }
+        }
+        new_index[ops_.size()] = count;
+        if(count == static_cast<long>(ops_.size())) {
+            return;
+        }
+        std::vector<Op> ops;
+        ops.reserve(count);
+        for(std::size_t i = 0; i < ops_.size(); ++i) {
+            if(ops_[i].dead_) {
+                continue;
+            }
+            Op op = ops_[i];
+            if(IsJump(op.op_)) {
+                op.target_ = new_index[op.target_];
+            }
+            ops.push_back(op);
+        }
+        ops_.swap(ops);
+    }
+
+    bool Optimizer::ThreadJumps() {
+        long size = ops_.size();
+        bool changed = false;
+        for(long i = 0; i < size; ++i) {
+            Op& op = ops_[i];
+            if(!IsJump(op.op_)) {
+                continue;
+            }
+            long target = op.target_;
+            for(long hops = 0; target < size && hops < size; ++hops) {
+                const Op& next = ops_[target];
+                if(next.target_ == target) {
+                    break;
+                }
+                // A JmpFalse landing on a test of the same register takes
+                // that branch too.
+                if(next.op_ == TypeOp_Jmp
+                   || (op.op_ == TypeOp_JmpFalse && next.op_ == TypeOp_JmpFalse && next.a_ == op.a_)) {
+                    target = next.target_;
+                }else{
+                    break;
+                }
+            }
+            if(target != op.target_) {
+                op.target_ = target;
+                changed = true;
+            }
+            if(target == i + 1) {
+                op.dead_ = true;
+                changed = true;
+            }else if(op.op_ == TypeOp_Jmp && target < size && ops_[target].op_ == TypeOp_Ret) {
+                op = ops_[target];
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    bool Optimizer::FoldConstants() {
+        ComputeJumpTargets();
+        // Const index held by each register, -1 when unknown.
+        std::vector<long> known(kRegisterCount, -1);
+        RegisterSet defs;
+        bool changed = false;
+        for(std::size_t i = 0; i < ops_.size(); ++i) {
+            Op& op = ops_[i];
+            if(jump_target_[i]) {
+                known.assign(kRegisterCount, -1);
+            }
+            long folded = -1;
+            switch (op.op_) {
+                case TypeOp_LoadConst:
+                    folded = op.bx_;
+                    break;
+                case TypeOp_Move:
+                    if(known[op.b_] >= 0) {
+                        folded = known[op.b_];
+                        op.op_ = TypeOp_LoadConst;
+                        op.bx_ = folded;
+                        changed = true;
+                    }
+                    break;
+                case TypeOp_Neg: case TypeOp_Not: case TypeOp_Inc: case TypeOp_Dec:
+                    if(known[op.a_] >= 0) {
+                        Value value = *function_->GetConstValue(known[op.a_]);
+                        if(op.op_ == TypeOp_Not) {
+                            value.SetBoolean(value.IsFalse());
+                        }else if(value.IsNumber()) {
+                            double number = value.number();
+                            value.SetNumber(op.op_ == TypeOp_Neg ? -number
+                                            : op.op_ == TypeOp_Inc ? number + 1 : number - 1);
+                        }
+                        folded = AddConst(value);
+                    }
+                    if(folded >= 0) {
+                        op.op_ = TypeOp_LoadConst;
+                        op.bx_ = folded;
+                        changed = true;
+                    }
+                    break;
+                case TypeOp_JmpFalse:
+                    if(known[op.a_] >= 0) {
+                        if(function_->GetConstValue(known[op.a_])->IsFalse()) {
+                            op.op_ = TypeOp_Jmp;
+                        }else{
+                            op.dead_ = true;
+                        }
+                        changed = true;
+                    }
+                    break;
+                case TypeOp_Call:
+                    // The callee may write any register above its own and,
+                    // through upvalues, captured ones.
+                    known.assign(kRegisterCount, -1);
+                    break;
+                default:
+                    if(IsBinary(op.op_) && known[op.b_] >= 0 && known[op.c_] >= 0) {
+                        Value result;
+                        if(FoldOp(op, *function_->GetConstValue(known[op.b_]),
+                                  *function_->GetConstValue(known[op.c_]), &result)) {
+                            folded = AddConst(result);
+                        }
+                        if(folded >= 0) {
+                            op.op_ = TypeOp_LoadConst;
+                            op.bx_ = folded;
+                            changed = true;
+                        }
+                    }
+                    break;
+            }
+            Defs(op, &defs);
+            for(long r = 0; r < kRegisterCount; ++r) {
+                if(defs[r]) {
+                    known[r] = captured_[r] ? -1 : folded;
+                }
+            }
+            if(op.op_ == TypeOp_Jmp || op.op_ == TypeOp_Ret) {
+                known.assign(kRegisterCount, -1);
+            }
+        }
+        return changed;
+    }
+
+    bool Optimizer::PropagateCopies() {
+        ComputeJumpTargets();
+        // Register each register was last copied from, -1 when none.
+        std::vector<long> copy(kRegisterCount, -1);
+        RegisterSet defs;
+        bool changed = false;
+        for(std::size_t i = 0; i < ops_.size(); ++i) {
+            Op& op = ops_[i];
+            if(jump_target_[i]) {
+                copy.assign(kRegisterCount, -1);
+            }
+            long* uses[3] = {nullptr, nullptr, nullptr};
+            switch (op.op_) {
+                case TypeOp_Move:
+                    uses[0] = &op.b_;
+                    break;
+                case TypeOp_SetUpvalue: case TypeOp_Ret: case TypeOp_JmpFalse:
+                    uses[0] = &op.a_;
+                    break;
+                case TypeOp_SetTable:
+                    uses[0] = &op.a_;
+                    uses[1] = &op.b_;
+                    uses[2] = &op.c_;
+                    break;
+                case TypeOp_GetTable:
+                    uses[0] = &op.b_;
+                    uses[1] = &op.c_;
+                    break;
+                default:
+                    if(IsBinary(op.op_)) {
+                        uses[0] = &op.b_;
+                        uses[1] = &op.c_;
+                    }
+                    break;
+            }
+            for(int u = 0; u < 3; ++u) {
+                if(uses[u] != nullptr && copy[*uses[u]] >= 0) {
+                    *uses[u] = copy[*uses[u]];
+                    changed = true;
+                }
+            }
+            if(op.op_ == TypeOp_Call || op.op_ == TypeOp_Jmp || op.op_ == TypeOp_Ret) {
+                copy.assign(kRegisterCount, -1);
+                continue;
+            }
+            Defs(op, &defs);
+            for(long r = 0; r < kRegisterCount; ++r) {
+                if(defs[r] || (copy[r] >= 0 && defs[copy[r]])) {
+                    copy[r] = -1;
+                }
+            }
+            if(op.op_ == TypeOp_Move && op.a_ != op.b_ && !captured_[op.a_] && !captured_[op.b_]) {
+                copy[op.a_] = op.b_;
+            }
+        }
+        return changed;
+    }
+
+    bool Optimizer::RemoveDeadCode() {
+        ComputeLiveness();
+        ComputeJumpTargets();
+        long size = ops_.size();
+        RegisterSet defs;
+        bool changed = false;
+        for(long i = 0; i < size; ++i) {
+            Op& op = ops_[i];
+            if(op.op_ == TypeOp_Move && op.a_ == op.b_) {
+                op.dead_ = true;
+                changed = true;
+                continue;
+            }
+            // "Op tmp ...; Move var, tmp" writes var directly when tmp is
+            // not read afterwards. A call returns into var only if var lies
+            // below the callee's frame.
+            if(i + 1 < size && !jump_target_[i + 1] && ops_[i + 1].op_ == TypeOp_Move) {
+                Op& move = ops_[i + 1];
+                long* dst = DefinesA(op.op_) ? &op.a_
+                    : op.op_ == TypeOp_Call && move.a_ < op.a_ ? &op.c_ : nullptr;
+                if(dst != nullptr && move.b_ == *dst && move.a_ != *dst
+                   && !captured_[*dst] && !live_out_[i + 1][*dst]) {
+                    *dst = move.a_;
+                    move.dead_ = true;
+                    changed = true;
+                    ++i;
+                    continue;
+                }
+            }
+            if(IsPure(op.op_)) {
+                Defs(op, &defs);
+                if((defs & live_out_[i]).none()) {
+                    op.dead_ = true;
+                    changed = true;
+                }
+            }
+        }
+        return changed;
+    }
+
+    bool Optimizer::RemoveUnreachableCode() {
+        long size = ops_.size();
+        std::vector<bool> reached(size, false);
+        std::vector<long> pending(1, 0);
+        std::vector<long> successors;
+        while(!pending.empty()) {
+            long index = pending.back();
+            pending.pop_back();
+            if(index >= size || reached[index]) {
+                continue;
+            }
+            reached[index] = true;
+            Successors(index, &successors);
+            pending.insert(pending.end(), successors.begin(), successors.end());
+        }
+        bool changed = false;
+        for(long i = 0; i < size; ++i) {
+            if(!reached[i]) {
+                ops_[i].dead_ = true;
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    bool Optimizer::FuseCompares() {
+        ComputeLiveness();
+        ComputeJumpTargets();
+        bool changed = false;
+        for(std::size_t i = 0; i + 1 < ops_.size(); ++i) {
+            Op& op = ops_[i];
+            Op& jmp = ops_[i + 1];
+            if(jmp.op_ != TypeOp_JmpFalse || jmp.a_ != op.a_ || jump_target_[i + 1]
+               || live_out_[i + 1][op.a_]) {
+                continue;
+            }
+            // Non numbers are NaN boxed, so every comparison with them is
+            // false whichever side they are on and Greater can swap into Less.
+            switch (op.op_) {
+                case TypeOp_Less:
+                    op.op_ = TypeOp_LessJmpFalse;
+                    break;
+                case TypeOp_LessEqual:
+                    op.op_ = TypeOp_LessEqualJmpFalse;
+                    break;
+                case TypeOp_Greater:
+                    op.op_ = TypeOp_LessJmpFalse;
+                    std::swap(op.b_, op.c_);
+                    break;
+                case TypeOp_GreaterEqual:
+                    op.op_ = TypeOp_LessEqualJmpFalse;
+                    std::swap(op.b_, op.c_);
+                    break;
+                default:
+                    continue;
+            }
+            op.a_ = 0;
+            jmp.op_ = TypeOp_Jmp;
+            jmp.a_ = 0;
+            changed = true;
+            ++i;
+        }
+        return changed;
+    }
+
+    void Optimizer::ComputeLiveness() {
+        long size = ops_.size();
+        std::vector<RegisterSet> live_in(size);
+        live_out_.assign(size, RegisterSet());
+        RegisterSet exit = exit_live_ | captured_;
+        std::vector<long> successors;
+        RegisterSet uses;
+        RegisterSet defs;
+        bool changed = true;
+        while(changed) {
+            changed = false;
+            for(long i = size - 1; i >= 0; --i) {
+                RegisterSet out = captured_;
+                if(ops_[i].op_ == TypeOp_Ret) {
+                    out |= exit;
+                }
+                Successors(i, &successors);
+                for(std::size_t s = 0; s < successors.size(); ++s) {
+                    out |= successors[s] >= size ? exit : live_in[successors[s]];
+                }
+                Uses(ops_[i], &uses);
+                Defs(ops_[i], &defs);
+                RegisterSet in = uses | (out & ~defs);
+                if(in != live_in[i] || out != live_out_[i]) {
+                    live_in[i] = in;
+                    live_out_[i] = out;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    void Optimizer::ComputeJumpTargets() {
+        jump_target_.assign(ops_.size() + 1, false);
+        for(std::size_t i = 0; i < ops_.size(); ++i) {
+            if(IsJump(ops_[i].op_)) {
+                jump_target_[ops_[i].target_] = true;
+            }
+        }
+    }
+
+    void Optimizer::Successors(long index, std::vector<long>* successors) {
+        successors->clear();
+        const Op& op = ops_[index];
+        switch (op.op_) {
+            case TypeOp_Jmp:
+                successors->push_back(op.target_);
+                break;
+            case TypeOp_JmpFalse:
+                successors->push_back(index + 1);
+                successors->push_back(op.target_);
+                break;
+            case TypeOp_Ret:
+                break;
+            case TypeOp_LessJmpFalse: case TypeOp_LessEqualJmpFalse:
+                successors->push_back(index + 1);
+                successors->push_back(index + 2);
+                break;
+            default:
+                successors->push_back(index + 1);
+                break;
+        }
+    }
+
+    void Optimizer::Uses(const Op& op, RegisterSet* uses) {
+        uses->reset();
+        switch (op.op_) {
+            case TypeOp_LoadNil: case TypeOp_LoadConst: case TypeOp_GetUpvalue:
+            case TypeOp_GetGlobal: case TypeOp_Closure: case TypeOp_Jmp:
+            case TypeOp_Noop:
+                break;
+            case TypeOp_Move:
+                uses->set(op.b_);
+                break;
+            case TypeOp_SetUpvalue: case TypeOp_Ret: case TypeOp_JmpFalse:
+            case TypeOp_Neg: case TypeOp_Not: case TypeOp_Inc: case TypeOp_Dec:
+                uses->set(op.a_);
+                break;
+            case TypeOp_Call:
+                // The callee and its arguments.
+                for(long r = op.a_; r <= op.a_ + op.b_ && r < kRegisterCount; ++r) {
+                    uses->set(r);
+                }
+                break;
+            case TypeOp_GetTable: case TypeOp_LessJmpFalse: case TypeOp_LessEqualJmpFalse:
+                uses->set(op.b_);
+                uses->set(op.c_);
+                break;
+            default:
+                if(!IsBinary(op.op_)) {
+                    uses->set(op.a_);
+                }
+                uses->set(op.b_);
+                uses->set(op.c_);
+                break;
+        }
+    }
+
+    void Optimizer::Defs(const Op& op, RegisterSet* defs) {
+        defs->reset();
+        if(DefinesA(op.op_) || op.op_ == TypeOp_Neg || op.op_ == TypeOp_Not
+           || op.op_ == TypeOp_Inc || op.op_ == TypeOp_Dec) {
+            defs->set(op.a_);
+        }else if(op.op_ == TypeOp_Call) {
+            defs->set(op.c_);
+        }
+    }
+
+    // Mirrors the interpreter exactly, operand types it does not handle the
+    // same way at run time are left alone.
+    bool Optimizer::FoldOp(const Op& op, const Value& b, const Value& c, Value* result) {
+        if(op.op_ == TypeOp_Equal || op.op_ == TypeOp_UnEqual) {
+            result->SetBoolean((b == c) == (op.op_ == TypeOp_Equal));
+            return true;
+        }
+        if(op.op_ == TypeOp_And || op.op_ == TypeOp_Or) {
+            if(!b.IsBoolean() || !c.IsBoolean()) {
+                return false;
+            }
+            result->SetBoolean(op.op_ == TypeOp_And ? b.boolean() && c.boolean()
+                               : b.boolean() || c.boolean());
+            return true;
+        }
+        if(!b.IsNumber() || !c.IsNumber()) {
+            return false;
+        }
+        double x = b.number();
+        double y = c.number();
+        switch (op.op_) {
+            case TypeOp_Add:
+                result->SetNumber(x + y);
+                return true;
+            case TypeOp_Sub:
+                result->SetNumber(x - y);
+                return true;
+            case TypeOp_Mul:
+                result->SetNumber(x * y);
+                return true;
+            case TypeOp_Div:
+                result->SetNumber(x / y);
+                return true;
+            case TypeOp_Mod:
+                if(!(std::fabs(x / y) < 2147483647.0)) {
+                    return false;
+                }
+                result->SetNumber(x - int(x / y) * y);
+                return true;
+            case TypeOp_Less:
+                result->SetBoolean(x < y);
+                return true;
+            case TypeOp_Greater:
+                result->SetBoolean(x > y);
+                return true;
+            case TypeOp_LessEqual:
+                result->SetBoolean(x <= y);
+                return true;
+            case TypeOp_GreaterEqual:
+                result->SetBoolean(x >= y);
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Function::AddConstValue merges numbers within an epsilon, folded
+    // results need an exact match.
+    long Optimizer::AddConst(const Value& value) {
+        std::vector<Value>& consts = function_->const_values_;
+        for(std::size_t i = 0; i < consts.size(); ++i) {
+            if(consts[i].bits() == value.bits()) {
+                return i;
+            }
+        }
+        if(static_cast<long>(consts.size()) > kMaxConstIndex || value.IsString()) {
+            return -1;
+        }
+        consts.push_back(value);
+        return consts.size() - 1;
+    }
+}
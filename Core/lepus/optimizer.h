@@ -0,0 +1,75 @@
+#ifndef LYNX_LEPUS_OPTIMIZER_H_
+#define LYNX_LEPUS_OPTIMIZER_H_
+
+#include <bitset>
+#include <vector>
+
+#include "lepus/function.h"
+#include "lepus/op_code.h"
+
+namespace lepus {
+    // Rewrites the op codes of a freshly generated function tree, before its
+    // first run or serialization:
+    //   - constant folding, constant and copy propagation inside basic
+    //     blocks,
+    //   - coalescing of "Op tmp ...; Move var, tmp" into "Op var ...",
+    //   - dead code and unreachable code elimination,
+    //   - jump threading,
+    //   - fusion of a compare followed by JmpFalse into a superinstruction.
+    // Registers captured by child functions are written behind the
+    // optimizer's back during calls, so they are always live and never
+    // assumed constant. Functions containing a Switch are left untouched,
+    // their jump tables hold raw offsets.
+    class Optimizer {
+    public:
+        typedef std::bitset<256> RegisterSet;
+
+        Optimizer();
+
+        // |exit_live| are the registers read after |function| returns, the
+        // top level variables for the root function. Child functions are
+        // optimized too.
+        void Optimize(Function* function, const RegisterSet& exit_live);
+
+    private:
+        struct Op {
+            long op_;
+            long a_;
+            long b_;
+            long c_;
+            long bx_;
+            // Absolute index of the jump target for Jmp and JmpFalse, may be
+            // the op code count, which returns nil.
+            long target_;
+            bool dead_;
+        };
+
+        void Load();
+        void Store();
+        void Compact();
+
+        bool ThreadJumps();
+        bool FoldConstants();
+        bool PropagateCopies();
+        bool RemoveDeadCode();
+        bool RemoveUnreachableCode();
+        bool FuseCompares();
+
+        void ComputeLiveness();
+        void ComputeJumpTargets();
+        void Successors(long index, std::vector<long>* successors);
+        void Uses(const Op& op, RegisterSet* uses);
+        void Defs(const Op& op, RegisterSet* defs);
+        bool FoldOp(const Op& op, const Value& b, const Value& c, Value* result);
+        long AddConst(const Value& value);
+
+        Function* function_;
+        std::vector<Op> ops_;
+        RegisterSet exit_live_;
+        RegisterSet captured_;
+        std::vector<RegisterSet> live_out_;
+        std::vector<bool> jump_target_;
+    };
+}
+
+#endif  // LYNX_LEPUS_OPTIMIZER_H_
@@ -0,0 +1,176 @@
+#include "lepus/profiler.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <iomanip>
+
+#include "lepus/disassembler.h"
+#include "lepus/value.h"
+
+namespace lepus {
+    namespace {
+        bool ByExclusiveTime(const Profiler::Stats* left, const Profiler::Stats* right) {
+            return left->exclusive_ns_ > right->exclusive_ns_;
+        }
+
+        void WriteJsonString(std::ostream& out, const std::string& str) {
+            out << '"';
+            for(std::size_t i = 0; i < str.size(); ++i) {
+                char c = str[i];
+                if(c == '"' || c == '\\') {
+                    out << '\\' << c;
+                }else if(static_cast<unsigned char>(c) < 0x20) {
+                    out << ' ';
+                }else{
+                    out << c;
+                }
+            }
+            out << '"';
+        }
+    }
+
+    Profiler::Profiler()
+        : epoch_(Clock::now()),
+          stats_(),
+          calls_(),
+          trace_(),
+          dropped_events_(0) {
+        memset(op_counts_, 0, sizeof(op_counts_));
+    }
+
+    Profiler::Stats* Profiler::Enter(const void* key, bool native) {
+        Stats* stats = &stats_[key];
+        if(stats->calls_ == 0) {
+            stats->native_ = native;
+        }
+        ++stats->calls_;
+        ++stats->active_;
+        Call call = {stats, Clock::now(), 0};
+        calls_.push_back(call);
+        return stats;
+    }
+
+    void Profiler::Leave() {
+        // Profiling may have started inside a call.
+        if(calls_.empty()) {
+            return;
+        }
+        Clock::time_point end = Clock::now();
+        Call call = calls_.back();
+        calls_.pop_back();
+        int64_t inclusive = Nanoseconds(call.begin_, end);
+        Stats* stats = call.stats_;
+        if(--stats->active_ == 0) {
+            stats->inclusive_ns_ += inclusive;
+        }
+        stats->exclusive_ns_ += inclusive - call.children_ns_;
+        if(!calls_.empty()) {
+            calls_.back().children_ns_ += inclusive;
+        }
+        if(trace_.size() < kMaxTraceEvents) {
+            TraceEvent event = {stats, Nanoseconds(epoch_, call.begin_), inclusive};
+            trace_.push_back(event);
+        }else{
+            ++dropped_events_;
+        }
+    }
+
+    void Profiler::Unwind() {
+        while(!calls_.empty()) {
+            Leave();
+        }
+    }
+
+    void Profiler::Reset() {
+        epoch_ = Clock::now();
+        stats_.clear();
+        calls_.clear();
+        trace_.clear();
+        dropped_events_ = 0;
+        memset(op_counts_, 0, sizeof(op_counts_));
+    }
+
+    void Profiler::WriteStats(std::ostream& out, bool native) {
+        std::vector<const Stats*> sorted;
+        std::unordered_map<const void*, Stats>::iterator iter;
+        for(iter = stats_.begin(); iter != stats_.end(); ++iter) {
+            if(iter->second.native_ == native) {
+                sorted.push_back(&iter->second);
+            }
+        }
+        std::sort(sorted.begin(), sorted.end(), ByExclusiveTime);
+        out << std::left << std::setw(32) << (native ? "native function" : "function")
+            << std::right << std::setw(12) << "calls"
+            << std::setw(14) << "incl ms" << std::setw(14) << "excl ms"
+            << std::setw(14) << "excl ns/call" << std::endl;
+        for(std::size_t i = 0; i < sorted.size(); ++i) {
+            const Stats* stats = sorted[i];
+            out << std::left << std::setw(32) << stats->name_
+                << std::right << std::setw(12) << stats->calls_
+                << std::setw(14) << stats->inclusive_ns_ / 1e6
+                << std::setw(14) << stats->exclusive_ns_ / 1e6
+                << std::setw(14) << stats->exclusive_ns_ / static_cast<double>(stats->calls_)
+                << std::endl;
+        }
+    }
+
+    void Profiler::WriteReport(std::ostream& out) {
+        std::ios::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+        out << std::fixed << std::setprecision(3);
+
+        out << "-- lepus profile" << std::endl;
+        WriteStats(out, false);
+        out << std::endl;
+        WriteStats(out, true);
+        out << std::endl;
+
+        uint64_t total = 0;
+        std::vector<std::pair<uint64_t, long> > ops;
+        for(long op = 0; op <= kLastOpCode; ++op) {
+            total += op_counts_[op];
+            if(op_counts_[op] != 0) {
+                ops.push_back(std::make_pair(op_counts_[op], op));
+            }
+        }
+        std::sort(ops.rbegin(), ops.rend());
+        out << std::left << std::setw(32) << "op code"
+            << std::right << std::setw(12) << "count" << std::setw(14) << "%" << std::endl;
+        for(std::size_t i = 0; i < ops.size(); ++i) {
+            out << std::left << std::setw(32) << OpCodeName(ops[i].second)
+                << std::right << std::setw(12) << ops[i].first
+                << std::setw(14) << ops[i].first * 100.0 / total << std::endl;
+        }
+        out << "-- " << total << " instructions";
+        if(dropped_events_ != 0) {
+            out << ", " << dropped_events_ << " calls missing from the trace";
+        }
+        out << std::endl;
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+    void Profiler::WriteTrace(std::ostream& out) {
+        std::ios::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+        out << std::fixed << std::setprecision(3);
+
+        // Complete events in microseconds, one thread per context.
+        out << "{\"traceEvents\":[";
+        for(std::size_t i = 0; i < trace_.size(); ++i) {
+            const TraceEvent& event = trace_[i];
+            out << (i == 0 ? "\n" : ",\n") << "{\"name\":";
+            WriteJsonString(out, event.stats_->name_);
+            out << ",\"cat\":\"" << (event.stats_->native_ ? "native" : "lepus") << '"'
+                << ",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+                << ",\"ts\":" << event.begin_ns_ / 1e3
+                << ",\"dur\":" << event.duration_ns_ / 1e3 << '}';
+        }
+        out << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef LYNX_LEPUS_PROFILER_H_
+#define LYNX_LEPUS_PROFILER_H_
+
+#include <stdint.h>
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "lepus/op_code.h"
+
+namespace lepus {
+    // Opt-in profile of a VMContext, see VMContext::set_profiling. Counts
+    // calls and inclusive and exclusive time of every lepus function and
+    // native function it enters, and how often each op code executes.
+    // Recursive calls add to the inclusive time of their outermost call
+    // only. Calls are also kept as trace events, up to kMaxTraceEvents.
+    class Profiler {
+    public:
+        struct Stats {
+            std::string name_;
+            bool native_;
+            uint64_t calls_;
+            int64_t inclusive_ns_;
+            int64_t exclusive_ns_;
+            // Open calls, to leave out the inclusive time of recursion.
+            int active_;
+        };
+
+        static const std::size_t kMaxTraceEvents = 1 << 18;
+
+        Profiler();
+
+        void CountOp(long op) {
+            ++op_counts_[op];
+        }
+
+        // |key| identifies the function, a Function or a CFunction. The
+        // returned stats have no name yet on the first call, the caller
+        // names them.
+        Stats* Enter(const void* key, bool native);
+        void Leave();
+        // Drops the open calls, after an exception unwound the frames.
+        void Unwind();
+
+        void Reset();
+
+        // Table of functions by exclusive time, native functions and the
+        // op code histogram.
+        void WriteReport(std::ostream& out);
+        // Chrome trace event format, for chrome://tracing or Perfetto.
+        void WriteTrace(std::ostream& out);
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        struct Call {
+            Stats* stats_;
+            Clock::time_point begin_;
+            int64_t children_ns_;
+        };
+
+        struct TraceEvent {
+            const Stats* stats_;
+            int64_t begin_ns_;
+            int64_t duration_ns_;
+        };
+
+        int64_t Nanoseconds(Clock::time_point from, Clock::time_point to) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+        }
+
+        void WriteStats(std::ostream& out, bool native);
+
+        Clock::time_point epoch_;
+        std::unordered_map<const void*, Stats> stats_;
+        std::vector<Call> calls_;
+        std::vector<TraceEvent> trace_;
+        uint64_t dropped_events_;
+        uint64_t op_counts_[kLastOpCode + 1];
+    };
+}
+
+#endif  // LYNX_LEPUS_PROFILER_H_
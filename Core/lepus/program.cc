@@ -0,0 +1,28 @@
+#include "lepus/program.h"
+
+#include "lepus/vm_context.h"
+
+namespace lepus {
+    Program::Program(VMContext* context) : context_(context) {
+    }
+
+    Program::~Program() {
+    }
+
+    Program* Program::Compile(VMContext* context, const char* source, std::size_t length) {
+        return Freeze(context, context->Parse(source, length));
+    }
+
+    Program* Program::CompileBytecode(VMContext* context, const char* data, std::size_t size) {
+        return Freeze(context, context->ReadBytecode(data, size));
+    }
+
+    Program* Program::Freeze(VMContext* context, bool compiled) {
+        if(!compiled) {
+            lynx_delete(context);
+            return nullptr;
+        }
+        context->gc()->Freeze();
+        return lynx_new Program(context);
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef LYNX_LEPUS_PROGRAM_H_
+#define LYNX_LEPUS_PROGRAM_H_
+
+#include <cstddef>
+
+#include "base/ref_counted_ptr.h"
+#include "base/scoped_ptr.h"
+
+namespace lepus {
+    class VMContext;
+
+    // A compiled script frozen for sharing. The program keeps the context
+    // it was compiled in, with its function tree, interned strings and
+    // globals, builtins included. None of them change afterwards, so any
+    // number of contexts attached with VMContext(Program*) run the script
+    // at the same time, on any threads, without compiling it or
+    // registering builtins again.
+    //
+    //   base::ScopedRefPtr<Program> program(Program::Compile(context, source, length));
+    //   VMContext attached(program.Get());
+    //   attached.ExecuteProgram();
+    class Program : public base::RefCountPtr<Program> {
+    public:
+        // Compiles |source| in |context| without running it. |context| must
+        // be initialized, natives registered, and is owned by the program
+        // from here on, or deleted when nullptr is returned on a compile
+        // error.
+        static Program* Compile(VMContext* context, const char* source, std::size_t length);
+        // The same for serialized bytecode, see lepus/bytecode.h.
+        static Program* CompileBytecode(VMContext* context, const char* data, std::size_t size);
+
+        ~Program();
+
+        VMContext* context() const {
+            return context_.Get();
+        }
+
+    private:
+        explicit Program(VMContext* context);
+        static Program* Freeze(VMContext* context, bool compiled);
+
+        base::ScopedPtr<VMContext> context_;
+    };
+}
+
+#endif  // LYNX_LEPUS_PROGRAM_H_
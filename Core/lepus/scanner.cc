@@ -13,8 +13,9 @@
 #include "lepus/exception.h"
 
 namespace lepus {
-    Scanner::Scanner(parser::InputStream* input, StringPool* string_pool)
-        : input_stream_(input),
+    Scanner::Scanner(const char* source, std::size_t length, StringPool* string_pool)
+        : cursor_(source),
+        end_(source + length),
         string_pool_(string_pool),
         current_character_(EOF),
         line_(1),
@@ -61,9 +62,10 @@ namespace lepus {
     }
     
     void Scanner::ParseNumber(Token& token) {
-        std::string buffer;
+        const char* begin = CurrentPosition();
+        const char* end = begin;
         while(true) {
-            buffer.push_back(current_character_);
+            end = cursor_;
             current_character_ = NextCharacter();
             if(!IsDigit(current_character_)
                && !IsHex(current_character_)
@@ -71,6 +73,8 @@ namespace lepus {
                 break;
             }
         }
+        // strtod needs a terminator the span may not have.
+        std::string buffer(begin, end - begin);
         token = Token(line_, column_, Token_Number, strtod(buffer.c_str(), nullptr));
     }
     
@@ -104,12 +108,13 @@ namespace lepus {
     
     void Scanner::ParseString(Token& token) {
         int quote = current_character_;
-        std::string buffer;
-        while((current_character_ = NextCharacter()) && (current_character_ != quote)) {
-            buffer.push_back(current_character_);
+        const char* begin = cursor_;
+        while((current_character_ = NextCharacter()) != EOF && (current_character_ != quote)) {
         }
+        // An unterminated string runs to the end of the source.
+        const char* end = current_character_ == EOF ? cursor_ : CurrentPosition();
         current_character_ = NextCharacter();
-        token = Token(line_, column_, Token_String, string_pool_->NewString(buffer));
+        token = Token(line_, column_, Token_String, string_pool_->NewString(begin, end - begin));
     }
     
     void Scanner::ParseId(Token& token) {
@@ -117,15 +122,15 @@ namespace lepus {
            current_character_ != '_') {
             throw CompileException("invalid name", Token(line_, column_, Token_Id));
         }
-        std::string buffer;
-        buffer.push_back(current_character_);
-        while((current_character_ = NextCharacter()) && (isalnum(current_character_) || current_character_ == '_')) {
-            buffer.push_back(current_character_);
+        const char* begin = CurrentPosition();
+        const char* end = cursor_;
+        while((current_character_ = NextCharacter()) != EOF && (isalnum(current_character_) || current_character_ == '_')) {
+            end = cursor_;
         }
         
         int token_type = Token_EOF;
-        if(!IsKeyWord(buffer, token_type)) {
-            token = Token(line_, column_, Token_Id, string_pool_->NewString(buffer));
+        if(!IsKeyWord(begin, end - begin, token_type)) {
+            token = Token(line_, column_, Token_Id, string_pool_->NewString(begin, end - begin));
             return;
         }
         token = Token(line_, column_, token_type);
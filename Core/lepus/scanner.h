@@ -9,15 +9,20 @@
 #ifndef LYNX_LEPUS_LEXER_H_
 #define LYNX_LEPUS_LEXER_H_
 
-#include "base/scoped_ptr.h"
+#include <cstddef>
+#include <cstdio>
+
 #include "lepus/token.h"
-#include "parser/input_stream.h"
 #include "lepus/lepus_string.h"
 
 namespace lepus {
+    // Tokenizes a span of source in place, which may be a mapped file and
+    // need not be null terminated; a '\0' byte ends the source early. The
+    // span must outlive the scanner. Identifiers and string literals are
+    // interned straight from the span.
     class Scanner {
     public:
-        Scanner(parser::InputStream* input, StringPool* string_pool);
+        Scanner(const char* source, std::size_t length, StringPool* string_pool);
         void NextToken(Token& token);
     private:
         void ParseNewLine();
@@ -30,16 +35,20 @@ namespace lepus {
         void ParseId(Token& token);
         
         int NextCharacter() {
-            int character = input_stream_->Next();
-            if(character != 0) {
-                ++column_;
-            }else{
-                character = EOF;
+            if(cursor_ == end_ || *cursor_ == 0) {
+                return EOF;
             }
-            return character;
+            ++column_;
+            return *cursor_++;
+        }
+        
+        // Start of the character last returned by NextCharacter().
+        const char* CurrentPosition() {
+            return cursor_ - 1;
         }
         
-        parser::InputStream* input_stream_;
+        const char* cursor_;
+        const char* end_;
         StringPool* string_pool_;
         int current_character_;
         int line_;
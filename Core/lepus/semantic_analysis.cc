@@ -382,7 +382,12 @@ namespace lepus {
     }
     
     void SemanticAnalysis::Visit(MemberAccessorAST* ast, void* data){
-        ast->table()->Accept(this, data);
+        ExprData* expr_data = static_cast<ExprData*>(data);
+        ast->lex_op() = expr_data == nullptr ? LexicalOp_Read : expr_data->lex_po_;
+        // Assigning to a member only reads the table.
+        ExprData table_data;
+        table_data.lex_po_ = LexicalOp_Read;
+        ast->table()->Accept(this, &table_data);
     }
     
     void SemanticAnalysis::Visit(FunctionCallAST* ast, void* data) {
@@ -11,10 +11,10 @@ namespace lepus {
         long params_count = context->GetParamsSize();
         Value* thiz = context->GetParam(0);
         Value* arg = context->GetParam(1);
-        long index = params_count == 2 ? 0 : context->GetParam(2)->number_;
+        long index = params_count == 2 ? 0 : context->GetParam(2)->number();
         
-        if(thiz->type_ == Value_String && arg->type_ == Value_String) {
-            return Value(thiz->str_->find(*arg->str_, index));
+        if(thiz->IsString() && arg->IsString()) {
+            return Value(thiz->str()->find(*arg->str(), index));
         }
         
         return Value(-1);
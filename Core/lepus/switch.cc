@@ -3,140 +3,222 @@
 #include "lepus/value.h"
 
 namespace lepus {
-    SwitchInfo* SwitchInfo::Create(base::ScopedVector<ASTree>& cases) {
-        SwitchInfo* info = lynx_new SwitchInfo;
-        CaseStatementAST* ast = static_cast<CaseStatementAST*>(cases[0]);
-        if(ast->key().token_ == Token_Number) {
-            info->key_type_ = Token_Number;
-        }else if(ast->key().token_ == Token_String) {
-            info->key_type_ = Token_String;
-        }
+    namespace {
+        // Bounds the memory of a forced table, Build() stays far below it.
+        const double kMaxTableSize = 1 << 16;
+        const double kMaxSafeInteger = 9007199254740992.0;
+        // Candidate multipliers per hash table size before one more bit is
+        // tried, and bits tried beyond the minimum.
+        const int kHashAttempts = 64;
+        const int kMaxExtraHashBits = 3;
         
-        std::vector<std::pair<long, long> > table;
-        for(base::ScopedVector<ASTree>::iterator iter = cases.begin();
-            iter != cases.end(); ++iter) {
-            CaseStatementAST* ast = static_cast<CaseStatementAST*>(*iter);
-            if(ast->is_default()){
-                continue;
-            }
-            if(info->key_type_ == Token_Number) {
-                info->min_ = info->min_ < ast->key().number_ ? info->min_ : ast->key().number_;
-                info->max_ = info->max_ < ast->key().number_ ? ast->key().number_: info->max_;
-                table.push_back(std::make_pair(ast->key().number_, -1));
-            }else if(info->key_type_ == Token_String){
-                table.push_back(std::make_pair(ast->key().str_->hash(), -1));
+        // -0 === 0, both must find the same key.
+        uint64_t KeyOf(const Value& value) {
+            if(value.IsNumber() && value.number() == 0) {
+                return Value(0).bits();
             }
-               
+            return value.bits();
         }
-        double useful_rate = cases.size() / (info->max_ - info->min_);
         
-        if(useful_rate > 0.7) {
-            long size = info->max_ - info->min_ + 1;
-            info->switch_table_.resize(size);
-            for(base::ScopedVector<ASTree>::iterator iter = cases.begin();
-                iter != cases.end(); ++iter) {
-                info->switch_table_[(int)ast->key().number_] = std::make_pair(ast->key().number_, -1);
-            }
-            info->type_ = SwitchType_Table;
-        }else{
-            std::swap(info->switch_table_, table);
-            info->type_ = SwitchType_Lookup;
-            info->Adjust();
+        Value FromKey(uint64_t key) {
+            return Value::FromBits(key);
+        }
+        
+        // Odd multipliers, the same on every run so a rebuilt switch, e.g.
+        // from bytecode, gets the same table.
+        uint64_t Multiplier(int attempt) {
+            uint64_t z = 0x9E3779B97F4A7C15ULL * (attempt + 1);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return (z ^ (z >> 31)) | 1;
         }
-        return info;
     }
     
-    // 升序排列
-    bool SwitchInfo::SortTable(const std::pair<int, int> &v1, const std::pair<int, int> &v2 ){
-        return v1.first < v2.first;
+    const double SwitchInfo::kMinTableDensity = 0.5;
+    
+    SwitchInfo::SwitchInfo()
+        : type_(SwitchType_Lookup),
+          default_offset_(-1),
+          cases_(),
+          strings_(),
+          min_(0),
+          table_(),
+          entries_(),
+          multiplier_(0),
+          shift_(0) {
     }
     
-    long SwitchInfo::BinarySearchTable(long key){
-        if(switch_table_.size() == 0){
-            return -1;
+    SwitchInfo::~SwitchInfo() {
+        for(std::size_t i = 0; i < strings_.size(); ++i) {
+            strings_[i]->Release();
         }
-        long low = 0;
-        long high = switch_table_.size() - 1;
-        long mid = 0;
-        while(low <= high){
-            mid = (low + high) / 2;
-            if(switch_table_[mid].first < key){
-                low = mid + 1;
-            }else if(switch_table_[mid].first > key){
-                high = mid-1;
-            }else{
-                return mid;
+    }
+    
+    void SwitchInfo::AddCase(const Value& key, long offset) {
+        // NaN matches nothing, not even a NaN case.
+        if(key.IsNumber() && key.number() != key.number()) {
+            return;
+        }
+        Case c = {KeyOf(key), offset};
+        for(std::size_t i = 0; i < cases_.size(); ++i) {
+            if(cases_[i].key_ == c.key_) {
+                return;
+            }
+        }
+        if(key.IsString()) {
+            key.str()->AddRef();
+            strings_.push_back(key.str());
+        }
+        cases_.push_back(c);
+    }
+    
+    bool SwitchInfo::IntegerRange(double* min, double* max) {
+        for(std::size_t i = 0; i < cases_.size(); ++i) {
+            Value key = FromKey(cases_[i].key_);
+            // Beyond 2^53 every double is an integer, but not a long.
+            if(!key.IsNumber() || std::floor(key.number()) != key.number()
+               || std::fabs(key.number()) > kMaxSafeInteger) {
+                return false;
             }
+            *min = i == 0 || key.number() < *min ? key.number() : *min;
+            *max = i == 0 || key.number() > *max ? key.number() : *max;
         }
-        return -1;
+        return !cases_.empty();
     }
     
+    Value SwitchInfo::GetCaseKey(std::size_t index) const {
+        return FromKey(cases_[index].key_);
+    }
     
-    void SwitchInfo::Modify(Token& key, long offset) {
-        if(key.token_ == Token_Defalut) {
-            default_offset_ = offset;
+    void SwitchInfo::Build() {
+        double min = 0;
+        double max = 0;
+        if(IntegerRange(&min, &max) && cases_.size() >= kMinTableDensity * (max - min + 1)
+           && Build(SwitchType_Table)) {
             return;
         }
-        if(type_ == SwitchType_Table) {
-            if(key.token_ != Token_Number || min_ > max_) {
-                return ;
-            }
-            
-            long k = (long)key.number_;
-            if(k < min_ || k > max_) {
-                default_offset_ = offset;
-                return;
-            }
-            long index = k - min_;
-            
-            switch_table_[index].second = offset;
+        if(Build(SwitchType_Hash)) {
             return;
-        }else if(type_ == SwitchType_Lookup){
-            long key_index;
-            if(key.token_ == Token_Number) {
-                key_index = key.number_;
-            }else if(key.token_ == Token_String){
-                key_index = key.str_->hash();
-            }else{
-                return;
+        }
+        Build(SwitchType_Lookup);
+    }
+    
+    bool SwitchInfo::Build(SwitchType type) {
+        table_.clear();
+        entries_.clear();
+        switch (type) {
+            case SwitchType_Table: {
+                double min = 0;
+                double max = 0;
+                if(!IntegerRange(&min, &max) || max - min + 1 > kMaxTableSize) {
+                    return false;
+                }
+                min_ = static_cast<long>(min);
+                table_.assign(static_cast<long>(max) - min_ + 1, -1);
+                for(std::size_t i = 0; i < cases_.size(); ++i) {
+                    long key = static_cast<long>(FromKey(cases_[i].key_).number());
+                    table_[key - min_] = cases_[i].offset_;
+                }
+                break;
+            }
+            case SwitchType_Hash: {
+                if(cases_.empty() || strings_.size() != cases_.size()) {
+                    return false;
+                }
+                // At most half full, so misses end on an empty slot soon.
+                int bits = 1;
+                while((static_cast<std::size_t>(1) << bits) < cases_.size() * 2) {
+                    ++bits;
+                }
+                bool built = false;
+                for(int extra = 0; extra <= kMaxExtraHashBits && !built; ++extra) {
+                    for(int attempt = 0; attempt < kHashAttempts && !built; ++attempt) {
+                        built = BuildHash(bits + extra, Multiplier(attempt), true);
+                    }
+                }
+                // Rare enough to settle for probing past collisions.
+                if(!built) {
+                    BuildHash(bits + kMaxExtraHashBits, Multiplier(0), false);
+                }
+                break;
             }
-            long search_index = BinarySearchTable(key_index);
-            if(search_index != -1){
-                switch_table_[search_index].second = offset;
+            case SwitchType_Lookup:
+                entries_ = cases_;
+                std::sort(entries_.begin(), entries_.end(), KeyLess);
+                break;
+        }
+        type_ = type;
+        return true;
+    }
+    
+    bool SwitchInfo::BuildHash(int bits, uint64_t multiplier, bool perfect) {
+        Case empty = {0, -1};
+        entries_.assign(static_cast<std::size_t>(1) << bits, empty);
+        multiplier_ = multiplier;
+        shift_ = 64 - bits;
+        std::size_t mask = entries_.size() - 1;
+        for(std::size_t i = 0; i < cases_.size(); ++i) {
+            std::size_t slot = HashSlot(cases_[i].key_);
+            while(entries_[slot].offset_ >= 0) {
+                if(perfect) {
+                    return false;
+                }
+                slot = (slot + 1) & mask;
             }
+            entries_[slot] = cases_[i];
         }
+        return true;
     }
     
-    void SwitchInfo::Adjust() {
-        if(type_ != SwitchType_Table) {
-            std::sort(switch_table_.begin(), switch_table_.end(), SortTable);
+    long SwitchInfo::Lookup(uint64_t key) {
+        long low = 0;
+        long high = static_cast<long>(entries_.size()) - 1;
+        while(low <= high) {
+            long mid = (low + high) / 2;
+            if(entries_[mid].key_ < key) {
+                low = mid + 1;
+            }else if(entries_[mid].key_ > key) {
+                high = mid - 1;
+            }else{
+                return entries_[mid].offset_;
+            }
         }
+        return default_offset_;
     }
     
-    long SwitchInfo::Switch(Value* value) {
-        if(type_ == SwitchType_Table) {
-            if(value->type_ != Value_Number || min_ > max_) {
-                return -1;
+    long SwitchInfo::Hash(uint64_t key) {
+        std::size_t mask = entries_.size() - 1;
+        for(std::size_t slot = HashSlot(key);; slot = (slot + 1) & mask) {
+            const Case& entry = entries_[slot];
+            if(entry.key_ == key && entry.offset_ >= 0) {
+                return entry.offset_;
             }
-            long v = (long)value->number_;
-            long index = v - min_;
-            if(v < min_ || v > max_ || switch_table_[index].second < 0) {
+            if(entry.offset_ < 0) {
                 return default_offset_;
             }
-            return switch_table_[index].second;
-        }else if(type_ == SwitchType_Lookup){
-            long key_index = 0;
-            if(value->type_ == Value_Number) {
-                key_index = value->number_;
-            }else if(value->type_ == Value_String){
-                key_index = value->str_->hash();
-            }
-            long search_index = BinarySearchTable(key_index);
-            if(search_index != -1){
-                return switch_table_[search_index].second;
+        }
+    }
+    
+    long SwitchInfo::Switch(const Value* value) {
+        switch (type_) {
+            case SwitchType_Table: {
+                if(!value->IsNumber()) {
+                    return default_offset_;
+                }
+                double number = value->number();
+                if(number >= min_ && number < min_ + static_cast<double>(table_.size())) {
+                    long key = static_cast<long>(number);
+                    if(key == number && table_[key - min_] >= 0) {
+                        return table_[key - min_];
+                    }
+                }
+                return default_offset_;
             }
-            return default_offset_;
+            case SwitchType_Hash:
+                // A string always hashes as itself, anything else misses.
+                return Hash(value->bits());
+            default:
+                return Lookup(KeyOf(*value));
         }
-        return -1;
     }
 }
@@ -1,35 +1,40 @@
-
 #ifndef LYNX_LEPUS_SWITCH_H_
 #define LYNX_LEPUS_SWITCH_H_
 
+#include <stdint.h>
+
 #include <vector>
-#include "lepus/syntax_tree.h"
-#include "lepus/token.h"
-#include <algorithm>
 
 namespace lepus {
     enum SwitchType {
         SwitchType_Table,
         SwitchType_Lookup,
+        SwitchType_Hash,
     };
     
+    class String;
     class Value;
+
+    // Jump table of a switch statement. Case keys are constants, numbers,
+    // strings, booleans or nil, matched exactly like ===. Offsets are
+    // relative to the Switch instruction. Build() picks how to dispatch
+    // from the keys:
+    //   - Table: integer keys covering at least kMinTableDensity of their
+    //     range, one array load indexed by the key,
+    //   - Hash: string keys, looked up by interned pointer with a
+    //     multiplicative hash chosen to be collision free when possible,
+    //   - Lookup: binary search over the keys, everything else.
     class SwitchInfo {
     public:
-        static SwitchInfo* Create(base::ScopedVector<ASTree>& cases);
-        
-        SwitchInfo()
-            :key_type_(0),
-             min_(LONG_MAX),
-             max_(0),
-             default_offset_(-1),
-             switch_table_(){}
-        
-        void Modify(Token& key, long offset);
-        long BinarySearchTable(long key);
-        static bool SortTable(const std::pair<int, int> &v1, const std::pair<int, int> &v2 );
-        void Adjust();
-        long Switch(Value* value);
+        static const double kMinTableDensity;
+        
+        SwitchInfo();
+        ~SwitchInfo();
+        
+        // Cases are added in source order. A repeated key keeps the offset
+        // of its first case, which is the one that would match.
+        void AddCase(const Value& key, long offset);
+        
         long default_offset() {
             return default_offset_;
         }
@@ -37,13 +42,66 @@ namespace lepus {
         void set_default_offset(long offset) {
             default_offset_ = offset;
         }
+        
+        // Builds the dispatch once every case has been added.
+        void Build();
+        // Builds the dispatch of |type|, for comparing strategies. Returns
+        // false and leaves the switch unbuilt when the keys do not allow it.
+        bool Build(SwitchType type);
+        
+        SwitchType type() const {
+            return type_;
+        }
+        
+        long Switch(const Value* value);
+        
+        // The cases as added, without repeated keys.
+        std::size_t CaseSize() const {
+            return cases_.size();
+        }
+        Value GetCaseKey(std::size_t index) const;
+        long GetCaseOffset(std::size_t index) const {
+            return cases_[index].offset_;
+        }
+        
     private:
+        friend class BytecodeWriter;
+        friend class BytecodeReader;
+        
+        // A key is the raw word of its Value, see Value::bits().
+        struct Case {
+            uint64_t key_;
+            long offset_;
+        };
+        
+        static bool KeyLess(const Case& left, const Case& right) {
+            return left.key_ < right.key_;
+        }
+        
+        // The smallest and largest key, when every key is an integer.
+        bool IntegerRange(double* min, double* max);
+        long Lookup(uint64_t key);
+        long Hash(uint64_t key);
+        std::size_t HashSlot(uint64_t key) {
+            return static_cast<std::size_t>((key * multiplier_) >> shift_);
+        }
+        bool BuildHash(int bits, uint64_t multiplier, bool perfect);
+        
         SwitchType type_;
-        long key_type_;
-        long min_;
-        long max_;
         long default_offset_;
-        std::vector<std::pair<long, long> > switch_table_;
+        // In source order, the input of Build().
+        std::vector<Case> cases_;
+        // Pinned for the lifetime of the switch.
+        std::vector<String*> strings_;
+        
+        // Table: offset of key min_ + i, or -1.
+        long min_;
+        std::vector<long> table_;
+        // Lookup: cases sorted by key. Hash: slots, an empty one has
+        // offset -1 and ends a probe.
+        std::vector<Case> entries_;
+        uint64_t multiplier_;
+        int shift_;
     };
 }
 
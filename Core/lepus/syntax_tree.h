@@ -485,7 +485,7 @@ virtual void Accept(Visitor* visitor, void* data);
     class MemberAccessorAST : public ASTree {
     public:
         MemberAccessorAST(ASTree* table, const Token& member)
-        : table_(table), member_(member){
+        : table_(table), member_(member), lex_op_(LexicalOp_None){
             
         }
         
@@ -497,6 +497,10 @@ virtual void Accept(Visitor* visitor, void* data);
             return member_;
         }
         
+        LexicalOp& lex_op() {
+            return lex_op_;
+        }
+        
         virtual ASTType type() {
             return ASTType_MemberAccessor;
         }
@@ -505,6 +509,7 @@ virtual void Accept(Visitor* visitor, void* data);
     private:
         base::ScopedPtr<ASTree> table_;
         Token member_;
+        LexicalOp lex_op_;
     };
     
     class FunctionCallAST : public ASTree {
@@ -2,24 +2,184 @@
 #include "lepus/table.h"
 
 namespace lepus {
-    Dictonary::Dictonary() {}
-    
-    Dictonary::~Dictonary() {
-        HashMap::iterator iter = hash_map_.begin();
-        for(;iter != hash_map_.end(); ++iter) {
-            iter->first->Release();
+    namespace {
+        const std::size_t kMinNodes = 4;
+        const double kMaxArrayIndex = 2147483647.0;
+
+        bool ToArrayIndex(const Value& key, std::size_t* index) {
+            if(!key.IsNumber()) {
+                return false;
+            }
+            double number = key.number();
+            if(number < 0 || number > kMaxArrayIndex
+               || number != static_cast<double>(static_cast<long>(number))) {
+                return false;
+            }
+            *index = static_cast<std::size_t>(number);
+            return true;
+        }
+
+        std::size_t HashKey(const Value& key) {
+            uint64_t hash = key.IsString() ? key.str()->hash() : key.bits();
+            hash ^= hash >> 33;
+            hash *= 0xFF51AFD7ED558CCDULL;
+            hash ^= hash >> 33;
+            return static_cast<std::size_t>(hash);
         }
     }
-    
+
+    Dictonary::Dictonary() : array_(), nodes_(), used_nodes_(0) {}
+
     void Dictonary::SetValue(const String* key, const Value& value) {
-        const_cast<String*>(key)->AddRef();
-        hash_map_[const_cast<String*>(key)] = value;
+        Value k;
+        k.SetString(const_cast<String*>(key));
+        SetValue(k, value);
     }
-    
+
     Value Dictonary::GetValue(const String* key) {
-        HashMap::iterator iter = hash_map_.find(const_cast<String*>(key));
-        if(iter != hash_map_.end())
-            return iter->second;
-        return Value();
+        Value k;
+        k.SetString(const_cast<String*>(key));
+        return GetValue(k);
+    }
+
+    void Dictonary::SetValue(const Value& key, const Value& value) {
+        std::size_t cache = kNoSlot;
+        SetValueSlow(key, value, &cache);
+    }
+
+    Value Dictonary::GetValue(const Value& key) {
+        std::size_t cache = kNoSlot;
+        return GetValueSlow(key, &cache);
+    }
+
+    Value Dictonary::GetValueSlow(const Value& key, std::size_t* cache) {
+        Value k = key;
+        std::size_t index;
+        if(ToArrayIndex(key, &index)) {
+            if(index < array_.size()) {
+                return array_[index];
+            }
+            // -0 and 0 must find the same node.
+            k.SetNumber(static_cast<double>(index));
+        }
+        std::size_t slot = FindSlot(nodes_, k);
+        if(slot == kNoSlot) {
+            return Value();
+        }
+        *cache = slot;
+        return nodes_[slot].value_;
+    }
+
+    void Dictonary::SetValueSlow(const Value& key, const Value& value, std::size_t* cache) {
+        if(key.IsNil()) {
+            return;
+        }
+        Value k = key;
+        std::size_t index;
+        if(ToArrayIndex(key, &index)) {
+            if(index < array_.size()) {
+                array_[index] = value;
+                return;
+            }
+            k.SetNumber(static_cast<double>(index));
+            if(index == array_.size() && FindSlot(nodes_, k) == kNoSlot) {
+                // Keys that now continue the array part move over on the
+                // next rehash.
+                if(!value.IsNil()) {
+                    array_.push_back(value);
+                }
+                return;
+            }
+        }
+        std::size_t slot = FindSlot(nodes_, k);
+        if(slot == kNoSlot) {
+            if(value.IsNil()) {
+                return;
+            }
+            slot = InsertSlot(k);
+        }
+        nodes_[slot].value_ = value;
+        *cache = slot;
+    }
+
+    std::size_t Dictonary::FindSlot(const std::vector<Node>& nodes, const Value& key) {
+        if(nodes.empty()) {
+            return kNoSlot;
+        }
+        std::size_t mask = nodes.size() - 1;
+        for(std::size_t slot = HashKey(key) & mask;; slot = (slot + 1) & mask) {
+            if(nodes[slot].key_.bits() == key.bits()) {
+                return slot;
+            }
+            if(nodes[slot].key_.IsNil()) {
+                return kNoSlot;
+            }
+        }
+    }
+
+    std::size_t Dictonary::InsertSlot(const Value& key) {
+        // Keep at least a quarter of the nodes empty so probes stay short
+        // and always end.
+        if((used_nodes_ + 1) * 4 > nodes_.size() * 3) {
+            Rehash();
+        }
+        std::size_t mask = nodes_.size() - 1;
+        std::size_t slot = HashKey(key) & mask;
+        while(!nodes_[slot].key_.IsNil()) {
+            slot = (slot + 1) & mask;
+        }
+        nodes_[slot].key_ = key;
+        ++used_nodes_;
+        return slot;
+    }
+
+    void Dictonary::Rehash() {
+        std::vector<Node> old;
+        old.swap(nodes_);
+
+        // Integer keys that continue the array part move into it, the
+        // moved and the nil valued nodes are dropped.
+        for(;;) {
+            Value next(static_cast<double>(array_.size()));
+            std::size_t slot = FindSlot(old, next);
+            if(slot == kNoSlot || old[slot].value_.IsNil()) {
+                break;
+            }
+            array_.push_back(old[slot].value_);
+            old[slot].value_.SetNil();
+        }
+
+        std::size_t live = 0;
+        for(std::size_t i = 0; i < old.size(); ++i) {
+            if(!old[i].value_.IsNil()) {
+                ++live;
+            }
+        }
+        std::size_t size = kMinNodes;
+        while((live + 1) * 4 > size * 3) {
+            size *= 2;
+        }
+        nodes_.resize(size);
+        used_nodes_ = 0;
+        for(std::size_t i = 0; i < old.size(); ++i) {
+            if(!old[i].value_.IsNil()) {
+                std::size_t slot = InsertSlot(old[i].key_);
+                nodes_[slot].value_ = old[i].value_;
+            }
+        }
+    }
+
+    void Dictonary::Trace(GC* gc) {
+        for(std::size_t i = 0; i < array_.size(); ++i) {
+            gc->Mark(array_[i]);
+        }
+        for(std::size_t i = 0; i < nodes_.size(); ++i) {
+            gc->Mark(nodes_[i].key_);
+            gc->Mark(nodes_[i].value_);
+        }
+    }
+
+    std::size_t Dictonary::GCSize() {
+        return sizeof(Dictonary) + array_.capacity() * sizeof(Value) + nodes_.size() * sizeof(Node);
     }
 }
@@ -1,20 +1,86 @@
 #ifndef LYNX_LEPUS_TABLE_H_
 #define LYNX_LEPUS_TABLE_H_
 
-#include <unordered_map>
+#include <vector>
 #include "lepus/value.h"
 #include "lepus/lepus_string.h"
-#include "base/scoped_ptr.h"
+#include "lepus/gc.h"
 namespace lepus {
-    class Dictonary {
+    // Lua style table. Integer keys from 0 up to the first missing one live
+    // in a contiguous array part, every other key lives in an open addressing
+    // hash part probed linearly. Strings are interned, so every key compares
+    // by its raw bits. A key is never in both parts.
+    // Keys and values are traced. Call GC::Barrier with the key and the value
+    // after storing into a table the collector may already have scanned.
+    class Dictonary : public GCObject {
     public:
         Dictonary();
-        ~Dictonary();
         void SetValue(const String* key, const Value& value);
         Value GetValue(const String* key);
+        void SetValue(const Value& key, const Value& value);
+        Value GetValue(const Value& key);
+
+        // Variants for GetTable and SetTable. |cache| is the inline cache of
+        // the instruction: the hash slot the key was last found in, kNoSlot
+        // at first. While the slot still holds the key the access is a single
+        // load, otherwise the table is searched and the cache refreshed.
+        Value GetValue(const Value& key, std::size_t* cache) {
+            std::size_t slot = *cache;
+            if(slot < nodes_.size() && nodes_[slot].key_.bits() == key.bits()) {
+                return nodes_[slot].value_;
+            }
+            return GetValueSlow(key, cache);
+        }
+
+        void SetValue(const Value& key, const Value& value, std::size_t* cache) {
+            std::size_t slot = *cache;
+            if(slot < nodes_.size() && nodes_[slot].key_.bits() == key.bits()
+               && !key.IsNil()) {
+                nodes_[slot].value_ = value;
+                return;
+            }
+            SetValueSlow(key, value, cache);
+        }
+
+        std::size_t array_size() const {
+            return array_.size();
+        }
+
+        // Calls |visitor(key, value)| for every entry, in no particular
+        // order. |visitor| must not modify the table.
+        template<typename Visitor>
+        void ForEach(Visitor visitor) const {
+            for(std::size_t i = 0; i < array_.size(); ++i) {
+                visitor(Value(static_cast<double>(i)), array_[i]);
+            }
+            for(std::size_t i = 0; i < nodes_.size(); ++i) {
+                if(!nodes_[i].key_.IsNil()) {
+                    visitor(nodes_[i].key_, nodes_[i].value_);
+                }
+            }
+        }
+
+        static const std::size_t kNoSlot = static_cast<std::size_t>(-1);
+    protected:
+        virtual void Trace(GC* gc);
+        virtual std::size_t GCSize();
     private:
-        typedef std::unordered_map<String*, Value> HashMap;
-        HashMap hash_map_;
+        // An empty node has a nil key. Assigning nil to a key keeps its node
+        // until the next rehash so cached slots stay valid.
+        struct Node {
+            Value key_;
+            Value value_;
+        };
+
+        Value GetValueSlow(const Value& key, std::size_t* cache);
+        void SetValueSlow(const Value& key, const Value& value, std::size_t* cache);
+        static std::size_t FindSlot(const std::vector<Node>& nodes, const Value& key);
+        std::size_t InsertSlot(const Value& key);
+        void Rehash();
+
+        std::vector<Value> array_;
+        std::vector<Node> nodes_;
+        std::size_t used_nodes_;
     };
 }
 
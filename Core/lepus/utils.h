@@ -9,6 +9,10 @@
 #ifndef LYNX_LEPUS_UTILS_H_
 #define LYNX_LEPUS_UTILS_H_
 
+#include <string.h>
+#include <cstddef>
+#include <string>
+
 #include "lepus/token.h"
 
 namespace lepus {
@@ -37,33 +41,46 @@ namespace lepus {
         || c == ';' || c == ':' || c == ',' || c == '.'||c == '?';
     }
     
-    const static std::map<std::string, int> kKeyWords = {
-        {"break", Token_Break},
-        {"do", Token_Do},
-        {"if", Token_If},
-        {"else", Token_Else},
-        {"elseif", Token_Elseif},
-        {"false", Token_False},
-        {"true", Token_True},
-        {"function", Token_Function},
-        {"for", Token_For},
-        {"var", Token_Var},
-        {"null", Token_Nil},
-        {"while", Token_While},
-        {"switch", Token_Switch},
-        {"case", Token_Case},
-        {"default", Token_Defalut},
-        {"return", Token_Return}
+    struct KeyWord {
+        const char* word_;
+        std::size_t length_;
+        int token_;
     };
-    static inline bool IsKeyWord(const std::string& word, int& token) {
-        auto iter = kKeyWords.find(word);
-        if(iter != kKeyWords.end()) {
-            token = iter->second;
-            return true;
+    
+    // Scanned identifiers are slices of the source, so key words are
+    // matched by length and bytes without building a string.
+    const static KeyWord kKeyWords[] = {
+        {"break", 5, Token_Break},
+        {"do", 2, Token_Do},
+        {"if", 2, Token_If},
+        {"else", 4, Token_Else},
+        {"elseif", 6, Token_Elseif},
+        {"false", 5, Token_False},
+        {"true", 4, Token_True},
+        {"function", 8, Token_Function},
+        {"for", 3, Token_For},
+        {"var", 3, Token_Var},
+        {"null", 4, Token_Nil},
+        {"while", 5, Token_While},
+        {"switch", 6, Token_Switch},
+        {"case", 4, Token_Case},
+        {"default", 7, Token_Defalut},
+        {"return", 6, Token_Return}
+    };
+    static inline bool IsKeyWord(const char* word, std::size_t length, int& token) {
+        for(const KeyWord& key_word : kKeyWords) {
+            if(key_word.length_ == length && memcmp(key_word.word_, word, length) == 0) {
+                token = key_word.token_;
+                return true;
+            }
         }
         return false;
     }
     
+    static inline bool IsKeyWord(const std::string& word, int& token) {
+        return IsKeyWord(word.data(), word.size(), token);
+    }
+    
     static inline bool IsPrimaryExpr(int token) {
         return
         token == Token_Nil ||
@@ -1,6 +1,10 @@
 #ifndef LYNX_LEPUS_VALUE_H_
 #define LYNX_LEPUS_VALUE_H_
 
+#include <stdint.h>
+#include <string.h>
+#include <cmath>
+
 #include "lepus/lepus_string.h"
 #include "lepus/function.h"
 
@@ -14,205 +18,229 @@ namespace lepus {
         Value_Closure,
         Value_CFunction,
     };
-    
+
+    // A Value is a NaN-boxed 64 bit word. Numbers are stored as plain
+    // doubles, every NaN is canonicalized to kCanonicalNaN on the way in.
+    // Other types live in the negative quiet NaN space that canonical NaNs
+    // never use: the top 13 bits are set, bits 48..50 hold the type tag
+    // (ValueType + 1, never 0) and the low 48 bits hold the payload, which
+    // is a bool or a pointer. Pointers must therefore fit in 48 bits, which
+    // holds for user space addresses on the supported 32 and 64 bit targets.
+    // Strings, closures and tables are owned by the context's GC, so a
+    // Value is a plain word and copying it never touches a counter.
     class Value {
     public:
-        union {
-            double number_;
-            bool boolean_;
-            String* str_;
-            Closure* closure_;
-            void* native_function_;
-            void* table_;
-        };
-        ValueType type_;
-        
-        Value():number_(0), type_(Value_Nil){}
-        Value(double number):number_(number), type_(Value_Number){}
-        Value(const Value& value) {
-            Copy(value);
-        }
-        
-        ~Value(){
-            SetNil();
-        }
-        
+        Value():bits_(kNilBits){}
+        Value(double number):bits_(Box(number)){}
+
+        ValueType type() const {
+            return IsNumber() ? Value_Number
+                : static_cast<ValueType>(((bits_ >> kTagShift) & kTagMask) - 1);
+        }
+
+        bool IsNil() const { return bits_ == kNilBits; }
+        bool IsNumber() const { return bits_ < kBoxedBits; }
+        bool IsBoolean() const { return HasTag(Value_Boolean); }
+        bool IsString() const { return HasTag(Value_String); }
+        bool IsTable() const { return HasTag(Value_Table); }
+        bool IsClosure() const { return HasTag(Value_Closure); }
+        bool IsCFunction() const { return HasTag(Value_CFunction); }
+
+        double number() const {
+            double number;
+            memcpy(&number, &bits_, sizeof(number));
+            return number;
+        }
+
+        bool boolean() const {
+            return (bits_ & kPayloadMask) != 0;
+        }
+
+        String* str() const {
+            return static_cast<String*>(Pointer());
+        }
+
+        Closure* closure() const {
+            return static_cast<Closure*>(Pointer());
+        }
+
+        void* table() const {
+            return Pointer();
+        }
+
+        void* native_function() const {
+            return Pointer();
+        }
+
+        // The raw word, equal for identical values. Tables hash and compare
+        // keys by it.
+        uint64_t bits() const {
+            return bits_;
+        }
+
+        // The value whose raw word is |bits|, which must come from bits().
+        static Value FromBits(uint64_t bits) {
+            Value value;
+            value.bits_ = bits;
+            return value;
+        }
+
         bool IsFalse() const
-        { return type_ == Value_Nil
-            || (type_ == Value_Boolean && !boolean_)
-            || (type_ == Value_Number && number_ == 0)
-            || (type_ == Value_String && strcmp(str_->c_str(),"") == 0); }
+        { return bits_ == kNilBits
+            || (IsBoolean() && !boolean())
+            || (IsNumber() && number() == 0)
+            || (IsString() && str()->c_str()[0] == '\0'); }
 
         void SetNil() {
-            if(this->type_ == Value_String ) {
-                str_->Release();
-            }else if(this->type_ == Value_Closure) {
-                closure_->Release();
-            }
-            number_ = 0;
-            type_ = Value_Nil;
+            bits_ = kNilBits;
         }
-        
-        Value& operator= (const Value& value) {
-            if(*this == value) {
-                return *this;
-            }
-            if(this->type_ == Value_String) {
-                str_->Release();
-            }else if(this->type_ == Value_Closure){
-                closure_->Release();
-            }
-            
-            Copy(value);
-            
-            return *this;
+
+        void SetNumber(double number) {
+            bits_ = Box(number);
+        }
+
+        void SetBoolean(bool boolean) {
+            bits_ = Tag(Value_Boolean) | (boolean ? 1 : 0);
+        }
+
+        void SetString(String* str) {
+            bits_ = Tag(Value_String) | ToBits(str);
+        }
+
+        void SetClosure(Closure* closure) {
+            bits_ = Tag(Value_Closure) | ToBits(closure);
+        }
+
+        void SetTable(void* table) {
+            bits_ = Tag(Value_Table) | ToBits(table);
         }
-    
+
+        void SetCFunction(void* native_function) {
+            bits_ = Tag(Value_CFunction) | ToBits(native_function);
+        }
+
         friend bool operator == (const Value& left, const Value& right) {
-            if(left.type_ != right.type_) return false;
-            switch (left.type_) {
-                case Value_Nil:
-                    return true;
-                case Value_Number:
-                    return fabs(left.number_ - right.number_) < 0.000001 ;
-                case Value_Boolean:
-                    return left.boolean_ == right.boolean_;
-                case Value_String:
-                    return left.str_ == right.str_;
-                case Value_Closure:
-                    return left.closure_ == right.closure_;
-                case Value_CFunction:
-                    return left.native_function_ == right.native_function_;
-                default:
-                    break;
+            if(left.IsNumber() && right.IsNumber()) {
+                return fabs(left.number() - right.number()) < 0.000001;
             }
-            return false;
+            // Every other type compares by payload identity.
+            return left.bits_ == right.bits_;
         }
-        
+
         friend bool operator != (const Value& left, const Value& right) {
             return !(left == right);
         }
-        
+
         friend Value operator + (const Value& left, const Value& right) {
-            Value value;
-            if(left.type_ == Value_Number && right.type_ == Value_Number) {
-                value.type_ = Value_Number;
-                value.number_ = left.number_ + right.number_;
+            if(left.IsNumber() && right.IsNumber()) {
+                return Value(left.number() + right.number());
             }
-            return value;
+            return Value();
         }
-        
+
         friend Value operator - (const Value& left, const Value& right) {
-            Value value;
-            if(left.type_ == Value_Number && right.type_ == Value_Number) {
-                value.type_ = Value_Number;
-                value.number_ = left.number_ - right.number_;
+            if(left.IsNumber() && right.IsNumber()) {
+                return Value(left.number() - right.number());
             }
-            return value;
+            return Value();
         }
-        
+
         friend Value operator * (const Value& left, const Value& right) {
-            Value value;
-            if(left.type_ == Value_Number && right.type_ == Value_Number) {
-                value.type_ = Value_Number;
-                value.number_ = left.number_ * right.number_;
+            if(left.IsNumber() && right.IsNumber()) {
+                return Value(left.number() * right.number());
             }
-            return value;
+            return Value();
         }
-        
+
         friend Value operator / (const Value& left, const Value& right) {
-            Value value;
-            if(left.type_ == Value_Number && right.type_ == Value_Number) {
-                value.type_ = Value_Number;
-                value.number_ = left.number_ / right.number_;
+            if(left.IsNumber() && right.IsNumber()) {
+                return Value(left.number() / right.number());
             }
-            return value;
+            return Value();
         }
-        
+
         friend Value operator %(const Value& left, const Value& right) {
-            Value value;
-            if(left.type_ == Value_Number && right.type_ == Value_Number) {
-                value.type_ = Value_Number;
-                value.number_ = ((int)left.number_) % ((int)right.number_);
+            if(left.IsNumber() && right.IsNumber()) {
+                return Value(((int)left.number()) % ((int)right.number()));
             }
-            return value;
+            return Value();
         }
-        
+
         Value& operator += (const Value& value) {
-            if(type_ == Value_Number && value.type_ == Value_Number) {
-                number_ += value.number_;
+            if(IsNumber() && value.IsNumber()) {
+                bits_ = Box(number() + value.number());
             }
             return *this;
         }
-        
+
         Value& operator -= (const Value& value) {
-            if(type_ == Value_Number && value.type_ == Value_Number) {
-                number_ -= value.number_;
+            if(IsNumber() && value.IsNumber()) {
+                bits_ = Box(number() - value.number());
             }
             return *this;
         }
-        
+
         Value& operator *= (const Value& value) {
-            if(type_ == Value_Number && value.type_ == Value_Number) {
-                number_ *= value.number_;
+            if(IsNumber() && value.IsNumber()) {
+                bits_ = Box(number() * value.number());
             }
             return *this;
         }
-        
+
         Value& operator /= (const Value& value) {
-            if(type_ == Value_Number && value.type_ == Value_Number) {
-                number_ /= value.number_;
+            if(IsNumber() && value.IsNumber()) {
+                bits_ = Box(number() / value.number());
             }
             return *this;
         }
-        
+
         Value& operator %= (const Value& value) {
-            if(type_ == Value_Number && value.type_ == Value_Number) {
-                number_ = ((int)number_) % ((int)value.number_);
+            if(IsNumber() && value.IsNumber()) {
+                bits_ = Box(((int)number()) % ((int)value.number()));
             }
             return *this;
         }
-        
+
     private:
-        inline void Copy(const Value& value) {
-            switch (value.type_) {
-                case Value_Nil:
-                    this->str_ = nullptr;
-                    this->type_ = Value_Nil;
-                    break;
-                case Value_Number:
-                    this->number_ = value.number_;
-                    this->type_ = Value_Number;
-                    break;
-                case Value_Boolean:
-                    this->boolean_ = value.boolean_;
-                    this->type_ = Value_Boolean;
-                    break;
-                case Value_String:
-                    this->str_ = value.str_;
-                    this->str_->AddRef();
-                    this->type_ = Value_String;
-                    break;
-                case Value_Closure:
-                    this->closure_ = value.closure_;
-                    this->closure_->AddRef();
-                    this->type_ = Value_Closure;
-                    break;
-                case Value_CFunction:
-                    this->native_function_ = value.native_function_;
-                    this->type_ = Value_CFunction;
-                    break;
-                case Value_Table:
-                    this->table_ = value.table_;
-                    this->type_ = Value_Table;
-                    break;
-                default:
-                    this->str_ = nullptr;
-                    this->type_ = Value_Nil;
-                    break;
+        // Emits the tag checks inline.
+        friend class JitCompiler;
+
+        static const uint64_t kCanonicalNaN = 0x7FF8000000000000ULL;
+        static const uint64_t kBoxedBits = 0xFFF9000000000000ULL;
+        static const uint64_t kPayloadMask = 0x0000FFFFFFFFFFFFULL;
+        static const int kTagShift = 48;
+        static const uint64_t kTagMask = 0x7;
+        static const uint64_t kNilBits = 0xFFF8000000000000ULL | (1ULL << kTagShift);
+
+        static uint64_t Tag(ValueType type) {
+            return 0xFFF8000000000000ULL | (static_cast<uint64_t>(type + 1) << kTagShift);
+        }
+
+        static uint64_t Box(double number) {
+            if(number != number) {
+                return kCanonicalNaN;
             }
+            uint64_t bits;
+            memcpy(&bits, &number, sizeof(bits));
+            return bits;
+        }
+
+        static uint64_t ToBits(void* pointer) {
+            return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer)) & kPayloadMask;
+        }
+
+        bool HasTag(ValueType type) const {
+            return (bits_ & ~kPayloadMask) == Tag(type);
         }
+
+        void* Pointer() const {
+            return reinterpret_cast<void*>(static_cast<uintptr_t>(bits_ & kPayloadMask));
+        }
+
+        uint64_t bits_;
     };
+
+    static_assert(sizeof(Value) == 8, "lepus::Value must stay one word");
 }
 
 #endif // LYNX_LEPUS_VALUE_H_
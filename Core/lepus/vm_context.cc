@@ -1,6 +1,8 @@
 
 #include "lepus/vm_context.h"
-#include "parser/input_stream.h"
+
+#include <algorithm>
+
 #include "lepus/scanner.h"
 #include "lepus/parser.h"
 #include "lepus/exception.h"
@@ -10,26 +12,102 @@
 #include "lepus/builtin.h"
 #include "lepus/table.h"
 #include "lepus/string_util.h"
+#include "lepus/bytecode.h"
+#include "lepus/optimizer.h"
+#include "lepus/disassembler.h"
+#include "lepus/program.h"
 
 namespace lepus {
 
 #define GET_CONST_VALUE(i) \
-        (function->GetConstValue(Instruction::GetParamBx(i)))
+        (function->GetConstValue((i)->bx_))
 #define GET_Global_VALUE(i) \
-        (global()->Get(Instruction::GetParamBx(i)))
+        (global()->Get((i)->bx_))
 #define GET_REGISTER_A(i)  \
-        (frame->register_ + Instruction::GetParamA(i))
+        (frame->register_ + (i)->a_)
 #define GET_REGISTER_B(i)  \
-        (frame->register_ + Instruction::GetParamB(i))
+        (frame->register_ + (i)->b_)
 #define GET_REGISTER_C(i)  \
-        (frame->register_ + Instruction::GetParamC(i))
+        (frame->register_ + (i)->c_)
 
-#define GET_UPVALUE_B(i)  (closure->GetUpvalue(Instruction::GetParamB(i)))
+#define GET_UPVALUE_B(i)  (heap_.base() + closure->GetUpvalue((i)->b_))
     
 #define GET_REGISTER_ABC(i)                                 \
     a = GET_REGISTER_A(i);                                  \
     b = GET_REGISTER_B(i);                                  \
     c = GET_REGISTER_C(i);
+
+// Allocating ops let the collector advance once the new object is stored,
+// every live value is in a register or global at that point.
+#define GC_SAFEPOINT()                                      \
+    if(gc_.ShouldStep()) {                                  \
+        gc_.Step();                                         \
+    }
+
+// Compiled out of the interpreter unless profiling.
+#define PROFILE_OP(i)                                       \
+    if(kProfiled) {                                         \
+        profiler->CountOp((i)->op_);                        \
+    }
+
+// Each op code body is reachable both as a switch case and, where supported,
+// as a label whose address lives in the dispatch table. The threaded loop
+// jumps from handler to handler and never returns to the switch.
+#if LEPUS_COMPUTED_GOTO
+#define OPCODE(name) L_##name: case TypeOp_##name
+#define DISPATCH()                                          \
+    if(kThreaded) {                                         \
+        i = pc++;                                           \
+        PROFILE_OP(i);                                      \
+        goto *kDispatchTable[i->op_];                       \
+    }                                                       \
+    break
+#else
+#define OPCODE(name) case TypeOp_##name
+#define DISPATCH() break
+#endif
+    
+    VMContext::VMContext()
+        : heap_(),
+          frames_(),
+          threaded_dispatch_(LEPUS_COMPUTED_GOTO),
+          optimize_bytecode_(true),
+          jit_enabled_(false),
+          bytecode_dump_(nullptr),
+          max_upvalue_slot_(0),
+          nil_param_(),
+          profiler_(),
+          table_caches_(),
+          program_(),
+          top_level_variables_(),
+          root_function_() {
+    }
+    
+    VMContext::VMContext(Program* program)
+        : heap_(),
+          frames_(),
+          threaded_dispatch_(LEPUS_COMPUTED_GOTO),
+          optimize_bytecode_(true),
+          jit_enabled_(false),
+          bytecode_dump_(nullptr),
+          max_upvalue_slot_(0),
+          nil_param_(),
+          profiler_(),
+          table_caches_(),
+          program_(program),
+          top_level_variables_(),
+          root_function_() {
+        VMContext* shared = program->context();
+        string_pool_.set_shared(shared->string_pool());
+        // Compiled code addresses globals by index, keep the order.
+        std::vector<String*> names;
+        shared->global()->GetNames(names);
+        for(std::size_t i = 0; i < names.size(); ++i) {
+            global_.Add(names[i], *shared->global()->Get(i));
+        }
+        top_level_variables_ = shared->top_level_variables_;
+        table_caches_.assign(shared->table_caches_.size(), static_cast<std::size_t>(-1));
+    }
     
     VMContext::~VMContext() {
         std::unordered_map<String*, long>::iterator iter;
@@ -39,14 +117,17 @@ namespace lepus {
     }
     
     void VMContext::Initialize() {
-        RegisterBuiltin(this);
+        // An attached context already has the program's builtins.
+        if(program_.Get() == nullptr) {
+            RegisterBuiltin(this);
+        }
     }
     
-    void VMContext::Execute(const std::string& source) {
+    bool VMContext::Parse(const char* source, std::size_t length) {
         try {
-            parser::InputStream input;
-            input.Write(source);
-            Scanner scanner(&input, &string_pool_);
+            // The code generator pushes the root closure onto the stack.
+            CheckStack(heap_.top_, 1);
+            Scanner scanner(source, length, &string_pool_);
             Parser parser(&scanner);
             SemanticAnalysis semantic_analysis;
             CodeGenerator code_generator(this);
@@ -56,24 +137,133 @@ namespace lepus {
             root->Accept(&code_generator, &top_level_variables_);
         }catch(const lepus::Exception& exception) {
             std::cout<<exception.message()<<std::endl;
+            return false;
+        }
+        OptimizeBytecode();
+        PrepareFunctions();
+        return true;
+    }
+    
+    bool VMContext::ReadBytecode(const char* data, std::size_t size) {
+        try {
+            BytecodeReader reader(this, data, size);
+            root_function_.Reset(reader.Read(top_level_variables_));
+        }catch(const lepus::Exception& exception) {
+            std::cout<<exception.message()<<std::endl;
+            return false;
+        }
+        PrepareFunctions();
+        return true;
+    }
+    
+    void VMContext::PrepareFunctions() {
+        table_caches_.assign(root_function_->Prepare(0), static_cast<std::size_t>(-1));
+    }
+    
+    Function* VMContext::root_function() {
+        if(root_function_.Get() == nullptr && program_.Get() != nullptr) {
+            return program_->context()->root_function_.Get();
+        }
+        return root_function_.Get();
+    }
+    
+    void VMContext::OptimizeBytecode() {
+        Function* root = root_function_.Get();
+        std::size_t before = CountInstructions(root);
+        if(bytecode_dump_ != nullptr) {
+            *bytecode_dump_ << "-- bytecode" << (optimize_bytecode_ ? " before optimization" : "") << std::endl;
+            Disassemble(root, *bytecode_dump_);
+        }
+        if(!optimize_bytecode_) {
+            return;
+        }
+        // Top level variables stay readable from the host after the root
+        // function returns.
+        Optimizer::RegisterSet exit_live;
+        std::unordered_map<String*, long>::iterator iter;
+        for(iter = top_level_variables_.begin(); iter != top_level_variables_.end(); ++iter) {
+            if(iter->second >= 0 && iter->second < static_cast<long>(exit_live.size())) {
+                exit_live.set(iter->second);
+            }
+        }
+        Optimizer optimizer;
+        optimizer.Optimize(root, exit_live);
+        if(bytecode_dump_ != nullptr) {
+            *bytecode_dump_ << "-- bytecode after optimization" << std::endl;
+            Disassemble(root, *bytecode_dump_);
+            *bytecode_dump_ << "-- instructions: " << before << " -> "
+                            << CountInstructions(root) << std::endl;
         }
+    }
+    
+    void VMContext::Execute(const std::string& source) {
+        Execute(source.data(), source.size());
+    }
+    
+    void VMContext::Execute(const char* source, std::size_t length) {
+        if(!Parse(source, length))
+            return;
         CallFunction(heap().top_ - 1, 0, nullptr);
         Run();
     }
     
+    bool VMContext::Compile(const std::string& source, std::string& bytecode) {
+        if(!Parse(source.data(), source.size()))
+            return false;
+        BytecodeWriter writer(this);
+        writer.Write(root_function_.Get(), top_level_variables_, bytecode);
+        return true;
+    }
+    
+    void VMContext::ExecuteBytecode(const char* data, std::size_t size) {
+        if(!ReadBytecode(data, size))
+            return;
+        RunRoot(lynx_new Closure(root_function_.Get()));
+    }
+    
+    void VMContext::ExecuteProgram() {
+        Function* root = root_function();
+        if(root == nullptr)
+            return;
+        RunRoot(lynx_new Closure(root));
+    }
+    
+    void VMContext::RunRoot(Closure* closure) {
+        gc_.Track(closure);
+        Value* top = CheckStack(heap_.top_, 1);
+        heap_.top_ = top + 1;
+        top->SetClosure(closure);
+        CallFunction(top, 0, nullptr);
+        Run();
+    }
+    
     Value VMContext::Call(const std::string& name, const std::vector<Value>& args) {
+        // A name that was never interned can not be a top level variable.
+        String* str = string_pool()->Find(name.data(), name.size());
+        if(str == nullptr)
+            return Value();
+        return Call(str, args.empty() ? nullptr : &args[0], args.size());
+    }
+    
+    Value VMContext::Call(String* name, const Value* args, std::size_t argc) {
         Value ret;
-        base::ScopedRefPtr<String> scoped_str(string_pool()->NewString(name));
-        auto reg_info = top_level_variables_.find(scoped_str.Get());
+        auto reg_info = top_level_variables_.find(name);
         if(reg_info == top_level_variables_.end())
             return Value();
         long reg = reg_info->second;
-        Value* function = heap_.top_;
+        Value* function = nullptr;
+        try {
+            function = CheckStack(heap_.top_, argc + 1);
+        } catch (const lepus::Exception& exception) {
+            std::cout<<exception.message()<<std::endl;
+            return ret;
+        }
+        heap_.top_ = function;
         *(heap_.top_++) = *(heap_.base() + reg + 1);
-        for(std::size_t i = 0; i < args.size(); ++i) {
+        for(std::size_t i = 0; i < argc; ++i) {
             *(heap_.top_++) = args[i];
         }
-        CallFunction(function, args.size(), &ret);
+        CallFunction(function, argc, &ret);
         Run();
         return ret;
     }
@@ -84,11 +274,22 @@ namespace lepus {
     }
     
     Value* VMContext::GetParam(long index) {
+        if(index < 0 || index >= GetParamsSize()) {
+            nil_param_.SetNil();
+            return &nil_param_;
+        }
         return frames_.back().register_ + index;
     }
 
     bool VMContext::UpdateTopLevelVariable(const std::string &name, Value value) {
-        auto reg_info = top_level_variables_.find(string_pool()->NewString(name));
+        String* str = string_pool()->Find(name.data(), name.size());
+        if(str == nullptr)
+            return false;
+        return UpdateTopLevelVariable(str, value);
+    }
+    
+    bool VMContext::UpdateTopLevelVariable(String* name, Value value) {
+        auto reg_info = top_level_variables_.find(name);
         if(reg_info == top_level_variables_.end())
             return false;
         long reg = reg_info->second;
@@ -96,26 +297,215 @@ namespace lepus {
         return true;
     }
     
+    String* VMContext::FindTopLevelVariable(const std::string& name) {
+        String* str = string_pool()->Find(name.data(), name.size());
+        if(str == nullptr || top_level_variables_.find(str) == top_level_variables_.end())
+            return nullptr;
+        return str;
+    }
+    
+    void VMContext::set_profiling(bool profiling) {
+        profiler_.Reset(profiling ? lynx_new Profiler : nullptr);
+    }
+    
+    namespace {
+        // Appends the child indexes leading from |function| to |target|.
+        bool FunctionPath(Function* function, Function* target, std::string& path) {
+            if(function == target) {
+                return true;
+            }
+            for(std::size_t i = 0; i < function->ChildFunctionsSize(); ++i) {
+                if(FunctionPath(function->GetChildFunction(i), target, path)) {
+                    path.insert(0, "." + to_string(i));
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+    
+    std::string VMContext::FunctionName(Function* function) {
+        Function* root = root_function();
+        if(root == nullptr) {
+            return "function";
+        }
+        if(function == root) {
+            return "main";
+        }
+        // A top level function is the child whose closure the root function
+        // stores into the variable's register. Registers are reused, so
+        // their contents at call time would be ambiguous.
+        for(std::size_t pc = 0; pc < root->OpCodeSize(); ++pc) {
+            Instruction i = *root->GetInstruction(pc);
+            if(Instruction::GetOpCode(i) != TypeOp_Closure
+               || root->GetChildFunction(Instruction::GetParamBx(i)) != function) {
+                continue;
+            }
+            std::unordered_map<String*, long>::iterator iter;
+            for(iter = top_level_variables_.begin(); iter != top_level_variables_.end(); ++iter) {
+                if(iter->second == Instruction::GetParamA(i)) {
+                    return iter->first->c_str();
+                }
+            }
+        }
+        std::string path;
+        if(FunctionPath(root, function, path)) {
+            return "function 0" + path;
+        }
+        return "function";
+    }
+    
+    std::string VMContext::CFunctionName(void* cfunction) {
+        std::vector<String*> names;
+        global()->GetNames(names);
+        for(std::size_t i = 0; i < names.size(); ++i) {
+            Value* value = global()->Get(i);
+            if(names[i] == nullptr) {
+                continue;
+            }
+            if(value->IsCFunction() && value->native_function() == cfunction) {
+                return names[i]->c_str();
+            }
+            if(value->IsTable()) {
+                std::string name;
+                static_cast<Dictonary*>(value->table())->ForEach(
+                    [&](const Value& key, const Value& entry) {
+                        if(name.empty() && key.IsString() && entry.IsCFunction()
+                           && entry.native_function() == cfunction) {
+                            name = std::string(names[i]->c_str()) + "." + key.str()->c_str();
+                        }
+                    });
+                if(!name.empty()) {
+                    return name;
+                }
+            }
+        }
+        return "native function";
+    }
+    
+    void VMContext::set_max_stack_size(std::size_t size) {
+        heap_.set_max_size(size);
+    }
+    
+    std::size_t VMContext::stack_size() {
+        return heap_.size();
+    }
+    
+    Value* VMContext::CheckStack(Value* from, std::size_t slots) {
+        if(from + slots <= heap_.limit()) {
+            return from;
+        }
+        std::size_t needed = from + slots - heap_.base();
+        if(needed > heap_.max_size()) {
+            throw RuntimeException("lepus stack overflow");
+        }
+        std::size_t offset = from - heap_.base();
+        ResizeStack(std::max(needed, heap_.size() * 2));
+        return heap_.base() + offset;
+    }
+    
+    std::size_t VMContext::LiveStackSize() {
+        std::size_t used = heap_.top_ - heap_.base();
+        Function* root = root_function();
+        if(root != nullptr) {
+            used = std::max(used, root->frame_size() + 1);
+        }
+        used = std::max(used, max_upvalue_slot_ + 1);
+        std::list<Frame>::iterator iter = frames_.begin();
+        for(; iter != frames_.end(); ++iter) {
+            if(iter->function_->IsClosure()) {
+                std::size_t end = iter->register_ - heap_.base()
+                    + iter->function_->closure()->function()->frame_size();
+                used = std::max(used, end);
+            }
+        }
+        return std::min(used, heap_.size());
+    }
+    
+    void VMContext::ShrinkStack() {
+        std::size_t used = LiveStackSize();
+        if(heap_.size() > Heap::kBaseHeapSize && heap_.size() > used * 4) {
+            ResizeStack(used * 2);
+        }
+    }
+    
+    void VMContext::MarkRoots(GC* gc) {
+        Context::MarkRoots(gc);
+        Value* base = heap_.base();
+        std::size_t live = LiveStackSize();
+        for(std::size_t i = 0; i < live; ++i) {
+            gc->Mark(base[i]);
+        }
+        // Slots above the live part are dead registers of returned frames,
+        // clear them rather than leave references to objects about to be
+        // freed.
+        for(std::size_t i = live; i < heap_.size(); ++i) {
+            base[i].SetNil();
+        }
+    }
+    
+    void VMContext::ResizeStack(std::size_t size) {
+        Value* old_base = heap_.base();
+        Value* old_limit = heap_.limit();
+        heap_.Resize(size);
+        std::list<Frame>::iterator iter = frames_.begin();
+        for(; iter != frames_.end(); ++iter) {
+            iter->register_ = Relocate(iter->register_, old_base, old_limit);
+            iter->function_ = Relocate(iter->function_, old_base, old_limit);
+            iter->return_ = Relocate(iter->return_, old_base, old_limit);
+        }
+    }
+    
+    Value* VMContext::Relocate(Value* value, Value* old_base, Value* old_limit) {
+        if(value >= old_base && value < old_limit) {
+            return heap_.base() + (value - old_base);
+        }
+        return value;
+    }
+    
     bool VMContext::CallFunction(Value* function, size_t argc, Value* ret) {
-        if(function->type_ == Value_Closure) {
+        if(function->IsClosure()) {
+            Function* callee = function->closure()->function();
+            const DecodedInstruction* instructions = callee->GetDecodedOpCodes();
+            if(function + callee->frame_size() + 1 > heap_.limit()) {
+                Value* old_base = heap_.base();
+                Value* old_limit = heap_.limit();
+                function = CheckStack(function, callee->frame_size() + 1);
+                ret = Relocate(ret, old_base, old_limit);
+            }
             heap_.top_ = function + 1;
             Frame frame;
             frame.return_ = ret;
             frame.function_ = function;
-            frame.instruction_ = static_cast<Function*>(function->closure_->function())->GetOpCodes();
-            frame.end_ = frame.instruction_ + static_cast<Function*>(function->closure_->function())->OpCodeSize();
+            frame.instruction_ = instructions;
             frame.register_ = heap_.top_;
             frames_.push_back(frame);
+            if(profiler_.Get() != nullptr) {
+                Profiler::Stats* stats = profiler_->Enter(callee, false);
+                if(stats->name_.empty()) {
+                    stats->name_ = FunctionName(callee);
+                }
+            }
             return true;
-        }else if(function->type_ == Value_CFunction) {
+        }else if(function->IsCFunction()) {
             heap_.top_ = function + argc + 1;
             Frame frame;
             frame.return_ = ret;
             frame.function_ = function;
             frame.register_ = function + 1;
             frames_.push_back(frame);
-            void* cfunction = function->native_function_;
+            void* cfunction = function->native_function();
+            Profiler* profiler = profiler_.Get();
+            if(profiler != nullptr) {
+                Profiler::Stats* stats = profiler->Enter(cfunction, true);
+                if(stats->name_.empty()) {
+                    stats->name_ = CFunctionName(cfunction);
+                }
+            }
             Value v = reinterpret_cast<CFunction>(cfunction)(this);
+            if(profiler != nullptr) {
+                profiler->Leave();
+            }
             if(ret){
                 *ret = v;
             }
@@ -129,237 +519,397 @@ namespace lepus {
         try {
             while(!frames_.empty()) {
                 RunFrame();
+                // Once the last frame returned its result may only be held
+                // by the native caller, so never collect then.
+                if(gc_.ShouldStep() && !frames_.empty()) {
+                    gc_.Step();
+                }
             }
-            heap_.top_ = heap_.base() + top_level_variables_.size() + 1;
         } catch (const lepus::Exception& exception) {
             std::cout<<exception.message()<<std::endl;
+            frames_.clear();
+            if(profiler_.Get() != nullptr) {
+                profiler_->Unwind();
+            }
         }
+        heap_.top_ = heap_.base() + top_level_variables_.size() + 1;
+        ShrinkStack();
     }
     
     void VMContext::RunFrame() {
+        if(profiler_.Get() != nullptr) {
+            if(threaded_dispatch_) {
+                Interpret<true, true>();
+            }else{
+                Interpret<false, true>();
+            }
+        }else if(threaded_dispatch_) {
+            Interpret<true, false>();
+        }else{
+            Interpret<false, false>();
+        }
+    }
+    
+    inline void VMContext::GetTable(std::size_t* cache, Value* a, Value* b, Value* c) {
+        if(b->IsTable()) {
+            *a = static_cast<Dictonary*>(b->table())->GetValue(*c, cache);
+        }else if(b->IsString() && c->IsString()){
+            Value* v = global()->Find(string_pool()->NewString("String"));
+            *a = static_cast<Dictonary*>(v->table())->GetValue(*c, cache);
+        }else{
+            a->SetNil();
+        }
+    }
+    
+    inline void VMContext::SetTable(std::size_t* cache, Value* a, Value* b, Value* c) {
+        if(a->IsTable()) {
+            Dictonary* table = static_cast<Dictonary*>(a->table());
+            if(table->shared()) {
+                table = UnshareTable(a);
+            }
+            table->SetValue(*b, *c, cache);
+            gc_.Barrier(table, *b);
+            gc_.Barrier(table, *c);
+        }
+    }
+    
+    Dictonary* VMContext::UnshareTable(Value* a) {
+        Dictonary* shared = static_cast<Dictonary*>(a->table());
+        Dictonary* table = lynx_new Dictonary;
+        shared->ForEach([table](const Value& key, const Value& value) {
+            table->SetValue(key, value);
+        });
+        gc_.Track(table);
+        for(std::size_t index = 0; Value* value = global()->Get(index); ++index) {
+            if(value->IsTable() && value->table() == shared) {
+                value->SetTable(table);
+            }
+        }
+        a->SetTable(table);
+        return table;
+    }
+    
+    template<bool kThreaded, bool kProfiled>
+    void VMContext::Interpret() {
+#if LEPUS_COMPUTED_GOTO
+        static const void* const kDispatchTable[] = {
+            &&L_End,
+            &&L_LoadNil, &&L_LoadConst, &&L_Move, &&L_GetUpvalue,
+            &&L_SetUpvalue, &&L_GetGlobal, &&L_SetGlobal, &&L_Closure,
+            &&L_Call, &&L_Ret, &&L_JmpFalse, &&L_Jmp, &&L_Neg, &&L_Not,
+            &&L_Len, &&L_Add, &&L_Sub, &&L_Mul, &&L_Div, &&L_Pow, &&L_Mod,
+            &&L_And, &&L_Or, &&L_Less, &&L_Greater, &&L_Equal, &&L_UnEqual,
+            &&L_LessEqual, &&L_GreaterEqual, &&L_NewTable, &&L_SetTable,
+            &&L_GetTable, &&L_Switch, &&L_Inc, &&L_Dec, &&L_Noop,
+            &&L_LessJmpFalse, &&L_LessEqualJmpFalse,
+        };
+        static_assert(sizeof(kDispatchTable) / sizeof(kDispatchTable[0]) == kLastOpCode + 1,
+                      "dispatch table must cover every op code");
+#endif
         Frame *frame = &frames_.back();
-        Closure* closure = frame->function_->closure_;
+        Closure* closure = frame->function_->closure();
         Function *function = closure->function();
+        const DecodedInstruction* pc = frame->instruction_;
+        std::size_t* table_caches = table_caches_.data() + function->table_cache_base();
+        const DecodedInstruction* i = nullptr;
         Value *a = nullptr;
         Value *b = nullptr;
         Value *c = nullptr;
-        while(frame->instruction_ < frame->end_) {
-            Instruction i = *frame->instruction_++;
-            switch (Instruction::GetOpCode(i)) {
-                case TypeOp_LoadNil:
+        Profiler* profiler = profiler_.Get();
+#if LEPUS_JIT
+        // Native code would hide the op codes from the profile.
+        if(!kProfiled && jit_enabled_) {
+            pc = EnterJit(function, frame, pc);
+        }
+#endif
+        for(;;) {
+            i = pc++;
+            PROFILE_OP(i);
+            switch (i->op_) {
+                OPCODE(LoadNil):
                     a = GET_REGISTER_A(i);
                     a->SetNil();
-                    break;
-                case TypeOp_LoadConst:
+                    DISPATCH();
+                OPCODE(LoadConst):
                     a = GET_REGISTER_A(i);
                     b = GET_CONST_VALUE(i);
                     *a = *b;
-                    break;
-                case TypeOp_Move:
+                    DISPATCH();
+                OPCODE(Move):
                     a = GET_REGISTER_A(i);
                     b = GET_REGISTER_B(i);
                     *a = *b;
-                    break;
-                case TypeOp_GetUpvalue:
+                    DISPATCH();
+                OPCODE(GetUpvalue):
                     a = GET_REGISTER_A(i);
                     b = GET_UPVALUE_B(i);
                     *a = *b;
-                    break;
-                case TypeOp_SetUpvalue:
+                    DISPATCH();
+                OPCODE(SetUpvalue):
                     a = GET_REGISTER_A(i);
                     b = GET_UPVALUE_B(i);
                     *b = *a;
-                    break;
-                case TypeOp_GetGlobal:
+                    DISPATCH();
+                OPCODE(GetGlobal):
                     a = GET_REGISTER_A(i);
                     b = GET_Global_VALUE(i);
                     *a = *b;
-                    break;
-                case TypeOp_SetGlobal:
-                    break;
-                case TypeOp_Closure:
-                {
+                    DISPATCH();
+                OPCODE(Closure):
                     a = GET_REGISTER_A(i);
-                    long index = Instruction::GetParamBx(i);
-                    GenerateClosure(a, index);
-                }
-                    break;
-                case TypeOp_Call:
-                {
+                    GenerateClosure(a, i->bx_);
+                    GC_SAFEPOINT();
+                    DISPATCH();
+                OPCODE(Call):
                     a = GET_REGISTER_A(i);
-                    long argc = Instruction::GetParamB(i);
                     c = GET_REGISTER_C(i);
-                    if(CallFunction(a, argc, c))
+                    frame->instruction_ = pc;
+                    if(CallFunction(a, i->b_, c))
                         return;
-                }
-                    break;
-                case TypeOp_Ret:
+                    // The native function may have compiled a new script.
+                    table_caches = table_caches_.data() + function->table_cache_base();
+#if LEPUS_JIT
+                    // Native functions return here, back into native code.
+                    if(!kProfiled && jit_enabled_) {
+                        pc = EnterJit(function, frame, pc);
+                    }
+#endif
+                    DISPATCH();
+                OPCODE(Ret):
                     a = GET_REGISTER_A(i);
                     if(frame->return_ != nullptr) {
                         *frame->return_ = *a;
                     }
                     frames_.pop_back();
+                    if(kProfiled) {
+                        profiler->Leave();
+                    }
                     return;
-                case TypeOp_JmpFalse:
+                OPCODE(JmpFalse):
                     a = GET_REGISTER_A(i);
                     if (a->IsFalse())
-                        frame->instruction_ += -1 + Instruction::GetParamsBx(i);
-                    break;
-                case TypeOp_Jmp:
-                    frame->instruction_ += -1 + Instruction::GetParamsBx(i);
-                    break;
-                case TypeOp_Neg:
+                        pc = i + i->bx_;
+                    DISPATCH();
+                OPCODE(Jmp):
+                    pc = i + i->bx_;
+#if LEPUS_JIT
+                    // Loops count towards hotness.
+                    if(!kProfiled && jit_enabled_ && i->bx_ < 0) {
+                        pc = EnterJit(function, frame, pc);
+                    }
+#endif
+                    DISPATCH();
+                OPCODE(LessJmpFalse):
+                    b = GET_REGISTER_B(i);
+                    c = GET_REGISTER_C(i);
+                    pc = b->IsNumber() && b->number() < c->number() ? i + 2 : i + i->bx_;
+                    DISPATCH();
+                OPCODE(LessEqualJmpFalse):
+                    b = GET_REGISTER_B(i);
+                    c = GET_REGISTER_C(i);
+                    pc = b->IsNumber() && b->number() <= c->number() ? i + 2 : i + i->bx_;
+                    DISPATCH();
+                OPCODE(Neg):
                     a = GET_REGISTER_A(i);
-                    a->number_ = -a->number_;
-                    break;
-                case TypeOp_Not:
+                    if (a->IsNumber())
+                        a->SetNumber(-a->number());
+                    DISPATCH();
+                OPCODE(Not):
                     a = GET_REGISTER_A(i);
-                    a->boolean_ = !a->boolean_;
-                    break;
-                case TypeOp_Len:
-                    break;
-                case TypeOp_Add:
+                    a->SetBoolean(a->IsFalse());
+                    DISPATCH();
+                OPCODE(Add):
                     GET_REGISTER_ABC(i);
                     // 判断是不是数字相加
-                    if( b->type_ == Value_String || c->type_ == Value_String){
+                    if (b->IsNumber() && c->IsNumber()) {
+                        a->SetNumber(b->number() + c->number());
+                    }else if( b->IsString() || c->IsString()){
                         std::string b_string;
                         std::string c_string;
-                        if(b->type_ == Value_Number){
-                            b_string = to_string(b->number_);
+                        if(b->IsNumber()){
+                            b_string = to_string(b->number());
                             DeleteZero(b_string);
                         }else{
-                            b_string = b->str_->c_str();
+                            b_string = b->str()->c_str();
                         }
-                        if(c->type_ == Value_Number){
-                            c_string = to_string(c->number_);
+                        if(c->IsNumber()){
+                            c_string = to_string(c->number());
                             DeleteZero(c_string);
                         }else{
-                            c_string = c->str_->c_str();
+                            c_string = c->str()->c_str();
                         }
-                        a->str_ = string_pool()->NewString(b_string + c_string);
-                        a->str_->AddRef();
-                        a->type_ = Value_String;
+                        a->SetString(string_pool()->NewString(b_string + c_string));
+                        GC_SAFEPOINT();
                     }else{
-                        a->number_ = b->number_ + c->number_;
-                        a->type_ = Value_Number;
+                        a->SetNumber(b->number() + c->number());
                     }
-                    break;
-                case TypeOp_Sub:
+                    DISPATCH();
+                OPCODE(Sub):
                     GET_REGISTER_ABC(i);
-                    a->number_ = b->number_ - c->number_;
-                    a->type_ = Value_Number;
-                    break;
-                case TypeOp_Mul:
+                    a->SetNumber(b->number() - c->number());
+                    DISPATCH();
+                OPCODE(Mul):
                     GET_REGISTER_ABC(i);
-                    a->number_ = b->number_ * c->number_;
-                    a->type_ = Value_Number;
-                    break;
-                case TypeOp_Div:
+                    a->SetNumber(b->number() * c->number());
+                    DISPATCH();
+                OPCODE(Div):
                     GET_REGISTER_ABC(i);
-                    a->number_ = b->number_ / c->number_;
-                    a->type_ = Value_Number;
-                    break;
-                case TypeOp_Pow:
-                    break;
-                case TypeOp_Mod:
+                    a->SetNumber(b->number() / c->number());
+                    DISPATCH();
+                OPCODE(Mod):
                     GET_REGISTER_ABC(i);
-                    a->number_ = int(b->number_/c->number_);
-                    a->number_ = b->number_ - a->number_ * c->number_;
-                    a->type_ = Value_Number;
-                    break;
-                case TypeOp_And:
+                    a->SetNumber(b->number() - int(b->number() / c->number()) * c->number());
+                    DISPATCH();
+                OPCODE(And):
                     GET_REGISTER_ABC(i);
-                    if (b->type_ == Value_Boolean)
-                        a->boolean_ = (b->boolean_ && c->boolean_);
-                    a->type_ = Value_Boolean;
-                    break;
-                case TypeOp_Or:
+                    a->SetBoolean(b->IsBoolean() && b->boolean() && c->boolean());
+                    DISPATCH();
+                OPCODE(Or):
                     GET_REGISTER_ABC(i);
-                    if (b->type_ == Value_Boolean)
-                        a->boolean_ = (b->boolean_ || c->boolean_);
-                    a->type_ = Value_Boolean;
-                    break;
-                case TypeOp_Less:
+                    a->SetBoolean(b->IsBoolean() && (b->boolean() || c->boolean()));
+                    DISPATCH();
+                OPCODE(Less):
                     GET_REGISTER_ABC(i);
-                    if (b->type_ == Value_Number)
-                        a->boolean_ = (b->number_ < c->number_);
-                    a->type_ = Value_Boolean;
-                    break;
-                case TypeOp_Greater:
+                    a->SetBoolean(b->IsNumber() && b->number() < c->number());
+                    DISPATCH();
+                OPCODE(Greater):
                     GET_REGISTER_ABC(i);
-                    if (b->type_ == Value_Number)
-                        a->boolean_ = (b->number_ > c->number_);
-                    a->type_ = Value_Boolean;
-                    break;
-                case TypeOp_Equal:
+                    a->SetBoolean(b->IsNumber() && b->number() > c->number());
+                    DISPATCH();
+                OPCODE(Equal):
                     GET_REGISTER_ABC(i);
-                    a->boolean_ = (*b == *c);
-                    a->type_ = Value_Boolean;
-                    break;
-                case TypeOp_UnEqual:
+                    a->SetBoolean(*b == *c);
+                    DISPATCH();
+                OPCODE(UnEqual):
                     GET_REGISTER_ABC(i);
-                    a->boolean_ = (*b != *c);
-                    a->type_ = Value_Boolean;
-                    break;
-                case TypeOp_LessEqual:
+                    a->SetBoolean(*b != *c);
+                    DISPATCH();
+                OPCODE(LessEqual):
                     GET_REGISTER_ABC(i);
-                    if (b->type_ == Value_Number)
-                        a->boolean_ = (b->number_ <= c->number_);
-                    a->type_ = Value_Boolean;
-                    break;
-                case TypeOp_GreaterEqual:
+                    a->SetBoolean(b->IsNumber() && b->number() <= c->number());
+                    DISPATCH();
+                OPCODE(GreaterEqual):
                     GET_REGISTER_ABC(i);
-                    if (b->type_ == Value_Number)
-                        a->boolean_ = (b->number_ >= c->number_);
-                    a->type_ = Value_Boolean;
-                    break;
-                case TypeOp_NewTable:
-                    break;
-                case TypeOp_SetTable:
-                    break;
-                case TypeOp_GetTable:
+                    a->SetBoolean(b->IsNumber() && b->number() >= c->number());
+                    DISPATCH();
+                OPCODE(GetTable):
                     GET_REGISTER_ABC(i);
-                    if(b->type_ == Value_Table && c->type_ == Value_String) {
-                        *a = static_cast<Dictonary*>(b->table_)->GetValue(c->str_);
-                    }else if(b->type_ == Value_String && c->type_ == Value_String){
-                        Value* v = global()->Find(string_pool()->NewString("String"));
-                        *a = static_cast<Dictonary*>(v->table_)->GetValue(c->str_);
-                    }
-                    
-                    break;
-                case TypeOp_Switch:
+                    GetTable(table_caches + i->bx_, a, b, c);
+                    DISPATCH();
+                OPCODE(SetTable):
+                    GET_REGISTER_ABC(i);
+                    SetTable(table_caches + i->bx_, a, b, c);
+                    DISPATCH();
+                OPCODE(Switch):
                 {
                     a = GET_REGISTER_A(i);
-                    long index = Instruction::GetParamBx(i);
-                    long jmp = function->GetSwitch(index)->Switch(a);
-                    frame->instruction_ += -1 + jmp;
+                    long jmp = function->GetSwitch(i->bx_)->Switch(a);
+                    pc = i + jmp;
                 }
-                    break;
-                case TypeOp_Inc:
+                    DISPATCH();
+                OPCODE(Inc):
                     a = GET_REGISTER_A(i);
-                    if (a->type_ == Value_Number)
-                        a->number_ += 1;
-                    break;
-                case TypeOp_Dec:
+                    if (a->IsNumber())
+                        a->SetNumber(a->number() + 1);
+                    DISPATCH();
+                OPCODE(Dec):
                     a = GET_REGISTER_A(i);
-                    if (a->type_ == Value_Number)
-                        a->number_ -= 1;
-                    break;
-                case TypeOp_Noop:
-                    break;
+                    if (a->IsNumber())
+                        a->SetNumber(a->number() - 1);
+                    DISPATCH();
+                OPCODE(SetGlobal):
+                OPCODE(Len):
+                OPCODE(Pow):
+                OPCODE(NewTable):
+                OPCODE(Noop):
+                    DISPATCH();
+#if LEPUS_COMPUTED_GOTO
+                L_End:
+#endif
+                case 0:
+                    if(frame->return_ != nullptr) {
+                        frame->return_->SetNil();
+                    }
+                    frames_.pop_back();
+                    if(kProfiled) {
+                        profiler->Leave();
+                    }
+                    return;
                 default:
                     break;
             }
         }
-        if(frame->return_ != nullptr) {
-            frame->return_->SetNil();
+    }
+    
+    template void VMContext::Interpret<true, false>();
+    template void VMContext::Interpret<false, false>();
+    template void VMContext::Interpret<true, true>();
+    template void VMContext::Interpret<false, true>();
+    
+#if LEPUS_JIT
+    const DecodedInstruction* VMContext::EnterJit(Function* function, Frame* frame,
+                                                  const DecodedInstruction* pc) {
+        static const JitHelpers kHelpers = {
+            &VMContext::JitGetGlobal, &VMContext::JitGetUpvalue,
+            &VMContext::JitSetUpvalue, &VMContext::JitGetTable,
+            &VMContext::JitSetTable, &VMContext::JitLogic,
+        };
+        JitCode* code = function->jit_code();
+        if(code == nullptr) {
+            if(!function->CountHotness()) {
+                return pc;
+            }
+            // A function that fails to compile stays interpreted.
+            code = JitCode::Compile(function, kHelpers);
+            if(code == nullptr) {
+                return pc;
+            }
+            function->set_jit_code(code);
+        }
+        const DecodedInstruction* base = function->GetDecodedOpCodes();
+        return base + code->Run(frame->register_, pc - base, this);
+    }
+    
+    void VMContext::JitGetGlobal(VMContext* context, Value* registers, const DecodedInstruction* i) {
+        registers[i->a_] = *context->global()->Get(i->bx_);
+    }
+    
+    void VMContext::JitGetUpvalue(VMContext* context, Value* registers, const DecodedInstruction* i) {
+        Closure* closure = context->frames_.back().function_->closure();
+        registers[i->a_] = *(context->heap_.base() + closure->GetUpvalue(i->b_));
+    }
+    
+    void VMContext::JitSetUpvalue(VMContext* context, Value* registers, const DecodedInstruction* i) {
+        Closure* closure = context->frames_.back().function_->closure();
+        *(context->heap_.base() + closure->GetUpvalue(i->b_)) = registers[i->a_];
+    }
+    
+    void VMContext::JitGetTable(VMContext* context, Value* registers, const DecodedInstruction* i) {
+        Function* function = context->frames_.back().function_->closure()->function();
+        std::size_t* cache = &context->table_caches_[function->table_cache_base() + i->bx_];
+        context->GetTable(cache, registers + i->a_, registers + i->b_, registers + i->c_);
+    }
+    
+    void VMContext::JitSetTable(VMContext* context, Value* registers, const DecodedInstruction* i) {
+        Function* function = context->frames_.back().function_->closure()->function();
+        std::size_t* cache = &context->table_caches_[function->table_cache_base() + i->bx_];
+        context->SetTable(cache, registers + i->a_, registers + i->b_, registers + i->c_);
+    }
+    
+    void VMContext::JitLogic(VMContext* context, Value* registers, const DecodedInstruction* i) {
+        Value* b = registers + i->b_;
+        Value* c = registers + i->c_;
+        if(i->op_ == TypeOp_And) {
+            registers[i->a_].SetBoolean(b->IsBoolean() && b->boolean() && c->boolean());
+        }else{
+            registers[i->a_].SetBoolean(b->IsBoolean() && (b->boolean() || c->boolean()));
         }
-        frames_.pop_back();
     }
+#endif
     
     void VMContext::GenerateClosure(Value* value, long index) {
         Frame* frame = &frames_.back();
-        Closure* current_closure = frame->function_->closure_;
+        Closure* current_closure = frame->function_->closure();
         Function *function = current_closure->function()->GetChildFunction(index);
         
         Closure* closure = lynx_new Closure(function);
@@ -368,15 +918,16 @@ namespace lepus {
         for(int i = 0; i < upvalues_count; ++i) {
             UpvalueInfo* info = function->GetUpvalue(i);
             if(info->in_parent_vars_) {
-                Value* v = frame->register_ + info->register_;
-                closure->AddUpvalue(v);
+                std::size_t slot = frame->register_ - heap_.base() + info->register_;
+                max_upvalue_slot_ = std::max(max_upvalue_slot_, slot);
+                closure->AddUpvalue(slot);
             }else{
                 closure->AddUpvalue(current_closure->GetUpvalue(info->register_));
             }
         }
         
-        value->type_ = Value_Closure;
-        value->closure_ = closure;
+        gc_.Track(closure);
+        value->SetClosure(closure);
     }
 
 }
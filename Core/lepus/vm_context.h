@@ -3,36 +3,173 @@
 #define LYNX_LEPUS_VM_CONTEXT_H_
 
 #include <list>
+#include <ostream>
 #include <unordered_map>
 
 #include "lepus/context.h"
 #include "lepus/value.h"
 #include "lepus/lepus_string.h"
 #include "lepus/heap.h"
+#include "lepus/jit.h"
+#include "lepus/profiler.h"
+#include "base/ref_counted_ptr.h"
+
+// Computed goto is a GNU extension, other compilers use the switch loop.
+#if defined(__GNUC__) || defined(__clang__)
+#define LEPUS_COMPUTED_GOTO 1
+#else
+#define LEPUS_COMPUTED_GOTO 0
+#endif
 
 namespace lepus {
+    class Program;
     
     class VMContext : public Context {
     public:
+        VMContext();
+        // Attaches to a compiled program instead of compiling one. The
+        // context shares the program's functions, strings and builtins and
+        // owns only its stack, top level variables and global values;
+        // ExecuteProgram() runs the program's top level code in it. Shared
+        // builtin tables are copied on their first write.
+        explicit VMContext(Program* program);
         virtual ~VMContext();
         virtual void Initialize();
         virtual void Execute(const std::string& source);
+        // Runs source straight from memory, e.g. a mapped file, without
+        // copying it. See Scanner.
+        void Execute(const char* source, std::size_t length);
         virtual Value Call(const std::string& name, const std::vector<Value>& args);
         virtual long GetParamsSize();
         virtual Value* GetParam(long index);
         virtual bool UpdateTopLevelVariable(const std::string &name, Value value);
+        
+        // Fast paths for hot native calls. |name| is an interned string of
+        // this context, kept from string_pool() and pinned with AddRef while
+        // held, so the lookup neither allocates nor hashes characters.
+        Value Call(String* name, const Value* args, std::size_t argc);
+        bool UpdateTopLevelVariable(String* name, Value value);
+        // Returns the interned name of the top level variable |name|, or
+        // nullptr when the script has none. The name stays pinned for the
+        // lifetime of the context, ready for the overloads above.
+        String* FindTopLevelVariable(const std::string& name);
+        // Compiles source without running it and serializes the result, see
+        // lepus/bytecode.h. Returns false on compile error.
+        virtual bool Compile(const std::string& source, std::string& bytecode);
+        virtual void ExecuteBytecode(const char* data, std::size_t size);
+        void ExecuteProgram();
+        
+        void set_threaded_dispatch(bool threaded) {
+            threaded_dispatch_ = threaded && LEPUS_COMPUTED_GOTO;
+        }
+        bool threaded_dispatch() {
+            return threaded_dispatch_;
+        }
+        
+        // Runs the bytecode optimizer on newly compiled scripts, on by
+        // default. See lepus/optimizer.h.
+        void set_optimize_bytecode(bool optimize) {
+            optimize_bytecode_ = optimize;
+        }
+        
+        // Compiles hot functions to native code, see lepus/jit.h. Off by
+        // default and a no-op on targets without a JIT backend.
+        void set_jit_enabled(bool enabled) {
+            jit_enabled_ = enabled && LEPUS_JIT;
+        }
+        bool jit_enabled() {
+            return jit_enabled_;
+        }
+        
+        // Starts a fresh profile of calls, native calls and op codes, or
+        // stops profiling. Switch it between runs, not from a CFunction.
+        // Profiling runs the plain interpreter, without the JIT.
+        void set_profiling(bool profiling);
+        // The profile so far, nullptr unless profiling. See lepus/profiler.h
+        // for the reports.
+        Profiler* profiler() {
+            return profiler_.Get();
+        }
+        
+        // When set, compiling prints the bytecode before and after the
+        // optimizer runs. |out| must outlive the compilations.
+        void set_bytecode_dump(std::ostream* out) {
+            bytecode_dump_ = out;
+        }
+        
+        // Hard limit of the register stack in values, exceeding it raises a
+        // RuntimeException instead of overrunning memory.
+        void set_max_stack_size(std::size_t size);
+        std::size_t stack_size();
+        
+        // Roots are the register stack, top level variables and globals.
+        virtual void MarkRoots(GC* gc);
     protected:
         friend class CodeGenerator;
         Heap& heap() {
             return heap_;
         }
     private:
+        friend class Program;
+        bool Parse(const char* source, std::size_t length);
+        bool ReadBytecode(const char* data, std::size_t size);
+        void OptimizeBytecode();
+        // Decodes the new root function's tree and resets the inline caches.
+        void PrepareFunctions();
+        Function* root_function();
+        // Runs |closure| from the bottom of the stack.
+        void RunRoot(Closure* closure);
         void Run();
         void RunFrame();
+        template<bool kThreaded, bool kProfiled> void Interpret();
         bool CallFunction(Value* function, size_t argc, Value* ret);
+        // Makes |slots| values from |from| addressable and returns |from|,
+        // which moves if the stack had to grow.
+        Value* CheckStack(Value* from, std::size_t slots);
+        void ShrinkStack();
+        // Number of stack slots reachable from frames, top level variables
+        // and captured upvalues.
+        std::size_t LiveStackSize();
+        void ResizeStack(std::size_t size);
+        Value* Relocate(Value* value, Value* old_base, Value* old_limit);
         void GenerateClosure(Value* value, long index);
+        // Shared by the interpreter and the JIT helpers. |cache| is the
+        // instruction's inline cache.
+        inline void GetTable(std::size_t* cache, Value* a, Value* b, Value* c);
+        inline void SetTable(std::size_t* cache, Value* a, Value* b, Value* c);
+        // Replaces the shared table in |a| by a private copy, also in the
+        // globals that hold it, and returns the copy.
+        Dictonary* UnshareTable(Value* a);
+        // Names for the profile: top level functions by their variable,
+        // others by their path in the function tree as in the disassembly,
+        // natives by their global or "Table.key" binding.
+        std::string FunctionName(Function* function);
+        std::string CFunctionName(void* cfunction);
+#if LEPUS_JIT
+        // Runs the native code of |function| from |pc| when it has some,
+        // compiling it once hot. Returns where the interpreter continues.
+        const DecodedInstruction* EnterJit(Function* function, Frame* frame,
+                                           const DecodedInstruction* pc);
+        static void JitGetGlobal(VMContext* context, Value* registers, const DecodedInstruction* i);
+        static void JitGetUpvalue(VMContext* context, Value* registers, const DecodedInstruction* i);
+        static void JitSetUpvalue(VMContext* context, Value* registers, const DecodedInstruction* i);
+        static void JitGetTable(VMContext* context, Value* registers, const DecodedInstruction* i);
+        static void JitSetTable(VMContext* context, Value* registers, const DecodedInstruction* i);
+        static void JitLogic(VMContext* context, Value* registers, const DecodedInstruction* i);
+#endif
         Heap heap_;
         std::list<Frame> frames_;
+        bool threaded_dispatch_;
+        bool optimize_bytecode_;
+        bool jit_enabled_;
+        std::ostream* bytecode_dump_;
+        std::size_t max_upvalue_slot_;
+        Value nil_param_;
+        base::ScopedPtr<Profiler> profiler_;
+        // Inline caches of every function of the tree, see
+        // Function::table_cache_base().
+        std::vector<std::size_t> table_caches_;
+        base::ScopedRefPtr<Program> program_;
     protected:
         friend class CodeGenerator;
         std::unordered_map<String*, long> top_level_variables_;
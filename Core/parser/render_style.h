@@ -6,6 +6,8 @@
 #include <string>
 #include "base/scoped_vector.h"
 #include "base/debug/memory_debug.h"
+#include "layout/css_property.h"
+#include "layout/css_value.h"
 
 namespace parser {
     class RenderStyle {
@@ -13,6 +15,10 @@ namespace parser {
         struct Style {
             std::string name_;
             std::string value_;
+            // Looked up and parsed once the text is read, see
+            // StyleParser::Parse.
+            lynx::CSSPropertyID id_;
+            lynx::CSSValue css_value_;
         };
         
         base::ScopedVector<Style>& styles() {
@@ -63,12 +63,19 @@ namespace parser {
                     break;
             }
         }
+        
+        size_t style_count = style_.styles().size();
+        for(int i = 0; i < style_count; ++i) {
+            RenderStyle::Style* style = style_.styles()[i];
+            style->id_ = lynx::CSSPropertyIDForName(style->name_);
+            style->css_value_ = lynx::CSSValue::Parse(style->id_, style->value_);
+        }
     }
     
     void StyleParser::Apply(lynx::RenderObject* renderer) {
         size_t style_count = style_.styles().size();
         for(int i = 0; i < style_count; ++i) {
-            renderer->SetStyle(style_.styles()[i]->name_, style_.styles()[i]->value_);
+            renderer->SetStyle(style_.styles()[i]->id_, style_.styles()[i]->css_value_);
         }
         renderer->FlushStyle();
     }
@@ -33,27 +33,27 @@ base::android::ScopedLocalJavaRef<jdoubleArray> GenerateAction(JNIEnv *env,
 
 base::android::ScopedLocalJavaRef<jobjectArray> GenerateEvent(JNIEnv *env,
                                                          lynx::CoordinatorAction action) {
-    if (action.event_.empty())
+    if (action.event_ == nullptr)
         return base::android::ScopedLocalJavaRef<jobjectArray>();
     int length = 2;
     auto result = base::android::LxJType::NewObjectArray(env, length);
-    auto event_name = base::android::JNIHelper::ConvertToJNIString(env, action.event_);
+    auto event_name = base::android::JNIHelper::ConvertToJNIString(env, std::string(action.event_->c_str()));
     env->SetObjectArrayElement(result.Get(), 0, event_name.Get());
-    switch (action.params_for_event_.type_) {
+    switch (action.params_for_event_.type()) {
         case lepus::ValueType::Value_String: {
-            const char* temp = action.params_for_event_.str_->c_str();
+            const char* temp = action.params_for_event_.str()->c_str();
             auto params = base::android::JNIHelper::ConvertToJNIString(env, (char *) temp);
             env->SetObjectArrayElement(result.Get(), 1, params.Get());
         }
             break;
         case lepus::ValueType::Value_Number:{
-            double temp = action.params_for_event_.number_;
+            double temp = action.params_for_event_.number();
             auto params = base::android::LxJType::NewDouble(env, temp);
             env->SetObjectArrayElement(result.Get(), 1, params.Get());
         }
             break;
         case lepus::ValueType::Value_Boolean:{
-            bool temp = action.params_for_event_.boolean_;
+            bool temp = action.params_for_event_.boolean();
             auto params = base::android::LxJType::NewBoolean(env, temp);
             env->SetObjectArrayElement(result.Get(), 1, params.Get());
         }
@@ -81,17 +81,15 @@ const std::vector<lepus::Value> ConstructCoordinatorArgs(JNIEnv *env,
     std::vector<lepus::Value> lepus_args;
 
     lepus::Value lepus_tag;
-    lepus_tag.type_ = lepus::Value_String;
     if (tag != NULL) {
-        lepus_tag.str_ = executor->context()
+        lepus_tag.SetString(executor->context()
                 ->string_pool()
-                ->NewString(base::android::JNIHelper::ConvertToString(env, tag).c_str());
+                ->NewString(base::android::JNIHelper::ConvertToString(env, tag).c_str()));
     } else {
-        lepus_tag.str_ = lepus_tag.str_ = executor->context()
+        lepus_tag.SetString(executor->context()
                 ->string_pool()
-                ->NewString("");
+                ->NewString(""));
     }
-    lepus_tag.str_->AddRef();
 
     lepus_args.push_back(lepus_tag);
     for (int i = 0; i < length; ++i) {
@@ -141,14 +139,12 @@ jboolean UpdateProperty(JNIEnv *env,
     lepus::Value lepus_value;
     // Add string
     if (type == 0) {
-        lepus_value.type_ = lepus::Value_String;
         if (value1 != NULL) {
-            lepus_value.str_ = executor->context()->string_pool()
-                    ->NewString(base::android::JNIHelper::ConvertToString(env, value1).c_str());
+            lepus_value.SetString(executor->context()->string_pool()
+                    ->NewString(base::android::JNIHelper::ConvertToString(env, value1).c_str()));
         } else {
-            lepus_value.str_ = lepus_value.str_ = executor->context()->string_pool()->NewString("");
+            lepus_value.SetString(executor->context()->string_pool()->NewString(""));
         }
-        lepus_value.str_->AddRef();
     }
     // Add double
     else if (type == 1) {
@@ -156,8 +152,7 @@ jboolean UpdateProperty(JNIEnv *env,
     }
     // Add boolean
     else if (type == 2) {
-        lepus_value.type_ = lepus::Value_Boolean;
-        lepus_value.boolean_ = value3;
+        lepus_value.SetBoolean(value3);
     }
     if (executor->context()->UpdateTopLevelVariable(name, lepus_value)) {
         return JNI_TRUE;
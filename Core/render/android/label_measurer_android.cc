@@ -15,10 +15,13 @@
 
 namespace lynx {
 
-base::Size LabelMeasurer::MeasureLabelSize(RenderObject* render_object,
-                                           const base::Size& size,
-                                           const std::string& text) {
-  JNIEnv* env = base::android::AttachCurrentThread();
+namespace {
+// The measured com.lynx.base.Size, which also carries the text layout.
+base::android::ScopedLocalJavaRef<jobject> MeasureLabel(
+    JNIEnv* env,
+    RenderObject* render_object,
+    const base::Size& size,
+    const std::string& text) {
   base::android::ScopedLocalJavaRef<jobject> style_obj =
       base::Convert::StyleConvert(render_object->css_style());
 
@@ -27,11 +30,18 @@ base::Size LabelMeasurer::MeasureLabelSize(RenderObject* render_object,
   int widthMode = base::Size::Descriptor::GetMode(size.width_);
   int heightMode = base::Size::Descriptor::GetMode(size.height_);
 
-  base::android::ScopedLocalJavaRef<jobject> size_obj(
-      Java_LabelMeasurer_measureLabelSize(
-          env,
-          (jstring)base::android::LxJType::NewString(env, text.c_str()).Get(),
-          style_obj.Get(), width, widthMode, height, heightMode));
+  return Java_LabelMeasurer_measureLabelSize(
+      env, (jstring)base::android::LxJType::NewString(env, text.c_str()).Get(),
+      style_obj.Get(), width, widthMode, height, heightMode);
+}
+}  // namespace
+
+base::Size LabelMeasurer::MeasureLabelSize(RenderObject* render_object,
+                                           const base::Size& size,
+                                           const std::string& text) {
+  JNIEnv* env = base::android::AttachCurrentThread();
+  base::android::ScopedLocalJavaRef<jobject> size_obj =
+      MeasureLabel(env, render_object, size, text);
 
   base::Size measured_size = base::Convert::SizeConvert(size_obj.Get());
   base::android::CheckException(env);
@@ -43,11 +53,13 @@ base::Size LabelMeasurer::MeasureLabelSizeAndSetTextLayout(
     const base::Size& size,
     const std::string& text) {
   JNIEnv* env = base::android::AttachCurrentThread();
-  base::Size measured_size = MeasureLabelSize(render_object, size, text);
+  base::android::ScopedLocalJavaRef<jobject> size_obj =
+      MeasureLabel(env, render_object, size, text);
+  base::Size measured_size = base::Convert::SizeConvert(size_obj.Get());
 
   auto data =
       jscore::LynxValue::MakePlatformValue(lynx_new jscore::PlatformValue(
-          env, Java_LabelMeasurer_getTextLayout(env).Get()));
+          env, Java_LabelMeasurer_getTextLayout(env, size_obj.Get()).Get()));
   render_object->SetData(RenderObject::TEXT_LAYOUT, data);
 
   base::android::CheckException(env);
@@ -94,7 +106,7 @@ base::Size LabelMeasurer::MeasureSpanSizeAndSetTextLayout(
 
   auto data =
       jscore::LynxValue::MakePlatformValue(lynx_new jscore::PlatformValue(
-          env, Java_LabelMeasurer_getTextLayout(env).Get()));
+          env, Java_LabelMeasurer_getTextLayout(env, size_obj.Get()).Get()));
   render_object->SetData(RenderObject::TEXT_LAYOUT, data);
 
   base::android::CheckException(env);
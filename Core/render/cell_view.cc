@@ -11,7 +11,7 @@ CellView::CellView(jscore::ThreadManager* manager, RenderTreeHost* host)
            1,
            RenderObjectImpl::Create(manager, LYNX_CELLVIEW),
            host) {
-  css_style_.set_flex_direction(CSSFLEX_DIRECTION_COLUMN);
+  MutableStyle()->set_flex_direction(CSSFLEX_DIRECTION_COLUMN);
 }
 
 void CellView::Layout(int left, int top, int right, int bottom) {
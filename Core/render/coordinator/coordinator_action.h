@@ -3,23 +3,29 @@
 #ifndef LYNX_RENDER_COORDINATOR_ACTION_H_
 #define LYNX_RENDER_COORDINATOR_ACTION_H_
 
-#include <vector>
+#include <climits>
+#include <string>
+#include <type_traits>
 #include "lepus/context.h"
 #include "lepus/value.h"
 
 namespace lynx {
 
-    class CoordinatorAction {
-    public:
+    // Result of one coordinator call. Each executor owns one and reaches it
+    // from the lepus CFunctions through the context's user data, so
+    // executors running on different threads never share state. The struct
+    // is trivially copyable and returned by value.
+    struct CoordinatorAction {
 
 #define SetCoordinatorNumber(name, value) \
     static lepus::Value name(lepus::Context* context) { \
+        CoordinatorAction* action = From(context); \
         long params_count = context->GetParamsSize(); \
         for(int i = 0; i < params_count; i++) { \
             lepus::Value* v = context->GetParam(i);  \
-            switch (v->type_) { \
+            switch (v->type()) { \
                 case lepus::Value_Number: \
-                        value = v->number_; \
+                        action->value = v->number(); \
                 break; \
                 default: break; \
             } \
@@ -29,12 +35,13 @@ namespace lynx {
 
 #define SetCoordinatorBool(name, value) \
     static lepus::Value name(lepus::Context* context) { \
+        CoordinatorAction* action = From(context); \
         long params_count = context->GetParamsSize(); \
         for(int i = 0; i < params_count; i++) { \
             lepus::Value* v = context->GetParam(i);  \
-            switch (v->type_) { \
+            switch (v->type()) { \
                 case lepus::Value_Boolean: \
-                        value = v->boolean_; \
+                        action->value = v->boolean(); \
                 break; \
                 default: break; \
             } \
@@ -66,56 +73,91 @@ namespace lynx {
         SetCoordinatorBool(SetConsumed, consumed_)
 
         static lepus::Value DispatchEvent(lepus::Context* context) {
+            CoordinatorAction* action = From(context);
             long params_count = context->GetParamsSize();
-            if (params_count > 0) {
-                event_ = context->GetParam(0)->str_->c_str();
+            if (params_count > 0 && context->GetParam(0)->IsString()) {
+                action->ReleaseEvent();
+                // Read by the platform after the script returned, the
+                // strings stay pinned until the executor runs again.
+                action->event_ = context->GetParam(0)->str();
+                action->event_->AddRef();
             }
             if (params_count > 1) {
-                params_for_event_ = *context->GetParam(1);
+                action->ReleaseParamsForEvent();
+                action->params_for_event_ = *context->GetParam(1);
+                if (action->params_for_event_.IsString()) {
+                    action->params_for_event_.str()->AddRef();
+                }
             }
             return lepus::Value();
         }
 
         static lepus::Value SetTimingFunction(lepus::Context *context) {
-            std::string type = context->GetParam(0)->str_->c_str();
+            CoordinatorAction* action = From(context);
+            std::string type = context->GetParam(0)->str()->c_str();
             if (type.compare("LINEAR")) {
-                timing_function_ = 0;
+                action->timing_function_ = 0;
             } else if (type.compare("EASE")) {
-                timing_function_ = 1;
+                action->timing_function_ = 1;
             } else if (type.compare("EASE_OUT")) {
-                timing_function_ = 2;
+                action->timing_function_ = 2;
             } else if (type.compare("EASE_IN")) {
-                timing_function_ = 3;
+                action->timing_function_ = 3;
             } else if (type.compare("EASE_IN_OUT")) {
-                timing_function_ = 4;
+                action->timing_function_ = 4;
             }
             return lepus::Value();
         }
 
-        static void Reset();
-
-        static double translate_x_;
-        static double translate_y_;
-        static double scale_x_;
-        static double scale_y_;
-        static double rotate_x_;
-        static double rotate_y_;
-        static double origin_x_;
-        static double origin_y_;
-        static double opacity_;
-        static double top_offset_;
-        static double bottom_offset_;
-        static double left_offset_;
-        static double right_offset_;
-        static bool consumed_;
-        static double duration_;
-        static double timing_function_;
-
-        static std::string event_;
-        static lepus::Value params_for_event_;
+        static CoordinatorAction* From(lepus::Context* context) {
+            return static_cast<CoordinatorAction*>(context->user_data());
+        }
+
+        // Unpins the event of the previous call and marks every property
+        // as not set. Only the owning executor calls it, on its own
+        // thread, before running the script.
+        void Reset();
+
+        void ReleaseEvent() {
+            if (event_ != nullptr) {
+                event_->Release();
+            }
+            event_ = nullptr;
+        }
+
+        void ReleaseParamsForEvent() {
+            if (params_for_event_.IsString()) {
+                params_for_event_.str()->Release();
+            }
+            params_for_event_ = lepus::Value();
+        }
+
+        double translate_x_;
+        double translate_y_;
+        double scale_x_;
+        double scale_y_;
+        double rotate_x_;
+        double rotate_y_;
+        double origin_x_;
+        double origin_y_;
+        double opacity_;
+        double top_offset_;
+        double bottom_offset_;
+        double left_offset_;
+        double right_offset_;
+        bool consumed_;
+        double duration_;
+        double timing_function_;
+
+        // Name of the dispatched event, nullptr when none was dispatched.
+        lepus::String* event_;
+        lepus::Value params_for_event_;
 
         const static int kNotSet = INT_MAX;
     };
+
+    static_assert(std::is_trivially_copyable<CoordinatorAction>::value,
+                  "CoordinatorAction is returned by value on every call");
 }
 
 #endif //LYNX_RENDER_COORDINATOR_ACTION_H_
@@ -2,38 +2,101 @@
 
 #include "render/coordinator/coordinator_executor.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "base/threading/lock.h"
 #include "lepus/vm_context.h"
 #include "lepus/builtin.h"
+#include "lepus/bytecode.h"
 
 namespace lynx {
 
     typedef lepus::Value (*NativeFunction)(const std::vector<lepus::Value>& args);
 
-    CoordinatorExecutor::CoordinatorExecutor(const std::string &executable) {
+    namespace {
+        // Programs of the scripts compiled last, most recent at the back.
+        // Executors keep their own reference, so an evicted program lives on
+        // until its last executor goes away.
+        const std::size_t kMaxCachedPrograms = 8;
 
-        vm_ = lynx_new lepus::VM();
-        lepus::VMContext* ctx = new lepus::VMContext();
+        struct ProgramCache {
+            base::Lock lock_;
+            std::vector<std::pair<std::string, base::ScopedRefPtr<lepus::Program> > > programs_;
+        };
+
+        ProgramCache& GetProgramCache() {
+            static ProgramCache cache;
+            return cache;
+        }
+    }
+
+    base::ScopedRefPtr<lepus::Program> CoordinatorExecutor::GetProgram(const std::string& executable) {
+        ProgramCache& cache = GetProgramCache();
+        base::AutoLock lock(cache.lock_);
+        for(std::size_t i = 0; i < cache.programs_.size(); ++i) {
+            if(cache.programs_[i].first == executable) {
+                std::rotate(cache.programs_.begin() + i, cache.programs_.begin() + i + 1,
+                            cache.programs_.end());
+                return cache.programs_.back().second;
+            }
+        }
+
+        // The compiling context holds everything a script may refer to by
+        // name, attached contexts only add their action as user data.
+        lepus::VMContext* ctx = lynx_new lepus::VMContext();
         ctx->Initialize();
 
-        lepus::RegisterCFunction(ctx, "setTranslateY", action_.SetTranslateY);
-        lepus::RegisterCFunction(ctx, "setTranslateX", action_.SetTranslateX);
-        lepus::RegisterCFunction(ctx, "setScaleX", action_.SetScaleX);
-        lepus::RegisterCFunction(ctx, "setScaleY", action_.SetScaleY);
-        lepus::RegisterCFunction(ctx, "setRotateX", action_.SetRotateX);
-        lepus::RegisterCFunction(ctx, "setRotateY", action_.SetRotateY);
-        lepus::RegisterCFunction(ctx, "setOriginX", action_.SetOriginX);
-        lepus::RegisterCFunction(ctx, "setOriginY", action_.SetOriginY);
-        lepus::RegisterCFunction(ctx, "setOpacity", action_.SetOpacity);
-        lepus::RegisterCFunction(ctx, "setTopOffset", action_.SetTopOffset);
-        lepus::RegisterCFunction(ctx, "setBottomOffset", action_.SetBottomOffset);
-        lepus::RegisterCFunction(ctx, "setLeftOffset", action_.SetLeftOffset);
-        lepus::RegisterCFunction(ctx, "setRightOffset", action_.SetRightOffset);
-        lepus::RegisterCFunction(ctx, "setConsumed", action_.SetConsumed);
-        lepus::RegisterCFunction(ctx, "setDuration", action_.SetDuration);
-        lepus::RegisterCFunction(ctx, "dispatchEvent", action_.DispatchEvent);
-        lepus::RegisterCFunction(ctx, "setTimingFunction", action_.SetTimingFunction);
-
-        vm_->Execute(ctx, executable);
+        lepus::RegisterCFunction(ctx, "setTranslateY", CoordinatorAction::SetTranslateY);
+        lepus::RegisterCFunction(ctx, "setTranslateX", CoordinatorAction::SetTranslateX);
+        lepus::RegisterCFunction(ctx, "setScaleX", CoordinatorAction::SetScaleX);
+        lepus::RegisterCFunction(ctx, "setScaleY", CoordinatorAction::SetScaleY);
+        lepus::RegisterCFunction(ctx, "setRotateX", CoordinatorAction::SetRotateX);
+        lepus::RegisterCFunction(ctx, "setRotateY", CoordinatorAction::SetRotateY);
+        lepus::RegisterCFunction(ctx, "setOriginX", CoordinatorAction::SetOriginX);
+        lepus::RegisterCFunction(ctx, "setOriginY", CoordinatorAction::SetOriginY);
+        lepus::RegisterCFunction(ctx, "setOpacity", CoordinatorAction::SetOpacity);
+        lepus::RegisterCFunction(ctx, "setTopOffset", CoordinatorAction::SetTopOffset);
+        lepus::RegisterCFunction(ctx, "setBottomOffset", CoordinatorAction::SetBottomOffset);
+        lepus::RegisterCFunction(ctx, "setLeftOffset", CoordinatorAction::SetLeftOffset);
+        lepus::RegisterCFunction(ctx, "setRightOffset", CoordinatorAction::SetRightOffset);
+        lepus::RegisterCFunction(ctx, "setConsumed", CoordinatorAction::SetConsumed);
+        lepus::RegisterCFunction(ctx, "setDuration", CoordinatorAction::SetDuration);
+        lepus::RegisterCFunction(ctx, "dispatchEvent", CoordinatorAction::DispatchEvent);
+        lepus::RegisterCFunction(ctx, "setTimingFunction", CoordinatorAction::SetTimingFunction);
+
+        // Scripts precompiled at build time skip the scanner, parser and
+        // code generator entirely.
+        base::ScopedRefPtr<lepus::Program> program;
+        if (lepus::IsBytecode(executable.data(), executable.size())) {
+            program = lepus::Program::CompileBytecode(ctx, executable.data(), executable.size());
+        } else {
+            program = lepus::Program::Compile(ctx, executable.data(), executable.size());
+        }
+        if (program.Get() == nullptr) {
+            return program;
+        }
+        if (cache.programs_.size() == kMaxCachedPrograms) {
+            cache.programs_.erase(cache.programs_.begin());
+        }
+        cache.programs_.push_back(std::make_pair(executable, program));
+        return program;
+    }
+
+    // Value initialization leaves the action without a pinned event.
+    CoordinatorExecutor::CoordinatorExecutor(const std::string &executable)
+        : program_(GetProgram(executable)), action_() {
+
+        vm_ = lynx_new lepus::VM();
+        // A script that failed to compile leaves an empty context, calls
+        // into it find no methods.
+        lepus::VMContext* ctx = program_.Get() != nullptr
+            ? lynx_new lepus::VMContext(program_.Get())
+            : lynx_new lepus::VMContext();
+        ctx->Initialize();
+        ctx->set_user_data(&action_);
+        ctx->ExecuteProgram();
         ctx_ = ctx;
     }
 
@@ -48,4 +111,18 @@ namespace lynx {
         vm_->Call(ctx_, method, args);
         return action_;
     }
+
+    CoordinatorExecutor::Method CoordinatorExecutor::Resolve(const std::string& method) {
+        return ctx_->FindTopLevelVariable(method);
+    }
+
+    CoordinatorAction CoordinatorExecutor::Execute(Method method,
+                                                   const lepus::Value* args,
+                                                   size_t argc) {
+        action_.Reset();
+        if (method != nullptr) {
+            ctx_->Call(method, args, argc);
+        }
+        return action_;
+    }
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #define LYNX_RENDER_COORDINATOR_EXECUTOR_H_
 
 #include <string>
+#include "base/ref_counted_ptr.h"
+#include "lepus/program.h"
 #include "lepus/vm_context.h"
 #include "lepus/vm.h"
 #include "render/coordinator/coordinator_action.h"
@@ -11,15 +13,33 @@
 namespace lynx {
     class CoordinatorExecutor {
     public:
+        // Reusable handle of a script method, see Resolve().
+        typedef lepus::String* Method;
+
+        // Executors of the same script share one compiled program, each
+        // only creates a context attached to it, see lepus::Program.
         CoordinatorExecutor(const std::string& executable);
         ~CoordinatorExecutor();
 
         CoordinatorAction Execute(const std::string& method, const std::vector<lepus::Value>& args);
 
+        // Looks |method| up once. The handle stays valid for the lifetime
+        // of the executor and is nullptr when the script has no such
+        // top level name.
+        Method Resolve(const std::string& method);
+
+        // Calls a resolved method without allocating or hashing the name,
+        // |args| are copied straight onto the lepus stack. Calling a null
+        // handle only resets the action.
+        CoordinatorAction Execute(Method method, const lepus::Value* args, size_t argc);
+
         lepus::VMContext *context() {
             return ctx_;
         }
     private:
+        static base::ScopedRefPtr<lepus::Program> GetProgram(const std::string& executable);
+
+        base::ScopedRefPtr<lepus::Program> program_;
         lepus::VMContext *ctx_;
         lepus::VM *vm_;
 
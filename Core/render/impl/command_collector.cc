@@ -2,39 +2,142 @@
 
 #include "render/impl/command_collector.h"
 
+#include <map>
+#include <set>
+#include <utility>
+
 #include "base/debug/memory_debug.h"
-#include "render/render_object.h"
+#include "base/timer/time_utils.h"
+#include "base/trace_event/trace_event_common.h"
 #include "render/impl/render_object_impl.h"
 #include "render/impl/render_command.h"
 
 namespace lynx {
 
-RenderCommandCollector::RenderCommandCollector() {
-    commands_ = lynx_new base::ScopedVector<RenderCommand>();
+RenderCommandCollector::RenderCommandCollector()
+    : recording_(0), first_collected_(0) {
 }
 
 RenderCommandCollector::~RenderCommandCollector() {
-    lynx_delete(commands_);
 }
 
-void RenderCommandCollector::Collect(RenderCommand* command) {
-    commands_->push_back(command);
+bool RenderCommandCollector::Collect(RenderCommand* command) {
+    base::AutoLock lock(lock_);
+    RenderCommands& commands = buffers_[recording_];
+    bool first = commands.empty();
+    if (first) {
+        first_collected_ = base::CurrentTimeMicroseconds();
+    }
+    commands.push_back(command);
+    return first;
 }
 
-void RenderCommandCollector::Push() {
-    base::AutoLock lock(lock_);
-    collectors_.push(commands_);
-    commands_ = lynx_new base::ScopedVector<RenderCommand>();
+void RenderCommandCollector::Flush() {
+    RenderCommands* commands = NULL;
+    uint64_t first_collected = 0;
+    {
+        base::AutoLock lock(lock_);
+        commands = &buffers_[recording_];
+        recording_ = 1 - recording_;
+        first_collected = first_collected_;
+    }
+    // The buffer swapped out is only touched here, on the UI thread, and
+    // is empty again before the next Flush swaps it back in.
+    if (commands->empty())
+        return;
+
+    TRACE_EVENT0("renderer", "RenderCommandCollector::Flush");
+    std::vector<bool> skipped;
+    size_t executed = Coalesce(*commands, skipped);
+    TRACE_COUNTER1("renderer", "RenderCommandsIssued",
+                   static_cast<int64_t>(commands->size()));
+    TRACE_COUNTER1("renderer", "RenderCommandsExecuted",
+                   static_cast<int64_t>(executed));
+    TRACE_COUNTER1("renderer", "RenderCommandLatencyUs",
+                   static_cast<int64_t>(base::CurrentTimeMicroseconds() -
+                                        first_collected));
+    for (size_t i = 0; i < commands->size(); ++i) {
+        if (!skipped[i])
+            (*commands)[i]->Execute();
+    }
+    commands->clear();
 }
 
-base::ScopedVector<RenderCommand>* RenderCommandCollector::Pop() {
-    base::AutoLock lock(lock_);
+size_t RenderCommandCollector::Coalesce(RenderCommands& commands,
+                                        std::vector<bool>& skipped) {
+    size_t count = commands.size();
+    skipped.assign(count, false);
+
+    // Only the last command sets the position, size, style or text, each
+    // of which replaces the whole of what the ones before set.
+    std::set<std::pair<RenderObjectImpl*, int> > set_later;
+    for (size_t i = count; i-- > 0;) {
+        RenderCommand* command = commands[i];
+        switch (command->type()) {
+            case RenderCommand::CMD_SET_POSITION:
+            case RenderCommand::CMD_SET_SIZE:
+            case RenderCommand::CMD_SET_STYLE:
+            case RenderCommand::CMD_SET_LABEL_TEXT:
+                skipped[i] = !set_later.insert(
+                    std::make_pair(command->host(), command->type())).second;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // The index of an add counts the children before it, so an add is only
+    // taken back by a remove when it is still the last change of the
+    // parent. A view that had a parent before the add is moved by it, and
+    // the add must stay. Whether each child ends up removed is kept as
+    // well.
+    std::map<RenderObjectImpl*, size_t> last_add;
+    std::map<RenderObjectImpl*, bool> removed;
+    std::set<RenderObjectImpl*> gone;
+    for (size_t i = 0; i < count; ++i) {
+        RenderCommand* command = commands[i];
+        if (command->type() == RenderCommand::CMD_DESTROY_VIEW) {
+            // A view removed for good is never seen again.
+            std::map<RenderObjectImpl*, bool>::iterator iter =
+                removed.find(command->host());
+            if (iter != removed.end() && iter->second)
+                gone.insert(command->host());
+            skipped[i] = true;
+            continue;
+        }
+        if (command->type() != RenderCommand::CMD_ADD_VIEW &&
+            command->type() != RenderCommand::CMD_REMOVE_VIEW)
+            continue;
+        RendererOperatorCommand* operation =
+            static_cast<RendererOperatorCommand*>(command);
+        RenderObjectImpl* child = operation->child();
+        bool is_add = command->type() == RenderCommand::CMD_ADD_VIEW;
+        removed[child] = !is_add;
+
+        std::map<RenderObjectImpl*, size_t>::iterator add =
+            last_add.find(command->host());
+        if (!is_add && add != last_add.end()) {
+            RendererOperatorCommand* last =
+                static_cast<RendererOperatorCommand*>(commands[add->second]);
+            if (last->child() == child && !last->child_attached()) {
+                skipped[add->second] = true;
+                skipped[i] = true;
+            }
+        }
+        if (is_add) {
+            last_add[command->host()] = i;
+        } else if (add != last_add.end()) {
+            last_add.erase(add);
+        }
+    }
 
-    RenderCommands* collector = NULL;
-    if (!collectors_.empty()) {
-        collector = collectors_.front();
-        collectors_.pop();
+    size_t left = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!skipped[i] && gone.count(commands[i]->host()))
+            skipped[i] = true;
+        if (!skipped[i])
+            ++left;
     }
-    return collector;
+    return left;
 }
 }  // namespace lynx
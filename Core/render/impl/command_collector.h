@@ -3,26 +3,53 @@
 #ifndef LYNX_RENDER_IMPL_COMMAND_COLLECTOR_H_
 #define LYNX_RENDER_IMPL_COMMAND_COLLECTOR_H_
 
-#include <queue>
+#include <stdint.h>
+
+#include <vector>
+
 #include "base/threading/lock.h"
 #include "base/scoped_vector.h"
-#include "base/scoped_ptr.h"
 
 namespace lynx {
 class RenderCommand;
+
+// Gathers the render commands of a frame so that the UI thread executes
+// them together, in one task, instead of one task per command. Two
+// buffers take turns: one records while the other, swapped out by Flush,
+// is executed.
 class RenderCommandCollector {
  public:
     typedef base::ScopedVector<RenderCommand> RenderCommands;
-    typedef base::ScopedVector<RenderCommand> RenderCommandsStorage;
+
     RenderCommandCollector();
     ~RenderCommandCollector();
 
-    void Collect(RenderCommand* command);
-    void Push();
-    RenderCommands* Pop();
+    // Records |command| for the next flush. Returns true for the first
+    // command since the last flush, for the caller to schedule one.
+    bool Collect(RenderCommand* command);
+
+    // Swaps the buffers and executes the recorded commands, on the UI
+    // thread, less those coalesced away. Traces how many were issued and
+    // executed, and how long the first waited.
+    void Flush();
+
+    // Marks the commands of |commands| that need not execute:
+    //  - all but the last position, size, style or text of a view,
+    //  - a view without a parent added and removed again, with nothing
+    //    inserted or removed between, on the same parent, to shift its
+    //    index,
+    //  - those on a view removed for good: a destroy command follows.
+    // Only reads the commands, the views may be changing meanwhile.
+    // Returns how many are left to execute.
+    static size_t Coalesce(RenderCommands& commands,
+                           std::vector<bool>& skipped);
+
  private:
-    RenderCommandsStorage* commands_;
-    std::queue<RenderCommandsStorage*> collectors_;
+    RenderCommands buffers_[2];
+    // The buffer Collect records into, guarded by |lock_|.
+    int recording_;
+    // When the first command of the recording buffer came.
+    uint64_t first_collected_;
     base::Lock lock_;
 };
 }  // namespace lynx
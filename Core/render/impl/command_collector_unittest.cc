@@ -0,0 +1,202 @@
+// Copyright 2017 The Lynx Authors. All rights reserved.
+
+#include "render/impl/command_collector.h"
+
+#include <vector>
+
+#include "base/debug/memory_debug.h"
+#include "gtest/gtest.h"
+#include "render/impl/render_command.h"
+#include "render/impl/render_object_impl.h"
+
+namespace lynx {
+
+namespace {
+class MockRenderObjectImpl : public RenderObjectImpl {
+ public:
+  MockRenderObjectImpl() : RenderObjectImpl(NULL, LYNX_VIEW) {}
+
+  virtual void UpdateStyle(const CSSStyle& style) {}
+  virtual void SetPosition(const base::Position& position) {}
+  virtual void SetSize(const base::Size& size) {}
+  virtual void InsertChild(RenderObjectImpl* child, int index) {}
+  virtual void RemoveChild(RenderObjectImpl* child) {}
+  virtual void SetText(const std::string& text) {}
+  virtual void SetAttribute(const std::string& key,
+                            const std::string& value) {}
+  virtual void RequestLayout() {}
+  virtual void AddEventListener(const std::string& event) {}
+  virtual void RemoveEventListener(const std::string& event) {}
+  virtual void SetData(int key, base::ScopedPtr<jscore::LynxValue> value) {}
+  virtual void Animate(base::ScopedPtr<jscore::LynxArray>& keyframes,
+                       base::ScopedPtr<jscore::LynxMap>& options) {}
+  virtual void CancelAnimation(const std::string& id) {}
+  virtual base::ScopedPtr<jscore::LynxMap> GetImagePixel(int x,
+                                                         int y,
+                                                         int w,
+                                                         int h) {
+    return base::ScopedPtr<jscore::LynxMap>();
+  }
+};
+}  // namespace
+
+class RenderCommandCollectorTest : public testing::Test {
+ protected:
+  RenderObjectImpl* NewView() {
+    RenderObjectImpl* view = lynx_new MockRenderObjectImpl;
+    views_.push_back(base::ScopedRefPtr<RenderObjectImpl>(view));
+    return view;
+  }
+
+  void SetPosition(RenderObjectImpl* view, int left) {
+    base::Position position(left, 0, left + 10, 10);
+    commands_.push_back(lynx_new RendererPosUpdateCommand(
+        view, position, RenderCommand::CMD_SET_POSITION));
+  }
+
+  void SetSize(RenderObjectImpl* view, int width) {
+    base::Size size(width, 10);
+    commands_.push_back(lynx_new RendererSizeUpdateCommand(
+        view, size, RenderCommand::CMD_SET_SIZE));
+  }
+
+  void SetStyle(RenderObjectImpl* view) {
+    commands_.push_back(lynx_new RendererStyleUpdateCommand(
+        view, SharedCSSStylePtr(), RenderCommand::CMD_SET_STYLE));
+  }
+
+  void SetText(RenderObjectImpl* view, const std::string& text) {
+    commands_.push_back(lynx_new RendererAttrUpdateCommand(
+        view, "", text, RenderCommand::CMD_SET_LABEL_TEXT));
+  }
+
+  void Add(RenderObjectImpl* parent,
+           RenderObjectImpl* child,
+           int index,
+           bool attached) {
+    commands_.push_back(lynx_new RendererOperatorCommand(
+        parent, child, index, RenderCommand::CMD_ADD_VIEW, attached));
+  }
+
+  void Remove(RenderObjectImpl* parent, RenderObjectImpl* child) {
+    commands_.push_back(lynx_new RendererOperatorCommand(
+        parent, child, 0, RenderCommand::CMD_REMOVE_VIEW, true));
+  }
+
+  void Destroy(RenderObjectImpl* view) {
+    commands_.push_back(lynx_new RendererDestroyCommand(view));
+  }
+
+  // The commands left to execute, by index.
+  std::vector<size_t> Coalesce() {
+    std::vector<bool> skipped;
+    size_t left = RenderCommandCollector::Coalesce(commands_, skipped);
+    std::vector<size_t> executed;
+    for (size_t i = 0; i < skipped.size(); ++i) {
+      if (!skipped[i])
+        executed.push_back(i);
+    }
+    EXPECT_EQ(left, executed.size());
+    return executed;
+  }
+
+  std::vector<size_t> Indices(size_t a, size_t b) {
+    std::vector<size_t> indices;
+    indices.push_back(a);
+    indices.push_back(b);
+    return indices;
+  }
+
+  // Declared after the views, so the commands release them first.
+  std::vector<base::ScopedRefPtr<RenderObjectImpl> > views_;
+  RenderCommandCollector::RenderCommands commands_;
+};
+
+TEST_F(RenderCommandCollectorTest, LastSetWinsTest) {
+  RenderObjectImpl* view = NewView();
+  RenderObjectImpl* other = NewView();
+  SetPosition(view, 0);
+  SetSize(view, 10);
+  SetStyle(view);
+  SetText(view, "a");
+  SetPosition(other, 0);
+  SetPosition(view, 10);
+  SetSize(view, 20);
+  SetStyle(view);
+  SetText(view, "b");
+
+  std::vector<size_t> executed = Coalesce();
+  ASSERT_EQ(5u, executed.size());
+  EXPECT_EQ(4u, executed[0]);
+  EXPECT_EQ(5u, executed[1]);
+  EXPECT_EQ(6u, executed[2]);
+  EXPECT_EQ(7u, executed[3]);
+  EXPECT_EQ(8u, executed[4]);
+}
+
+TEST_F(RenderCommandCollectorTest, AddRemoveTest) {
+  RenderObjectImpl* parent = NewView();
+  RenderObjectImpl* child = NewView();
+  Add(parent, child, 0, false);
+  SetPosition(child, 0);
+  Remove(parent, child);
+
+  // The view is kept alive and may be added back with its position.
+  std::vector<size_t> executed = Coalesce();
+  ASSERT_EQ(1u, executed.size());
+  EXPECT_EQ(1u, executed[0]);
+}
+
+TEST_F(RenderCommandCollectorTest, InterleavedAddRemoveTest) {
+  RenderObjectImpl* parent = NewView();
+  RenderObjectImpl* first = NewView();
+  RenderObjectImpl* second = NewView();
+  Add(parent, first, 0, false);
+  Add(parent, second, 1, false);
+  Remove(parent, first);
+  Remove(parent, second);
+
+  // The index of the second add counts the first child.
+  EXPECT_EQ(4u, Coalesce().size());
+}
+
+TEST_F(RenderCommandCollectorTest, ReparentTest) {
+  RenderObjectImpl* parent = NewView();
+  RenderObjectImpl* child = NewView();
+  Add(parent, child, 0, true);
+  Remove(parent, child);
+
+  // The add takes the view from its old parent.
+  EXPECT_EQ(Indices(0, 1), Coalesce());
+}
+
+TEST_F(RenderCommandCollectorTest, GoneTest) {
+  RenderObjectImpl* parent = NewView();
+  RenderObjectImpl* child = NewView();
+  SetPosition(child, 0);
+  SetText(child, "a");
+  Remove(parent, child);
+  SetPosition(parent, 0);
+  Destroy(child);
+
+  // Only the removal is seen.
+  EXPECT_EQ(Indices(2, 3), Coalesce());
+}
+
+TEST_F(RenderCommandCollectorTest, GoneAfterAddTest) {
+  RenderObjectImpl* parent = NewView();
+  RenderObjectImpl* child = NewView();
+  RenderObjectImpl* other = NewView();
+  Add(parent, child, 0, false);
+  SetPosition(child, 0);
+  Remove(parent, child);
+  Destroy(child);
+  // Destroyed without a removal in this batch.
+  SetPosition(other, 0);
+  Destroy(other);
+
+  std::vector<size_t> executed = Coalesce();
+  ASSERT_EQ(1u, executed.size());
+  EXPECT_EQ(4u, executed[0]);
+}
+}  // namespace lynx
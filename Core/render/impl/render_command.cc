@@ -53,7 +53,7 @@ void RendererOperatorCommand::Execute() {
     void RendererStyleUpdateCommand::Execute() {
         switch (type_) {
             case CMD_SET_STYLE:
-                host_->UpdateStyle(style_);
+                host_->UpdateStyle(*style_);
                 break;
             default:
                 break;
@@ -15,6 +15,7 @@
 #include "runtime/base/lynx_map.h"
 #include "runtime/canvas_cmd.h"
 #include "layout/css_style.h"
+#include "layout/shared_css_style.h"
 
 namespace lynx {
 class RenderObjectImpl;
@@ -36,6 +37,7 @@ class RenderCommand : public base::Closure {
         CMD_SET_DATA,
         CMD_ANIMATE,
         CMD_CANCEL_ANIMATION,
+        CMD_DESTROY_VIEW,
     };
 
     virtual void Execute() = 0;
@@ -44,6 +46,10 @@ class RenderCommand : public base::Closure {
         Execute();
     }
 
+    RenderObjectImpl* host() const { return host_; }
+
+    int type() const { return type_; }
+
  protected:
     RenderObjectImpl* host_;
     int type_;
@@ -51,18 +57,39 @@ class RenderCommand : public base::Closure {
 
     class RendererOperatorCommand : public RenderCommand {
     public:
-        explicit RendererOperatorCommand(RenderObjectImpl* host, RenderObjectImpl* child, int index, int type)
+        // |child_attached| tells whether the view of |child| had a parent
+        // when the command was built.
+        explicit RendererOperatorCommand(RenderObjectImpl* host, RenderObjectImpl* child, int index, int type,
+                                         bool child_attached)
                 : RenderCommand(host, type),
                   child_(child),
-                  index_(index){
+                  index_(index),
+                  child_attached_(child_attached){
 
         }
         virtual ~RendererOperatorCommand() {}
         virtual void Execute();
 
+        RenderObjectImpl* child() const { return child_.Get(); }
+
+        bool child_attached() const { return child_attached_; }
+
     private:
         base::ScopedRefPtr<RenderObjectImpl> child_;
         int index_;
+        bool child_attached_;
+    };
+
+    // Tells the collector that the render object of a removed view is gone,
+    // so no command can add the view back. Executes nothing.
+    class RendererDestroyCommand : public RenderCommand {
+    public:
+        explicit RendererDestroyCommand(RenderObjectImpl* host)
+                : RenderCommand(host, CMD_DESTROY_VIEW) {
+
+        }
+        virtual ~RendererDestroyCommand() {}
+        virtual void Execute() {}
     };
 
     class RendererPosUpdateCommand : public RenderCommand {
@@ -94,7 +121,9 @@ class RenderCommand : public base::Closure {
 
     class RendererStyleUpdateCommand : public RenderCommand {
     public:
-        explicit RendererStyleUpdateCommand(RenderObjectImpl* host, CSSStyle& style, int type)
+        // The style is shared with the render object, which copies it
+        // before changing it again, so the command holds no copy of its own.
+        explicit RendererStyleUpdateCommand(RenderObjectImpl* host, const SharedCSSStylePtr& style, int type)
                 : RenderCommand(host, type), style_(style) {
 
         }
@@ -102,7 +131,7 @@ class RenderCommand : public base::Closure {
         virtual void Execute();
 
     private:
-        CSSStyle style_;
+        SharedCSSStylePtr style_;
     };
 
     class RendererAttrUpdateCommand : public RenderCommand {
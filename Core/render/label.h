@@ -36,6 +36,9 @@ class Label : public RenderObject {
   TextNode* text_node() { return text_node_; }
   virtual base::Size MeasureTextSize(const base::Size& size);
 
+  // The measured height follows the text even when the style fixes it.
+  virtual bool IsRelayoutBoundary() override { return false; }
+
  protected:
   virtual base::Size OnMeasure(int width_descriptor,
                                int height_descriptor) override;
@@ -0,0 +1,26 @@
+// Copyright 2017 The Lynx Authors. All rights reserved.
+
+#include "render/label.h"
+
+#include "gtest/gtest.h"
+#include "layout/css_style_config.h"
+
+namespace lynx {
+
+TEST(LabelTest, IsRelayoutBoundaryTest) {
+  CSSStyleConfig config;
+  CSSStyle::Initialize(&config);
+  CSSStyle style(&config, 1, 750, 750);
+  style.SetValue("width", "100px");
+  style.SetValue("height", "20px");
+
+  LayoutObject box;
+  box.set_css_style(style);
+  EXPECT_TRUE(box.IsRelayoutBoundary());
+
+  // The measured height follows the text, whatever the style fixes.
+  Label label(NULL, "label", 1, NULL);
+  label.set_css_style(style);
+  EXPECT_FALSE(label.IsRelayoutBoundary());
+}
+}  // namespace lynx
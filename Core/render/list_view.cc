@@ -23,7 +23,7 @@ void ListView::OnLayout(int left, int top, int right, int bottom) {
   RenderObject* child = static_cast<RenderObject*>(LastChild());
   if (child == NULL)
     return;
-  if (css_style_.flex_direction_ == CSSStyleType::CSSFLEX_DIRECTION_COLUMN) {
+  if (css_style_->flex_direction_ == CSSStyleType::CSSFLEX_DIRECTION_COLUMN) {
     set_scroll_height(child->measured_position().bottom_);
     set_scroll_width(offset_width());
   } else {
@@ -30,6 +30,7 @@ RenderObject::RenderObject(const char* tag_name,
       render_object_type_(type),
       impl_(impl),
       render_tree_host_(host),
+      view_state_(VIEW_NEW),
       weak_ptr_(this) {
   if (impl != NULL) {
     impl->SetRenderObjectWeakRef(weak_ptr_);
@@ -37,6 +38,13 @@ RenderObject::RenderObject(const char* tag_name,
 }
 
 RenderObject::~RenderObject() {
+  // Nothing can add a removed view back now, the collector may drop the
+  // commands it still holds for it.
+  if (view_state_ == VIEW_REMOVED && render_tree_host_ != NULL &&
+      impl_.Get() != NULL) {
+    render_tree_host_->UpdateRenderObject(
+        lynx_new RendererDestroyCommand(impl_.Get()));
+  }
   weak_ptr_.Invalidate();
 }
 
@@ -103,12 +111,30 @@ void RenderObject::SetStyle(const std::string& key, const std::string& value) {
   if (!key.empty()) {
     LayoutObject::SetStyle(key, value);
     HandleFixedStyle();
+#if ENABLE_INSPECTOR
     styles_[key] = value;
+#endif
   } else {
     FlushStyle();
   }
 }
 
+void RenderObject::SetStyle(CSSPropertyID id, const std::string& value) {
+  if (id == CSS_PROPERTY_INVALID)
+    return;
+  SetStyle(id, CSSValue::Parse(id, value));
+}
+
+void RenderObject::SetStyle(CSSPropertyID id, const CSSValue& value) {
+  if (id == CSS_PROPERTY_INVALID)
+    return;
+  LayoutObject::SetStyle(id, value);
+  HandleFixedStyle();
+#if ENABLE_INSPECTOR
+  styles_[CSSPropertyName(id)] = value.text();
+#endif
+}
+
 void RenderObject::InsertChild(ContainerNode* child, int index) {
   if (child == NULL)
     return;
@@ -130,16 +156,15 @@ void RenderObject::InsertChild(ContainerNode* child, int index) {
   int insert_index = index < 0 ? GetChildCount() - 1 : index;
   for (int i = 0; i < insert_index; ++i) {
     RenderObject* temp = static_cast<RenderObject*>(Find(i));
-    if (temp->css_style_.css_position_type_ == CSSStyleType::CSS_POSITION_FIXED)
+    if (temp->css_style_->css_position_type_ == CSSStyleType::CSS_POSITION_FIXED)
       continue;
     final_insert_index += GetVisibleChildrenLength(temp);
   }
 
   for (int i = 0; i < visible_children.size(); ++i) {
     RenderObject* visible_child = visible_children.at(i);
-    RenderCommand* cmd = lynx_new RendererOperatorCommand(
-        renderer->impl(), visible_child->impl_.Get(), i + final_insert_index,
-        RenderCommand::CMD_ADD_VIEW);
+    RenderCommand* cmd = visible_child->CreateViewCommand(
+        renderer, i + final_insert_index, RenderCommand::CMD_ADD_VIEW);
     render_tree_host_->UpdateRenderObject(cmd);
   }
 
@@ -157,8 +182,14 @@ void RenderObject::RecalculateLayoutPosition(base::Position& position) {
 
 
 base::Size RenderObject::Measure(int width_descriptor, int height_descriptor) {
-  if (NeedRemeasure(width_descriptor, height_descriptor)) {
+  base::Size old_size = measured_size_;
+  bool remeasured = NeedRemeasure(width_descriptor, height_descriptor);
+  if (remeasured) {
     measured_size_ = OnMeasure(width_descriptor, height_descriptor);
+    CacheMeasuredSize(width_descriptor, height_descriptor);
+  }
+  // A cached size can differ from the one last sent as well.
+  if (remeasured || !old_size.IsEqual(measured_size_)) {
     if (!IsInvisible()) {
       base::Size size(base::Size::Descriptor::GetSize(measured_size_.width_),
                       base::Size::Descriptor::GetSize(measured_size_.height_));
@@ -227,9 +258,8 @@ void RenderObject::RemoveChild(ContainerNode* child) {
   GetVisibleChildren(static_cast<RenderObject*>(child), visible_children);
   std::vector<RenderObject*>::iterator visible_child = visible_children.begin();
   for (; visible_child != visible_children.end(); ++visible_child) {
-    RenderCommand* cmd = lynx_new RendererOperatorCommand(
-        renderer->impl(), (*visible_child)->impl_.Get(), 0,
-        RenderCommand::CMD_REMOVE_VIEW);
+    RenderCommand* cmd = (*visible_child)->CreateViewCommand(
+        renderer, 0, RenderCommand::CMD_REMOVE_VIEW);
     render_tree_host_->UpdateRenderObject(cmd);
   }
 }
@@ -257,11 +287,12 @@ void RenderObject::RemoveAttribute(const std::string& key) {
 
 void RenderObject::FlushStyle() {
   if (!IsInvisible()) {
+    InternStyle();
     RenderCommand* cmd = lynx_new RendererStyleUpdateCommand(
         impl(), css_style_, RenderCommand::CMD_SET_STYLE);
     render_tree_host_->UpdateRenderObject(cmd);
   }
-  Dirty();
+  DirtyStyle();
 }
 
 void RenderObject::SetScrollLeft(int scroll_left) {
@@ -312,25 +343,25 @@ void RenderObject::SetData(int key, base::ScopedPtr<jscore::LynxValue> value) {
 }
 
 void RenderObject::HandleFixedStyle() {
-  CSSStyleType cur_fixed_state = css_style_.css_position_type();
+  CSSStyleType cur_fixed_state = css_style_->css_position_type();
   if (parent_ == NULL)
     return;
 
   if (is_fixed_ &&
       (cur_fixed_state != CSSStyleType::CSS_POSITION_FIXED ||
-       css_style_.visible_ == CSSStyleType::CSS_HIDDEN ||
-       css_style_.css_display_type_ == CSSStyleType::CSS_DISPLAY_NONE)) {
+       css_style_->visible_ == CSSStyleType::CSS_HIDDEN ||
+       css_style_->css_display_type_ == CSSStyleType::CSS_DISPLAY_NONE)) {
     static_cast<RenderObject*>(parent_)->RemoveFixedChild(this);
   } else if (!is_fixed_ &&
              cur_fixed_state == CSSStyleType::CSS_POSITION_FIXED &&
-             css_style_.visible_ == CSSStyleType::CSS_VISIBLE &&
-             css_style_.css_display_type_ != CSSStyleType::CSS_DISPLAY_NONE) {
+             css_style_->visible_ == CSSStyleType::CSS_VISIBLE &&
+             css_style_->css_display_type_ != CSSStyleType::CSS_DISPLAY_NONE) {
     static_cast<RenderObject*>(parent_)->AddFixedChild(this);
   }
 }
 
 void RenderObject::AddFixedChildIfHave(RenderObject* child) {
-  if (child->css_style_.css_position_type() == CSSStyleType::CSS_POSITION_FIXED) {
+  if (child->css_style_->css_position_type() == CSSStyleType::CSS_POSITION_FIXED) {
     child->HandleFixedStyle();
   }
   if (child->fixed_children_.size() > 0) {
@@ -342,7 +373,7 @@ void RenderObject::AddFixedChildIfHave(RenderObject* child) {
 }
 
 void RenderObject::RemoveFixedChildIfHave(RenderObject* removed) {
-  if (removed->css_style_.css_position_type() == CSSStyleType::CSS_POSITION_FIXED) {
+  if (removed->css_style_->css_position_type() == CSSStyleType::CSS_POSITION_FIXED) {
     removed->HandleFixedStyle();
   }
 
@@ -356,15 +387,14 @@ void RenderObject::AddFixedChild(RenderObject* fixed_child) {
   fixed_children_.push_back(fixed_child);
   if (this == fixed_child->parent_) {
     // Remove from parent
-    RenderCommand* cmd_move_from_parent = lynx_new RendererOperatorCommand(
-        impl(), fixed_child->impl_.Get(), 0, RenderCommand::CMD_REMOVE_VIEW);
+    RenderCommand* cmd_move_from_parent = fixed_child->CreateViewCommand(
+        this, 0, RenderCommand::CMD_REMOVE_VIEW);
     render_tree_host_->UpdateRenderObject(cmd_move_from_parent);
 
     // Move to body
     RenderObject* root = render_tree_host_->render_root();
-    RenderCommand* cmd_move_to_body =
-        lynx_new RendererOperatorCommand(root->impl(), fixed_child->impl_.Get(),
-                                         -1, RenderCommand::CMD_ADD_VIEW);
+    RenderCommand* cmd_move_to_body = fixed_child->CreateViewCommand(
+        root, -1, RenderCommand::CMD_ADD_VIEW);
     render_tree_host_->UpdateRenderObject(cmd_move_to_body);
     fixed_child->is_fixed_ = true;
   }
@@ -386,20 +416,29 @@ void RenderObject::RemoveFixedChild(RenderObject* fixed_child) {
   if (this == fixed_child->parent_) {
     // Remove from body
     RenderObject* root = render_tree_host_->render_root();
-    RenderCommand* cmd_remove_from_body =
-        lynx_new RendererOperatorCommand(root->impl(), fixed_child->impl_.Get(),
-                                         0, RenderCommand::CMD_REMOVE_VIEW);
+    RenderCommand* cmd_remove_from_body = fixed_child->CreateViewCommand(
+        root, 0, RenderCommand::CMD_REMOVE_VIEW);
     render_tree_host_->UpdateRenderObject(cmd_remove_from_body);
     fixed_child->is_fixed_ = false;
 
     // Move to body
     int index = Find(fixed_child);
-    RenderCommand* cmd_move_to_parent = lynx_new RendererOperatorCommand(
-        impl(), fixed_child->impl_.Get(), index, RenderCommand::CMD_ADD_VIEW);
+    RenderCommand* cmd_move_to_parent = fixed_child->CreateViewCommand(
+        this, index, RenderCommand::CMD_ADD_VIEW);
     render_tree_host_->UpdateRenderObject(cmd_move_to_parent);
   }
 }
 
+RenderCommand* RenderObject::CreateViewCommand(RenderObject* parent,
+                                               int index,
+                                               int type) {
+  bool attached = view_state_ == VIEW_ATTACHED;
+  view_state_ =
+      type == RenderCommand::CMD_ADD_VIEW ? VIEW_ATTACHED : VIEW_REMOVED;
+  return lynx_new RendererOperatorCommand(parent->impl(), impl_.Get(), index,
+                                          type, attached);
+}
+
 std::string RenderObject::Animate(
     base::ScopedPtr<jscore::LynxArray>& keyframes,
     base::ScopedPtr<jscore::LynxMap>& options) {
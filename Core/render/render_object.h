@@ -22,6 +22,7 @@
 
 namespace lynx {
 class TouchEvent;
+class RenderCommand;
 class RenderObjectImpl;
 class RenderTreeHost;
 class RenderObject : public LayoutObject, public EventTarget {
@@ -36,6 +37,8 @@ class RenderObject : public LayoutObject, public EventTarget {
 
  virtual void SetStyle(const std::string& key,
                        const std::string& value) override;
+ virtual void SetStyle(CSSPropertyID id, const std::string& value) override;
+ virtual void SetStyle(CSSPropertyID id, const CSSValue& value) override;
   virtual void FlushStyle();
 
 
@@ -71,7 +74,10 @@ class RenderObject : public LayoutObject, public EventTarget {
  bool HasAttribute(const std::string& key);
  void RemoveAttribute(const std::string& key);
  const Attributes& attributes() { return attributes_; }
+#if ENABLE_INSPECTOR
+ // The styles as they were set, kept for the inspector only.
  const Styles& styles() { return styles_; }
+#endif
 
  // Sync attributes from element impl
  void UpdateData(int key, base::ScopedPtr<jscore::LynxValue> value);
@@ -158,6 +164,16 @@ class RenderObject : public LayoutObject, public EventTarget {
   void RemoveFixedChildIfHave(RenderObject* removed);
   void AddFixedChild(RenderObject* fixed_child);
   void RemoveFixedChild(RenderObject* fixed_child);
+  // Builds the command adding the view of this object to, or removing it
+  // from, the view of |parent|, and tracks where the view is.
+  RenderCommand* CreateViewCommand(RenderObject* parent, int index, int type);
+
+  // Where the view of this object is, as of the commands built so far.
+  enum ViewState {
+    VIEW_NEW,
+    VIEW_ATTACHED,
+    VIEW_REMOVED,
+  };
 
   std::string tag_name_;
   uint64_t id_;
@@ -170,7 +186,9 @@ class RenderObject : public LayoutObject, public EventTarget {
   std::string text_;
 
   Attributes attributes_;
+#if ENABLE_INSPECTOR
   Styles styles_;
+#endif
 
   bool is_fixed_;
   std::vector<RenderObject*> fixed_children_;
@@ -183,6 +201,8 @@ class RenderObject : public LayoutObject, public EventTarget {
 
   RenderTreeHost* render_tree_host_;
 
+  ViewState view_state_;
+
   base::WeakPtr<RenderObject> weak_ptr_;
 
   DISALLOW_COPY_AND_ASSIGN(RenderObject);
@@ -2,6 +2,8 @@
 
 #include "render/render_tree_host.h"
 
+#include <thread>
+
 #include "render/impl/render_command.h"
 #include "render/render_object.h"
 #include "render/render_tree_host_impl.h"
@@ -9,10 +11,33 @@
 #include "runtime/element.h"
 #include "runtime/runtime.h"
 
+#include "base/task/callback.h"
+#include "base/threading/thread_local.h"
 #include "base/trace_event/trace_event_common.h"
 
 namespace lynx {
 
+namespace {
+// The host whose DoBeginFrame lays out on this thread, if any. Its commit
+// flushes the commands, while a layout forced on the UI thread meanwhile
+// still posts its own flush.
+base::ThreadLocalPointer<RenderTreeHost> frame_host;
+
+// A command emitted by layout on a worker, handed back to the thread that
+// joins it.
+class DeferredRenderCommand : public base::Closure {
+ public:
+  DeferredRenderCommand(RenderTreeHost* host, RenderCommand* command)
+      : host_(host), command_(command) {}
+
+  virtual void Run() { host_->UpdateRenderObject(command_); }
+
+ private:
+  RenderTreeHost* host_;
+  RenderCommand* command_;
+};
+}  // namespace
+
 RenderTreeHost::RenderTreeHost(jscore::JSContext* context,
                                jscore::ThreadManager* thread_manager,
                                RenderObject* root)
@@ -20,7 +45,8 @@ RenderTreeHost::RenderTreeHost(jscore::JSContext* context,
       context_(context),
       thread_manager_(thread_manager),
       did_first_layout_(false),
-      page_location_("") {
+      page_location_(""),
+      layout_worker_pool_() {
   SetRenderRoot(root);
 }
 
@@ -36,47 +62,66 @@ void RenderTreeHost::SetRenderRoot(RenderObject* root) {
 }
 
 void RenderTreeHost::UpdateRenderObject(RenderCommand* command) {
-  // exec command immediately
-  thread_manager_->RunOnUIThread(command);
+  if (LayoutWorkerPool::InTask()) {
+    LayoutWorkerPool::Defer(lynx_new DeferredRenderCommand(this, command));
+    return;
+  }
 
-  // collect command and wait vsync signal to exec
-  // collector_.Collect(command);
+  // Commands of a frame wait for its commit, others for one flush posted
+  // with the first of them.
+  if (collector_.Collect(command) && frame_host.Get() != this) {
+    base::ScopedRefPtr<RenderTreeHost> ref(this);
+    thread_manager_->RunOnUIThread(
+        base::Bind(&RenderTreeHost::FlushCommands, ref));
+  }
 }
 
 void RenderTreeHost::ForceLayout(int left, int top, int right, int bottom) {
+  LayoutWorkerPool::Scope scope(layout_worker_pool_.Get());
   render_root_->ReLayout(left, top, right, bottom);
 }
 
+void RenderTreeHost::SetLayoutWorkerCount(int worker_count) {
+  // Workers sharing a core with the JS thread only add hand-off costs, so
+  // single core devices keep laying out sequentially.
+  int hardware_threads = static_cast<int>(std::thread::hardware_concurrency());
+  if (hardware_threads > 0 && worker_count > hardware_threads - 1) {
+    worker_count = hardware_threads - 1;
+  }
+  layout_worker_pool_.Reset(
+      worker_count > 0 ? lynx_new LayoutWorkerPool(worker_count) : NULL);
+}
+
 void RenderTreeHost::DoBeginFrame(const BeginFrameData& data) {
   viewport_ = data.viewport_;
   PrepareCommit(data);
-  render_root_->ReLayout(viewport_.left_, viewport_.top_, viewport_.right_,
-                         viewport_.bottom_);
+  {
+    LayoutWorkerPool::Scope scope(layout_worker_pool_.Get());
+    RenderTreeHost* outer = frame_host.Get();
+    frame_host.Set(this);
+    render_root_->ReLayout(viewport_.left_, viewport_.top_, viewport_.right_,
+                           viewport_.bottom_);
+    frame_host.Set(outer);
+  }
   render_tree_host_impl_->NotifyBeginFrameComplete();
 }
 
 void RenderTreeHost::PrepareCommit(const BeginFrameData& data) {
   render_tree_host_impl_->PrepareCommit();
-  collector_.Push();
 }
 
 void RenderTreeHost::DoCommit() {
   TRACE_EVENT0("renderer", "RenderTreeHost::DoCommit");
-  RenderCommandCollector::RenderCommands* commands = collector_.Pop();
-  if (commands == NULL)
-    return;
-  RenderCommandCollector::RenderCommandsStorage::iterator iter =
-      commands->begin();
-  for (; iter != commands->end(); ++iter) {
-    (*iter)->Execute();
-  }
-  lynx_delete(commands);
+  collector_.Flush();
 }
 
 void RenderTreeHost::ForceFlushCommands() {
   TRACE_EVENT0("js", "RenderTreeHost::ForceFlushCommands");
-  collector_.Push();
-  DoCommit();
+  collector_.Flush();
+}
+
+void RenderTreeHost::FlushCommands() {
+  collector_.Flush();
 }
 
 void RenderTreeHost::TreeSync() {
@@ -3,6 +3,8 @@
 #ifndef LYNX_RENDER_RENDER_TREE_HOST_H_
 #define LYNX_RENDER_RENDER_TREE_HOST_H_
 
+#include "base/scoped_ptr.h"
+#include "layout/layout_worker_pool.h"
 #include "render/impl/command_collector.h"
 #include "render/render_object.h"
 #include "render/render_tree_host_client.h"
@@ -36,6 +38,12 @@ class RenderTreeHost : public base::RefCountPtr<RenderTreeHost> {
   void DoCommit();
 
   void ForceLayout(int left, int top, int right, int bottom);
+
+  // Lays out independent subtrees, such as list cells, on |worker_count|
+  // threads besides the JS thread, at most one per spare hardware thread.
+  // Off by default, 0 turns it off again.
+  void SetLayoutWorkerCount(int worker_count);
+
   void ForceFlushCommands();
   void TreeSync();
   void RendererSync(RenderObject* renderer);
@@ -67,6 +75,8 @@ class RenderTreeHost : public base::RefCountPtr<RenderTreeHost> {
 
  private:
   void PrepareCommit(const BeginFrameData& data);
+  // Executes the commands collected outside a frame, on the UI thread.
+  void FlushCommands();
 
   RenderCommandCollector collector_;
   jscore::JSContext* context_;
@@ -77,6 +87,7 @@ class RenderTreeHost : public base::RefCountPtr<RenderTreeHost> {
   bool did_first_layout_;
   std::map<std::string, RenderObject*> renderer_id_map_;
   std::string page_location_;
+  base::ScopedPtr<LayoutWorkerPool> layout_worker_pool_;
 };
 }  // namespace lynx
 
@@ -32,7 +32,7 @@ base::Size ScrollView::OnMeasure(int width, int height) {
     height_temp += child->measured_size().height_ +
                    child->css_style().margin_bottom() + child->css_style().margin_top();
   }
-  if (css_style_.flex_direction() == CSSFLEX_DIRECTION_ROW) {
+  if (css_style_->flex_direction() == CSSFLEX_DIRECTION_ROW) {
     set_scroll_width(width_temp);
   } else {
     set_scroll_height(height_temp);
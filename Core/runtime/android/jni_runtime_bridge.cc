@@ -150,6 +150,10 @@ void InitGlobalConfig(JNIEnv* env, jclass jcaller,
             screenWidthPx, screenHeightPx, density, zoomRatioPx, device_info);
 }
 
+void SetLayoutWorkerCount(JNIEnv* env, jclass jcaller, jint count) {
+    config::GlobalConfigData::GetInstance()->set_layout_worker_count(count);
+}
+
 void SetExceptionListner(JNIEnv* env, jobject jcaller,
                          jlong runtime,
                          jobject listener) {
@@ -1,5 +1,6 @@
 // Copyright 2017 The Lynx Authors. All rights reserved.
 
+#include "config/global_config_data.h"
 #include "runtime/js/js_context.h"
 #include "runtime/runtime.h"
 #include "runtime/global.h"
@@ -39,6 +40,8 @@ namespace jscore {
     lynx::RenderTreeHost* Runtime::SetupRenderHost() {
         render_tree_host_ = lynx_new lynx::RenderTreeHost(context_.Get(),
                                                      thread_manager_.Get(), NULL);
+        render_tree_host_->SetLayoutWorkerCount(
+                config::GlobalConfigData::GetInstance()->layout_worker_count());
         lynx::Body* root = lynx_new lynx::Body(thread_manager(), render_tree_host());
         render_tree_host_->SetRenderRoot(root);
         return render_tree_host_.Get();
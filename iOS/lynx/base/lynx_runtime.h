@@ -20,6 +20,11 @@
 
 + (CGFloat) defaultZoomRatio;
 
+// Lays out independent subtrees, such as list cells, on |count| threads
+// besides the JS thread, for runtimes activated from now on. 0, the
+// default, turns it off.
++ (void) setLayoutWorkerCount:(NSInteger) count;
+
 - (void) prepare;
 
 - (void) prepareWithZoomRatio:(CGFloat) zoomRatio;
@@ -23,6 +23,10 @@ static CGFloat kDefaultZoomRatio = -1;
     return kDefaultZoomRatio;
 }
 
++ (void) setLayoutWorkerCount:(NSInteger) count {
+    config::GlobalConfigData::GetInstance()->set_layout_worker_count((int) count);
+}
+
 - (id) init {
     self = [super init];
     if (self) {
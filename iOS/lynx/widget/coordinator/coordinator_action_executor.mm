@@ -20,15 +20,15 @@ LX_NOT_IMPLEMENTED(- (instancetype) init)
 }
 
 - (void) postEvent:(lynx::CoordinatorAction) action {
-    if (!action.event_.empty()) {
-        NSString *eventName = [[[NSString alloc] initWithUTF8String:action.event_.c_str()] lowercaseString];
+    if (action.event_ != nullptr) {
+        NSString *eventName = [[[NSString alloc] initWithUTF8String:action.event_->c_str()] lowercaseString];
         id params = nil;
-        switch(action.params_for_event_.type_) {
+        switch(action.params_for_event_.type()) {
             case lepus::Value_Number:
-                params = [[NSNumber alloc] initWithDouble: action.params_for_event_.number_];
+                params = [[NSNumber alloc] initWithDouble: action.params_for_event_.number()];
                 break;
             case lepus::Value_String:
-                params = [[NSString alloc] initWithUTF8String: action.params_for_event_.str_->c_str()];
+                params = [[NSString alloc] initWithUTF8String: action.params_for_event_.str()->c_str()];
                 break;
             default: break;
         }
@@ -46,17 +46,15 @@
     std::vector<lepus::Value> lepus_args;
     
     lepus::Value lepus_tag;
-    lepus_tag.type_ = lepus::Value_String;
     if (tag) {
-        lepus_tag.str_ = _cExecutor->context()
+        lepus_tag.SetString(_cExecutor->context()
         ->string_pool()
-        ->NewString([tag UTF8String]);
+        ->NewString([tag UTF8String]));
     } else {
-        lepus_tag.str_ = lepus_tag.str_ = _cExecutor->context()
+        lepus_tag.SetString(_cExecutor->context()
         ->string_pool()
-        ->NewString("");
+        ->NewString(""));
     }
-    lepus_tag.str_->AddRef();
     
     lepus_args.push_back(lepus_tag);
     for (int i = 0; i < length; ++i) {
@@ -71,14 +69,12 @@
         std::string name = [property UTF8String];
         lepus::Value lepus_value;
         // Add string
-        lepus_value.type_ = lepus::Value_String;
         if (value != NULL) {
-            lepus_value.str_ = _cExecutor->context()->string_pool()
-            ->NewString([value UTF8String]);
+            lepus_value.SetString(_cExecutor->context()->string_pool()
+            ->NewString([value UTF8String]));
         } else {
-            lepus_value.str_ = lepus_value.str_ = _cExecutor->context()->string_pool()->NewString("");
+            lepus_value.SetString(_cExecutor->context()->string_pool()->NewString(""));
         }
-        lepus_value.str_->AddRef();
         if (_cExecutor->context()->UpdateTopLevelVariable(name, lepus_value)) {
             return YES;
         }
@@ -90,8 +86,7 @@
     // Add boolean
     std::string name = [property UTF8String];
     lepus::Value lepus_value;
-    lepus_value.type_ = lepus::Value_Boolean;
-    lepus_value.boolean_ = value;
+    lepus_value.SetBoolean(value);
     if (_cExecutor->context()->UpdateTopLevelVariable(name, lepus_value)) {
         return YES;
     } else {
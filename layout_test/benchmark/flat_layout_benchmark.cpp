@@ -0,0 +1,216 @@
+//
+//  flat_layout_benchmark.cpp
+//  layout_test
+//
+//  Loads the layout_test/feature fixtures, repeats them under one root
+//  until the tree holds at least the requested number of nodes, and times
+//  a full layout with CSSStaticLayout on the LayoutObject tree against
+//  CSSFlatLayout on its flattened copy. Both must produce the same
+//  positions for every node.
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "layout/css_flat_layout.h"
+#include "layout/css_style_config.h"
+#include "layout/layout_object.h"
+#include "layout/mock_layout_host.h"
+
+#ifndef LAYOUT_FEATURE_DIR
+#define LAYOUT_FEATURE_DIR "feature"
+#endif
+
+static const char* kFixtures[] = {
+    "AbsoluteTest", "AlignItemsTest", "AlignSelfTest", "BorderTest",
+    "DisplayTest", "FlexDirectionTest", "FlexOrderTest", "FlexTest",
+    "FlexWrapTest", "HeightTest", "JustifyContentTest", "MarginTest",
+    "MinMaxTest", "PaddingTest", "WidthTest",
+};
+
+struct FixtureNode {
+    std::vector<std::pair<std::string, std::string> > styles_;
+    std::vector<FixtureNode> children_;
+};
+
+static std::string Trim(const std::string& str) {
+    std::size_t begin = str.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    std::size_t end = str.find_last_not_of(" \t\r\n");
+    return str.substr(begin, end - begin + 1);
+}
+
+static void ParseStyle(const std::string& style, FixtureNode* node) {
+    std::stringstream stream(style);
+    std::string declaration;
+    while (std::getline(stream, declaration, ';')) {
+        std::size_t colon = declaration.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        node->styles_.push_back(std::make_pair(
+            Trim(declaration.substr(0, colon)), Trim(declaration.substr(colon + 1))));
+    }
+}
+
+// The fixtures are nested <div style="..."> elements and nothing else.
+static bool ParseDivs(const std::string& html, std::size_t* pos,
+                      std::vector<FixtureNode>* nodes) {
+    while (true) {
+        std::size_t open = html.find('<', *pos);
+        if (open == std::string::npos) {
+            return true;
+        }
+        if (html.compare(open, 6, "</div>") == 0) {
+            *pos = open + 6;
+            return true;
+        }
+        std::size_t close = html.find('>', open);
+        if (close == std::string::npos) {
+            return false;
+        }
+        std::string tag = html.substr(open, close - open);
+        *pos = close + 1;
+        if (tag.compare(0, 4, "<div") != 0) {
+            continue;
+        }
+        FixtureNode node;
+        std::size_t style = tag.find("style=\"");
+        if (style != std::string::npos) {
+            style += 7;
+            ParseStyle(tag.substr(style, tag.find('"', style) - style), &node);
+        }
+        if (!ParseDivs(html, pos, &node.children_)) {
+            return false;
+        }
+        nodes->push_back(node);
+    }
+}
+
+static bool LoadFixture(const std::string& path, std::vector<FixtureNode>* nodes) {
+    std::ifstream file(path.c_str());
+    if (!file) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string html = buffer.str();
+    std::size_t pos = 0;
+    return ParseDivs(html, &pos, nodes);
+}
+
+static int Instantiate(const FixtureNode& fixture, lynx::CSSStyleConfig* config,
+                       lynx::LayoutObject* parent) {
+    lynx::LayoutObject* object = new lynx::LayoutObject();
+    object->set_css_style(lynx::CSSStyle(config, 1, 750, 750));
+    for (std::size_t i = 0; i < fixture.styles_.size(); ++i) {
+        object->SetStyle(fixture.styles_[i].first, fixture.styles_[i].second);
+    }
+    parent->InsertChild(object, -1);
+    int count = 1;
+    for (std::size_t i = 0; i < fixture.children_.size(); ++i) {
+        count += Instantiate(fixture.children_[i], config, object);
+    }
+    return count;
+}
+
+static int Populate(const std::vector<FixtureNode>& fixtures, int min_nodes,
+                    lynx::MockLayoutHost* host) {
+    int count = 1;
+    while (count < min_nodes) {
+        for (std::size_t i = 0; i < fixtures.size(); ++i) {
+            count += Instantiate(fixtures[i], host->config(), host->body());
+        }
+    }
+    return count;
+}
+
+static void Collect(lynx::LayoutObject* object, std::vector<lynx::LayoutObject*>* objects) {
+    objects->push_back(object);
+    for (lynx::Node* child = object->FirstChild(); child != NULL; child = child->Next()) {
+        Collect(static_cast<lynx::LayoutObject*>(child), objects);
+    }
+}
+
+static void Dirty(const std::vector<lynx::LayoutObject*>& objects) {
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        objects[i]->Dirty();
+    }
+}
+
+int main(int argc, const char* argv[]) {
+    int min_nodes = argc > 1 ? atoi(argv[1]) : 10000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 20;
+    std::string feature_dir = argc > 3 ? argv[3] : LAYOUT_FEATURE_DIR;
+
+    std::vector<FixtureNode> fixtures;
+    for (std::size_t i = 0; i < sizeof(kFixtures) / sizeof(kFixtures[0]); ++i) {
+        std::string path = feature_dir + "/" + kFixtures[i] + ".html";
+        if (!LoadFixture(path, &fixtures)) {
+            std::cerr << "cannot read " << path << std::endl;
+            return 1;
+        }
+    }
+
+    lynx::MockLayoutHost static_host;
+    lynx::MockLayoutHost flat_host;
+    int count = Populate(fixtures, min_nodes, &static_host);
+    Populate(fixtures, min_nodes, &flat_host);
+    std::vector<lynx::LayoutObject*> static_objects;
+    std::vector<lynx::LayoutObject*> flat_objects;
+    Collect(static_host.body(), &static_objects);
+    Collect(flat_host.body(), &flat_objects);
+    std::cout << count << " nodes from " << fixtures.size() << " fixtures" << std::endl;
+
+    // Every node is dirtied before each round, so both engines measure and
+    // lay out the whole tree.
+    lynx::LayoutObject* root = static_host.body();
+    root->ReLayout(0, 0, 750, 0);
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        Dirty(static_objects);
+        root->ReLayout(0, 0, 750, 0);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double static_ms = std::chrono::duration<double, std::milli>(end - begin).count() / rounds;
+
+    lynx::CSSFlatLayout flat;
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        flat.Build(flat_host.body());
+    }
+    end = std::chrono::steady_clock::now();
+    double build_ms = std::chrono::duration<double, std::milli>(end - begin).count() / rounds;
+
+    flat.Layout(0, 0, 750, 0);
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        flat.Layout(0, 0, 750, 0);
+    }
+    end = std::chrono::steady_clock::now();
+    double flat_ms = std::chrono::duration<double, std::milli>(end - begin).count() / rounds;
+    flat.WriteBack();
+
+    int mismatches = 0;
+    for (std::size_t i = 0; i < static_objects.size(); ++i) {
+        const base::Position& expected = static_objects[i]->measured_position();
+        base::Position actual = flat_objects[i]->measured_position();
+        if (!actual.Equal(expected.left_, expected.top_, expected.right_, expected.bottom_)) {
+            ++mismatches;
+        }
+    }
+
+    std::cout << "CSSStaticLayout: " << static_ms << " ms" << std::endl;
+    std::cout << "CSSFlatLayout:   " << flat_ms << " ms  (build " << build_ms
+              << " ms, " << static_ms / flat_ms << "x)" << std::endl;
+    std::cout << mismatches << " nodes laid out differently" << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
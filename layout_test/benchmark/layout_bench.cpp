@@ -0,0 +1,356 @@
+//
+//  layout_bench.cpp
+//  layout_test
+//
+//  Times CSSStaticLayout on synthetic trees built from every combination
+//  of:
+//    shape      deep (nested chains) or wide (flat groups)
+//    direction  row or column containers
+//    wrap       flex-wrap: wrap or nowrap
+//    absolute   every eighth child position: absolute, or none
+//    clamp      min/max width and height on the leaves, or none
+//  Leaves are text nodes measured through an OnMeasure callback that
+//  spends a configurable time per call, as a platform text measurer does,
+//  or fixed size boxes when that time is negative.
+//
+//  Reports ns per node for the first layout of a fresh tree, a relayout
+//  with nothing dirty, and a relayout after one leaf's text changed, and
+//  how many times the first layout ran OnMeasure per node.
+//
+//  usage: layout_bench [--nodes=N] [--rounds=N] [--text-cost=NS]
+//                      [--filter=SUBSTRING] [--json[=FILE]]
+//  --json writes the results as JSON, to stdout or FILE, for regression
+//  tracking.
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/size.h"
+#include "layout/css_style_config.h"
+#include "layout/layout_object.h"
+#include "layout/mock_layout_host.h"
+
+namespace {
+
+struct Options {
+    Options() : nodes_(10000), rounds_(10), text_cost_(200), json_(false) {}
+
+    int nodes_;
+    int rounds_;
+    // Nanoseconds spent in each text measure, negative for no text.
+    int text_cost_;
+    std::string filter_;
+    bool json_;
+    std::string json_file_;
+};
+
+struct Shape {
+    bool deep_;
+    bool row_;
+    bool wrap_;
+    bool absolute_;
+    bool clamp_;
+
+    std::string Name() const {
+        std::string name = deep_ ? "deep" : "wide";
+        name += row_ ? "/row" : "/column";
+        name += wrap_ ? "/wrap" : "/nowrap";
+        name += absolute_ ? "/absolute" : "/static";
+        name += clamp_ ? "/clamp" : "/free";
+        return name;
+    }
+};
+
+struct Result {
+    std::string name_;
+    int nodes_;
+    double first_layout_;
+    double noop_relayout_;
+    double leaf_dirty_relayout_;
+    // OnMeasure calls of the first layout.
+    long measures_;
+    long text_measures_;
+};
+
+long measures = 0;
+long text_measures = 0;
+
+class Container : public lynx::LayoutObject {
+ public:
+    virtual base::Size OnMeasure(int width_descriptor, int height_descriptor) {
+        ++measures;
+        return lynx::LayoutObject::OnMeasure(width_descriptor, height_descriptor);
+    }
+};
+
+// A leaf measured like a label: 8px per character, wrapped into lines of
+// 20px when the width is bounded.
+class TextNode : public lynx::LayoutObject {
+ public:
+    TextNode(int length, int cost) : length_(length), cost_(cost) {}
+
+    void SetLength(int length) {
+        length_ = length;
+        Dirty();
+    }
+
+    virtual bool IsRelayoutBoundary() { return false; }
+
+    virtual base::Size OnMeasure(int width_descriptor, int height_descriptor) {
+        ++measures;
+        ++text_measures;
+        if (cost_ > 0) {
+            auto until = std::chrono::steady_clock::now() + std::chrono::nanoseconds(cost_);
+            while (std::chrono::steady_clock::now() < until) {
+            }
+        }
+        int width = length_ * 8;
+        int max_width = base::Size::Descriptor::GetSize(width_descriptor);
+        int mode = base::Size::Descriptor::GetMode(width_descriptor);
+        if (mode == base::Size::Descriptor::EXACTLY ||
+            (mode == base::Size::Descriptor::AT_MOST && max_width > 0 && width > max_width)) {
+            width = max_width;
+        }
+        int lines = width > 0 ? (length_ * 8 + width - 1) / width : 1;
+        return base::Size(width, lines * 20);
+    }
+
+ private:
+    int length_;
+    int cost_;
+};
+
+class Tree {
+ public:
+    Tree(const Shape& shape, const Options& options)
+        : shape_(shape), options_(options), host_(), count_(1) {
+        lynx::LayoutObject* root = host_.body();
+        if (shape_.deep_) {
+            // Chains 32 containers deep, each holding three leaves and the
+            // next container.
+            while (count_ < options_.nodes_) {
+                lynx::LayoutObject* parent = root;
+                for (int depth = 0; depth < 32 && count_ < options_.nodes_; ++depth) {
+                    lynx::LayoutObject* container = AddContainer(parent);
+                    for (int i = 0; i < 3; ++i) {
+                        AddLeaf(container, i);
+                    }
+                    parent = container;
+                }
+            }
+        } else {
+            // Groups of 64 leaves under the root.
+            while (count_ < options_.nodes_) {
+                lynx::LayoutObject* container = AddContainer(root);
+                for (int i = 0; i < 64 && count_ < options_.nodes_; ++i) {
+                    AddLeaf(container, i);
+                }
+            }
+        }
+    }
+
+    lynx::LayoutObject* root() { return host_.body(); }
+
+    int count() const { return count_; }
+
+    const std::vector<lynx::LayoutObject*>& leaves() const { return leaves_; }
+
+    // Changes the content of a leaf, picked by |index|.
+    void ChangeLeaf(int index) {
+        lynx::LayoutObject* leaf = leaves_[(index * 7919) % leaves_.size()];
+        if (options_.text_cost_ >= 0) {
+            static_cast<TextNode*>(leaf)->SetLength(5 + index % 17);
+        } else {
+            leaf->Dirty();
+        }
+    }
+
+ private:
+    lynx::LayoutObject* AddContainer(lynx::LayoutObject* parent) {
+        lynx::LayoutObject* container = new Container();
+        container->set_css_style(lynx::CSSStyle(host_.config(), 1, 750, 750));
+        container->SetStyle("flex-direction", shape_.row_ ? "row" : "column");
+        if (shape_.wrap_) {
+            container->SetStyle("flex-wrap", "wrap");
+            container->SetStyle(shape_.row_ ? "max-width" : "max-height", "700px");
+        }
+        container->SetStyle("padding-left", "4px");
+        container->SetStyle("margin-top", "2px");
+        parent->InsertChild(container, -1);
+        ++count_;
+        return container;
+    }
+
+    void AddLeaf(lynx::LayoutObject* parent, int index) {
+        lynx::LayoutObject* leaf;
+        if (options_.text_cost_ >= 0) {
+            leaf = new TextNode(4 + (count_ * 13) % 29, options_.text_cost_);
+        } else {
+            leaf = new Container();
+        }
+        leaf->set_css_style(lynx::CSSStyle(host_.config(), 1, 750, 750));
+        if (options_.text_cost_ < 0) {
+            leaf->SetStyle("width", std::to_string(20 + count_ % 60) + "px");
+            leaf->SetStyle("height", std::to_string(10 + count_ % 30) + "px");
+        }
+        leaf->SetStyle("margin-right", "3px");
+        if (index % 5 == 4) {
+            leaf->SetStyle("flex", "1");
+        }
+        if (shape_.absolute_ && index % 8 == 7) {
+            leaf->SetStyle("position", "absolute");
+            leaf->SetStyle("left", "10px");
+            leaf->SetStyle("top", "6px");
+        }
+        if (shape_.clamp_) {
+            leaf->SetStyle("min-width", "30px");
+            leaf->SetStyle("max-width", "120px");
+            leaf->SetStyle("min-height", "12px");
+            leaf->SetStyle("max-height", "48px");
+        }
+        parent->InsertChild(leaf, -1);
+        leaves_.push_back(leaf);
+        ++count_;
+    }
+
+    Shape shape_;
+    const Options& options_;
+    lynx::MockLayoutHost host_;
+    int count_;
+    std::vector<lynx::LayoutObject*> leaves_;
+};
+
+const int kViewportWidth = 750;
+const int kViewportHeight = 1334;
+
+double Elapsed(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin)
+        .count();
+}
+
+Result Run(const Shape& shape, const Options& options) {
+    Result result;
+    result.name_ = shape.Name();
+    result.first_layout_ = 0;
+    result.noop_relayout_ = 0;
+    result.leaf_dirty_relayout_ = 0;
+
+    int rounds = options.rounds_;
+    for (int round = 0; round < rounds; ++round) {
+        Tree tree(shape, options);
+        result.nodes_ = tree.count();
+
+        measures = 0;
+        text_measures = 0;
+        auto begin = std::chrono::steady_clock::now();
+        tree.root()->ReLayout(0, 0, kViewportWidth, kViewportHeight);
+        result.first_layout_ += Elapsed(begin);
+        result.measures_ = measures;
+        result.text_measures_ = text_measures;
+
+        begin = std::chrono::steady_clock::now();
+        tree.root()->ReLayout(0, 0, kViewportWidth, kViewportHeight);
+        result.noop_relayout_ += Elapsed(begin);
+
+        tree.ChangeLeaf(round);
+        begin = std::chrono::steady_clock::now();
+        tree.root()->ReLayout(0, 0, kViewportWidth, kViewportHeight);
+        result.leaf_dirty_relayout_ += Elapsed(begin);
+    }
+    double scale = 1.0 / (static_cast<double>(rounds) * result.nodes_);
+    result.first_layout_ *= scale;
+    result.noop_relayout_ *= scale;
+    result.leaf_dirty_relayout_ *= scale;
+    return result;
+}
+
+void WriteJson(std::ostream& out, const Options& options, const std::vector<Result>& results) {
+    out << "{\n"
+        << "  \"benchmark\": \"layout_bench\",\n"
+        << "  \"nodes\": " << options.nodes_ << ",\n"
+        << "  \"rounds\": " << options.rounds_ << ",\n"
+        << "  \"text_cost_ns\": " << options.text_cost_ << ",\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        out << "    {\"name\": \"" << result.name_ << "\", \"nodes\": " << result.nodes_
+            << ", \"first_layout_ns_per_node\": " << result.first_layout_
+            << ", \"noop_relayout_ns_per_node\": " << result.noop_relayout_
+            << ", \"leaf_dirty_relayout_ns_per_node\": " << result.leaf_dirty_relayout_
+            << ", \"first_layout_measures_per_node\": "
+            << static_cast<double>(result.measures_) / result.nodes_
+            << ", \"first_layout_text_measures\": " << result.text_measures_ << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n"
+        << "}\n";
+}
+
+bool ParseOptions(int argc, const char* argv[], Options* options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string flag(argv[i]);
+        if (flag.compare(0, 8, "--nodes=") == 0) {
+            options->nodes_ = atoi(flag.c_str() + 8);
+        } else if (flag.compare(0, 9, "--rounds=") == 0) {
+            options->rounds_ = atoi(flag.c_str() + 9);
+        } else if (flag.compare(0, 12, "--text-cost=") == 0) {
+            options->text_cost_ = atoi(flag.c_str() + 12);
+        } else if (flag.compare(0, 9, "--filter=") == 0) {
+            options->filter_ = flag.substr(9);
+        } else if (flag == "--json") {
+            options->json_ = true;
+        } else if (flag.compare(0, 7, "--json=") == 0) {
+            options->json_ = true;
+            options->json_file_ = flag.substr(7);
+        } else {
+            return false;
+        }
+    }
+    return options->nodes_ > 0 && options->rounds_ > 0;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    Options options;
+    if (!ParseOptions(argc, argv, &options)) {
+        std::cerr << "usage: layout_bench [--nodes=N] [--rounds=N] [--text-cost=NS]"
+                  << " [--filter=SUBSTRING] [--json[=FILE]]" << std::endl;
+        return 1;
+    }
+
+    std::vector<Result> results;
+    for (int i = 0; i < 32; ++i) {
+        Shape shape = {(i & 16) != 0, (i & 8) != 0, (i & 4) != 0, (i & 2) != 0, (i & 1) != 0};
+        if (shape.Name().find(options.filter_) == std::string::npos) {
+            continue;
+        }
+        results.push_back(Run(shape, options));
+        // With JSON on stdout, keep the table off it.
+        if (!options.json_ || !options.json_file_.empty()) {
+            const Result& result = results.back();
+            std::cout << result.name_ << "  " << result.nodes_ << " nodes"
+                      << "  first " << result.first_layout_ << " ns/node"
+                      << "  no-op " << result.noop_relayout_ << " ns/node"
+                      << "  leaf dirty " << result.leaf_dirty_relayout_ << " ns/node"
+                      << "  " << static_cast<double>(result.measures_) / result.nodes_
+                      << " measures/node (" << result.text_measures_ << " of text)" << std::endl;
+        }
+    }
+
+    if (options.json_) {
+        if (options.json_file_.empty()) {
+            WriteJson(std::cout, options, results);
+        } else {
+            std::ofstream out(options.json_file_.c_str());
+            WriteJson(out, options, results);
+        }
+    }
+    return 0;
+}
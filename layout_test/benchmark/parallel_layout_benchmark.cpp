@@ -0,0 +1,171 @@
+//
+//  parallel_layout_benchmark.cpp
+//  layout_test
+//
+//  Lays out a wide tree, a column of fixed size cells each holding a small
+//  flexbox subtree, with LayoutWorkerPools of growing size. Every node is
+//  dirtied before a round, so each one measures and lays out the whole
+//  tree. The positions and the number of OnMeasure calls must match the
+//  sequential layout for every worker count.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "layout/css_style_config.h"
+#include "layout/layout_object.h"
+#include "layout/layout_worker_pool.h"
+#include "layout/mock_layout_host.h"
+
+// Counts the measures that miss the measure cache.
+class CountingObject : public lynx::LayoutObject {
+public:
+    virtual base::Size OnMeasure(int width_descriptor, int height_descriptor) {
+        ++measures;
+        return lynx::LayoutObject::OnMeasure(width_descriptor, height_descriptor);
+    }
+
+    static std::atomic<long> measures;
+};
+
+std::atomic<long> CountingObject::measures(0);
+
+static lynx::LayoutObject* AddChild(lynx::LayoutObject* parent, lynx::CSSStyleConfig* config,
+                                    const char* styles[][2], int style_count) {
+    lynx::LayoutObject* child = new CountingObject();
+    child->set_css_style(lynx::CSSStyle(config, 1, 750, 750));
+    for (int i = 0; i < style_count; ++i) {
+        child->SetStyle(styles[i][0], styles[i][1]);
+    }
+    parent->InsertChild(child, -1);
+    return child;
+}
+
+// A list cell: an avatar, a text column with wrapping tags, and an
+// absolutely positioned badge.
+static int AddCell(lynx::LayoutObject* list, lynx::CSSStyleConfig* config, int index) {
+    const char* cell_style[][2] = {
+        {"width", "750px"}, {"height", "160px"}, {"flex-direction", "row"},
+        {"padding-left", "20px"}, {"padding-top", "10px"}, {"align-items", "center"},
+    };
+    const char* avatar_style[][2] = {
+        {"width", "120px"}, {"height", "120px"}, {"margin-right", "20px"},
+    };
+    const char* body_style[][2] = {
+        {"flex", "1"}, {"flex-direction", "column"}, {"justify-content", "space-between"},
+    };
+    const char* line_style[][2] = {
+        {"flex-direction", "row"}, {"flex-wrap", "wrap"}, {"max-width", "560px"},
+    };
+    const char* badge_style[][2] = {
+        {"position", "absolute"}, {"right", "20px"}, {"top", "10px"},
+        {"width", "40px"}, {"height", "40px"},
+    };
+    int count = 0;
+    lynx::LayoutObject* cell = AddChild(list, config, cell_style, 6);
+    AddChild(cell, config, avatar_style, 3);
+    lynx::LayoutObject* body = AddChild(cell, config, body_style, 3);
+    count += 3;
+    for (int line = 0; line < 3; ++line) {
+        lynx::LayoutObject* row = AddChild(body, config, line_style, 3);
+        ++count;
+        for (int tag = 0; tag < 8; ++tag) {
+            std::string width = std::to_string(30 + (index * 7 + line * 13 + tag * 29) % 90) + "px";
+            const char* tag_style[][2] = {
+                {"width", width.c_str()}, {"height", "30px"}, {"margin-right", "6px"},
+                {"min-width", "40px"},
+            };
+            AddChild(row, config, tag_style, 4);
+            ++count;
+        }
+    }
+    AddChild(cell, config, badge_style, 5);
+    return count + 1;
+}
+
+static void Collect(lynx::LayoutObject* object, std::vector<lynx::LayoutObject*>* objects) {
+    objects->push_back(object);
+    for (lynx::Node* child = object->FirstChild(); child != NULL; child = child->Next()) {
+        Collect(static_cast<lynx::LayoutObject*>(child), objects);
+    }
+}
+
+// Returns the mean time of a round, and the OnMeasure calls of a round in
+// |measures|.
+static double TimeLayout(lynx::LayoutObject* root, const std::vector<lynx::LayoutObject*>& objects,
+                         lynx::LayoutWorkerPool* pool, int rounds, long* measures) {
+    lynx::LayoutWorkerPool::Scope scope(pool);
+    double total = 0;
+    CountingObject::measures = 0;
+    for (int i = 0; i < rounds; ++i) {
+        for (size_t j = 0; j < objects.size(); ++j) {
+            objects[j]->Dirty();
+        }
+        auto begin = std::chrono::steady_clock::now();
+        root->ReLayout(0, 0, 750, 1334);
+        auto end = std::chrono::steady_clock::now();
+        total += std::chrono::duration<double, std::milli>(end - begin).count();
+    }
+    *measures = CountingObject::measures / rounds;
+    return total / rounds;
+}
+
+int main(int argc, const char* argv[]) {
+    int cells = argc > 1 ? atoi(argv[1]) : 2000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 10;
+    int max_workers = argc > 3 ? atoi(argv[3]) : 8;
+
+    lynx::MockLayoutHost host;
+    lynx::LayoutObject* root = host.body();
+    int count = 1;
+    for (int i = 0; i < cells; ++i) {
+        count += AddCell(root, host.config(), i);
+    }
+    std::vector<lynx::LayoutObject*> objects;
+    Collect(root, &objects);
+    std::cout << count << " nodes in " << cells << " cells, "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+    long expected_measures = 0;
+    TimeLayout(root, objects, NULL, 1, &expected_measures);
+    double sequential = TimeLayout(root, objects, NULL, rounds, &expected_measures);
+    std::vector<base::Position> expected;
+    for (size_t i = 0; i < objects.size(); ++i) {
+        expected.push_back(objects[i]->measured_position());
+    }
+    std::cout << "sequential: " << sequential << " ms, " << expected_measures << " measures"
+              << std::endl;
+
+    int failures = 0;
+    for (int workers = 0; workers <= max_workers; workers = workers == 0 ? 1 : workers * 2) {
+        lynx::LayoutWorkerPool pool(workers);
+        long measures = 0;
+        TimeLayout(root, objects, &pool, 1, &measures);
+        double ms = TimeLayout(root, objects, &pool, rounds, &measures);
+        int mismatches = 0;
+        for (size_t i = 0; i < objects.size(); ++i) {
+            base::Position position = objects[i]->measured_position();
+            if (!position.Equal(expected[i].left_, expected[i].top_, expected[i].right_,
+                                expected[i].bottom_)) {
+                ++mismatches;
+            }
+        }
+        std::cout << workers << " workers: " << ms << " ms  (" << sequential / ms << "x), "
+                  << measures << " measures";
+        if (mismatches != 0) {
+            std::cout << "  " << mismatches << " nodes laid out differently";
+            ++failures;
+        }
+        if (measures != expected_measures) {
+            std::cout << "  " << measures - expected_measures << " extra measures";
+            ++failures;
+        }
+        std::cout << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
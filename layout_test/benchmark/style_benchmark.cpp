@@ -0,0 +1,144 @@
+//
+//  style_benchmark.cpp
+//  layout_test
+//
+//  Applies the declarations of a typical list cell to CSSStyle, in css
+//  and camelCase names, and times:
+//    map      looking the names up in a std::map, as CSSStyleConfig did
+//    lookup   looking the names up with CSSPropertyIDForName
+//    name     CSSStyle::SetValue by name
+//    replay   CSSStyle::SetValue by id, the names looked up beforehand
+//    parsed   CSSStyle::SetValue by id with a CSSValue, the values parsed
+//             beforehand as the style parser does
+//    mirror   keeping the text in a std::map, as RenderObject did on
+//             every SetStyle before the map became inspector only
+//  All times are ns per declaration.
+//
+//  usage: style_benchmark [ROUNDS]
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "layout/css_property.h"
+#include "layout/css_style.h"
+#include "layout/css_style_config.h"
+#include "layout/css_value.h"
+
+namespace {
+
+const char* kDeclarations[][2] = {
+    {"width", "750px"},          {"height", "160px"},
+    {"flex-direction", "row"},   {"padding-left", "20px"},
+    {"padding-top", "10px"},     {"align-items", "center"},
+    {"background-color", "#fff"}, {"border-width", "1px"},
+    {"border-color", "#e0e0e0"}, {"marginRight", "20px"},
+    {"flexWrap", "wrap"},        {"maxWidth", "560px"},
+    {"fontSize", "28"},          {"color", "#333333"},
+    {"lineHeight", "40"},        {"textOverflow", "ellipsis"},
+    {"position", "absolute"},    {"right", "20px"},
+    {"top", "10px"},             {"opacity", "0.8"},
+    {"zIndex", "2"},             {"borderRadius", "8px"},
+    {"justify-content", "space-between"}, {"flex", "1"},
+};
+
+const int kDeclarationCount = sizeof(kDeclarations) / sizeof(kDeclarations[0]);
+
+std::map<std::string, lynx::CSSPropertyID> BuildMap() {
+    std::map<std::string, lynx::CSSPropertyID> map;
+#define MAP_NAME(id, setter, name, parser) map[name] = lynx::CSS_PROPERTY_##id;
+    CSS_PROPERTY_LIST(MAP_NAME)
+#undef MAP_NAME
+#define MAP_ALIAS(id, alias) map[alias] = lynx::CSS_PROPERTY_##id;
+    CSS_PROPERTY_ALIAS_LIST(MAP_ALIAS)
+#undef MAP_ALIAS
+    return map;
+}
+
+template <typename Function>
+double Time(int rounds, Function function) {
+    auto begin = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        function();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() /
+           (static_cast<double>(rounds) * kDeclarationCount);
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    int rounds = argc > 1 ? atoi(argv[1]) : 200000;
+
+    lynx::CSSStyleConfig config;
+    lynx::CSSStyle::Initialize(&config);
+    lynx::CSSStyle style(&config, 2, 750, 750);
+
+    std::vector<std::string> names;
+    std::vector<std::pair<lynx::CSSPropertyID, std::string> > parsed;
+    std::vector<lynx::CSSValue> values;
+    for (int i = 0; i < kDeclarationCount; ++i) {
+        names.push_back(kDeclarations[i][0]);
+        lynx::CSSPropertyID id = lynx::CSSPropertyIDForName(names.back());
+        if (id == lynx::CSS_PROPERTY_INVALID) {
+            std::cerr << "unknown property " << names.back() << std::endl;
+            return 1;
+        }
+        parsed.push_back(std::make_pair(id, std::string(kDeclarations[i][1])));
+        values.push_back(lynx::CSSValue::Parse(id, parsed.back().second));
+    }
+
+    std::map<std::string, lynx::CSSPropertyID> map = BuildMap();
+    long found = 0;
+    double map_ns = Time(rounds, [&]() {
+        for (int i = 0; i < kDeclarationCount; ++i) {
+            found += map.find(names[i]) != map.end();
+        }
+    });
+    double lookup_ns = Time(rounds, [&]() {
+        for (int i = 0; i < kDeclarationCount; ++i) {
+            found += lynx::CSSPropertyIDForName(names[i]) != lynx::CSS_PROPERTY_INVALID;
+        }
+    });
+    double name_ns = Time(rounds, [&]() {
+        for (int i = 0; i < kDeclarationCount; ++i) {
+            found += style.SetValue(names[i], parsed[i].second);
+        }
+    });
+    double replay_ns = Time(rounds, [&]() {
+        for (int i = 0; i < kDeclarationCount; ++i) {
+            found += style.SetValue(parsed[i].first, parsed[i].second);
+        }
+    });
+    double parsed_ns = Time(rounds, [&]() {
+        for (int i = 0; i < kDeclarationCount; ++i) {
+            found += style.SetValue(parsed[i].first, values[i]);
+        }
+    });
+    std::map<std::string, std::string> mirror;
+    double mirror_ns = Time(rounds, [&]() {
+        for (int i = 0; i < kDeclarationCount; ++i) {
+            mirror[names[i]] = parsed[i].second;
+        }
+        found += kDeclarationCount;
+    });
+
+    if (found != 6L * rounds * kDeclarationCount) {
+        std::cerr << "lookups failed" << std::endl;
+        return 1;
+    }
+    std::cout << kDeclarationCount << " declarations, " << rounds << " rounds" << std::endl;
+    std::cout << "map:    " << map_ns << " ns" << std::endl;
+    std::cout << "lookup: " << lookup_ns << " ns" << std::endl;
+    std::cout << "name:   " << name_ns << " ns" << std::endl;
+    std::cout << "replay: " << replay_ns << " ns" << std::endl;
+    std::cout << "parsed: " << parsed_ns << " ns" << std::endl;
+    std::cout << "mirror: " << mirror_ns << " ns" << std::endl;
+    return 0;
+}
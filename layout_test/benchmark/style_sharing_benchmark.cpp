@@ -0,0 +1,173 @@
+//
+//  style_sharing_benchmark.cpp
+//  layout_test
+//
+//  Builds a page of list cells, each an image beside a title and a
+//  subtitle, with styles from a handful of classes and a few inline
+//  overrides, and reports the heap held by the styles:
+//    own      every node holding a style of its own, as before interning
+//    interned every node holding the shared style of the pool
+//  and what a style command for every node copied before, when each one
+//  carried a CSSStyle by value. Checks that interning leaves the layout
+//  unchanged.
+//
+//  usage: style_sharing_benchmark [NODES]
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "layout/css_style_config.h"
+#include "layout/layout_object.h"
+#include "layout/mock_layout_host.h"
+#include "layout/shared_css_style.h"
+
+namespace {
+
+// Live heap bytes, counted by the operator new below.
+long live_bytes = 0;
+
+const int kViewportWidth = 750;
+const int kViewportHeight = 1334;
+
+struct StyleClass {
+    const char* declarations_[8][2];
+};
+
+const StyleClass kCell = {{{"flex-direction", "row"}, {"height", "160px"},
+                           {"padding-left", "20px"}, {"padding-right", "20px"},
+                           {"align-items", "center"}, {"border-width", "1px"},
+                           {"border-color", "#e0e0e0"}, {"background-color", "#ffffff"}}};
+const StyleClass kImage = {{{"width", "120px"}, {"height", "120px"},
+                            {"margin-right", "20px"}, {"border-radius", "8px"},
+                            {"object-fit", "cover"}}};
+const StyleClass kText = {{{"flex-direction", "column"}, {"flex", "1"},
+                           {"justify-content", "space-between"}}};
+const StyleClass kTitle = {{{"font-size", "32"}, {"color", "#333333"},
+                            {"line-height", "44"}, {"text-overflow", "ellipsis"},
+                            {"white-space", "nowrap"}}};
+const StyleClass kSubtitle = {{{"font-size", "26"}, {"color", "#999999"},
+                               {"margin-top", "8px"}, {"line-height", "36"}}};
+
+class Page {
+ public:
+    explicit Page(int nodes) : host_(), count_(1) {
+        for (int index = 0; count_ < nodes; ++index) {
+            lynx::LayoutObject* cell = Add(host_.body(), kCell);
+            // Every fifth cell is highlighted inline.
+            if (index % 5 == 0) {
+                cell->SetStyle(lynx::CSS_PROPERTY_BACKGROUND_COLOR, "#fff8e0");
+            }
+            Add(cell, kImage);
+            lynx::LayoutObject* text = Add(cell, kText);
+            Add(text, kTitle);
+            lynx::LayoutObject* subtitle = Add(text, kSubtitle);
+            // Some subtitles are cut to one line.
+            if (index % 3 == 0) {
+                subtitle->SetStyle(lynx::CSS_PROPERTY_TEXT_OVERFLOW, "ellipsis");
+            }
+        }
+    }
+
+    lynx::LayoutObject* root() { return host_.body(); }
+
+    lynx::CSSStyleConfig* config() { return host_.config(); }
+
+    const std::vector<lynx::LayoutObject*>& nodes() const { return nodes_; }
+
+    void InternStyles() {
+        host_.body()->InternStyle();
+        for (size_t i = 0; i < nodes_.size(); ++i) {
+            nodes_[i]->InternStyle();
+        }
+    }
+
+ private:
+    lynx::LayoutObject* Add(lynx::LayoutObject* parent, const StyleClass& style_class) {
+        lynx::LayoutObject* node = new lynx::LayoutObject();
+        node->set_css_style(lynx::CSSStyle(host_.config(), 2, 750, 750));
+        for (int i = 0; i < 8 && style_class.declarations_[i][0] != NULL; ++i) {
+            node->SetStyle(lynx::CSSPropertyIDForName(style_class.declarations_[i][0]),
+                           style_class.declarations_[i][1]);
+        }
+        parent->InsertChild(node, -1);
+        nodes_.push_back(node);
+        ++count_;
+        return node;
+    }
+
+    lynx::MockLayoutHost host_;
+    int count_;
+    std::vector<lynx::LayoutObject*> nodes_;
+};
+
+std::vector<int> Positions(Page& page) {
+    page.root()->ReLayout(0, 0, kViewportWidth, kViewportHeight);
+    std::vector<int> positions;
+    for (size_t i = 0; i < page.nodes().size(); ++i) {
+        lynx::LayoutObject* node = page.nodes()[i];
+        positions.push_back(node->offset_left());
+        positions.push_back(node->offset_top());
+        positions.push_back(node->offset_width());
+        positions.push_back(node->offset_height());
+    }
+    return positions;
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+    size_t* block = static_cast<size_t*>(malloc(size + sizeof(size_t) * 2));
+    if (block == NULL) {
+        throw std::bad_alloc();
+    }
+    block[0] = size;
+    live_bytes += size;
+    return block + 2;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr == NULL) {
+        return;
+    }
+    size_t* block = static_cast<size_t*>(ptr) - 2;
+    live_bytes -= block[0];
+    free(block);
+}
+
+int main(int argc, const char* argv[]) {
+    int nodes = argc > 1 ? atoi(argv[1]) : 5000;
+
+    Page page(nodes);
+    std::vector<int> own_positions = Positions(page);
+
+    long own_bytes = live_bytes;
+    auto begin = std::chrono::steady_clock::now();
+    page.InternStyles();
+    auto end = std::chrono::steady_clock::now();
+    long interned_bytes = live_bytes;
+
+    std::vector<int> interned_positions = Positions(page);
+    if (own_positions != interned_positions) {
+        std::cerr << "layout changed by interning" << std::endl;
+        return 1;
+    }
+
+    long count = static_cast<long>(page.nodes().size()) + 1;
+    size_t unique = page.config()->style_pool()->size();
+    double intern_ns =
+        std::chrono::duration<double, std::nano>(end - begin).count() / count;
+    std::cout << count << " nodes, " << unique << " distinct styles" << std::endl;
+    std::cout << "style size:     " << sizeof(lynx::SharedCSSStyle) << " bytes" << std::endl;
+    std::cout << "heap own:       " << own_bytes / 1024 << " KiB" << std::endl;
+    std::cout << "heap interned:  " << interned_bytes / 1024 << " KiB" << std::endl;
+    std::cout << "saved:          " << (own_bytes - interned_bytes) / 1024 << " KiB" << std::endl;
+    std::cout << "command copies: " << count * sizeof(lynx::CSSStyle) / 1024
+              << " KiB before, none now" << std::endl;
+    std::cout << "intern:         " << intern_ns << " ns per node" << std::endl;
+    return 0;
+}
@@ -0,0 +1,78 @@
+//
+//  coordinator_benchmark.cpp
+//  lepus
+//
+//  Per call latency of a scroll coordinator method, called by name with a
+//  vector of arguments and through a handle from Resolve(), and the cost of
+//  creating one more executor for a script already in use.
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "render/coordinator/coordinator_executor.h"
+#include "lepus/value.h"
+
+static const char* kScript =
+    "function onScroll(tag, y) {\n"
+    "  if (y < 300) {\n"
+    "    setTranslateY(0 - y / 2)\n"
+    "    setOpacity(1 - y / 300)\n"
+    "  } else {\n"
+    "    setOpacity(0)\n"
+    "  }\n"
+    "  setConsumed(true)\n"
+    "}\n";
+
+int main(int argc, const char* argv[]) {
+    int calls = argc > 1 ? atoi(argv[1]) : 1000000;
+    int executors = argc > 2 ? atoi(argv[2]) : 10000;
+
+    lynx::CoordinatorExecutor executor(kScript);
+
+    auto create_begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < executors; ++i) {
+        lynx::CoordinatorExecutor list(kScript);
+    }
+    auto create_end = std::chrono::steady_clock::now();
+    double create = std::chrono::duration<double, std::micro>(create_end - create_begin).count()
+        / executors;
+    lepus::Value tag;
+    tag.SetString(executor.context()->string_pool()->NewString("header"));
+    tag.str()->AddRef();
+
+    double by_name_sum = 0;
+    std::vector<lepus::Value> args;
+    args.push_back(tag);
+    args.push_back(lepus::Value(0));
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; ++i) {
+        args[1].SetNumber(i % 400);
+        by_name_sum += executor.Execute("onScroll", args).opacity_;
+    }
+    auto end = std::chrono::steady_clock::now();
+    double by_name = std::chrono::duration<double, std::nano>(end - begin).count() / calls;
+
+    lynx::CoordinatorExecutor::Method method = executor.Resolve("onScroll");
+    double by_handle_sum = 0;
+    lepus::Value handle_args[2];
+    handle_args[0] = tag;
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; ++i) {
+        handle_args[1].SetNumber(i % 400);
+        by_handle_sum += executor.Execute(method, handle_args, 2).opacity_;
+    }
+    end = std::chrono::steady_clock::now();
+    double by_handle = std::chrono::duration<double, std::nano>(end - begin).count() / calls;
+
+    tag.str()->Release();
+    std::cout << "by name: " << by_name << " ns/call"
+              << "  by handle: " << by_handle << " ns/call"
+              << "  speedup: " << by_name / by_handle << "x"
+              << (by_name_sum == by_handle_sum ? "" : "  (results differ)") << std::endl;
+    std::cout << "create: " << create << " us/executor" << std::endl;
+    return 0;
+}
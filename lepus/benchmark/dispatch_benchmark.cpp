@@ -0,0 +1,88 @@
+//
+//  dispatch_benchmark.cpp
+//  lepus
+//
+//  Compares the switch interpreter loop with the threaded (computed goto)
+//  one on an arithmetic-heavy, a call-heavy and a table field heavy script.
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "lepus/vm_context.h"
+#include "lepus/value.h"
+
+static const char* kScript =
+    "function arith(n) {\n"
+    "  var x = 0\n"
+    "  var i = 0\n"
+    "  while (i < n) {\n"
+    "    x = x + i * 2 - i / 3\n"
+    "    x = x % 1000\n"
+    "    i++\n"
+    "  }\n"
+    "  return x\n"
+    "}\n"
+    "function add(a, b) {\n"
+    "  return a + b\n"
+    "}\n"
+    "function calls(n) {\n"
+    "  var s = 0\n"
+    "  for (var i = 0; i < n; i++) {\n"
+    "    s = add(s, i)\n"
+    "  }\n"
+    "  return s\n"
+    "}\n"
+    "function fields(n) {\n"
+    "  var s = 0\n"
+    "  for (var i = 0; i < n; i++) {\n"
+    "    Math.acc = i\n"
+    "    s = s + Math.acc\n"
+    "  }\n"
+    "  return s\n"
+    "}\n";
+
+static double Run(lepus::VMContext* ctx, const char* name, double n, int rounds) {
+    std::vector<lepus::Value> args;
+    args.push_back(lepus::Value(n));
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        ctx->Call(name, args);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+int main(int argc, const char* argv[]) {
+    double n = argc > 1 ? atof(argv[1]) : 100000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 20;
+
+    lepus::VMContext ctx;
+    ctx.Initialize();
+    ctx.Execute(kScript);
+
+    const char* workloads[] = {"arith", "calls", "fields"};
+    for (const char* name : workloads) {
+        ctx.set_threaded_dispatch(false);
+        Run(&ctx, name, n, 1);
+        double switch_ms = Run(&ctx, name, n, rounds);
+
+        ctx.set_threaded_dispatch(true);
+        Run(&ctx, name, n, 1);
+        double threaded_ms = Run(&ctx, name, n, rounds);
+
+        std::cout << name
+                  << "  switch: " << switch_ms << " ms"
+                  << "  threaded: " << threaded_ms << " ms";
+        if (ctx.threaded_dispatch()) {
+            std::cout << "  speedup: " << switch_ms / threaded_ms << "x";
+        } else {
+            std::cout << "  (computed goto unavailable)";
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
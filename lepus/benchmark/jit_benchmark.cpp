@@ -0,0 +1,100 @@
+//
+//  jit_benchmark.cpp
+//  lepus
+//
+//  Compares the interpreter with the baseline JIT on an animation style
+//  interpolation loop, one calling Math functions, and a table field heavy
+//  one. Both contexts must compute the same results.
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "lepus/vm_context.h"
+#include "lepus/value.h"
+
+static const char* kScript =
+    "function interpolate(n) {\n"
+    "  var sum = 0\n"
+    "  for (var i = 0; i < n; i++) {\n"
+    "    var t = (i % 1000) / 1000\n"
+    "    var eased = t * t * (3 - 2 * t)\n"
+    "    var y = 100 + (400 - 100) * eased\n"
+    "    if (y > 250) {\n"
+    "      sum = sum + y - 250\n"
+    "    } else {\n"
+    "      sum = sum - y / 2\n"
+    "    }\n"
+    "  }\n"
+    "  return sum\n"
+    "}\n"
+    "function spring(n) {\n"
+    "  var sum = 0\n"
+    "  for (var i = 0; i < n; i++) {\n"
+    "    var t = (i % 100) / 100\n"
+    "    sum = sum + 1 - Math.cos(t * 3) * Math.exp(0 - t * 4)\n"
+    "  }\n"
+    "  return sum\n"
+    "}\n"
+    "function fields(n) {\n"
+    "  var s = 0\n"
+    "  for (var i = 0; i < n; i++) {\n"
+    "    Math.acc = i\n"
+    "    s = s + Math.acc\n"
+    "  }\n"
+    "  return s\n"
+    "}\n";
+
+static double Run(lepus::VMContext* ctx, const char* name, double n, int rounds,
+                  double* result) {
+    std::vector<lepus::Value> args;
+    args.push_back(lepus::Value(n));
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        *result = ctx->Call(name, args).number();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+int main(int argc, const char* argv[]) {
+    double n = argc > 1 ? atof(argv[1]) : 100000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 20;
+
+    lepus::VMContext interpreter;
+    interpreter.Initialize();
+    interpreter.Execute(kScript);
+
+    lepus::VMContext jit;
+    jit.Initialize();
+    jit.set_jit_enabled(true);
+    jit.Execute(kScript);
+
+    const char* workloads[] = {"interpolate", "spring", "fields"};
+    for (const char* name : workloads) {
+        double interpreted_result = 0;
+        double jit_result = 0;
+        Run(&interpreter, name, n, 1, &interpreted_result);
+        double interpreted_ms = Run(&interpreter, name, n, rounds, &interpreted_result);
+        Run(&jit, name, n, 1, &jit_result);
+        double jit_ms = Run(&jit, name, n, rounds, &jit_result);
+
+        std::cout << name
+                  << "  interpreter: " << interpreted_ms << " ms"
+                  << "  jit: " << jit_ms << " ms";
+        if (jit.jit_enabled()) {
+            std::cout << "  speedup: " << interpreted_ms / jit_ms << "x";
+        } else {
+            std::cout << "  (no jit on this target)";
+        }
+        if (interpreted_result != jit_result) {
+            std::cout << "  (results differ: " << interpreted_result
+                      << " vs " << jit_result << ")";
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+//
+//  lexer_benchmark.cpp
+//  lepus
+//
+//  Tokenizes a generated bundle of scroll coordinator functions and
+//  reports the Scanner's throughput in MB/s.
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "lepus/scanner.h"
+#include "lepus/token.h"
+#include "lepus/vm_context.h"
+
+static const char* kFunction =
+    "// Collapses the header while the list scrolls.\n"
+    "function onScroll_%(tag, y) {\n"
+    "    var progress = y / 300\n"
+    "    if (progress < 1) {\n"
+    "        setTranslateY(0 - y / 2)\n"
+    "        setOpacity(1 - progress)\n"
+    "        setScale(1 - progress * 0.25)\n"
+    "    } else {\n"
+    "        setOpacity(0)\n"
+    "    }\n"
+    "    /* the list keeps scrolling */\n"
+    "    setConsumed(false)\n"
+    "    return \"header_%\"\n"
+    "}\n";
+
+static std::string MakeBundle(int functions) {
+    std::string bundle;
+    for (int i = 0; i < functions; ++i) {
+        std::ostringstream index;
+        index << i;
+        std::string function(kFunction);
+        std::string::size_type at;
+        while ((at = function.find('%')) != std::string::npos) {
+            function.replace(at, 1, index.str());
+        }
+        bundle += function;
+    }
+    return bundle;
+}
+
+static long Tokenize(lepus::VMContext* ctx, const std::string& source) {
+    lepus::Scanner scanner(source.data(), source.size(), ctx->string_pool());
+    lepus::Token token;
+    long tokens = 0;
+    do {
+        scanner.NextToken(token);
+        ++tokens;
+    } while (token.token_ != lepus::Token_EOF);
+    return tokens;
+}
+
+int main(int argc, const char* argv[]) {
+    int functions = argc > 1 ? atoi(argv[1]) : 5000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 20;
+
+    std::string bundle = MakeBundle(functions);
+    lepus::VMContext ctx;
+    ctx.Initialize();
+
+    long tokens = Tokenize(&ctx, bundle);
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        Tokenize(&ctx, bundle);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    double megabytes = static_cast<double>(bundle.size()) * rounds / (1024 * 1024);
+
+    std::cout << bundle.size() << " bytes, " << tokens << " tokens"
+              << "  " << megabytes / seconds << " MB/s"
+              << "  " << seconds * 1e9 / (static_cast<double>(tokens) * rounds) << " ns/token"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,217 @@
+//
+//  switch_benchmark.cpp
+//  lepus
+//
+//  Times SwitchInfo::Switch with every strategy the keys allow, on dense
+//  integer cases, sparse integer cases and event name strings, and then a
+//  script dispatching events through a switch statement. All strategies
+//  must agree on every offset.
+//
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "lepus/builtin.h"
+#include "lepus/switch.h"
+#include "lepus/table.h"
+#include "lepus/value.h"
+#include "lepus/vm_context.h"
+
+static const char* kEventNames[] = {
+    "tap", "longpress", "touchstart", "touchmove", "touchend", "touchcancel",
+    "scroll", "scrolltoupper", "scrolltolower", "focus", "blur", "input",
+    "confirm", "change", "load", "error", "appear", "disappear", "layout",
+    "animationstart", "animationend", "transitionend", "keyboard", "submit",
+};
+
+static const char* kScript =
+    "function dispatch(n) {\n"
+    "  var sum = 0\n"
+    "  for (var i = 0; i < n; i++) {\n"
+    "    switch (Events.name(i % 24)) {\n"
+    "      case \"tap\": sum = sum + 1; break\n"
+    "      case \"longpress\": sum = sum + 2; break\n"
+    "      case \"touchstart\": sum = sum + 3; break\n"
+    "      case \"touchmove\": sum = sum + 4; break\n"
+    "      case \"touchend\": sum = sum + 5; break\n"
+    "      case \"touchcancel\": sum = sum + 6; break\n"
+    "      case \"scroll\": sum = sum + 7; break\n"
+    "      case \"scrolltoupper\": sum = sum + 8; break\n"
+    "      case \"scrolltolower\": sum = sum + 9; break\n"
+    "      case \"focus\": sum = sum + 10; break\n"
+    "      case \"blur\": sum = sum + 11; break\n"
+    "      case \"input\": sum = sum + 12; break\n"
+    "      case \"confirm\": sum = sum + 13; break\n"
+    "      case \"change\": sum = sum + 14; break\n"
+    "      case \"load\": sum = sum + 15; break\n"
+    "      case \"error\": sum = sum + 16; break\n"
+    "      default: sum = sum + 100\n"
+    "    }\n"
+    "  }\n"
+    "  return sum\n"
+    "}\n"
+    "function opcodes(n) {\n"
+    "  var sum = 0\n"
+    "  for (var i = 0; i < n; i++) {\n"
+    "    switch (i % 12) {\n"
+    "      case 0: sum = sum + 1; break\n"
+    "      case 1: sum = sum + 2; break\n"
+    "      case 2: sum = sum + 3; break\n"
+    "      case 3: sum = sum + 4; break\n"
+    "      case 4: sum = sum + 5; break\n"
+    "      case 5: sum = sum + 6; break\n"
+    "      case 6: sum = sum + 7; break\n"
+    "      case 7: sum = sum + 8; break\n"
+    "      case 8: sum = sum + 9; break\n"
+    "      case 9: sum = sum + 10; break\n"
+    "      default: sum = sum + 100\n"
+    "    }\n"
+    "  }\n"
+    "  return sum\n"
+    "}\n";
+
+static std::vector<lepus::Value> event_names;
+
+static lepus::Value EventName(lepus::Context* context) {
+    return event_names[static_cast<std::size_t>(context->GetParam(1)->number())];
+}
+
+struct Workload {
+    const char* name_;
+    std::vector<lepus::Value> keys_;
+    // Values switched on, mostly hits and some misses.
+    std::vector<lepus::Value> probes_;
+};
+
+static double Time(lepus::SwitchInfo* info, const std::vector<lepus::Value>& probes,
+                   int rounds, long* checksum) {
+    long sum = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (std::size_t i = 0; i < probes.size(); ++i) {
+            sum += info->Switch(&probes[i]);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    *checksum = sum;
+    return std::chrono::duration<double, std::nano>(end - begin).count()
+        / (static_cast<double>(rounds) * probes.size());
+}
+
+static void RunWorkload(const Workload& workload, int rounds) {
+    const lepus::SwitchType types[] = {
+        lepus::SwitchType_Table, lepus::SwitchType_Lookup, lepus::SwitchType_Hash,
+    };
+    const char* type_names[] = {"table", "lookup", "hash"};
+
+    std::cout << workload.name_ << " (" << workload.keys_.size() << " cases)";
+    long expected = 0;
+    bool first = true;
+    for (int t = 0; t < 3; ++t) {
+        lepus::SwitchInfo info;
+        for (std::size_t i = 0; i < workload.keys_.size(); ++i) {
+            info.AddCase(workload.keys_[i], static_cast<long>(i) + 1);
+        }
+        info.set_default_offset(-1);
+        if (!info.Build(types[t])) {
+            continue;
+        }
+        long checksum = 0;
+        Time(&info, workload.probes_, 1, &checksum);
+        double ns = Time(&info, workload.probes_, rounds, &checksum);
+        std::cout << "  " << type_names[t] << ": " << ns << " ns";
+        if (first) {
+            expected = checksum;
+            first = false;
+        } else if (checksum != expected) {
+            std::cout << " (offsets differ)";
+        }
+    }
+    lepus::SwitchInfo chosen;
+    for (std::size_t i = 0; i < workload.keys_.size(); ++i) {
+        chosen.AddCase(workload.keys_[i], static_cast<long>(i) + 1);
+    }
+    chosen.Build();
+    std::cout << "  build() picks " << type_names[chosen.type()] << std::endl;
+}
+
+static double RunScript(lepus::VMContext* ctx, const char* name, double n, int rounds,
+                        double* result) {
+    std::vector<lepus::Value> args;
+    args.push_back(lepus::Value(n));
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        *result = ctx->Call(name, args).number();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+int main(int argc, const char* argv[]) {
+    int rounds = argc > 1 ? atoi(argv[1]) : 2000;
+    double n = argc > 2 ? atof(argv[2]) : 1000000;
+
+    lepus::VMContext ctx;
+    ctx.Initialize();
+
+    std::vector<Workload> workloads(3);
+    workloads[0].name_ = "dense int";
+    for (int i = 0; i < 32; ++i) {
+        workloads[0].keys_.push_back(lepus::Value(static_cast<double>(i)));
+    }
+    for (int i = 0; i < 1024; ++i) {
+        workloads[0].probes_.push_back(lepus::Value(static_cast<double>((i * 7) % 40)));
+    }
+
+    workloads[1].name_ = "sparse int";
+    for (int i = 0; i < 32; ++i) {
+        workloads[1].keys_.push_back(lepus::Value(static_cast<double>(i * i * 97)));
+    }
+    for (int i = 0; i < 1024; ++i) {
+        int k = (i * 7) % 40;
+        workloads[1].probes_.push_back(lepus::Value(static_cast<double>(k * k * 97)));
+    }
+
+    workloads[2].name_ = "event name";
+    std::size_t event_count = sizeof(kEventNames) / sizeof(kEventNames[0]);
+    std::vector<lepus::Value> names(event_count + 4);
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        std::string name = i < event_count ? kEventNames[i] : "custom" + std::to_string(i);
+        names[i].SetString(ctx.string_pool()->NewString(name));
+        // Only held from C++, pinned so the collector keeps them.
+        names[i].str()->AddRef();
+    }
+    for (std::size_t i = 0; i < 16; ++i) {
+        workloads[2].keys_.push_back(names[i]);
+    }
+    for (int i = 0; i < 1024; ++i) {
+        workloads[2].probes_.push_back(names[(i * 7) % names.size()]);
+    }
+
+    for (std::size_t i = 0; i < workloads.size(); ++i) {
+        RunWorkload(workloads[i], rounds);
+    }
+
+    event_names = names;
+    lepus::Dictonary* table = lynx_new lepus::Dictonary;
+    lepus::RegisterTableFunction(&ctx, table, "name", &EventName);
+    lepus::RegisterFunctionTable(&ctx, "Events", table);
+    ctx.Execute(kScript);
+
+    const char* scripts[] = {"dispatch", "opcodes"};
+    for (const char* name : scripts) {
+        double result = 0;
+        RunScript(&ctx, name, n / 10, 1, &result);
+        double ms = RunScript(&ctx, name, n, 5, &result);
+        std::cout << name << ": " << ms / 5 << " ms for " << n
+                  << " switches  (result " << result << ")" << std::endl;
+    }
+
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        names[i].str()->Release();
+    }
+    return 0;
+}
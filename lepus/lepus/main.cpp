@@ -6,36 +6,167 @@
 //  Copyright © 2017年 dli. All rights reserved.
 //
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <iostream>
 #include <fstream>
 #include <cassert>
 #include <string>
 
 #include "lepus/vm_context.h"
-#include "lepus/vm.h"
 #include "lepus/value.h"
+#include "lepus/bytecode.h"
+
+static std::string ReadFile(const char* path) {
+    std::ifstream t(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(t)),
+                       std::istreambuf_iterator<char>());
+}
+
+// Read only mapping of a script, which the scanner tokenizes in place.
+class MappedFile {
+public:
+    explicit MappedFile(const char* path) : data_(nullptr), size_(0) {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                data_ = static_cast<const char*>(data);
+                size_ = st.st_size;
+            }
+        }
+        close(fd);
+    }
+
+    ~MappedFile() {
+        if (data_ != nullptr) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+    }
+
+    const char* data() const {
+        return data_;
+    }
 
+    std::size_t size() const {
+        return size_;
+    }
+
+private:
+    const char* data_;
+    std::size_t size_;
+};
+
+static void PrintGCStats(const lepus::GC::Stats& stats) {
+    std::cout << "gc: " << stats.collections << " cycles, "
+              << stats.steps << " steps, "
+              << stats.allocated_objects << " objects / "
+              << stats.allocated_bytes << " bytes allocated, "
+              << stats.freed_objects << " freed, "
+              << stats.live_objects << " objects / "
+              << stats.live_bytes << " bytes live" << std::endl;
+    std::cout << "gc pause: max " << stats.max_pause_ms << " ms, last "
+              << stats.last_pause_ms << " ms, total "
+              << stats.total_pause_ms << " ms" << std::endl;
+}
+
+// usage: lepus [--gc-stats] [--dump-bytecode] [--no-optimize] [--jit]
+//              [--profile[=trace.json]] [script]
+// --profile prints a profile after the run and optionally writes it as a
+// Chrome trace.
+//        lepus [--dump-bytecode] [--no-optimize] --compile <script> <output>
 int main(int argc, const char * argv[]) {
-    std::ifstream t("../../../test.js");
-    std::string str((std::istreambuf_iterator<char>(t)),
-                    std::istreambuf_iterator<char>());
+    bool gc_stats = false;
+    bool dump_bytecode = false;
+    bool optimize = true;
+    bool jit = false;
+    bool profile = false;
+    std::string profile_trace;
+    while (argc > 1 && std::string(argv[1]) != "--compile"
+           && std::string(argv[1]).compare(0, 2, "--") == 0) {
+        std::string flag(argv[1]);
+        if (flag == "--gc-stats") {
+            gc_stats = true;
+        } else if (flag == "--dump-bytecode") {
+            dump_bytecode = true;
+        } else if (flag == "--no-optimize") {
+            optimize = false;
+        } else if (flag == "--jit") {
+            jit = true;
+        } else if (flag.compare(0, 9, "--profile") == 0
+                   && (flag.size() == 9 || flag[9] == '=')) {
+            profile = true;
+            profile_trace = flag.size() > 10 ? flag.substr(10) : "";
+        } else {
+            std::cerr << "unknown flag " << flag << std::endl;
+            return 1;
+        }
+        --argc;
+        ++argv;
+    }
+    
+    if (argc == 4 && std::string(argv[1]) == "--compile") {
+        lepus::VMContext ctx;
+        ctx.Initialize();
+        ctx.set_optimize_bytecode(optimize);
+        if (dump_bytecode) {
+            ctx.set_bytecode_dump(&std::cout);
+        }
+        std::string bytecode;
+        if (!ctx.Compile(ReadFile(argv[2]), bytecode)) {
+            return 1;
+        }
+        std::ofstream out(argv[3], std::ios::binary);
+        out.write(bytecode.data(), bytecode.size());
+        return out.good() ? 0 : 1;
+    }
+    
+    MappedFile script(argc > 1 ? argv[1] : "../../../test.js");
     
-    lepus::VM vm;
     lepus::VMContext ctx;
     ctx.Initialize();
-    vm.Execute(&ctx, str);
+    ctx.set_optimize_bytecode(optimize);
+    ctx.set_jit_enabled(jit);
+    ctx.set_profiling(profile);
+    if (dump_bytecode) {
+        ctx.set_bytecode_dump(&std::cout);
+    }
+    if (lepus::IsBytecode(script.data(), script.size())) {
+        ctx.ExecuteBytecode(script.data(), script.size());
+    } else {
+        ctx.Execute(script.data(), script.size());
+    }
     std::vector<lepus::Value> args;
     lepus::Value v1;
-    v1.number_ = 3;
-    v1.type_ = lepus::Value_Number;
+    v1.SetNumber(3);
     args.push_back(v1);
     lepus::Value v2;
-    v2.number_ = 3;
-    v2.type_ = lepus::Value_Number;
+    v2.SetNumber(3);
     args.push_back(v2);
 //    vm.Call(&ctx, "onScrollEvent1", args);
 //    vm.Call(&ctx, "onScrollEvent1", args);
     //vm.Call(&ctx, "onScrollEvent1", std::vector<lepus::Value>());
     std::cout<<"hello lepus"<<std::endl;
+    if (gc_stats) {
+        PrintGCStats(ctx.gc()->stats());
+    }
+    if (profile) {
+        ctx.profiler()->WriteReport(std::cout);
+        if (!profile_trace.empty()) {
+            std::ofstream trace(profile_trace.c_str());
+            ctx.profiler()->WriteTrace(trace);
+            if (!trace.good()) {
+                std::cerr << "can not write " << profile_trace << std::endl;
+                return 1;
+            }
+        }
+    }
     return 0;
 }
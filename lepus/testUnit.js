@@ -80,4 +80,17 @@ console.assert(Math.sqrt(0.64) === 0.8, "error: Math.sqrt")
 
 console.assert(Math.tan(0.5) === 0.546302, "error: Math.tan")
 
+Math.scale = 2;
+console.assert(Math.scale === 2, "error: member assign")
+Math.scale += 3;
+console.assert(Math.scale === 5, "error: member assign add")
+Math.scale *= 2;
+console.assert(Math.scale === 10, "error: member assign mul")
+var total = 0;
+for (var i = 0; i < 10; i++) {
+    Math.scale = i;
+    total += Math.scale;
+}
+console.assert(total === 45, "error: member assign in loop")
+
 console.log("success")